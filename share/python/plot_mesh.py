@@ -94,13 +94,93 @@ def read_meshdata(mesh_file, read_front=False):
     return nodes, boundaries, bdry_marker, front_edges, tris
 
 
+BIN_MAGIC   = b'TMESHBIN'
+BIN_VERSION = 1
+BIN_HEADER  = np.dtype([('magic',        'S8'),
+                        ('version',      '<u4'),
+                        ('header_size',  '<u4'),
+                        ('n_nodes',      '<u8'),
+                        ('n_tris',       '<u8'),
+                        ('n_bdry',       '<u8'),
+                        ('off_nodes',    '<u8'),
+                        ('off_tris',     '<u8'),
+                        ('off_nbrs',     '<u8'),
+                        ('off_bdry',     '<u8'),
+                        ('off_markers',  '<u8'),
+                        ('off_bdry_ids', '<u8'),
+                        ('file_size',    '<u8')])
+
+def is_binary_mesh(mesh_file):
+    '''
+    Function to check, if a file has been written 
+    with tmMesh_writeBinary()
+    '''
+    with open(mesh_file, 'rb') as reader:
+        return reader.read(len(BIN_MAGIC)) == BIN_MAGIC
+
+def map_binary_mesh(mesh_file):
+    '''
+    Function to map a binary mesh file into memory.
+    Returns a dictionary of read-only numpy arrays, 
+    which share a single memory map of the file
+    '''
+    buf = np.memmap(mesh_file, dtype=np.uint8, mode='r')
+    hdr = np.ndarray((), dtype=BIN_HEADER, buffer=buf)
+
+    if hdr['magic'] != BIN_MAGIC:
+        raise ValueError("{:} is no binary mesh file".format(mesh_file))
+    if hdr['version'] != BIN_VERSION:
+        raise ValueError("Unsupported mesh file version {:}".format(
+            hdr['version']))
+    if hdr['file_size'] != buf.size:
+        raise ValueError("Mesh file {:} is truncated".format(mesh_file))
+
+    n_nodes = int(hdr['n_nodes'])
+    n_tris  = int(hdr['n_tris'])
+    n_bdry  = int(hdr['n_bdry'])
+
+    def array(offset, shape, dtype):
+        return np.ndarray(shape, dtype=dtype, buffer=buf, 
+                          offset=int(hdr[offset]))
+
+    return {'nodes'        : array('off_nodes',    (n_nodes, 2), '<f8'),
+            'tris'         : array('off_tris',     (n_tris, 3),  '<i4'),
+            'neighbors'    : array('off_nbrs',     (n_tris, 3),  '<i4'),
+            'bdry_edges'   : array('off_bdry',     (n_bdry, 2),  '<i4'),
+            'bdry_markers' : array('off_markers',  (n_bdry,),    '<i4'),
+            'bdry_ids'     : array('off_bdry_ids', (n_bdry,),    '<i4')}
+
+def read_binary_meshdata(mesh_file):
+    '''
+    Function to read the mesh data of a binary mesh file 
+    in the same form as read_meshdata()
+    '''
+    mesh = map_binary_mesh(mesh_file)
+
+    boundaries  = {}
+    bdry_marker = {}
+
+    for edge, marker, bdry in zip(mesh['bdry_edges'].tolist(), 
+                                  mesh['bdry_markers'].tolist(),
+                                  mesh['bdry_ids'].tolist()):
+        boundaries.setdefault(bdry, []).append(tuple(edge))
+        bdry_marker.setdefault(marker, []).append(tuple(edge))
+
+    return mesh['nodes'], boundaries, bdry_marker, [], mesh['tris']
+
+
 def main():
     ''' The main function '''
     if len(sys.argv) < 3:
         print("plot_boundary.py <mesh> <export_path>")
         sys.exit(1)
 
-    nodes, boundaries, bdry_marker, front_edges, tris = read_meshdata(sys.argv[1])
+    if is_binary_mesh(sys.argv[1]):
+        read_data = read_binary_meshdata
+    else:
+        read_data = read_meshdata
+
+    nodes, boundaries, bdry_marker, front_edges, tris = read_data(sys.argv[1])
     export_path = sys.argv[2]
 
     i_plts = 0
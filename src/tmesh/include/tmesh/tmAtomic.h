@@ -0,0 +1,182 @@
+/*
+ * This header file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef TMESH_TMATOMIC_H
+#define TMESH_TMATOMIC_H
+
+#include "tmesh/tmTypedefs.h"
+
+/**********************************************************
+* Atomic accesses on plain (non-_Atomic) variables:
+*
+*   TM_ATOMIC_GNUC:    GCC / Clang __atomic builtins
+*   TM_ATOMIC_C11:     C11 <stdatomic.h>, which accesses
+*                      the variables through _Atomic
+*                      pointers of the same type
+*   TM_ATOMIC_PTHREAD: a global mutex (see tmAtomic.c)
+*
+* The implementation is chosen in the order above, unless
+* one of the macros is defined at compile time.
+**********************************************************/
+#if !defined(TM_ATOMIC_GNUC)  \
+ && !defined(TM_ATOMIC_C11)   \
+ && !defined(TM_ATOMIC_PTHREAD)
+#  if defined(__ATOMIC_RELAXED)
+#    define TM_ATOMIC_GNUC
+#  elif defined(__STDC_VERSION__)          \
+     && __STDC_VERSION__ >= 201112L        \
+     && !defined(__STDC_NO_ATOMICS__)
+#    define TM_ATOMIC_C11
+#  else
+#    define TM_ATOMIC_PTHREAD
+#  endif
+#endif
+
+#if defined(TM_ATOMIC_C11)
+#  include <stdatomic.h>
+#elif defined(TM_ATOMIC_PTHREAD)
+#  include <pthread.h>
+extern pthread_mutex_t tmAtomic_lock;
+#endif
+
+/**********************************************************
+* Function: tmAtomic_loadDouble()
+*----------------------------------------------------------
+* Relaxed atomic load of a floating point value
+**********************************************************/
+static inline tmDouble tmAtomic_loadDouble(tmDouble *p)
+{
+  tmDouble v;
+#if defined(TM_ATOMIC_GNUC)
+  __atomic_load(p, &v, __ATOMIC_RELAXED);
+#elif defined(TM_ATOMIC_C11)
+  v = atomic_load_explicit((_Atomic tmDouble*) p,
+                           memory_order_relaxed);
+#else
+  pthread_mutex_lock(&tmAtomic_lock);
+  v = *p;
+  pthread_mutex_unlock(&tmAtomic_lock);
+#endif
+  return v;
+}
+
+/**********************************************************
+* Function: tmAtomic_storeDouble()
+*----------------------------------------------------------
+* Relaxed atomic store of a floating point value
+**********************************************************/
+static inline void tmAtomic_storeDouble(tmDouble *p,
+                                        tmDouble v)
+{
+#if defined(TM_ATOMIC_GNUC)
+  __atomic_store(p, &v, __ATOMIC_RELAXED);
+#elif defined(TM_ATOMIC_C11)
+  atomic_store_explicit((_Atomic tmDouble*) p, v,
+                        memory_order_relaxed);
+#else
+  pthread_mutex_lock(&tmAtomic_lock);
+  *p = v;
+  pthread_mutex_unlock(&tmAtomic_lock);
+#endif
+}
+
+/**********************************************************
+* Function: tmAtomic_addLong()
+*----------------------------------------------------------
+* Relaxed atomic increment of a counter
+**********************************************************/
+static inline void tmAtomic_addLong(long *p, long v)
+{
+#if defined(TM_ATOMIC_GNUC)
+  __atomic_fetch_add(p, v, __ATOMIC_RELAXED);
+#elif defined(TM_ATOMIC_C11)
+  atomic_fetch_add_explicit((_Atomic long*) p, v,
+                            memory_order_relaxed);
+#else
+  pthread_mutex_lock(&tmAtomic_lock);
+  *p += v;
+  pthread_mutex_unlock(&tmAtomic_lock);
+#endif
+}
+
+/**********************************************************
+* Function: tmAtomic_loadInt()
+*----------------------------------------------------------
+* Atomic load of a flag with acquire semantics
+**********************************************************/
+static inline int tmAtomic_loadInt(int *p)
+{
+  int v;
+#if defined(TM_ATOMIC_GNUC)
+  v = __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#elif defined(TM_ATOMIC_C11)
+  v = atomic_load_explicit((_Atomic int*) p,
+                           memory_order_acquire);
+#else
+  pthread_mutex_lock(&tmAtomic_lock);
+  v = *p;
+  pthread_mutex_unlock(&tmAtomic_lock);
+#endif
+  return v;
+}
+
+/**********************************************************
+* Function: tmAtomic_storeInt()
+*----------------------------------------------------------
+* Atomic store of a flag with release semantics
+**********************************************************/
+static inline void tmAtomic_storeInt(int *p, int v)
+{
+#if defined(TM_ATOMIC_GNUC)
+  __atomic_store_n(p, v, __ATOMIC_RELEASE);
+#elif defined(TM_ATOMIC_C11)
+  atomic_store_explicit((_Atomic int*) p, v,
+                        memory_order_release);
+#else
+  pthread_mutex_lock(&tmAtomic_lock);
+  *p = v;
+  pthread_mutex_unlock(&tmAtomic_lock);
+#endif
+}
+
+/**********************************************************
+* Function: tmAtomic_fenceRelease()
+*----------------------------------------------------------
+* Orders all prior memory accesses before subsequent
+* stores. The mutex fallback relies on the full barrier
+* of pthread_mutex_lock() / pthread_mutex_unlock().
+**********************************************************/
+static inline void tmAtomic_fenceRelease(void)
+{
+#if defined(TM_ATOMIC_GNUC)
+  __atomic_thread_fence(__ATOMIC_RELEASE);
+#elif defined(TM_ATOMIC_C11)
+  atomic_thread_fence(memory_order_release);
+#else
+  pthread_mutex_lock(&tmAtomic_lock);
+  pthread_mutex_unlock(&tmAtomic_lock);
+#endif
+}
+
+/**********************************************************
+* Function: tmAtomic_fenceAcquire()
+*----------------------------------------------------------
+* Orders prior loads before all subsequent memory accesses
+**********************************************************/
+static inline void tmAtomic_fenceAcquire(void)
+{
+#if defined(TM_ATOMIC_GNUC)
+  __atomic_thread_fence(__ATOMIC_ACQUIRE);
+#elif defined(TM_ATOMIC_C11)
+  atomic_thread_fence(memory_order_acquire);
+#else
+  pthread_mutex_lock(&tmAtomic_lock);
+  pthread_mutex_unlock(&tmAtomic_lock);
+#endif
+}
+
+#endif
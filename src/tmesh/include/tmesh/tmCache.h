@@ -0,0 +1,122 @@
+/*
+ * This header file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef TMESH_TMCACHE_H
+#define TMESH_TMCACHE_H
+
+#include <stdint.h>
+
+#include "tmesh/tmTypedefs.h"
+
+/**********************************************************
+* tmCache: Content-addressed cache of mesh output files.
+*          Entries are stored as <dir>/<key>.tmc, where 
+*          the key is a hash of the meshing input and the
+*          library version. Every entry starts with the
+*          hashed input (its length as uint64_t followed by
+*          the bytes), which is compared on a hit, so that 
+*          colliding keys are never mixed up. 
+*          The modification time of an entry is its last use.
+**********************************************************/
+typedef struct tmCache {
+
+  char     *dir;
+  long      max_bytes;  /* Size limit of all entries      */
+
+  uint64_t  hash;       /* Key of the current entry       */
+  char     *path;       /* Path of the current entry      */
+  char     *tmp_path;   /* Path of a new entry            */
+
+  unsigned char *input; /* Hashed input of the entry      */
+  size_t    n_input;
+  size_t    size_input;
+
+} tmCache;
+
+/**********************************************************
+* Function: tmCache_create()
+*----------------------------------------------------------
+* Create a new tmCache structure for the directory dir, 
+* which is created if it does not exist
+*----------------------------------------------------------
+* @param dir: cache directory
+* @param max_bytes: size limit of all cache entries
+* @return: Pointer to a new tmCache structure or NULL,
+*          if the directory can not be used
+**********************************************************/
+tmCache *tmCache_create(const char *dir, long max_bytes);
+
+/**********************************************************
+* Function: tmCache_destroy()
+*----------------------------------------------------------
+* Removes an unfinished new entry and frees the memory
+* of a tmCache structure
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache to destroy
+**********************************************************/
+void tmCache_destroy(tmCache *cache);
+
+/**********************************************************
+* Function: tmCache_updateKey()
+*----------------------------------------------------------
+* Adds data to the key of the current entry
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache
+* @param data, n: bytes to add
+* @return: FALSE, if the data can not be stored
+**********************************************************/
+tmBool tmCache_updateKey(tmCache *cache, const void *data, size_t n);
+
+/**********************************************************
+* Function: tmCache_key()
+*----------------------------------------------------------
+* Returns the key of the current entry as hex string
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache
+* @param key: returns the key (17 characters)
+**********************************************************/
+void tmCache_key(tmCache *cache, char key[17]);
+
+/**********************************************************
+* Function: tmCache_fetch()
+*----------------------------------------------------------
+* Copies the current entry from the mapped cache file
+* to a file and marks it as used
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache
+* @param path: output file, NULL for the standard output
+* @return: FALSE, if there is no entry for the input or 
+*          the output has failed
+**********************************************************/
+tmBool tmCache_fetch(tmCache *cache, const char *path);
+
+/**********************************************************
+* Function: tmCache_tmpPath()
+*----------------------------------------------------------
+* Returns the path of a temporary file, to which a new
+* entry for the current key is written before 
+* tmCache_store()
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache
+* @return: temporary file path
+**********************************************************/
+const char *tmCache_tmpPath(tmCache *cache);
+
+/**********************************************************
+* Function: tmCache_store()
+*----------------------------------------------------------
+* Moves the temporary file behind the hashed input into 
+* the cache as current entry and removes the least 
+* recently used entries, until all entries fit into the
+* size limit
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache
+* @return: FALSE, if the entry can not be stored
+**********************************************************/
+tmBool tmCache_store(tmCache *cache);
+
+#endif
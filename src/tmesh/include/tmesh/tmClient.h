@@ -0,0 +1,199 @@
+/*
+ * This header file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef TMESH_TMCLIENT_H
+#define TMESH_TMCLIENT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "tmesh/tmTypedefs.h"
+
+/**********************************************************
+* Messages of the TMesh daemon (TMesh --serve) over a
+* Unix domain socket. Every message starts with a header
+* in host byte order:
+*   char     magic[4]   (TM_MSG_REQUEST / TM_MSG_RESPONSE)
+*   uint32   type       (request type / response status)
+*   uint64   length     (number of following bytes)
+* A TM_REQUEST_PARA request contains the content of a
+* parameter file and is answered with the binary mesh
+* (see TM_BIN_MAGIC) or with an error message.
+* A TM_REQUEST_SHM request contains a null terminated
+* shared memory segment name followed by the content of
+* a parameter file. The mesh is exported to the segment
+* (see TM_SHM_MAGIC) and answered with an empty message.
+* A connection may be used for any number of requests.
+**********************************************************/
+#define TM_MSG_REQUEST     "TMRQ"
+#define TM_MSG_RESPONSE    "TMRS"
+#define TM_MSG_HEADER_SIZE ( 16 )
+
+enum { TM_REQUEST_PARA = 1, TM_REQUEST_SHUTDOWN = 2,
+       TM_REQUEST_SHM  = 3 };
+enum { TM_RESPONSE_OK  = 0, TM_RESPONSE_ERROR   = 1 };
+
+/**********************************************************
+* tmClient: Connection to the TMesh daemon
+**********************************************************/
+typedef struct tmClient {
+
+  int fd;
+
+} tmClient;
+
+/**********************************************************
+* tmClientMesh: Binary mesh of the TMesh daemon.
+*               The arrays point into the data of the
+*               message (see TM_BIN_MAGIC).
+**********************************************************/
+typedef struct tmClientMesh {
+
+  unsigned char   *data;
+  size_t           size;
+
+  int              n_nodes;
+  int              n_tris;
+  int              n_bdry;
+
+  const double   (*nodes)[2];
+  const int32_t  (*tris)[3];
+  const int32_t  (*nbrs)[3];      /* -1: no neighbor      */
+  const int32_t  (*bdry_edges)[2];
+  const int32_t   *bdry_markers;
+  const int32_t   *bdry_ids;
+
+} tmClientMesh;
+
+/**********************************************************
+* Function: tmClient_connect()
+*----------------------------------------------------------
+* Connects to the TMesh daemon at a socket path
+*----------------------------------------------------------
+* @param path: path of the daemon's socket
+* @return: Pointer to a new tmClient structure or NULL,
+*          if the daemon can not be reached
+**********************************************************/
+tmClient *tmClient_connect(const char *path);
+
+/**********************************************************
+* Function: tmClient_destroy()
+*----------------------------------------------------------
+* Closes the connection and frees the tmClient memory
+*----------------------------------------------------------
+* @param client: pointer to a tmClient to destroy
+**********************************************************/
+void tmClient_destroy(tmClient *client);
+
+/**********************************************************
+* Function: tmClient_mesh()
+*----------------------------------------------------------
+* Sends the content of a parameter file to the daemon
+* and receives the generated mesh.
+* The mesh must be freed with tmClientMesh_free().
+*----------------------------------------------------------
+* @param client: pointer to a tmClient
+* @param para, len: content of a parameter file
+* @param mesh: returns the mesh
+* @return: FALSE, if the mesh could not be generated
+**********************************************************/
+tmBool tmClient_mesh(tmClient     *client,
+                     const char   *para,
+                     size_t        len,
+                     tmClientMesh *mesh);
+
+/**********************************************************
+* Function: tmClient_meshShm()
+*----------------------------------------------------------
+* Sends the content of a parameter file to the daemon,
+* which exports the generated mesh to the shared memory
+* segment name. The mesh can be mapped with tmShm_map().
+*----------------------------------------------------------
+* @param client: pointer to a tmClient
+* @param para, len: content of a parameter file
+* @param name: shared memory segment name
+* @return: FALSE, if the mesh could not be generated
+**********************************************************/
+tmBool tmClient_meshShm(tmClient   *client,
+                        const char *para,
+                        size_t      len,
+                        const char *name);
+
+/**********************************************************
+* Function: tmClient_shutdown()
+*----------------------------------------------------------
+* Requests the daemon to stop accepting connections, 
+* which is only granted to clients of the daemon's user
+*----------------------------------------------------------
+* @param client: pointer to a tmClient
+* @return: FALSE, if the request has failed or was denied
+**********************************************************/
+tmBool tmClient_shutdown(tmClient *client);
+
+/**********************************************************
+* Function: tmClientMesh_init()
+*----------------------------------------------------------
+* Sets the arrays of a mesh from binary mesh data
+* (see TM_BIN_MAGIC), which is owned by the mesh
+* afterwards. The data must be aligned to 8 bytes.
+* Only little-endian hosts are supported.
+*----------------------------------------------------------
+* @param mesh: mesh to initialize
+* @param data, size: binary mesh data
+* @return: FALSE, if the data is invalid
+**********************************************************/
+tmBool tmClientMesh_init(tmClientMesh *mesh,
+                         void         *data,
+                         size_t        size);
+
+/**********************************************************
+* Function: tmClientMesh_free()
+*----------------------------------------------------------
+* Frees the data of a mesh
+*----------------------------------------------------------
+* @param mesh: pointer to a tmClientMesh
+**********************************************************/
+void tmClientMesh_free(tmClientMesh *mesh);
+
+/**********************************************************
+* Function: tmClient_sendMsg()
+*----------------------------------------------------------
+* Sends a message over a socket
+*----------------------------------------------------------
+* @param fd: socket
+* @param magic: TM_MSG_REQUEST or TM_MSG_RESPONSE
+* @param type: request type or response status
+* @param data, len: message data
+* @return: FALSE, if the message could not be sent
+**********************************************************/
+tmBool tmClient_sendMsg(int         fd,
+                        const char *magic,
+                        uint32_t    type,
+                        const void *data,
+                        uint64_t    len);
+
+/**********************************************************
+* Function: tmClient_recvMsg()
+*----------------------------------------------------------
+* Receives a message from a socket. The data is
+* terminated by an additional null character and must
+* be freed by the caller.
+*----------------------------------------------------------
+* @param fd: socket
+* @param magic: TM_MSG_REQUEST or TM_MSG_RESPONSE
+* @param type: returns the request type or status
+* @param data, len: returns the message data
+* @return: FALSE on errors or if the connection is
+*          closed
+**********************************************************/
+tmBool tmClient_recvMsg(int          fd,
+                        const char  *magic,
+                        uint32_t    *type,
+                        void       **data,
+                        uint64_t    *len);
+
+#endif
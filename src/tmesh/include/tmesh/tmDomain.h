@@ -0,0 +1,278 @@
+/*
+ * This header file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef TMESH_TMDOMAIN_H
+#define TMESH_TMDOMAIN_H
+
+#include "tmesh/tmTypedefs.h"
+
+/**********************************************************
+* tmDomainVert: Vertex of a subdomain boundary loop
+**********************************************************/
+typedef struct tmDomainVert {
+
+  tmNode  *node;    /* Node of the parent mesh             */
+  tmDouble rho;     /* Size function value at the node     */
+
+  /*-------------------------------------------------------
+  | Properties of the segment to the next vertex
+  -------------------------------------------------------*/
+  tmIndex  marker;
+  tmDouble sizeFac;
+
+} tmDomainVert;
+
+/**********************************************************
+* tmDomainLoop: Closed boundary loop of a subdomain
+**********************************************************/
+typedef struct tmDomainLoop {
+
+  tmDomainVert *verts;
+  int           n_verts;
+
+  int           index;       /* Index of parent boundary */
+  tmBool        is_interior;
+
+} tmDomainLoop;
+
+/**********************************************************
+* tmDomain: Subdomain of a mesh, which is bounded by
+*           one exterior loop and any number of interior
+*           loops (holes).
+*           Loop segments, which are located on 
+*           interfaces to other subdomains, are marked 
+*           with TM_DOMAIN_MARKER.
+**********************************************************/
+typedef struct tmDomain {
+
+  /*-------------------------------------------------------
+  | Parent mesh properties
+  -------------------------------------------------------*/
+  tmMesh *mesh;
+
+  /*-------------------------------------------------------
+  | Boundary loops -> loops[0] is the exterior loop
+  -------------------------------------------------------*/
+  tmDomainLoop *loops;
+  int           n_loops;
+
+  tmDouble      area;
+  tmDouble      xy_min[2];
+  tmDouble      xy_max[2];
+
+  /*-------------------------------------------------------
+  | Size function samples (x, y, weight) within this 
+  | domain -> work is the estimated number of elements
+  -------------------------------------------------------*/
+  tmDouble    (*samples)[3];
+  int           n_samples;
+  tmDouble      work;
+
+  /*-------------------------------------------------------
+  | Mesh of this subdomain and its mapping to the
+  | parent mesh
+  -------------------------------------------------------*/
+  tmMesh  *sub;
+  int      n_bdry_nodes;
+  tmNode **node_map;
+  tmTri  **tri_map;
+
+  /*-------------------------------------------------------
+  | Images of other domains: the mesh of the source 
+  | domain is mapped by xy -> trafo * (xy, 1)
+  -------------------------------------------------------*/
+  struct tmDomain *source;
+  tmDouble         trafo[2][3];
+
+} tmDomain;
+
+
+/**********************************************************
+* Function: tmDomain_create()
+*----------------------------------------------------------
+* Create a new tmDomain structure from the boundaries
+* of a mesh. The mesh must be defined by exactly one
+* exterior boundary loop. The boundary size functions
+* of the mesh must be initialized.
+* The size function is sampled at about n_samples 
+* locations in order to estimate the number of elements
+* of the domain and its subdomains.
+*----------------------------------------------------------
+* @param *mesh: pointer to parent mesh
+* @param n_samples: number of size function samples
+* @return: Pointer to a new tmDomain structure or NULL,
+*          if the boundaries are not supported
+**********************************************************/
+tmDomain *tmDomain_create(tmMesh *mesh, int n_samples);
+
+/**********************************************************
+* Function: tmDomain_destroy()
+*----------------------------------------------------------
+* Destroys a tmDomain structure, its subdomain mesh
+* and frees all its memory.
+*----------------------------------------------------------
+* @param *dom: pointer to a tmDomain to destroy
+**********************************************************/
+void tmDomain_destroy(tmDomain *dom);
+
+/**********************************************************
+* Function: tmDomain_split()
+*----------------------------------------------------------
+* Splits a domain along a straight axis-aligned cut
+* into subdomains with a similar estimated number
+* of elements. 
+* Nodes on the cut are distributed according to the 
+* size function of the parent mesh and are shared by 
+* the subdomains on both sides.
+* Usually, two subdomains are created, but depending on
+* the domain shape, the cut may result in more.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain to split
+* @return: list of subdomains or NULL, if no suitable
+*          cut has been found
+**********************************************************/
+tmList *tmDomain_split(tmDomain *dom);
+
+/**********************************************************
+* Function: tmDomain_clip()
+*----------------------------------------------------------
+* Clips a domain to the half plane n*xy >= c.
+* Nodes on the clipping line are distributed according
+* to the size function of the parent mesh. Loop vertices
+* on the line are kept as nodes of the line, such that
+* the mirror image of the clipped domain matches it 
+* along the line, unless the line is bent.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain to clip
+* @param n: unit normal of the clipping line
+* @param c: location of the clipping line
+* @param bend: TRUE -> crossings of the line with loop 
+*              segments, which are located close to a 
+*              loop vertex, are moved onto the vertex
+* @param pin: location on the line, which becomes a node
+*             of the line, or NULL
+* @param pin_sym: TRUE -> the nodes on the line are 
+*                 point symmetric to the pin
+* @param ref: prescribed locations (x, y, size) of the 
+*             nodes on the line or NULL
+* @param n_ref: number of prescribed locations
+* @return: list of subdomains (empty, if the domain is 
+*          located outside of the half plane) or NULL, 
+*          if the line can not be used as cut
+**********************************************************/
+tmList *tmDomain_clip(tmDomain       *dom, 
+                      const tmDouble  n[2], 
+                      tmDouble        c,
+                      tmBool          bend,
+                      const tmDouble *pin,
+                      tmBool          pin_sym,
+                      const tmDouble (*ref)[3],
+                      int             n_ref);
+
+/**********************************************************
+* Function: tmDomain_isInvariant()
+*----------------------------------------------------------
+* Checks if the boundary loops of a domain are mapped 
+* onto themselves by an isometry, i.e. if every loop 
+* segment is mapped onto a loop segment with the same
+* boundary marker.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+* @param trafo: isometry xy -> trafo * (xy, 1)
+* @return: TRUE, if the loops are invariant
+**********************************************************/
+tmBool tmDomain_isInvariant(tmDomain       *dom,
+                            const tmDouble  trafo[2][3]);
+
+/**********************************************************
+* Function: tmDomain_createImage()
+*----------------------------------------------------------
+* Creates the image of a domain under an isometry.
+* The image has no loops and no mesh of its own, but 
+* merges the mesh of its source domain, mapped by the 
+* isometry, into the parent mesh. 
+*----------------------------------------------------------
+* @param *dom: pointer to the source domain
+* @param trafo: isometry xy -> trafo * (xy, 1)
+* @return: pointer to the new image domain
+**********************************************************/
+tmDomain *tmDomain_createImage(tmDomain       *dom,
+                               const tmDouble  trafo[2][3]);
+
+/**********************************************************
+* Function: tmDomain_matchSides()
+*----------------------------------------------------------
+* Distributes nodes on the sides of a rectangular 
+* domain, such that opposite sides have the same nodes
+* up to a translation by the domain width / height.
+* The nodes suit the size function on both sides.
+* Hence, translated copies of the domain share their
+* nodes on common sides (periodic cells).
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+* @return: FALSE, if the exterior loop is not an 
+*          axis-aligned rectangle
+**********************************************************/
+tmBool tmDomain_matchSides(tmDomain *dom);
+
+/**********************************************************
+* Function: tmDomain_createMesh()
+*----------------------------------------------------------
+* Creates the mesh of a subdomain with boundaries
+* according to the subdomain loops.
+* The mesh evaluates the size function of its parent.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+* @return: pointer to the subdomain mesh
+**********************************************************/
+tmMesh *tmDomain_createMesh(tmDomain *dom);
+
+/**********************************************************
+* Function: tmDomain_mergeTris()
+*----------------------------------------------------------
+* Copies the nodes and triangles of a meshed subdomain
+* to its parent mesh. Boundary nodes of the subdomain
+* are mapped onto the existing parent nodes.
+* Images copy the mesh of their source domain, where 
+* the boundary nodes are mapped onto the parent nodes
+* at their image locations or created, if there are none.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+**********************************************************/
+void tmDomain_mergeTris(tmDomain *dom);
+
+/**********************************************************
+* Function: tmDomain_mergeEdges()
+*----------------------------------------------------------
+* Copies the edges of a meshed subdomain to its parent
+* mesh. Edges on subdomain interfaces and boundary 
+* edges, which are shared with another subdomain, are 
+* created only once and are connected to the triangles
+* on both sides. This requires, that all subdomains have
+* been merged with tmDomain_mergeTris() before.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+* @return: FALSE, if an interface edge does not match
+**********************************************************/
+tmBool tmDomain_mergeEdges(tmDomain *dom);
+
+/**********************************************************
+* Function: tmDomain_mergeBdrys()
+*----------------------------------------------------------
+* Copies the boundary loops of a meshed domain or image
+* to its parent mesh. Every interior loop becomes a new
+* interior boundary. Exterior loop segments are added to
+* the boundary ext, unless they are shared with another
+* subdomain. This requires, that all subdomains have been
+* merged with tmDomain_mergeEdges() before.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+* @param *ext: exterior boundary of the parent mesh
+**********************************************************/
+void tmDomain_mergeBdrys(tmDomain *dom, tmBdry *ext);
+
+#endif
@@ -35,7 +35,7 @@ typedef struct tmEdge {
   tmBool    is_on_front;
   tmBool    is_on_bdry;
   tmBool    is_on_mesh;
-  tmBool    is_local_delaunay;
+  tmBool    is_local_delaunay; /* FALSE -> on delaunay stack */
 
   tmListNode *stack_pos;
   tmListNode *qtree_pos;
@@ -51,6 +51,12 @@ typedef struct tmEdge {
   -------------------------------------------------------*/
   tmDouble sizeFac;
 
+  /*-------------------------------------------------------
+  | Cached value of the size function at the centroid 
+  | -> 0.0, if it has not been evaluated yet
+  -------------------------------------------------------*/
+  tmDouble size;
+
   /*-------------------------------------------------------
   | Vector tangential to edge
   -------------------------------------------------------*/
@@ -121,6 +127,22 @@ tmEdge *tmEdge_create(tmMesh  *mesh,
 **********************************************************/
 void tmEdge_destroy(tmEdge *edge);
 
+/**********************************************************
+* Function: tmEdge_setNodes()
+*----------------------------------------------------------
+* Redefines the nodes of an existing mesh edge in place.
+* The edge lists of the nodes are updated and the edge 
+* geometry is recomputed.
+* The edge's location in the mesh qtree is not updated
+* -> this is left to the caller (see tmQtree_updateObj()).
+* This function can also be used to update an edge, 
+* whose node coordinates have been moved.
+*----------------------------------------------------------
+* @param edge: pointer to mesh edge
+* @param n1,n2: new start and ending nodes of the edge
+**********************************************************/
+void tmEdge_setNodes(tmEdge *edge, tmNode *n1, tmNode *n2);
+
 /**********************************************************
 * Function: tmEdge_isLeft()
 *----------------------------------------------------------
@@ -201,8 +223,8 @@ tmNode *tmEdge_createNode(tmEdge *edge);
 * Function: tmEdge_isLocalDelaunay()
 *----------------------------------------------------------
 * Check if an edge is locally delaunay
-* If yes, put edge on the non-delaunay edge stack of the
-* mesh
+* If not, put edge on the non-delaunay edge stack of the
+* mesh, unless it is already located there
 *----------------------------------------------------------
 * @param edge: pointer to edge
 * 
@@ -210,10 +232,31 @@ tmNode *tmEdge_createNode(tmEdge *edge);
 void tmEdge_isDelaunay(tmEdge *edge);
 
 /**********************************************************
-* Function: tmEdge_flipEdge()
+* Function: tmEdge_setTriNbrs()
 *----------------------------------------------------------
-* Perform an edge flip, in order to get a new edge
-* which satisfies the delaunay constraint.
+* Sets the neighbors of a triangle from the mesh edges
+* it is adjacent to and updates the neighbor references 
+* of the adjacent triangles accordingly. 
+* Triangle sides without neighbor refer to the triangle
+* itself (as done by tmMesh_setTriNeighbors()).
+*----------------------------------------------------------
+* @param tri: pointer to triangle
+**********************************************************/
+void tmEdge_setTriNbrs(tmTri *tri);
+
+/**********************************************************
+* Function: tmEdge_swapEdge()
+*----------------------------------------------------------
+* Swaps an edge to the other diagonal of the quadrilateral
+* formed by its two adjacent triangles.
+* The swap is done in place: The edge and both adjacent 
+* triangles keep their memory and are only rewired.
+* Only the nodes, edges and triangles of the quadrilateral
+* and the neighbor pointers of the triangles adjacent to 
+* it are modified. The mesh area, the mesh qtrees and the 
+* delaunay stack are left untouched (see 
+* tmEdge_finishFlip()). Hence, edges whose quadrilaterals
+* do not share any node can be swapped concurrently.
 * Definition:
 *
 *                    n2
@@ -244,9 +287,85 @@ void tmEdge_isDelaunay(tmEdge *edge);
 *            
 *----------------------------------------------------------
 * @param edge: pointer to edge to flip
-* @return : pointer to new edge
+* @return : pointer to the swapped edge
+* 
+**********************************************************/
+tmEdge *tmEdge_swapEdge(tmEdge *e);
+
+/**********************************************************
+* Function: tmEdge_finishFlip()
+*----------------------------------------------------------
+* Completes the flip of an edge, which has been swapped
+* with tmEdge_swapEdge(): 
+* The mesh area and the locations of the edge and its 
+* adjacent triangles in the mesh qtrees are updated.
+* Then all edges of the new triangles are checked for the 
+* delaunay property and put on the delaunay stack if 
+* necessary.
+*----------------------------------------------------------
+* @param e: pointer to swapped edge
+* @param area_old: area of both triangles before the swap
+* 
+**********************************************************/
+void tmEdge_finishFlip(tmEdge *e, tmDouble area_old);
+
+/**********************************************************
+* Function: tmEdge_flipEdge()
+*----------------------------------------------------------
+* Perform an edge flip, in order to get a new edge
+* which satisfies the delaunay constraint.
+* The flip is done in place (see tmEdge_swapEdge()).
+*----------------------------------------------------------
+* @param edge: pointer to edge to flip
+* @return : pointer to the flipped edge
 * 
 **********************************************************/
 tmEdge *tmEdge_flipEdge(tmEdge *e);
 
+/**********************************************************
+* Function: tmEdge_getSize()
+*----------------------------------------------------------
+* Returns the value of the size function at the edge 
+* centroid. The value is evaluated once and cached on 
+* the edge, until one of its nodes is moved or the size 
+* function changes (see tmMesh_resetSizes()).
+* The function may be called concurrently.
+*----------------------------------------------------------
+* @param edge: pointer to edge
+* @return: size function value at the edge centroid
+**********************************************************/
+tmDouble tmEdge_getSize(tmEdge *edge);
+
+/**********************************************************
+* Function: tmEdge_subdivide()
+*----------------------------------------------------------
+* Computes the new nodes of n edges, which are subdivided
+* according to the size function of the mesh. 
+* The inverse element size 1 / (2 * fac * rho) is 
+* integrated along every edge and the edge is split into 
+* as many segments as the integral indicates, where all 
+* segments cover an equal part of the integral. 
+* The size function is first evaluated on 
+* TM_SUBDIV_SAMPLES points per edge and then on 
+* TM_SUBDIV_SAMPLES points per segment for all edges at 
+* once (see tmMesh_sizeFunBatch()).
+*----------------------------------------------------------
+* @param mesh: mesh of the edges
+* @param edges: edges to subdivide
+* @param n: number of edges
+* @param fac: refinement factor of the edges
+* @param off: returns the offsets of the new nodes of 
+*             edge i in xy_new, off[i] ... off[i+1]-1
+*             (size n+1)
+* @param xy_new: returns the coordinates of all new nodes,
+*                which must be freed by the caller
+* @return: FALSE on errors
+**********************************************************/
+tmBool tmEdge_subdivide(tmMesh    *mesh, 
+                        tmEdge   **edges, 
+                        int        n, 
+                        tmDouble   fac,
+                        int       *off,
+                        tmDouble (**xy_new)[2]);
+
 #endif
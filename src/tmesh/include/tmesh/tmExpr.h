@@ -0,0 +1,113 @@
+/*
+ * This header file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef TMESH_TMEXPR_H
+#define TMESH_TMEXPR_H
+
+#include "tmesh/tmTypedefs.h"
+
+/**********************************************************
+* Operations of a compiled expression
+**********************************************************/
+enum { TM_EXPR_ADD, TM_EXPR_SUB, TM_EXPR_MUL, TM_EXPR_DIV,
+       TM_EXPR_NEG, TM_EXPR_CALL1, TM_EXPR_CALL2 };
+
+typedef tmDouble (*tmExprFun1)(tmDouble);
+typedef tmDouble (*tmExprFun2)(tmDouble, tmDouble);
+
+/**********************************************************
+* tmExprInstr: Instruction of a compiled expression,
+*              which computes r[dst] = op(r[a], r[b])
+**********************************************************/
+typedef struct tmExprInstr {
+
+  int         op;
+  int         dst;
+  int         a;
+  int         b;
+
+  union {
+    tmExprFun1 fun1;  /* Function for TM_EXPR_CALL1      */
+    tmExprFun2 fun2;  /* Function for TM_EXPR_CALL2      */
+  };
+
+} tmExprInstr;
+
+/**********************************************************
+* tmExpr: Expression f(x,y), which is compiled to a flat
+*         register bytecode. The registers are:
+*         r[0] = x, r[1] = y,
+*         r[2 ... 2+n_consts-1] = constants,
+*         followed by temporary registers.
+**********************************************************/
+typedef struct tmExpr {
+
+  tmExprInstr *code;
+  int          n_code;
+
+  tmDouble    *consts;
+  int          n_consts;
+
+  int          n_regs;  /* Total number of registers      */
+  int          result;  /* Register of the result         */
+
+} tmExpr;
+
+/**********************************************************
+* Function: tmExpr_compile()
+*----------------------------------------------------------
+* Parses an expression of the variables x and y with
+* tinyexpr, which folds all constant subexpressions, and
+* lowers the syntax tree to a register bytecode
+*----------------------------------------------------------
+* @param str: expression string
+* @param error: returns 0 on success, otherwise the
+*               position of the error in str
+* @return: Pointer to a new tmExpr structure or NULL
+**********************************************************/
+tmExpr *tmExpr_compile(const char *str, int *error);
+
+/**********************************************************
+* Function: tmExpr_destroy()
+*----------------------------------------------------------
+* Frees the memory of a tmExpr structure
+*----------------------------------------------------------
+* @param expr: pointer to a tmExpr to destroy
+**********************************************************/
+void tmExpr_destroy(tmExpr *expr);
+
+/**********************************************************
+* Function: tmExpr_eval()
+*----------------------------------------------------------
+* Evaluates an expression at a point.
+* The result equals the one of te_eval() and the
+* function may be called concurrently.
+*----------------------------------------------------------
+* @param expr: pointer to a tmExpr
+* @param xy: point coordinates
+* @return: expression value
+**********************************************************/
+tmDouble tmExpr_eval(const tmExpr *expr, const tmDouble xy[2]);
+
+/**********************************************************
+* Function: tmExpr_evalBatch()
+*----------------------------------------------------------
+* Evaluates an expression at n points, where every
+* instruction is applied to TM_EXPR_BATCH_SIZE points
+* at once
+*----------------------------------------------------------
+* @param expr: pointer to a tmExpr
+* @param n: number of points
+* @param xy: point coordinates
+* @param out: returns the n expression values
+* @return: FALSE on memory errors
+**********************************************************/
+tmBool tmExpr_evalBatch(const tmExpr *expr, int n,
+                        const tmDouble (*xy)[2],
+                        tmDouble *out);
+
+#endif
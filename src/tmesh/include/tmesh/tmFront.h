@@ -34,6 +34,32 @@ typedef struct tmFront {
 
 } tmFront;
 
+/**********************************************************
+* tmFrontCand: Advancement of a front edge, which has 
+*              been evaluated without modifying the mesh
+**********************************************************/
+typedef struct tmFrontCand {
+
+  tmEdge  *edge;       /* Front edge to advance             */
+  tmBool   is_valid;   /* TRUE, if a valid triangle exists  */
+
+  /*-------------------------------------------------------
+  | Third node of the new triangle -> an existing node
+  | or a new node at xy, if node is NULL
+  -------------------------------------------------------*/
+  tmNode  *node;
+  tmDouble xy[2];
+  tmDouble size;       /* Size function value at xy         */
+
+  /*-------------------------------------------------------
+  | Bounding box of the mesh region, on which the 
+  | validity of the new triangle depends
+  -------------------------------------------------------*/
+  tmDouble xy_min[2];
+  tmDouble xy_max[2];
+
+} tmFrontCand;
+
 
 /**********************************************************
 * Function: tmFront_create()
@@ -95,6 +121,17 @@ tmListNode *tmFront_addEdge(tmFront *front, tmEdge *edge);
 **********************************************************/
 void tmFront_remEdge(tmFront *front, tmEdge *edge);
 
+/**********************************************************
+* Function: tmFront_postponeEdge()
+*----------------------------------------------------------
+* Moves an edge to the end of the front edge stack, such
+* that it is advanced after all other current front edges
+*----------------------------------------------------------
+* @param front: advancing front structure
+* @param edge: front edge to move
+**********************************************************/
+void tmFront_postponeEdge(tmFront *front, tmEdge *edge);
+
 /**********************************************************
 * Function: tmFront_init()
 *----------------------------------------------------------
@@ -119,7 +156,10 @@ void tmFront_sortEdges(tmMesh *mesh);
 * Function: tmFront_advance()
 *----------------------------------------------------------
 * Function to advance the front edges 
-* by one step
+* by one step.
+* If the first mesh->adv_n_serial neighbor nodes fail,
+* the remaining nodes are checked in batches on the 
+* thread pool of the mesh.
 *----------------------------------------------------------
 * @parameter mesh:  pointer to mesh structure
 * @parameter eStart: pointer to advancing front edge
@@ -129,6 +169,53 @@ void tmFront_sortEdges(tmMesh *mesh);
 **********************************************************/
 tmBool tmFront_advance(tmMesh *mesh, tmEdge *e_ad);
 
+/**********************************************************
+* Function: tmFront_evalAdvance()
+*----------------------------------------------------------
+* Evaluates the advancement of a front edge in the same 
+* way as tmFront_advance(), but without modifying the 
+* mesh. Hence, several front edges can be evaluated 
+* concurrently, as long as no objects are added to or 
+* removed from the mesh at the same time.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param cand: candidate with the front edge to advance
+* @return: TRUE, if a valid triangle has been found
+**********************************************************/
+tmBool tmFront_evalAdvance(tmMesh *mesh, tmFrontCand *cand);
+
+/**********************************************************
+* Function: tmFront_commitAdvance()
+*----------------------------------------------------------
+* Creates the triangle of a valid candidate, which has 
+* been evaluated with tmFront_evalAdvance(), and 
+* updates the advancing front.
+* The caller must ensure, that the mesh has not been 
+* modified within the region of the candidate since 
+* its evaluation.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param cand: valid candidate
+* @return: the new triangle
+**********************************************************/
+tmTri *tmFront_commitAdvance(tmMesh *mesh, tmFrontCand *cand);
+
+/**********************************************************
+* Function: tmFront_closeLoop()
+*----------------------------------------------------------
+* Closes the first front loop, which consists of three 
+* edges and whose triangle is valid (see tmTri_isValid()).
+* This is used as last resort, if no front edge can be 
+* advanced anymore. The triangle must pass the same 
+* angle and quality limits as an advancement, hence 
+* the result does not depend on the advancement order
+* of the serial, speculative or parallel meshing.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: TRUE, if a front loop has been closed
+**********************************************************/
+tmBool tmFront_closeLoop(tmMesh *mesh);
+
 /**********************************************************
 * Function: tmFront_update()
 *----------------------------------------------------------
@@ -49,8 +49,22 @@ typedef struct tmMesh {
   /*-------------------------------------------------------
   | Mesh size function
   -------------------------------------------------------*/
-  tmSizeFun     sizeFun;
-  tmSizeFunUser sizeFunUser;
+  tmSizeFun          sizeFun;
+  tmSizeFunUser      sizeFunUser;
+  tmSizeFunUserCtx   sizeFunUserCtx;
+  tmSizeFunBatch     sizeFunBatch;
+  tmSizeFunUserBatch sizeFunUserBatch;
+  void              *sizeFunCtx; /* Context of the user-
+                                    defined size functions */
+  long               n_size_saved; /* Evaluations, which 
+                                      are saved by the cached
+                                      node and edge sizes  */
+  tmDouble           period[2];    /* Cell size, if the 
+                                      size function is 
+                                      periodic             */
+  int                n_period[2];  /* Number of periodic 
+                                      cells and origin of  */
+  tmDouble           period_min[2];/* their lattice        */
 
   /*-------------------------------------------------------
   | Mesh edges
@@ -73,6 +87,52 @@ typedef struct tmMesh {
   tmQtree *tris_qtree;
   int      no_tris_delaunay;
 
+  /*-------------------------------------------------------
+  | Thread pool for parallel mesh operations
+  -------------------------------------------------------*/
+  int      n_threads;
+  tmPool  *pool;
+
+  /*-------------------------------------------------------
+  | Front edge advancement: Number of neighbor nodes, 
+  | that are checked serially, before the remaining nodes
+  | are checked in batches of adv_n_cands on the pool
+  -------------------------------------------------------*/
+  int      adv_n_serial;
+  int      adv_n_cands;
+
+  /*-------------------------------------------------------
+  | Method to subdivide the boundary edges according to 
+  | the size function
+  -------------------------------------------------------*/
+  int      subdivision;
+
+  /*-------------------------------------------------------
+  | Sink, which receives the final nodes and triangles 
+  | during the meshing
+  -------------------------------------------------------*/
+  tmSinkNodeFun sink_node;
+  tmSinkTriFun  sink_tri;
+  void         *sink_ctx;
+  int           sink_n_nodes;
+  int           sink_n_tris;
+
+  /*-------------------------------------------------------
+  | New objects are not added to the qtrees, while the 
+  | mesh is loaded -> the qtrees are bulk-loaded afterwards
+  -------------------------------------------------------*/
+  tmBool   qtree_defer;
+
+  /*-------------------------------------------------------
+  | Print the progress of the meshing
+  -------------------------------------------------------*/
+  tmBool   verbose;
+
+  /*-------------------------------------------------------
+  | Parent mesh, if this is the mesh of a subdomain
+  -------------------------------------------------------*/
+  tmMesh  *parent;
+
 } tmMesh;
 
 
@@ -101,6 +161,129 @@ tmMesh *tmMesh_create(tmDouble      xy_min[2],
 **********************************************************/
 void tmMesh_destroy(tmMesh *mesh);
 
+/**********************************************************
+* Function: tmMesh_setThreads()
+*----------------------------------------------------------
+* Sets the number of threads, that are used for parallel
+* mesh operations (e.g. the delaunay edge flips). 
+* A thread pool is created for n_threads > 1.
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param n_threads: number of threads
+**********************************************************/
+void tmMesh_setThreads(tmMesh *mesh, int n_threads);
+
+/**********************************************************
+* Function: tmMesh_setAdvanceCands()
+*----------------------------------------------------------
+* Sets the parameters for the parallel check of the 
+* neighbor nodes during the advancement of a front edge.
+* After n_serial nodes have been checked without success,
+* the remaining nodes are checked in batches of n_cands 
+* nodes on the thread pool of the mesh. 
+* The resulting mesh does not depend on these parameters.
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param n_cands: nodes per batch (1 disables batches)
+* @param n_serial: nodes, that are checked serially
+**********************************************************/
+void tmMesh_setAdvanceCands(tmMesh *mesh, int n_cands, int n_serial);
+
+/**********************************************************
+* Boundary edge subdivision methods
+**********************************************************/
+#define TM_SUBDIVIDE_BISECT   0
+#define TM_SUBDIVIDE_INTEGRAL 1
+
+/**********************************************************
+* Function: tmMesh_setSubdivision()
+*----------------------------------------------------------
+* Sets the method, which subdivides the boundary edges 
+* according to the size function before the meshing.
+* TM_SUBDIVIDE_BISECT halves every edge until it is 
+* shorter than the element size at its ends (default).
+* TM_SUBDIVIDE_INTEGRAL integrates the size function 
+* along every edge and places all new nodes at once
+* (see tmEdge_subdivide()), which gives a smoother size 
+* grading along the boundaries. Edges, which are still
+* too long for the refined boundaries, are then halved.
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param method: TM_SUBDIVIDE_BISECT or 
+*                TM_SUBDIVIDE_INTEGRAL
+**********************************************************/
+void tmMesh_setSubdivision(tmMesh *mesh, int method);
+
+/**********************************************************
+* Function: tmMesh_setVerbose()
+*----------------------------------------------------------
+* Enables or disables the progress output of the 
+* meshing functions (enabled by default)
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param verbose: TRUE to print the progress
+**********************************************************/
+void tmMesh_setVerbose(tmMesh *mesh, tmBool verbose);
+
+/**********************************************************
+* Function: tmMesh_setSizeFunCtx()
+*----------------------------------------------------------
+* Sets a user-defined size function, which receives a 
+* context pointer. It replaces the size function of 
+* tmMesh_create(), such that the size function does not
+* depend on global state and several meshes with 
+* different size functions can be created concurrently.
+* The context is also passed to the function of 
+* tmMesh_setSizeFunBatch().
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param sizeFunUserCtx: user-defined size function 
+*                        (may be NULL)
+* @param ctx: context, which is passed to the functions
+**********************************************************/
+void tmMesh_setSizeFunCtx(tmMesh           *mesh, 
+                          tmSizeFunUserCtx  sizeFunUserCtx,
+                          void             *ctx);
+
+/**********************************************************
+* Function: tmMesh_setSizeFunBatch()
+*----------------------------------------------------------
+* Sets a user-defined size function, which evaluates 
+* many points at once. It must return the same values 
+* as the size function of tmMesh_create() or 
+* tmMesh_setSizeFunCtx() and is used, when the mesh 
+* evaluates the size function for several points 
+* (see tmMesh_sizeFunBatch()).
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param sizeFunUserBatch: user-defined size function for
+*                          n points (may be NULL)
+**********************************************************/
+void tmMesh_setSizeFunBatch(tmMesh             *mesh, 
+                            tmSizeFunUserBatch  sizeFunUserBatch);
+
+/**********************************************************
+* Function: tmMesh_orderNodes()
+*----------------------------------------------------------
+* Sorts the mesh node list in the given order and sets 
+* the node indices accordingly
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param **nodes: all mesh nodes in their new order
+**********************************************************/
+void tmMesh_orderNodes(tmMesh *mesh, tmNode **nodes);
+
+/**********************************************************
+* Function: tmMesh_orderTris()
+*----------------------------------------------------------
+* Sorts the mesh triangle list in the given order and 
+* sets the triangle indices accordingly
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param **tris: all mesh triangles in their new order
+**********************************************************/
+void tmMesh_orderTris(tmMesh *mesh, tmTri **tris);
+
 /**********************************************************
 * Function: tmMesh_addNode()
 *----------------------------------------------------------
@@ -202,45 +385,156 @@ void tmMesh_remBdry(tmMesh *mesh, tmBdry *bdry);
 tmBool tmMesh_objInside(tmMesh   *mesh, tmDouble xy[2]);
 
 /**********************************************************
-* Function: tmMesh_printMesh()
+* Function: tmMesh_adfMeshing()
 *----------------------------------------------------------
-* Fuction to print out the mesh data
+* Function to perform the advancing front loop 
+* until either no edges are available anymore or until 
+* a final iteration is reached
 *----------------------------------------------------------
-* @param mesh: pointer to mesh structure
+* 
 **********************************************************/
-void tmMesh_printMesh(tmMesh *mesh);
+void tmMesh_ADFMeshing(tmMesh *mesh);
 
 /**********************************************************
-* Function: tmMesh_printMeshIncomflow()
-*----------------------------------------------------------
-* Fuction to print out the mesh data in the format for
-* the incomflow solver
-*----------------------------------------------------------
-* @param mesh: pointer to mesh structure
+* Function: tmMesh_ADFMeshingParallel()
+*----------------------------------------------------------
+* Splits the mesh domain along straight cuts into 
+* n_domains subdomains with a similar estimated number 
+* of elements (see tmDomain.h)
+* and meshes every subdomain as an independent tmMesh 
+* with the advancing front method. The subdomains are 
+* distributed onto the threads of the mesh and their 
+* meshes are finally merged into the mesh. 
+* Interface edges are treated as interior edges.
+* Falls back to tmMesh_ADFMeshing(), if the domain can 
+* not be split.
+*----------------------------------------------------------
+* @param *mesh: pointer to mesh
+* @param n_domains: number of subdomains
 **********************************************************/
-void tmMesh_printMeshIncomflow(tmMesh *mesh);
+void tmMesh_ADFMeshingParallel(tmMesh *mesh, int n_domains);
 
 /**********************************************************
-* Function: tmMesh_adfMeshing()
-*----------------------------------------------------------
-* Function to perform the advancing front loop 
-* until either no edges are available anymore or until 
-* a final iteration is reached
+* Mesh symmetries
+**********************************************************/
+#define TM_SYMMETRY_MIRROR   1
+#define TM_SYMMETRY_ROTATION 2
+
+/**********************************************************
+* Function: tmMesh_ADFMeshingSymmetric()
+*----------------------------------------------------------
+* Meshes a symmetric domain by meshing only its 
+* fundamental sector with the advancing front method
+* and copying the sector mesh onto the other sectors.
+* TM_SYMMETRY_MIRROR: the domain is symmetric to the 
+*   line through xy with the given angle and the sector
+*   is located to the left of the line.
+* TM_SYMMETRY_ROTATION: the domain is invariant under 
+*   rotations by 2*pi/n about xy and the sector starts
+*   at the given angle.
+* The nodes on the sector sides are distributed, such
+* that they are mapped onto each other by the symmetry.
+* Hence, the sector meshes share their nodes on the 
+* sides and the whole mesh is exactly symmetric.
+* Sector components are meshed in parallel. 
+* Falls back to tmMesh_ADFMeshing(), if the boundaries 
+* are not symmetric or the sector can not be created.
+*----------------------------------------------------------
+* @param *mesh: pointer to mesh
+* @param type: TM_SYMMETRY_MIRROR or TM_SYMMETRY_ROTATION
+* @param xy: location on the symmetry line / center of 
+*            the rotation
+* @param angle: angle of the symmetry line / start angle
+*               of the sector in radians
+* @param n: number of sectors of rotational symmetries
+**********************************************************/
+void tmMesh_ADFMeshingSymmetric(tmMesh   *mesh, 
+                                int       type,
+                                tmDouble  xy[2],
+                                tmDouble  angle,
+                                int       n);
+
+/**********************************************************
+* Function: tmMesh_ADFMeshingPeriodic()
+*----------------------------------------------------------
+* Meshes a domain, which consists of n_x * n_y copies of
+* a periodic cell. The cell is defined by the boundaries
+* of the mesh, where the exterior boundary must be an 
+* axis-aligned rectangle of width w and height h.
+* Only the cell is meshed with the advancing front 
+* method, where opposite cell sides get the same nodes.
+* The cell mesh is then copied onto the lattice 
+* (i*w, j*h) with 0 <= i < n_x and 0 <= j < n_y, such 
+* that neighboring copies share their nodes on common 
+* sides. Finally, the mesh boundaries are replaced by
+* the boundaries of the lattice. 
+* The mesh bounding box must contain the whole lattice.
+* The size function of the cell is the minimum of the
+* size function over the cell and its eight neighbors,
+* where it is only evaluated within the lattice and 
+* grows with TM_SIZEFUN_SLOPE outside of it.
+* Falls back to tmMesh_ADFMeshing(), if the cell is not
+* a rectangle.
+*----------------------------------------------------------
+* @param *mesh: pointer to mesh
+* @param n_x, n_y: number of cells in x- / y-direction
+**********************************************************/
+void tmMesh_ADFMeshingPeriodic(tmMesh *mesh, int n_x, int n_y);
+
+/**********************************************************
+* Function: tmMesh_ADFMeshingSpeculative()
+*----------------------------------------------------------
+* Advancing front meshing, where front edges from 
+* separated regions are advanced concurrently:
+* In every step, a batch of front edges is evaluated in 
+* parallel without modifying the mesh. Afterwards, the 
+* new triangles are created in the order of the batch.
+* If a triangle has been created within the region of 
+* a candidate in the same step, the candidate may be 
+* outdated and its front edge is evaluated again later.
+* Front edges, which can not be advanced, are moved to 
+* the end of the front edge stack. If no edge of a batch can be advanced, all front edges
+* are tried in serial as in tmMesh_ADFMeshing().
+* Falls back to tmMesh_ADFMeshing() for a single thread.
 *----------------------------------------------------------
-* 
+* @param mesh: pointer to mesh structure
 **********************************************************/
-void tmMesh_ADFMeshing(tmMesh *mesh);
+void tmMesh_ADFMeshingSpeculative(tmMesh *mesh);
 
 /**********************************************************
 * Function: tmMesh_delaunayFlip()
 *----------------------------------------------------------
 * Function to perform the flip algorithm on a triangulated
 * mesh, in order to obtain a triangulation that is delaunay
+* For mesh->n_threads > 1, independent sets of edges are
+* flipped in parallel.
 *----------------------------------------------------------
 * 
 **********************************************************/
 void tmMesh_delaunayFlip(tmMesh *mesh);
 
+/**********************************************************
+* Function: tmMesh_smooth()
+*----------------------------------------------------------
+* Optimizes the mesh quality by smoothing the locations
+* of all interior nodes, i.e. all nodes, which are not 
+* located on a boundary and whose triangles close a 
+* ring around them. 
+* Every iteration is a Jacobi sweep, which computes all 
+* new node locations from the previous ones in parallel
+* (see tmMesh_smoothNodes()). Node moves that would 
+* invert or collapse triangles are rejected.
+* All coordinates are kept in compact arrays during the 
+* sweeps, the mesh structures and qtrees are only 
+* updated once at the end. Afterwards, edges which are 
+* no longer delaunay are put on the delaunay stack, 
+* such that tmMesh_delaunayFlip() can be applied.
+*----------------------------------------------------------
+* @param mesh: the mesh structure
+* @param n_iter: number of smoothing sweeps
+**********************************************************/
+void tmMesh_smooth(tmMesh *mesh, int n_iter);
+
 /**********************************************************
 * Function: tmMesh_setTriNeighbors()
 *----------------------------------------------------------
@@ -281,6 +575,10 @@ tmTri* tmMesh_getTriFromCoords(tmMesh *mesh, tmDouble xy[2]);
 *----------------------------------------------------------
 * Add a new node at a specified location in the mesh
 * and subsequently re-triangulate the mesh in this area.
+* The triangle, which contains the node, is split into 
+* three triangles and the Delaunay property is restored 
+* with edge flips. Nodes on existing edges are not 
+* inserted.
 *----------------------------------------------------------
 * @param mesh: the mesh structure
 * @param xy:   coordinates of the new node to insert
@@ -299,4 +597,37 @@ void tmMesh_refineLocally(tmMesh *mesh, tmDouble xy[2]);
 **********************************************************/
 tmDouble tmMesh_sizeFun(tmMesh *mesh, tmDouble xy[2]);
 
+/**********************************************************
+* Function: tmMesh_resetSizes()
+*----------------------------------------------------------
+* Invalidates the size function values, which are cached
+* on the nodes and edges of the mesh (see 
+* tmNode_getSize()). This is required, whenever the 
+* size function changes, e.g. after the boundary size
+* functions have been initialized.
+*----------------------------------------------------------
+* @param mesh: the mesh structure
+**********************************************************/
+void tmMesh_resetSizes(tmMesh *mesh);
+
+/**********************************************************
+* Function: tmMesh_sizeFunBatch()
+*----------------------------------------------------------
+* Evaluates the global size function of the mesh for 
+* n points at once. The results equal the ones of 
+* tmMesh_sizeFun(). 
+* The user-defined size function is evaluated with the 
+* function of tmMesh_setSizeFunBatch(), if it is set, 
+* and the boundary term is computed for all points per 
+* boundary edge.
+*----------------------------------------------------------
+* @param mesh: the mesh structure
+* @param n:    number of points
+* @param xy:   coordinates to evaluate the size function
+* @param out:  returns the n size function values
+*
+**********************************************************/
+void tmMesh_sizeFunBatch(tmMesh *mesh, int n, 
+                         tmDouble (*xy)[2], tmDouble *out);
+
 #endif
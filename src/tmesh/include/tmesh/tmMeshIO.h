@@ -0,0 +1,216 @@
+/*
+ * This header file is part of the tmesh library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef TMESH_TMMESHIO_H
+#define TMESH_TMMESHIO_H
+
+#include "tmesh/tmTypedefs.h"
+
+/**********************************************************
+* Function: tmMesh_setSink()
+*----------------------------------------------------------
+* Sets the functions, which receive the nodes and 
+* triangles of the advancing front meshing as soon as 
+* they are final. A node is final, when it is no longer 
+* located on the advancing front, such that no further
+* triangles are connected to it. A triangle is passed 
+* after all of its nodes.
+* Nodes and triangles are numbered in the order of their
+* output. After the meshing, the mesh nodes and 
+* triangles are sorted in this order, such that the 
+* indices of any later mesh output are the same.
+* The functions are called from the meshing thread. 
+* Subdomain meshes of tmMesh_ADFMeshingParallel() are
+* passed after they have been merged.
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param nodeFun: function to receive nodes (may be NULL)
+* @param triFun: function to receive triangles (may be 
+*                NULL)
+* @param ctx: context, which is passed to the functions
+**********************************************************/
+void tmMesh_setSink(tmMesh        *mesh, 
+                    tmSinkNodeFun  nodeFun, 
+                    tmSinkTriFun   triFun,
+                    void          *ctx);
+
+/**********************************************************
+* Function: tmMesh_sinkUpdate()
+*----------------------------------------------------------
+* Passes the nodes of a new triangle, which are no longer
+* located on the advancing front, and their completed 
+* triangles to the sink of the mesh
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param *tri: new triangle
+**********************************************************/
+void tmMesh_sinkUpdate(tmMesh *mesh, tmTri *tri);
+
+/**********************************************************
+* Function: tmMesh_sinkFlush()
+*----------------------------------------------------------
+* Passes all remaining nodes and triangles to the sink 
+* of the mesh and sorts the mesh nodes and triangles 
+* in the order of their output
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+**********************************************************/
+void tmMesh_sinkFlush(tmMesh *mesh);
+
+/**********************************************************
+* Function: tmMesh_printMesh()
+*----------------------------------------------------------
+* Fuction to print out the mesh data
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+**********************************************************/
+void tmMesh_printMesh(tmMesh *mesh);
+
+/**********************************************************
+* Function: tmMesh_printMeshIncomflow()
+*----------------------------------------------------------
+* Fuction to print out the mesh data in the format for
+* the incomflow solver
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+**********************************************************/
+void tmMesh_printMeshIncomflow(tmMesh *mesh);
+
+/**********************************************************
+* Function: tmMesh_writeMesh()
+*----------------------------------------------------------
+* Writes the mesh data in the format of 
+* tmMesh_printMesh(). 
+* Large tables are formatted on the threads of the mesh.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param w: writer for the output
+* @return: FALSE, if the output has failed
+**********************************************************/
+tmBool tmMesh_writeMesh(tmMesh *mesh, tmWriter *w);
+
+/**********************************************************
+* Function: tmMesh_writeMeshIncomflow()
+*----------------------------------------------------------
+* Writes the mesh data in the format of 
+* tmMesh_printMeshIncomflow(). 
+* Large tables are formatted on the threads of the mesh.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param w: writer for the output
+* @return: FALSE, if the output has failed
+**********************************************************/
+tmBool tmMesh_writeMeshIncomflow(tmMesh *mesh, tmWriter *w);
+
+/**********************************************************
+* Binary mesh file format:
+* All values are stored in little-endian byte order.
+* The file starts with a header of TM_BIN_HEADER_SIZE 
+* bytes:
+*   char[8]  magic  ("TMESHBIN")
+*   uint32   version, uint32 header size
+*   uint64   number of nodes, triangles, boundary edges
+*   uint64   offsets of the arrays below
+*   uint64   total file size
+* Each array starts at an offset, which is a multiple 
+* of 8 bytes:
+*   float64  nodes[n_nodes][2]       (node coordinates)
+*   int32    tris[n_tris][3]         (node indices)
+*   int32    nbrs[n_tris][3]         (-1: no neighbor)
+*   int32    bdry_edges[n_bdry][2]   (node indices)
+*   int32    bdry_markers[n_bdry]
+*   int32    bdry_ids[n_bdry]        (boundary index)
+* Neighbor j of a triangle shares the side opposite to 
+* its node j. The boundary edges are the triangle sides
+* without a neighbor, ordered along the boundaries. 
+* Their markers replace the -1 of the neighbor array.
+**********************************************************/
+#define TM_BIN_MAGIC       "TMESHBIN"
+#define TM_BIN_VERSION     ( 1 )
+#define TM_BIN_HEADER_SIZE ( 96 )
+
+/**********************************************************
+* Function: tmMesh_writeBinaryTo()
+*----------------------------------------------------------
+* Writes the mesh data in the binary format 
+* (see TM_BIN_MAGIC) to a writer
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param w: writer
+* @return: FALSE, if the mesh could not be indexed
+**********************************************************/
+tmBool tmMesh_writeBinaryTo(tmMesh *mesh, tmWriter *w);
+
+/**********************************************************
+* Function: tmMesh_writeBinary()
+*----------------------------------------------------------
+* Writes the mesh data to a binary file, which can be 
+* mapped into memory as a whole (see TM_BIN_MAGIC for
+* the file format)
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param path: path of the output file
+* @return: FALSE, if the file could not be written
+**********************************************************/
+tmBool tmMesh_writeBinary(tmMesh *mesh, const char *path);
+
+/**********************************************************
+* VTU output: cell types and number of data arrays
+**********************************************************/
+#define TM_VTU_LINE     ( 3 )
+#define TM_VTU_TRIANGLE ( 5 )
+#define TM_VTU_N_ARRAYS ( 9 )
+
+/**********************************************************
+* Function: tmMesh_writeVTU()
+*----------------------------------------------------------
+* Writes the mesh to a VTK unstructured grid file (.vtu) 
+* with raw binary appended data, e.g. for ParaView.
+* The triangles are followed by the triangle sides on 
+* the boundaries as line cells. Cell data are the 
+* boundary markers (-1 for triangles) and the triangle 
+* quality, minAngle, maxAngle and area (zero for 
+* boundary sides).
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param path: path of the output file
+* @return: FALSE, if the file could not be written
+**********************************************************/
+tmBool tmMesh_writeVTU(tmMesh *mesh, const char *path);
+
+/**********************************************************
+* MSH output: element types and physical tag of the 
+* triangles
+**********************************************************/
+#define TM_MSH_LINE       ( 1 )
+#define TM_MSH_TRIANGLE   ( 2 )
+#define TM_MSH_DOMAIN_TAG ( 1 )
+
+/**********************************************************
+* Function: tmMesh_writeMSH()
+*----------------------------------------------------------
+* Writes the mesh to a binary Gmsh MSH 4.1 file.
+* All nodes and triangles belong to the surface entity
+* TM_MSH_DOMAIN_TAG, which is also its physical group.
+* The triangle sides on the boundaries form a curve 
+* entity for every pair of boundary and marker, whose 
+* line elements belong to the physical groups of the 
+* marker ("marker_<m>") and of the boundary index 
+* ("boundary_<i>"). Positive markers are the tags of 
+* their groups, since Gmsh requires positive tags. 
+* Other markers and the boundaries are tagged after 
+* the largest marker.
+* Node tags are the node indices plus one, triangles 
+* are numbered before the boundary sides.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param path: path of the output file
+* @return: FALSE, if the file could not be written
+**********************************************************/
+tmBool tmMesh_writeMSH(tmMesh *mesh, const char *path);
+
+#endif /* TMESH_TMMESHIO_H */
@@ -0,0 +1,59 @@
+/*
+ * This header file is part of the tmesh library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef TMESH_TMMESHLOAD_H
+#define TMESH_TMMESHLOAD_H
+
+#include <stdint.h>
+
+#include "tmesh/tmTypedefs.h"
+
+/**********************************************************
+* Function: tmMesh_checkBinHeader()
+*----------------------------------------------------------
+* Reads and validates the header of binary mesh data 
+* (see TM_BIN_MAGIC): the offsets must be aligned to 8 
+* bytes, increase and lie within the data, and each 
+* array must fit between its offset and the next one
+*----------------------------------------------------------
+* @param buf, len: binary mesh data
+* @param n: returns the numbers of nodes, triangles and
+*           boundary edges
+* @param off: returns the array offsets and the data size
+* @return: FALSE, if the header is invalid
+**********************************************************/
+tmBool tmMesh_checkBinHeader(const unsigned char *buf,
+                             size_t               len,
+                             uint64_t             n[3],
+                             uint64_t             off[7]);
+
+/**********************************************************
+* Function: tmMesh_load()
+*----------------------------------------------------------
+* Creates a mesh from the binary output of 
+* tmMesh_writeBinary() or from the text output of 
+* tmMesh_printMesh() / tmMesh_printMeshIncomflow(), 
+* including the mesh edges, the triangle neighbors and 
+* the qtrees, such that the mesh can be refined with 
+* tmMesh_refineLocally() and tmMesh_delaunayFlip().
+* Counter-clockwise boundary loops become exterior 
+* boundaries and clockwise loops interior boundaries. 
+* The boundary edges are loaded with a refinement of 1.0.
+* Text files store the coordinates only with 5 digits.
+*----------------------------------------------------------
+* @param path: path of the mesh file
+* @param qtree_max_obj: max. number of qtree objects
+* @param globSize: global element size
+* @param sizeFunUser: user-defined size function
+* @return: the mesh or NULL, if the file is invalid
+**********************************************************/
+tmMesh *tmMesh_load(const char    *path,
+                    int            qtree_max_obj,
+                    tmDouble       globSize,
+                    tmSizeFunUser  sizeFunUser);
+
+#endif /* TMESH_TMMESHLOAD_H */
@@ -26,6 +26,7 @@ typedef struct tmNode {
   -------------------------------------------------------*/
   tmDouble xy[2];
   tmIndex  index; /* Only used for the mesh-output       */
+  tmIndex  stream_index; /* Index of the mesh sink, or -1  */
   tmBool   is_active; /* Every node is active by default */ 
 
   /*-------------------------------------------------------
@@ -73,6 +74,12 @@ typedef struct tmNode {
   tmDouble rho;
   tmDouble k;
 
+  /*-------------------------------------------------------
+  | Cached value of the size function at the node 
+  | -> 0.0, if it has not been evaluated yet
+  -------------------------------------------------------*/
+  tmDouble size;
+
 } tmNode;
 
 
@@ -193,4 +200,18 @@ tmEdge *tmNode_getAdjFrontEdge(tmNode *n, tmNode *m);
 **********************************************************/
 tmBool tmNode_isValid(tmNode *node);
 
+/**********************************************************
+* Function: tmNode_getSize()
+*----------------------------------------------------------
+* Returns the value of the size function at a node. 
+* The value is evaluated once and cached on the node, 
+* until the node is moved or the size function changes
+* (see tmMesh_resetSizes()).
+* The function may be called concurrently.
+*----------------------------------------------------------
+* @param node: pointer to node
+* @return: size function value at the node
+**********************************************************/
+tmDouble tmNode_getSize(tmNode *node);
+
 #endif
@@ -153,4 +153,146 @@ int tmParam_readIntBdryData(struct bstrList *txtlist,
                             int          *nBdrys);
 
 
+/*************************************************************
+* Boundary definition of a memory mapped parameter file
+*************************************************************/
+typedef struct tmParamBdry {
+  int       marker;      /* Boundary marker               */
+  int     (*edges)[2];   /* Edge node indices             */
+  int      *edgeMarker;  /* Edge markers                  */
+  tmDouble *edgeRefine;  /* Edge refinements              */
+  int       nEdges;      /* Number of edges               */
+  int       size;        /* Allocated number of edges     */
+} tmParamBdry;
+
+/*************************************************************
+* Line of a memory mapped parameter file
+*************************************************************/
+typedef struct tmParamLine {
+  const char *str;       /* Start of line in mapped file  */
+  long        len;       /* Length without comment        */
+} tmParamLine;
+
+/*************************************************************
+* Memory mapped parameter file
+*
+* The file is tokenized in a single pass: Node coordinates 
+* and boundary edges are parsed directly into the arrays 
+* below, all other lines are kept as references to the 
+* mapped file for the extraction of parameters.
+*************************************************************/
+typedef struct tmParamFile {
+  const char  *path;     /* Path of file                  */
+  const char  *data;     /* Mapped file data              */
+  long         length;   /* Number of chars in file       */
+  tmBool       mapped;   /* Data is mapped from path      */
+
+  tmParamLine *params;   /* Lines outside of definitions  */
+  int          nParams;
+  int          sizeParams;
+
+  tmDouble   (*nodes)[2];/* Node coordinates              */
+  int          nNodes;
+  int          sizeNodes;
+
+  tmBool       hasExtBdry;
+  tmParamBdry  extBdry;  /* Exterior boundary             */
+  tmParamBdry *intBdrys; /* Interior boundaries           */
+  int          nIntBdrys;
+  int          sizeIntBdrys;
+
+} tmParamFile;
+
+/*************************************************************
+* Function: tmParamFile_create()
+*------------------------------------------------------------
+* Maps the parameter file at file_path into memory and 
+* reads its node and boundary definitions in a single pass
+* @return: NULL on errors
+*************************************************************/
+tmParamFile *tmParamFile_create(const char *file_path);
+
+/*************************************************************
+* Function: tmParamFile_createFromString()
+*------------------------------------------------------------
+* Reads the node and boundary definitions of the parameter
+* file content in data, which must persist until the file 
+* is destroyed
+* @return: NULL on errors
+*************************************************************/
+tmParamFile *tmParamFile_createFromString(const char *data,
+                                          long        length);
+
+/*************************************************************
+* Function: tmParamFile_destroy()
+*------------------------------------------------------------
+* Unmaps the parameter file and frees all its data
+*************************************************************/
+void tmParamFile_destroy(tmParamFile *file);
+
+/*************************************************************
+* Function: tmParamFile_extractParam()
+*------------------------------------------------------------
+* Same as tmParam_extractParam() for a mapped file
+*************************************************************/
+int tmParamFile_extractParam(tmParamFile *file,
+                             const char *fltr, int type,
+                             void *value);
+
+/*************************************************************
+* Function: tmParamFile_extractArray()
+*------------------------------------------------------------
+* Same as tmParam_extractArray() for a mapped file, where
+* only integers (type = 0) and doubles (type = 1) are 
+* supported. The number of values is stored in <n>.
+*************************************************************/
+int tmParamFile_extractArray(tmParamFile *file,
+                             const char *fltr, int type,
+                             void *value, int *n);
+
+/*************************************************************
+* Function: tmParam_nextLine()
+*------------------------------------------------------------
+* Returns the next line of the text in [*pos, end) without 
+* its comment and newline in <line>, <len> and moves *pos 
+* to the beginning of the following line
+* @return: FALSE, if there are no more lines
+*************************************************************/
+tmBool tmParam_nextLine(const char **pos, const char *end,
+                        const char **line, long *len);
+
+/*************************************************************
+* Function: tmParam_findStr()
+*------------------------------------------------------------
+* Searches for the string <fltr> in a line of length <len>,
+* as parameters are searched by tmParamFile_extractParam()
+* @return: pointer behind the first occurence of <fltr> or
+*          NULL, if it is not found
+*************************************************************/
+const char *tmParam_findStr(const char *line, long len,
+                            const char *fltr);
+
+/*************************************************************
+* Function: tmParam_parseDouble()
+*------------------------------------------------------------
+* Parses a floating point number from the text in 
+* [*pos, end) and moves *pos behind it. 
+* The result equals the one of strtod() for decimal 
+* numbers.
+* @return: FALSE, if there is no valid number
+*************************************************************/
+tmBool tmParam_parseDouble(const char **pos, const char *end,
+                           tmDouble *value);
+
+/*************************************************************
+* Function: tmParam_parseInt()
+*------------------------------------------------------------
+* Parses an integer from the text in [*pos, end) and moves 
+* *pos behind it
+* @return: FALSE, if there is no valid integer
+*************************************************************/
+tmBool tmParam_parseInt(const char **pos, const char *end,
+                        int *value);
+
+
 #endif
@@ -0,0 +1,101 @@
+/*
+ * This header file is part of the tmesh library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef TMESH_TMPOOL_H
+#define TMESH_TMPOOL_H
+
+#include <pthread.h>
+
+#include "tmesh/tmTypedefs.h"
+
+/**********************************************************
+* Function pointer for a parallel loop body, which 
+* processes the loop indices [i_beg, i_end).
+* thread_id is in [0, n_threads), where 0 refers to the 
+* calling thread.
+**********************************************************/
+typedef void (*tmPoolFun) (void *data, 
+                           size_t i_beg, size_t i_end,
+                           int thread_id);
+
+/**********************************************************
+* tmPool: Persistent pool of worker threads
+**********************************************************/
+typedef struct tmPool {
+
+  /*-------------------------------------------------------
+  | Number of threads (including the calling thread)
+  -------------------------------------------------------*/
+  int        n_threads;
+  pthread_t *threads;
+
+  /*-------------------------------------------------------
+  | Synchronization 
+  -------------------------------------------------------*/
+  pthread_mutex_t lock;
+  pthread_cond_t  work_cond; /* Signals a new job       */
+  pthread_cond_t  done_cond; /* Signals a finished job  */
+
+  unsigned long   job_id;    /* Incremented for each job*/
+  int             n_busy;    /* Workers on current job  */
+  tmBool          shutdown;
+
+  /*-------------------------------------------------------
+  | Current job: loop [0, n) in chunks of size chunk
+  -------------------------------------------------------*/
+  tmPoolFun fun;
+  void     *data;
+  size_t    n;
+  size_t    chunk;
+  size_t    next;
+
+} tmPool;
+
+/**********************************************************
+* Function: tmPool_create()
+*----------------------------------------------------------
+* Create a new tmPool structure with n_threads-1 worker
+* threads and return a pointer to it.
+* The calling thread takes part in every parallel loop.
+*----------------------------------------------------------
+* @param n_threads: total number of threads
+* @return: Pointer to a new tmPool structure
+**********************************************************/
+tmPool *tmPool_create(int n_threads);
+
+/**********************************************************
+* Function: tmPool_destroy()
+*----------------------------------------------------------
+* Joins all worker threads and frees the tmPool memory
+*----------------------------------------------------------
+* @param *pool: pointer to a tmPool to destroy
+**********************************************************/
+void tmPool_destroy(tmPool *pool);
+
+/**********************************************************
+* Function: tmPool_parallelFor()
+*----------------------------------------------------------
+* Processes the loop indices [0, n) in parallel.
+* Threads fetch chunks of indices dynamically, hence 
+* the loop body must not depend on the order in which 
+* chunks are processed. The function returns, when all 
+* indices have been processed.
+* If pool is NULL, the loop is processed serially.
+*----------------------------------------------------------
+* @param *pool: pointer to a tmPool (may be NULL)
+* @param n: number of loop indices
+* @param chunk: number of indices fetched at once
+* @param fun: loop body
+* @param data: data passed to the loop body
+**********************************************************/
+void tmPool_parallelFor(tmPool   *pool,
+                        size_t    n,
+                        size_t    chunk,
+                        tmPoolFun fun,
+                        void     *data);
+
+#endif
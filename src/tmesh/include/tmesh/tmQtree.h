@@ -116,6 +116,24 @@ void tmQtree_init(tmQtree *qtree,
 **********************************************************/
 tmBool tmQtree_addObj(tmQtree *qtree, void *obj);
 
+/**********************************************************
+* Function: tmQtree_addObjs()
+*----------------------------------------------------------
+* Adds an array of objects to the qtree at once. 
+* In contrast to tmQtree_addObj(), every object is only
+* moved down the qtree once and leaves are only splitted 
+* once, which makes it suited for the bulk-loading 
+* of an entire mesh.
+* The order of the array is changed.
+*----------------------------------------------------------
+* @param qtree: tmQtree structure
+* @param objs:  array of objects to add
+* @param n:     number of objects
+* @return: FALSE, if objects were located outside of the 
+*          qtree's bbox -> these are not added
+**********************************************************/
+tmBool tmQtree_addObjs(tmQtree *qtree, void **objs, int n);
+
 /**********************************************************
 * Function: tmQtree_remObj()
 *----------------------------------------------------------
@@ -126,6 +144,39 @@ tmBool tmQtree_addObj(tmQtree *qtree, void *obj);
 **********************************************************/
 tmBool tmQtree_remObj(tmQtree *qtree, void *obj);
 
+/**********************************************************
+* Function: tmQtree_detachObj()
+*----------------------------------------------------------
+* Detach an object from its qtree leaf, if its coordinates
+* have left the bounding box of this leaf. 
+* The leaf is not merged with its siblings, since these 
+* may still contain objects with outdated locations.
+*----------------------------------------------------------
+* @param qtree: root tmQtree structure
+* @param obj:   object to detach from the qtree
+* @return: TRUE if the object has been detached
+**********************************************************/
+tmBool tmQtree_detachObj(tmQtree *qtree, void *obj);
+
+/**********************************************************
+* Function: tmQtree_updateObj()
+*----------------------------------------------------------
+* Relocate an object within the qtree after its 
+* coordinates have changed. 
+* Nothing is done, if the object is still located in the
+* bounding box of its current qtree leaf. Otherwise it 
+* is detached from its leaf and inserted again, starting
+* from the given root qtree.
+* Inserting may split leaves, hence all other objects of 
+* the qtree must be located within their leaves. If 
+* several objects have been moved, all of them must be
+* detached with tmQtree_detachObj() first.
+*----------------------------------------------------------
+* @param qtree: root tmQtree structure
+* @param obj:   object to relocate in the qtree
+**********************************************************/
+tmBool tmQtree_updateObj(tmQtree *qtree, void *obj);
+
 /**********************************************************
 * Function: tmQtree_getObjNo()
 *----------------------------------------------------------
@@ -165,7 +216,10 @@ tmList *tmQtree_getObjBbox(tmQtree *qtree,
 * Function: tmQtree_getObjCirc()
 *----------------------------------------------------------
 * Return a list of objects that are contained within
-* a specified circle 
+* a specified circle.
+* The qtree and its objects are not modified, such that
+* concurrent queries are safe, as long as no objects are
+* added or removed at the same time.
 *----------------------------------------------------------
 * @param qtree: tmQtree structure to initialize
 * @param xy: circle centroid
@@ -0,0 +1,58 @@
+/*
+ * This header file is part of the tmesh library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef TMESH_TMRENUMBER_H
+#define TMESH_TMRENUMBER_H
+
+#include "tmesh/tmTypedefs.h"
+
+/**********************************************************
+* Mesh renumbering methods
+**********************************************************/
+#define TM_RENUMBER_NONE    0
+#define TM_RENUMBER_HILBERT 1
+#define TM_RENUMBER_RCM     2
+
+/**********************************************************
+* Function: tmMesh_renumber()
+*----------------------------------------------------------
+* Sorts the mesh nodes and triangles for the cache 
+* locality of solvers, which operate on the mesh output.
+* TM_RENUMBER_HILBERT orders the nodes and triangles 
+* along a Hilbert curve over the mesh bounding box.
+* TM_RENUMBER_RCM orders the nodes with the reverse 
+* Cuthill-McKee algorithm to reduce the bandwidth of the
+* node adjacency and the triangles by their lowest 
+* node index.
+* Triangle neighbors and boundary edges refer to the 
+* nodes and triangles directly and remain consistent.
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param method: TM_RENUMBER_HILBERT or TM_RENUMBER_RCM
+* @return: FALSE, if the memory can not be allocated
+**********************************************************/
+tmBool tmMesh_renumber(tmMesh *mesh, int method);
+
+/**********************************************************
+* Function: tmMesh_calcBandwidth()
+*----------------------------------------------------------
+* Sets the node indices according to their order in the
+* mesh list and computes the bandwidth and profile of the
+* node adjacency matrix
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param *bandwidth: maximum index distance of two 
+*                    connected nodes
+* @param *profile: sum of the index distances of all 
+*                  nodes to their lowest connected node
+* @return: FALSE, if the memory can not be allocated
+**********************************************************/
+tmBool tmMesh_calcBandwidth(tmMesh *mesh, 
+                            long   *bandwidth, 
+                            long   *profile);
+
+#endif /* TMESH_TMRENUMBER_H */
@@ -0,0 +1,110 @@
+/*
+ * This header file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef TMESH_TMSHM_H
+#define TMESH_TMSHM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tmMesh.h"
+
+/**********************************************************
+* Shared memory mesh format:
+* A named POSIX shared memory segment, which contains the
+* header below followed by the arrays of the incomflow
+* output in host byte order:
+*   float64  nodes[n_nodes][2]   (node coordinates)
+*   int32    tris[n_tris][3]     (node indices)
+*   int32    nbrs[n_tris][3]     (triangle indices or the
+*                                 negative boundary marker)
+* Each array is aligned to 8 bytes. The magic is written
+* last, such that readers never see an incomplete mesh.
+**********************************************************/
+#define TM_SHM_MAGIC   "TMESHSHM"
+#define TM_SHM_VERSION ( 1 )
+
+typedef struct tmShmHeader {
+
+  char      magic[8];
+  uint32_t  version;
+  uint32_t  header_size;
+  uint64_t  size;         /* Size of the segment            */
+  uint64_t  n_nodes;
+  uint64_t  n_tris;
+  uint64_t  off_nodes;    /* Array offsets                  */
+  uint64_t  off_tris;
+  uint64_t  off_nbrs;
+
+} tmShmHeader;
+
+/**********************************************************
+* tmShmMesh: Mapped shared memory mesh
+**********************************************************/
+typedef struct tmShmMesh {
+
+  void            *data;
+  size_t           size;
+
+  int              n_nodes;
+  int              n_tris;
+
+  const double   (*nodes)[2];
+  const int32_t  (*tris)[3];
+  const int32_t  (*nbrs)[3];
+
+} tmShmMesh;
+
+/**********************************************************
+* Function: tmShm_export()
+*----------------------------------------------------------
+* Writes the mesh to the shared memory segment name,
+* which replaces an existing segment of the same name.
+* The nodes and triangles are indexed in the order of
+* the mesh lists and written directly into the mapped
+* segment without any intermediate copy.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param name: segment name, e.g. "/tmesh"
+* @return: FALSE, if the segment could not be written
+**********************************************************/
+tmBool tmShm_export(tmMesh *mesh, const char *name);
+
+/**********************************************************
+* Function: tmShm_map()
+*----------------------------------------------------------
+* Maps the mesh of a shared memory segment read-only
+*----------------------------------------------------------
+* @param name: segment name
+* @param mesh: returns the mapped mesh
+* @return: FALSE, if the segment does not contain a
+*          complete mesh
+**********************************************************/
+tmBool tmShm_map(const char *name, tmShmMesh *mesh);
+
+/**********************************************************
+* Function: tmShm_unmap()
+*----------------------------------------------------------
+* Unmaps a mesh of tmShm_map()
+*----------------------------------------------------------
+* @param mesh: pointer to a mapped mesh
+**********************************************************/
+void tmShm_unmap(tmShmMesh *mesh);
+
+/**********************************************************
+* Function: tmShm_unlink()
+*----------------------------------------------------------
+* Removes a shared memory segment. Existing mappings
+* remain valid.
+*----------------------------------------------------------
+* @param name: segment name
+* @return: FALSE, if the segment does not exist
+**********************************************************/
+tmBool tmShm_unlink(const char *name);
+
+#endif
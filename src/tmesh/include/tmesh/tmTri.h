@@ -78,6 +78,7 @@ typedef struct tmTri {
   -------------------------------------------------------*/
   tmDouble xy[2];
   tmIndex  index; /* Only used for the mesh output       */
+  tmIndex  stream_index; /* Index of the mesh sink, or -1  */
 
   /*-------------------------------------------------------
   | Triangle properties
@@ -131,6 +132,34 @@ tmTri *tmTri_create(tmMesh *mesh,
 **********************************************************/
 void tmTri_destroy(tmTri *tri);
 
+/**********************************************************
+* Function: tmTri_calcProperties()
+*----------------------------------------------------------
+* (Re-)computes all geometric properties of a triangle
+* from the coordinates of its nodes
+*----------------------------------------------------------
+* @param *tri: pointer to a tmTri 
+**********************************************************/
+void tmTri_calcProperties(tmTri *tri);
+
+/**********************************************************
+* Function: tmTri_setNodes()
+*----------------------------------------------------------
+* Redefines the nodes of an existing triangle in place.
+* Only the triangle-lists of nodes that are removed from 
+* or added to the triangle are modified. 
+* Afterwards all triangle properties are recomputed.
+* The mesh area and the triangle's location in the mesh 
+* qtree are not updated -> this is left to the caller 
+* (see tmQtree_updateObj()), such that triangles with 
+* disjoint nodes can be redefined concurrently.
+*----------------------------------------------------------
+* @param *tri: pointer to a tmTri 
+* @param n1,n2,n3: new nodes of the triangle (ccw)
+**********************************************************/
+void tmTri_setNodes(tmTri *tri, 
+                    tmNode *n1, tmNode *n2, tmNode *n3);
+
 /**********************************************************
 * Function: tmTri_findNbrTriFromEdge()
 *----------------------------------------------------------
@@ -143,6 +172,7 @@ void tmTri_destroy(tmTri *tri);
 * @param tri:   triangle for which a neighbor will be found
 *               if one has been found, it will be included
 *               to its neighbors
+* @return: the neighbor or NULL, if none has been found
 **********************************************************/
 tmTri *tmTri_findTriNeighbor(tmNode *n1, 
                              tmNode *n2,
@@ -16,6 +16,12 @@
 #include "tmesh/dbg.h"
 #include "tmesh/tmList.h"
 
+/***********************************************************
+* Library version -> part of the mesh cache keys, such that
+* cached meshes of older versions are not used
+***********************************************************/
+#define TM_VERSION "1.1.0"
+
 /***********************************************************
 * Flag to use double precision -> undefine to use float
 ***********************************************************/
@@ -49,12 +55,26 @@ typedef struct tmBdry  tmBdry;
 typedef struct tmFront tmFront;
 typedef struct tmQtree tmQtree;
 typedef struct tmMesh  tmMesh;
+typedef struct tmPool  tmPool;
+typedef struct tmDomain tmDomain;
+typedef struct tmWriter tmWriter;
 
 /***********************************************************
 * Function pointers
 ***********************************************************/
 typedef tmDouble (*tmSizeFun) (tmMesh *mesh, tmDouble xy[2]);
 typedef tmDouble (*tmSizeFunUser) (tmDouble xy[2]);
+typedef tmDouble (*tmSizeFunUserCtx) (void *ctx, tmDouble xy[2]);
+typedef void (*tmSizeFunBatch) (tmMesh *mesh, int n, 
+                                tmDouble (*xy)[2], tmDouble *out);
+typedef void (*tmSizeFunUserBatch) (void *ctx, int n, 
+                                    tmDouble (*xy)[2],
+                                    tmDouble *out);
+
+typedef void (*tmSinkNodeFun) (void *ctx, tmIndex index, 
+                               tmDouble xy[2]);
+typedef void (*tmSinkTriFun)  (void *ctx, tmIndex index, 
+                               tmIndex n1, tmIndex n2, tmIndex n3);
 
 
 /***********************************************************
@@ -93,6 +113,48 @@ typedef tmDouble (*tmSizeFunUser) (tmDouble xy[2]);
 #define TM_TRI_MAX_ANGLE      ( (165.0*PI_D)/180.0 )
 #define TM_TRI_MIN_QUALITY    ( 0.04 )
 #define TM_SIZEFUN_SLOPE      ( 1.0 ) 
+#define TM_DELAUNAY_TOL       ( 1.0E-10 ) /* rel. incircle tol. */
+#define TM_DELAUNAY_FLIP_FAC  ( 16 )   /* max. flips per edge  */
+#define TM_SMOOTH_ANGLE_FAC   ( 0.5 ) /* angle-based weight   */
+#define TM_SMOOTH_AREA_FAC    ( 0.1 ) /* min. rel. tri area   */
+#define TM_EXPR_MAX_REGS      ( 256 ) /* size fun. registers  */
+#define TM_EXPR_BATCH_SIZE    ( 64 )  /* points per dispatch  */
+#define TM_SUBDIV_SAMPLES     ( 8 )   /* samples per segment  */
+#define TM_SUBDIV_TOL         ( 1.0E-6 ) /* segment tolerance */
+
+/***********************************************************
+* PARALLELIZATION PARAMETERS
+***********************************************************/
+#define TM_POOL_CHUNK_SIZE    ( 256 ) /* indices per fetch  */
+#define TM_DOMAIN_MARKER      ( -2 )  /* interface marker   */
+#define TM_DOMAIN_CUT_FAC     ( 1.0 ) /* min. cut distance  */
+#define TM_DOMAIN_CUT_SIN     ( 0.5 ) /* min. sin(cut angle)*/
+#define TM_DOMAIN_CUT_STEP    ( 0.05 )/* rel. cut shift     */
+#define TM_DOMAIN_CUT_TRIES   ( 5 )   /* cut shifts per side*/
+#define TM_DOMAIN_SAMPLES     ( 256 ) /* samples per domain */
+#define TM_DOMAIN_SNAP_FAC    ( 1.0E-3 )/* rel. snap distance*/
+#define TM_DOMAIN_BEND_FAC    ( 0.5 ) /* rel. bend distance */
+#define TM_ADF_BATCH_SIZE     ( 16 )  /* edges per thread   */
+#define TM_ADF_SCAN_FAC       ( 8 )   /* scanned edges/batch*/
+#define TM_ADF_REGION_FAC     ( 2.0 ) /* est. region / len  */
+#define TM_ADV_SERIAL_CANDS   ( 4 )   /* serial node checks */
+#define TM_ADV_PARALLEL_CANDS ( 8 )   /* node checks / batch*/
+
+/***********************************************************
+* OUTPUT PARAMETERS
+***********************************************************/
+#define TM_WRITER_BUF_SIZE    ( 1<<20 )/* file buffer bytes */
+#define TM_WRITER_CHUNK_ROWS  ( 4096 )/* rows per chunk     */
+#define TM_WRITER_CHUNKS_PER_THREAD ( 4 )
+#define TM_WRITER_FIXED_MAX   ( 1.0E12 )/* max. scaled value*/
+#define TM_WRITER_FIXED_TIE   ( 1.0E-3 )/* tie tolerance    */
+#define TM_HILBERT_BITS       ( 16 )  /* curve bits / axis  */
+#define TM_CACHE_MAX_MB       ( 1024 )/* mesh cache limit   */
+#define TM_BATCH_TRI_BYTES    ( 1024 )/* est. bytes/element */
+#define TM_BATCH_JOB_BYTES    ( 1<<20 )/* est. bytes / job  */
+#define TM_MSG_MAX_BYTES      ( 1L<<34 )/* daemon message   */
+#define TM_SERVE_TIMEOUT      ( 30 )  /* idle conn. sec.  */
+#define TM_SERVE_MAX_DOMAINS  ( 64 )  /* subdomains / req.*/
 
 /***********************************************************
 * Minimum and maximum allowed coordinates
@@ -0,0 +1,183 @@
+/*
+ * This header file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#ifndef TMESH_TMWRITER_H
+#define TMESH_TMWRITER_H
+
+#include "tmesh/tmTypedefs.h"
+
+/**********************************************************
+* tmWriter: Buffered output to a file descriptor or
+*           to memory
+**********************************************************/
+typedef struct tmWriter {
+
+  int     fd;        /* File descriptor, -1 for memory    */
+  tmBool  close_fd;  /* Close the descriptor on destroy   */
+
+  char   *buf;
+  size_t  n;         /* Number of buffered bytes          */
+  size_t  size;      /* Buffer capacity                   */
+
+  tmBool  ok;        /* FALSE, if any write has failed    */
+
+} tmWriter;
+
+/**********************************************************
+* Function pointer for the output of the rows
+* [i_beg, i_end) of a table to a writer
+**********************************************************/
+typedef void (*tmWriterFun) (void     *data,
+                             tmWriter *w,
+                             size_t    i_beg,
+                             size_t    i_end);
+
+/**********************************************************
+* Function: tmWriter_create()
+*----------------------------------------------------------
+* Create a new tmWriter structure, which writes to the
+* file descriptor fd. The descriptor is not closed,
+* when the writer is destroyed.
+* For fd < 0, all data is kept in the writer's buffer.
+*----------------------------------------------------------
+* @param fd: file descriptor
+* @return: Pointer to a new tmWriter structure
+**********************************************************/
+tmWriter *tmWriter_create(int fd);
+
+/**********************************************************
+* Function: tmWriter_createStdout()
+*----------------------------------------------------------
+* Create a new tmWriter structure, which writes to the
+* standard output. Pending output of the stdout stream 
+* is written before.
+*----------------------------------------------------------
+* @return: Pointer to a new tmWriter structure
+**********************************************************/
+tmWriter *tmWriter_createStdout(void);
+
+/**********************************************************
+* Function: tmWriter_open()
+*----------------------------------------------------------
+* Create a new tmWriter structure, which writes to the
+* file at path. An existing file is overwritten.
+*----------------------------------------------------------
+* @param path: file path
+* @return: Pointer to a new tmWriter structure or NULL,
+*          if the file can not be opened
+**********************************************************/
+tmWriter *tmWriter_open(const char *path);
+
+/**********************************************************
+* Function: tmWriter_destroy()
+*----------------------------------------------------------
+* Writes all buffered data, closes the file descriptor
+* of tmWriter_open() and frees the writer's memory
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter to destroy
+* @return: FALSE, if any write has failed
+**********************************************************/
+tmBool tmWriter_destroy(tmWriter *w);
+
+/**********************************************************
+* Function: tmWriter_flush()
+*----------------------------------------------------------
+* Writes all buffered data to the file descriptor
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @return: FALSE, if any write has failed
+**********************************************************/
+tmBool tmWriter_flush(tmWriter *w);
+
+/**********************************************************
+* Function: tmWriter_putBytes()
+*----------------------------------------------------------
+* Appends n bytes
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param data, n: bytes to append
+**********************************************************/
+void tmWriter_putBytes(tmWriter *w, const void *data, size_t n);
+
+/**********************************************************
+* Function: tmWriter_putStr()
+*----------------------------------------------------------
+* Appends a string
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param s: null-terminated string
+**********************************************************/
+void tmWriter_putStr(tmWriter *w, const char *s);
+
+/**********************************************************
+* Function: tmWriter_putChar()
+*----------------------------------------------------------
+* Appends a single character
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param c: character
+**********************************************************/
+void tmWriter_putChar(tmWriter *w, char c);
+
+/**********************************************************
+* Function: tmWriter_putInt()
+*----------------------------------------------------------
+* Appends an integer, right-aligned to a field of the
+* given width (as printf("%*ld"))
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param v: value
+* @param width: minimum field width
+**********************************************************/
+void tmWriter_putInt(tmWriter *w, long v, int width);
+
+/**********************************************************
+* Function: tmWriter_putFixed()
+*----------------------------------------------------------
+* Appends a floating point value with prec decimals,
+* right-aligned to a field of the given width.
+* The result is the same as printf("%*.*f").
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param v: value
+* @param width: minimum field width
+* @param prec: number of decimals
+**********************************************************/
+void tmWriter_putFixed(tmWriter *w, double v, int width, int prec);
+
+/**********************************************************
+* Function: tmWriter_putDouble()
+*----------------------------------------------------------
+* Appends the shortest representation of a floating
+* point value, which is read back to the same value
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param v: value
+**********************************************************/
+void tmWriter_putDouble(tmWriter *w, double v);
+
+/**********************************************************
+* Function: tmWriter_writeRows()
+*----------------------------------------------------------
+* Writes the rows [0, n_rows) of a table with the
+* function fun. Chunks of rows are formatted on the
+* threads of the pool and written in their order.
+* If pool is NULL, all rows are written directly.
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param pool: pointer to a tmPool (may be NULL)
+* @param n_rows: number of rows
+* @param fun: function to write a range of rows
+* @param data: data passed to fun
+**********************************************************/
+void tmWriter_writeRows(tmWriter   *w,
+                        tmPool     *pool,
+                        size_t      n_rows,
+                        tmWriterFun fun,
+                        void       *data);
+
+#endif
@@ -0,0 +1,207 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tmClient.h"
+#include "tmesh/tmShm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/*************************************************************
+* Returns the elapsed wall time in seconds
+*************************************************************/
+static double wallTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + 1.0E-9 * (double) ts.tv_nsec;
+}
+
+static int compareDouble(const void *a, const void *b)
+{
+  double d = *(const double*) a - *(const double*) b;
+  return (d > 0.0) - (d < 0.0);
+}
+
+/*************************************************************
+* Reads a whole file into a null terminated buffer
+*************************************************************/
+static char *readFile(const char *path, long *len)
+{
+  FILE *fp  = fopen(path, "rb");
+  char *buf = NULL;
+
+  check( fp != NULL, "Failed to open %s", path);
+
+  check( fseek(fp, 0, SEEK_END) == 0 && (*len = ftell(fp)) >= 0
+         && fseek(fp, 0, SEEK_SET) == 0,
+      "Failed to read %s", path);
+
+  buf = (char*) malloc(*len + 1);
+  check_mem(buf);
+
+  check( fread(buf, 1, *len, fp) == (size_t) *len,
+      "Failed to read %s", path);
+  buf[*len] = '\0';
+
+  fclose(fp);
+  return buf;
+
+error:
+  free(buf);
+  if ( fp != NULL )
+    fclose(fp);
+  return NULL;
+}
+
+/*************************************************************
+* Client of the TMesh daemon and latency benchmark:
+* Sends a parameter file repeatedly to the daemon and
+* prints the latency statistics of the requests. 
+* With --shm, the mesh is received through a shared memory 
+* segment instead of the socket.
+*************************************************************/
+int main(int argc, char *argv[])
+{
+  if (argc < 3)
+  {
+    tmPrint("TMeshClient <Socket> <Input-File> [--repeat N] "
+            "[--reconnect] [--output Mesh-File] [--shm Name]");
+    tmPrint("TMeshClient <Socket> --shutdown");
+    return 0;
+  }
+
+  const char  *sockPath  = argv[1];
+  const char  *input     = argv[2];
+  const char  *output    = NULL;
+  const char  *shmName   = NULL;
+  int          nRepeat   = 1;
+  tmBool       reconnect = FALSE;
+  tmClient    *client    = NULL;
+  tmClientMesh mesh      = { 0 };
+  tmShmMesh    shm       = { 0 };
+  double      *times     = NULL;
+  char        *para      = NULL;
+  long         len;
+  double       t_0, t_sum = 0.0;
+  int          i;
+
+  for (i = 3; i < argc; i++)
+  {
+    if ( strcmp(argv[i], "--repeat") == 0 && i+1 < argc )
+      nRepeat = atoi(argv[++i]);
+    else if ( strcmp(argv[i], "--output") == 0 && i+1 < argc )
+      output = argv[++i];
+    else if ( strcmp(argv[i], "--shm") == 0 && i+1 < argc )
+      shmName = argv[++i];
+    else if ( strcmp(argv[i], "--reconnect") == 0 )
+      reconnect = TRUE;
+  }
+
+  if ( strcmp(input, "--shutdown") == 0 )
+  {
+    client = tmClient_connect(sockPath);
+    check( client != NULL && tmClient_shutdown(client) == TRUE,
+        "Failed to shut down the daemon.");
+    tmClient_destroy(client);
+    return 0;
+  }
+
+  check( nRepeat > 0, "Invalid number of repetitions.");
+
+  para = readFile(input, &len);
+  check( para != NULL, "Failed to read parameter file %s", input);
+
+  times = (double*) calloc(nRepeat, sizeof(double));
+  check_mem(times);
+
+  /*----------------------------------------------------------
+  | Request the mesh repeatedly, where only the last mesh
+  | is kept
+  ----------------------------------------------------------*/
+  for (i = 0; i < nRepeat; i++)
+  {
+    tmClientMesh_free(&mesh);
+
+    t_0 = wallTime();
+
+    if ( client == NULL )
+    {
+      client = tmClient_connect(sockPath);
+      check( client != NULL, "Failed to connect to %s", sockPath);
+    }
+
+    if ( shmName != NULL )
+    {
+      tmShm_unmap(&shm);
+      check( tmClient_meshShm(client, para, len, shmName) == TRUE
+          && tmShm_map(shmName, &shm) == TRUE,
+          "Failed to mesh %s", input);
+    }
+    else
+    {
+      check( tmClient_mesh(client, para, len, &mesh) == TRUE,
+          "Failed to mesh %s", input);
+    }
+
+    if ( reconnect == TRUE )
+    {
+      tmClient_destroy(client);
+      client = NULL;
+    }
+
+    times[i] = wallTime() - t_0;
+    t_sum   += times[i];
+  }
+
+  if ( output != NULL && shmName == NULL )
+  {
+    FILE  *fp = fopen(output, "wb");
+    size_t n;
+
+    check( fp != NULL, "Failed to open %s", output);
+    n = fwrite(mesh.data, 1, mesh.size, fp);
+    check( fclose(fp) == 0 && n == mesh.size,
+        "Failed to write %s", output);
+  }
+
+  qsort(times, nRepeat, sizeof(double), compareDouble);
+
+  tmPrint("----------------------------------------------");
+  tmPrint("TMeshClient finished");
+  tmPrint("----------------------------------------------");
+  tmPrint("Number of nodes   : %d", 
+          shmName != NULL ? shm.n_nodes : mesh.n_nodes);
+  tmPrint("Number of elements: %d", 
+          shmName != NULL ? shm.n_tris : mesh.n_tris);
+  tmPrint("Requests          : %d (%s)", nRepeat,
+          reconnect == TRUE ? "one connection each"
+                            : "one connection");
+  tmPrint("Latency min       : %.3f ms", 1.0E3 * times[0]);
+  tmPrint("Latency median    : %.3f ms", 1.0E3 * times[nRepeat/2]);
+  tmPrint("Latency mean      : %.3f ms", 1.0E3 * t_sum / nRepeat);
+  tmPrint("Latency p99       : %.3f ms",
+          1.0E3 * times[(int) (0.99 * (nRepeat-1))]);
+  tmPrint("Latency max       : %.3f ms", 1.0E3 * times[nRepeat-1]);
+  tmPrint("----------------------------------------------");
+
+  tmClientMesh_free(&mesh);
+  tmShm_unmap(&shm);
+  tmClient_destroy(client);
+  free(times);
+  free(para);
+
+  return 0;
+
+error:
+  tmClientMesh_free(&mesh);
+  tmShm_unmap(&shm);
+  tmClient_destroy(client);
+  free(times);
+  free(para);
+
+  return 1;
+
+}
@@ -1,143 +1,656 @@
+#define _POSIX_C_SOURCE 200809L
+#define _GNU_SOURCE /* struct ucred of SO_PEERCRED */
+
 #include "tmesh/tmParam.h"
 #include "tmesh/tmNode.h"
 #include "tmesh/tmEdge.h"
 #include "tmesh/tmTri.h"
 #include "tmesh/tmBdry.h"
 #include "tmesh/tmMesh.h"
+#include "tmesh/tmMeshIO.h"
+#include "tmesh/tmRenumber.h"
 #include "tmesh/tmQtree.h"
 #include "tmesh/tmFront.h"
 #include "tmesh/tmList.h"
+#include "tmesh/tmWriter.h"
+#include "tmesh/tmCache.h"
+#include "tmesh/tmPool.h"
+#include "tmesh/tmClient.h"
+#include "tmesh/tmShm.h"
+#include "tmesh/tmAtomic.h"
 
-#include "tmesh/tinyexpr.h"
+#include "tmesh/tmExpr.h"
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <glob.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <time.h>
 
 
-tmDouble x, y;
-te_variable vars[] = {{"x", &x}, {"y", &y}};
-te_expr *expr;
+/*************************************************************
+* The size function expression is compiled to a bytecode, 
+* whose evaluation has no shared state, hence it may be 
+* evaluated concurrently by the subdomain meshes.
+* The compiled expression is passed as context of the mesh.
+*************************************************************/
+static tmDouble sizeFun( void *ctx, tmDouble xy[2] )
+{
+  return tmExpr_eval((const tmExpr*) ctx, xy);
+}
 
-static inline tmDouble sizeFun( tmDouble xy[2] )
+static void sizeFunBatch( void *ctx, int n, 
+                          tmDouble (*xy)[2], tmDouble *out )
 {
-  x = xy[0];
-  y = xy[1];
-  return te_eval(expr);
+  const tmExpr *expr = (const tmExpr*) ctx;
+  int i;
+
+  if ( tmExpr_evalBatch(expr, n, (const tmDouble (*)[2]) xy, out) )
+    return;
+
+  for (i = 0; i < n; i++)
+    out[i] = tmExpr_eval(expr, xy[i]);
 }
 
 
 /*************************************************************
-* 
+* Mesh output formats
 *************************************************************/
-int main(int argc, char *argv[])
+enum { OUTPUT_TEXT, OUTPUT_BINARY, OUTPUT_VTU, OUTPUT_MSH, OUTPUT_SHM };
+
+static const char *const outputNames[] = { "text", "binary", "vtu", "msh", 
+                                           "shm" };
+
+/*************************************************************
+* Parameters, which do not change the mesh output and are
+* not part of the mesh cache key. Lines are skipped, if they
+* contain one of these names anywhere, which is the rule of
+* tmParamFile_extractParam().
+*************************************************************/
+static const char *const cacheIgnoredParams[] = { 
+  "Output file:", "Binary output file:", "VTU output file:",
+  "MSH output file:", "Shared memory output:", "Cache directory:", 
+  "Cache size limit:", NULL };
+
+/*************************************************************
+* Computes the mesh cache key from the parameter file, 
+* without comments, empty lines and repeated whitespace,
+* and the output format
+*************************************************************/
+static tmBool hashParams(tmCache     *cache, 
+                         tmParamFile *file,
+                         int          format)
 {
-  if (argc < 2)
+  const char *pos = file->data;
+  const char *end = file->data + file->length;
+  const char *src;
+  char       *line = NULL;
+  long        len, k;
+  int         j, n;
+
+  while ( tmParam_nextLine(&pos, end, &src, &len) == TRUE )
   {
-    tmPrint("tmesh <Input-File>");
-    return 0;
+    while ( len > 0 && isspace((unsigned char) *src) )
+    {
+      src++;
+      len--;
+    }
+
+    if ( len == 0 )
+      continue;
+
+    for (j = 0; cacheIgnoredParams[j] != NULL; j++)
+      if ( tmParam_findStr(src, len, cacheIgnoredParams[j]) != NULL )
+        break;
+
+    if ( cacheIgnoredParams[j] != NULL )
+      continue;
+
+    line = (char*) malloc(len + 2);
+    check_mem(line);
+
+    n = 0;
+    for (k = 0; k < len; k++)
+    {
+      if ( !isspace((unsigned char) src[k]) )
+        line[n++] = src[k];
+      else if ( k+1 < len && !isspace((unsigned char) src[k+1]) )
+        line[n++] = ' ';
+    }
+    line[n++] = '\n';
+
+    check( tmCache_updateKey(cache, line, n) == TRUE,
+        "Failed to hash the parameters.");
+    free(line);
+    line = NULL;
   }
 
-  char *input = argv[1];
-  tmParam *file;
-  
-  int i,j;
+  check( tmCache_updateKey(cache, outputNames[format], 
+                           strlen(outputNames[format])) == TRUE,
+      "Failed to hash the parameters.");
+
+  return TRUE;
+
+error:
+  free(line);
+  return FALSE;
+}
+
+/*************************************************************
+* Writes the mesh in the given format to path or in text 
+* format to the standard output, if path is NULL
+*************************************************************/
+static tmBool writeMesh(tmMesh *mesh, int format, const char *path)
+{
+  tmWriter *writer;
+
+  if ( path == NULL )
+  {
+    tmMesh_printMeshIncomflow(mesh);
+    return TRUE;
+  }
+
+  if ( format == OUTPUT_BINARY )
+    return tmMesh_writeBinary(mesh, path);
+  if ( format == OUTPUT_VTU )
+    return tmMesh_writeVTU(mesh, path);
+  if ( format == OUTPUT_MSH )
+    return tmMesh_writeMSH(mesh, path);
+  if ( format == OUTPUT_SHM )
+    return tmShm_export(mesh, path);
+
+  writer = tmWriter_open(path);
+  check( writer != NULL, "Failed to open output file.");
+  tmMesh_writeMeshIncomflow(mesh, writer);
+  check( tmWriter_destroy(writer) == TRUE, 
+      "Failed to write output file.");
+
+  return TRUE;
+
+error:
+  return FALSE;
+}
+
+/*************************************************************
+* File extensions of the output formats in batch mode
+*************************************************************/
+static const char *const outputExts[] = { "txt", "bin", "vtu", "msh", "" };
+
+/*************************************************************
+* MeshJob: Meshing of a single parameter file
+*************************************************************/
+typedef struct MeshJob {
+
+  const char *input;   /* Parameter file                    */
+  const char *data;    /* Parameter file content or NULL    */
+  long        length;  /* Length of the content             */
+  tmWriter   *writer;  /* Binary mesh output or NULL        */
+  const char *shm;     /* Shared memory output or NULL      */
+  char       *name;    /* Output file name in batch mode    */
+  int         status;  /* 0 on success                      */
+  tmBool      cached;  /* Mesh was taken from the cache     */
+  int         no_tris; /* Number of elements                */
+  long        mem;     /* Estimated memory in bytes         */
+  double      time;    /* Wall time in seconds              */
+
+} MeshJob;
+
+/*************************************************************
+* MeshBatch: Jobs of the batch mode, which are processed
+*            by a pool of workers within a shared memory
+*            budget
+*************************************************************/
+typedef struct MeshBatch {
+
+  MeshJob    *jobs;
+  int         n_jobs;
+  const char *outDir;
+  tmBool      useCache;
+
+  long        budget;  /* Memory budget in bytes            */
+  long        used;    /* Memory of the running jobs        */
+  int         maxDomains; /* Subdomains per job (0: any)    */
+
+  pthread_mutex_t lock;
+  pthread_cond_t  cond;
 
-  tmSizeFunUser sizeFunUser;
+} MeshBatch;
 
+/*************************************************************
+* Returns the elapsed wall time in seconds
+*************************************************************/
+static double wallTime(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double) ts.tv_sec + 1.0E-9 * (double) ts.tv_nsec;
+}
+
+/*************************************************************
+* Estimates the memory of a mesh from the number of
+* elements of the bounding box. The element density is 
+* taken from the global element size or, if a size function 
+* is given, from its mean over the nodes of the boundaries.
+* Refinements of the boundary edges and the interior 
+* extrema of the size function are not accounted for.
+*************************************************************/
+static long estimateMemory(tmDouble globSize, tmDouble *bbox,
+                           const tmExpr *expr, 
+                           tmParamFile *file)
+{
+  tmDouble area = (bbox[2] - bbox[0]) * (bbox[3] - bbox[1]);
+  tmDouble density = 0.0;
+  tmDouble n_tris;
+  int i, n = 0;
+
+  if ( expr != NULL )
+  {
+    for (i = 0; i < file->nNodes; i++)
+    {
+      tmDouble h = tmExpr_eval(expr, file->nodes[i]);
+
+      if ( h > 0.0 )
+      {
+        density += 1.0 / ( h * h );
+        n += 1;
+      }
+    }
+  }
+
+  if ( n > 0 )
+    density /= (tmDouble) n;
+  else if ( globSize > 0.0 )
+    density = 1.0 / ( globSize * globSize );
+
+  if ( density <= 0.0 || area <= 0.0 )
+    return TM_BATCH_JOB_BYTES;
+
+  n_tris = 4.0 * area * density / sqrt(3.0);
+
+  if ( n_tris > 1.0E15 / TM_BATCH_TRI_BYTES )
+    n_tris = 1.0E15 / TM_BATCH_TRI_BYTES;
+
+  return TM_BATCH_JOB_BYTES + (long) (n_tris * TM_BATCH_TRI_BYTES);
+}
+
+/*************************************************************
+* Waits until the memory of a job fits into the budget.
+* A job, which exceeds the budget alone, is run once
+* no other job is running.
+*************************************************************/
+static void acquireMemory(MeshBatch *batch, long mem)
+{
+  pthread_mutex_lock(&batch->lock);
+
+  while ( batch->used > 0 && batch->used + mem > batch->budget )
+    pthread_cond_wait(&batch->cond, &batch->lock);
+
+  batch->used += mem;
+
+  pthread_mutex_unlock(&batch->lock);
+}
+
+static void releaseMemory(MeshBatch *batch, long mem)
+{
+  pthread_mutex_lock(&batch->lock);
+
+  batch->used -= mem;
+  pthread_cond_broadcast(&batch->cond);
+
+  pthread_mutex_unlock(&batch->lock);
+}
+
+/*************************************************************
+* Meshes the parameter file of a job.
+* If batch is NULL, the mesh is written to the output
+* defined in the parameter file and a summary is printed.
+* Otherwise, the memory of the job is taken from the
+* batch budget and the mesh is written to the output 
+* directory of the batch, in binary format to the 
+* writer of the job or to its shared memory segment.
+* The function has no shared state, hence jobs may be
+* processed concurrently.
+*************************************************************/
+static int meshFile(MeshJob *job, tmBool useCache, MeshBatch *batch)
+{
+  int i,j;
+
+  tmParamFile *file = NULL;
   tmDouble  globSize;
   tmDouble *globBbox = NULL;
+  int       nBbox;
   int       qtreeSize;
-  bstring   sizeFunExpr;
-
-  tmDouble (*nodes)[2] = NULL;
-  int        nNodes;
+  int       nThreads;
+  int       nDomains;
+  int       speculative;
+  tmDouble *symLine = NULL;
+  int       nSymLine = 0;
+  tmDouble *symRot = NULL;
+  int       nSymRot = 0;
+  tmDouble *tiling = NULL;
+  int       nTiling = 0;
+  int       nSmoothIter;
+  bstring   sizeFunExpr = NULL;
+  tmExpr   *expr = NULL;
+  bstring   binFile = NULL;
+  bstring   vtuFile = NULL;
+  bstring   mshFile = NULL;
+  bstring   shmName = NULL;
+  bstring   outFile = NULL;
+  bstring   renumbering = NULL;
+  bstring   subdivision = NULL;
+  bstring   cacheDir = NULL;
+  int       cacheSize;
+  tmCache  *cache = NULL;
+  int         outFormat = OUTPUT_TEXT;
+  const char *outPath   = NULL;
+  char       *batchPath = NULL;
+  tmBool      verbose   = ( batch == NULL );
+  tmMesh     *mesh      = NULL;
+  tmNode    **nodes_ptr = NULL;
+  long        mem       = 0;
+  double      t_0       = wallTime();
 
-  int     (*extBdryEdges)[2]  = NULL;
-  int      *extBdryEdgeMarker = NULL;
-  tmDouble *extBdryRefinement = NULL;
-  int       nExtBdryEdges;
-  int       extBdryMarker;
-
-  int     (**intrEdges)[2] = NULL;
-  int      **intrEdgeMarkers = NULL;
-  tmDouble **intrEdgeRefinements = NULL;
-  int       *nIntrEdges = NULL;
-  int       *intrBdryMarkers = NULL;
-  int        nIntrBdrys = 0;
-    
+  job->status  = 1;
+  job->cached  = FALSE;
+  job->no_tris = 0;
+  job->mem     = 0;
 
   /*----------------------------------------------------------
-  | Load parameter file and clear comments
+  | Map the parameter file and read its nodes and boundaries
   ----------------------------------------------------------*/
-  struct bstrList *buf;
-
-  file = tmParam_create( input );
-  buf  = tmParam_removeComments(file->txtlist, "#");
-  bstrListDestroy(file->txtlist);
-  file->txtlist = buf;
+  if ( job->data != NULL )
+    file = tmParamFile_createFromString( job->data, job->length );
+  else
+    file = tmParamFile_create( job->input );
+  check( file != NULL, "Failed to read parameter file %s", job->input);
 
   /*----------------------------------------------------------
   | Extract mandatory meshing parameters
   ----------------------------------------------------------*/
-  check( tmParam_extractParam(file->txtlist, 
+  check( tmParamFile_extractParam(file, 
        "Global element size:", 1, &globSize) != 0,
       "Missing parameter <Global element size:>");
 
-  check( tmParam_extractArray(file->txtlist,
-        "Mesh bounding box:", 1, &globBbox)  != 0,
+  check( tmParamFile_extractArray(file,
+        "Mesh bounding box:", 1, &globBbox, &nBbox) > 0 
+        && nBbox == 4,
       "Missing parameter <Mesh bounding box:>");
 
   /*----------------------------------------------------------
   | Extract optional meshing parameters
   ----------------------------------------------------------*/
-  if ( tmParam_extractParam(file->txtlist, 
+  if ( tmParamFile_extractParam(file, 
        "Number of quadtree elements:", 0, &qtreeSize) == 0 )
   {
     qtreeSize = 100;
   }
 
-  if ( tmParam_extractParam(file->txtlist,
-       "Size function:", 2, &sizeFunExpr) != 0 )
+  if ( tmParamFile_extractParam(file, 
+       "Number of threads:", 0, &nThreads) == 0 )
   {
-    int err;
-    expr = te_compile(sizeFunExpr->data, vars, 2, &err);
-    check(err == 0, "Wrong size function definition");
-    tmPrint("SIZE FUNCTION: %s", sizeFunExpr->data);
-    sizeFunUser = sizeFun;
+    nThreads = 1;
   }
-  else {
-    sizeFunExpr = NULL;
-    sizeFunUser = NULL;
+
+  if ( tmParamFile_extractParam(file, 
+       "Number of subdomains:", 0, &nDomains) == 0 )
+  {
+    nDomains = 1;
   }
 
   /*----------------------------------------------------------
-  | Extract node definitions
+  | Batch jobs run concurrently, hence each job is meshed 
+  | by a single thread. The daemon also limits the number 
+  | of subdomains of its requests.
   ----------------------------------------------------------*/
-  tmParam_readNodeCoords(file->txtlist, &nodes, &nNodes);
+  if ( batch != NULL )
+    nThreads = 1;
+
+  if ( batch != NULL && batch->maxDomains > 0 )
+    nDomains = MIN(nDomains, batch->maxDomains);
+
+  if ( tmParamFile_extractParam(file, 
+       "Speculative advancing front:", 0, &speculative) == 0 )
+  {
+    speculative = 0;
+  }
+
+  if ( tmParamFile_extractArray(file,
+       "Symmetry line:", 1, &symLine, &nSymLine) > 0 )
+  {
+    check( nSymLine == 3, 
+        "Wrong definition of parameter <Symmetry line:>");
+  }
+
+  if ( tmParamFile_extractArray(file,
+       "Rotational symmetry:", 1, &symRot, &nSymRot) > 0 )
+  {
+    check( (nSymRot == 3 || nSymRot == 4) && symRot[2] >= 1.0, 
+        "Wrong definition of parameter <Rotational symmetry:>");
+  }
+
+  if ( tmParamFile_extractArray(file,
+       "Periodic tiling:", 1, &tiling, &nTiling) > 0 )
+  {
+    check( nTiling == 2 && tiling[0] >= 1.0 && tiling[1] >= 1.0, 
+        "Wrong definition of parameter <Periodic tiling:>");
+  }
+
+  if ( tmParamFile_extractParam(file, 
+       "Smoothing iterations:", 0, &nSmoothIter) == 0 )
+  {
+    nSmoothIter = 0;
+  }
+
+  if ( tmParamFile_extractParam(file,
+       "Binary output file:", 2, &binFile) == 0 )
+  {
+    binFile = NULL;
+  }
+  else
+    btrimws(binFile);
+
+  if ( tmParamFile_extractParam(file,
+       "VTU output file:", 2, &vtuFile) == 0 )
+  {
+    vtuFile = NULL;
+  }
+  else
+    btrimws(vtuFile);
+
+  if ( tmParamFile_extractParam(file,
+       "MSH output file:", 2, &mshFile) == 0 )
+  {
+    mshFile = NULL;
+  }
+  else
+    btrimws(mshFile);
+
+  if ( tmParamFile_extractParam(file,
+       "Shared memory output:", 2, &shmName) == 0 )
+  {
+    shmName = NULL;
+  }
+  else
+    btrimws(shmName);
+
+  if ( tmParamFile_extractParam(file,
+       "Output file:", 2, &outFile) == 0 )
+  {
+    outFile = NULL;
+  }
+  else
+    btrimws(outFile);
+
+  if ( tmParamFile_extractParam(file,
+       "Renumbering:", 2, &renumbering) == 0 )
+  {
+    renumbering = NULL;
+  }
+  else
+    btrimws(renumbering);
+
+  if ( tmParamFile_extractParam(file,
+       "Edge subdivision:", 2, &subdivision) == 0 )
+  {
+    subdivision = NULL;
+  }
+  else
+    btrimws(subdivision);
+
+  if ( tmParamFile_extractParam(file,
+       "Cache directory:", 2, &cacheDir) == 0 )
+  {
+    cacheDir = NULL;
+  }
+  else
+    btrimws(cacheDir);
+
+  if ( tmParamFile_extractParam(file, 
+       "Cache size limit:", 0, &cacheSize) == 0 )
+  {
+    cacheSize = TM_CACHE_MAX_MB;
+  }
+
+  if ( binFile != NULL )
+  {
+    outFormat = OUTPUT_BINARY;
+    outPath   = (const char*) binFile->data;
+  }
+  else if ( vtuFile != NULL )
+  {
+    outFormat = OUTPUT_VTU;
+    outPath   = (const char*) vtuFile->data;
+  }
+  else if ( mshFile != NULL )
+  {
+    outFormat = OUTPUT_MSH;
+    outPath   = (const char*) mshFile->data;
+  }
+  else if ( shmName != NULL )
+  {
+    outFormat = OUTPUT_SHM;
+    outPath   = (const char*) shmName->data;
+  }
+  else if ( outFile != NULL )
+    outPath   = (const char*) outFile->data;
 
   /*----------------------------------------------------------
-  | Extract exterior boundary definition
+  | In batch mode, the mesh is written in the format of the
+  | parameter file to the output directory, shared memory 
+  | segments are named after the job
   ----------------------------------------------------------*/
-  tmParam_readExtBdryData(file->txtlist,
-                          &extBdryEdges, 
-                          &extBdryEdgeMarker, 
-                          &extBdryRefinement, 
-                          &nExtBdryEdges, 
-                          &extBdryMarker);
+  if ( batch != NULL && batch->outDir != NULL && 
+       outFormat == OUTPUT_SHM )
+  {
+    batchPath = (char*) malloc( strlen(job->name) + 2 );
+    check_mem(batchPath);
+    sprintf(batchPath, "/%s", job->name);
+    outPath = batchPath;
+  }
+  else if ( batch != NULL && batch->outDir != NULL )
+  {
+    batchPath = (char*) malloc( strlen(batch->outDir)
+                              + strlen(job->name) + 8 );
+    check_mem(batchPath);
+    sprintf(batchPath, "%s/%s.%s", batch->outDir, job->name,
+            outputExts[outFormat]);
+    outPath = batchPath;
+  }
+
+  /*----------------------------------------------------------
+  | Return a previously generated mesh from the cache, 
+  | which only holds files
+  ----------------------------------------------------------*/
+  if ( cacheDir != NULL && useCache == TRUE && 
+       outFormat != OUTPUT_SHM )
+  {
+    char key[17];
+
+    cache = tmCache_create((const char*) cacheDir->data, 
+                           (long) cacheSize * 1024 * 1024);
+
+    if ( cache != NULL && 
+         hashParams(cache, file, outFormat) == FALSE )
+    {
+      tmCache_destroy(cache);
+      cache = NULL;
+    }
+
+    if ( cache != NULL )
+    {
+      tmCache_key(cache, key);
+
+      if ( tmCache_fetch(cache, outPath) == TRUE )
+      {
+        if ( verbose == TRUE )
+          tmPrint("MESH CACHE HIT: %s", key);
+
+        tmCache_destroy(cache);
+        free(globBbox);
+        free(symLine);
+        free(symRot);
+        free(tiling);
+        free(batchPath);
+        bdestroy(binFile);
+        bdestroy(vtuFile);
+        bdestroy(mshFile);
+        bdestroy(shmName);
+        bdestroy(outFile);
+        bdestroy(renumbering);
+        bdestroy(subdivision);
+        bdestroy(cacheDir);
+        tmParamFile_destroy( file );
+
+        job->status = 0;
+        job->cached = TRUE;
+        job->time   = wallTime() - t_0;
+
+        return 0;
+      }
+
+      if ( verbose == TRUE )
+        tmPrint("MESH CACHE MISS: %s", key);
+    }
+  }
+
+  if ( tmParamFile_extractParam(file,
+       "Size function:", 2, &sizeFunExpr) != 0 )
+  {
+    int err;
+    expr = tmExpr_compile((const char*) sizeFunExpr->data, &err);
+    check(err == 0, "Wrong size function definition");
+
+    if ( verbose == TRUE )
+      tmPrint("SIZE FUNCTION: %s", sizeFunExpr->data);
+  }
+  else
+    sizeFunExpr = NULL;
+
+  check( file->hasExtBdry == TRUE, 
+      "Missing exterior boundary definition.");
 
   /*----------------------------------------------------------
-  | Extract interior boundary definitions
+  | Wait for the memory of the mesh in batch mode
   ----------------------------------------------------------*/
-  tmParam_readIntBdryData(file->txtlist,
-                          &intrEdges, 
-                          &intrEdgeMarkers,
-                          &intrEdgeRefinements,
-                          &nIntrEdges, 
-                          &intrBdryMarkers,
-                          &nIntrBdrys);
+  job->mem = estimateMemory(globSize, globBbox, expr, file);
+
+  if ( batch != NULL )
+  {
+    acquireMemory(batch, job->mem);
+    mem = job->mem;
+  }
 
   /*----------------------------------------------------------
   | Build the mesh
@@ -145,45 +658,68 @@ int main(int argc, char *argv[])
   tmDouble xyMin[2] = { globBbox[0], globBbox[1] };
   tmDouble xyMax[2] = { globBbox[2], globBbox[3] };
 
-  tmMesh *mesh = tmMesh_create(xyMin, xyMax, 
-                               qtreeSize, 
-                               globSize,
-                               sizeFunUser);
+  mesh = tmMesh_create(xyMin, xyMax, 
+                       qtreeSize, 
+                       globSize,
+                       NULL);
+
+  tmMesh_setThreads(mesh, nThreads);
+  tmMesh_setVerbose(mesh, verbose);
+
+  if ( expr != NULL )
+  {
+    tmMesh_setSizeFunCtx(mesh, sizeFun, expr);
+    tmMesh_setSizeFunBatch(mesh, sizeFunBatch);
+  }
+
+  if ( subdivision != NULL )
+  {
+    check( biseqcstrcaseless(subdivision, "bisection") ||
+           biseqcstrcaseless(subdivision, "integral"),
+        "Invalid parameter <Edge subdivision:>, use bisection or integral");
+
+    if ( biseqcstrcaseless(subdivision, "integral") )
+      tmMesh_setSubdivision(mesh, TM_SUBDIVIDE_INTEGRAL);
+  }
 
 
   /*----------------------------------------------------------
   | Add nodes to the mesh
   ----------------------------------------------------------*/
-  tmNode **nodes_ptr = calloc(nNodes, sizeof(tmNode*));
+  const int nNodes = file->nNodes;
   tmNode  *newNode;
 
+  nodes_ptr = calloc(nNodes, sizeof(tmNode*));
+  check_mem(nodes_ptr);
+
   for (i = 0; i < nNodes; i++)
   {
-    newNode = tmNode_create(mesh, nodes[i]);
+    newNode = tmNode_create(mesh, file->nodes[i]);
     nodes_ptr[i] = newNode;
   }
 
   /*----------------------------------------------------------
   | Add exterior boundary to the mesh
   ----------------------------------------------------------*/
-  tmEdge *bdryEdge;
-  tmBdry *bdry_ext = tmMesh_addBdry(mesh, 
-                                    FALSE, 
-                                    extBdryMarker);
+  tmEdge      *bdryEdge;
+  tmParamBdry *extBdry  = &file->extBdry;
+  tmBdry      *bdry_ext = tmMesh_addBdry(mesh, 
+                                         FALSE, 
+                                         extBdry->marker);
 
-  for (i = 0; i < nExtBdryEdges; i++)
+  for (i = 0; i < extBdry->nEdges; i++)
   {
-    int i0 = extBdryEdges[i][0];
-    int i1 = extBdryEdges[i][1];
+    int i0 = extBdry->edges[i][0];
+    int i1 = extBdry->edges[i][1];
 
-    check( i0 < nNodes && i1 < nNodes,
+    check( i0 >= 0 && i1 >= 0 && i0 < nNodes && i1 < nNodes,
         "Defined nodes do not fit to exterior boundary definition.");
 
     bdryEdge = tmBdry_edgeCreate(bdry_ext, 
                                  nodes_ptr[i0],
                                  nodes_ptr[i1],
-                                 extBdryEdgeMarker[i],
-                                 extBdryRefinement[i]);
+                                 extBdry->edgeMarker[i],
+                                 extBdry->edgeRefine[i]);
   }
 
 
@@ -191,79 +727,162 @@ int main(int argc, char *argv[])
   | Add interior boundaries to the mesh
   ----------------------------------------------------------*/
   tmBdry *bdry_int;
-  for (j = 0; j < nIntrBdrys; j++)
+  for (j = 0; j < file->nIntBdrys; j++)
   {
+    tmParamBdry *intBdry = &file->intBdrys[j];
+
     bdry_int = tmMesh_addBdry(mesh, 
                               TRUE, 
-                              intrBdryMarkers[j]);
+                              intBdry->marker);
 
-    for (i = 0; i < nIntrEdges[j]; i++)
+    for (i = 0; i < intBdry->nEdges; i++)
     {
-      int i0 = intrEdges[j][i][0];
-      int i1 = intrEdges[j][i][1];
+      int i0 = intBdry->edges[i][0];
+      int i1 = intBdry->edges[i][1];
 
-      check( i0 < nNodes && i1 < nNodes,
+      check( i0 >= 0 && i1 >= 0 && i0 < nNodes && i1 < nNodes,
           "Defined nodes do not fit to interior boundary with marker %d.",
-          intrBdryMarkers[j]);
+          intBdry->marker);
 
       bdryEdge = tmBdry_edgeCreate(bdry_int, 
                                    nodes_ptr[i0],
                                    nodes_ptr[i1],
-                                   intrEdgeMarkers[j][i],
-                                   intrEdgeRefinements[j][i]);
+                                   intBdry->edgeMarker[i],
+                                   intBdry->edgeRefine[i]);
     }
   }
 
   /*--------------------------------------------------------
   | Create mesh
   --------------------------------------------------------*/
-  clock_t tic_1 = clock();
-  tmMesh_ADFMeshing(mesh);
-  clock_t tic_2 = clock();
+  double tic_1 = wallTime();
+
+  if ( tiling != NULL )
+    tmMesh_ADFMeshingPeriodic(mesh, (int) tiling[0], (int) tiling[1]);
+  else if ( symLine != NULL )
+    tmMesh_ADFMeshingSymmetric(mesh, TM_SYMMETRY_MIRROR, symLine,
+                               symLine[2] * PI_D / 180.0, 0);
+  else if ( symRot != NULL )
+    tmMesh_ADFMeshingSymmetric(mesh, TM_SYMMETRY_ROTATION, symRot,
+        (nSymRot > 3) ? symRot[3] * PI_D / 180.0 : 0.0,
+        (int) symRot[2]);
+  else if ( nDomains > 1 )
+    tmMesh_ADFMeshingParallel(mesh, nDomains);
+  else if ( speculative > 0 )
+    tmMesh_ADFMeshingSpeculative(mesh);
+  else
+    tmMesh_ADFMeshing(mesh);
+
+  check( mesh->no_tris > 0 && mesh->front->no_edges == 0, 
+      "Failed to mesh the domain.");
+
+  /*--------------------------------------------------------
+  | Optimize mesh quality
+  --------------------------------------------------------*/
+  if ( nSmoothIter > 0 )
+  {
+    tmMesh_smooth(mesh, nSmoothIter);
+    tmMesh_delaunayFlip(mesh);
+  }
+  double tic_2 = wallTime();
+
+  /*--------------------------------------------------------
+  | Renumber the mesh for the cache locality of solvers
+  --------------------------------------------------------*/
+  if ( renumbering != NULL )
+  {
+    int  method = TM_RENUMBER_NONE;
+    long bw_0, pr_0, bw_1, pr_1;
+
+    if ( biseqcstrcaseless(renumbering, "hilbert") )
+      method = TM_RENUMBER_HILBERT;
+    else if ( biseqcstrcaseless(renumbering, "rcm") )
+      method = TM_RENUMBER_RCM;
+
+    check( method != TM_RENUMBER_NONE,
+        "Invalid parameter <Renumbering:>, use hilbert or rcm");
+
+    check( tmMesh_calcBandwidth(mesh, &bw_0, &pr_0) == TRUE &&
+           tmMesh_renumber(mesh, method) == TRUE &&
+           tmMesh_calcBandwidth(mesh, &bw_1, &pr_1) == TRUE,
+        "Failed to renumber the mesh.");
+
+    if ( verbose == TRUE )
+      tmPrint("Renumbering (%s): bandwidth %ld -> %ld, "
+              "profile %ld -> %ld", renumbering->data, 
+              bw_0, bw_1, pr_0, pr_1);
+  }
 
   /*--------------------------------------------------------
   | Print the mesh data 
   --------------------------------------------------------*/
   //tmMesh_printMesh(mesh);
-  tmMesh_printMeshIncomflow(mesh);
+  if ( job->shm != NULL )
+  {
+    check( tmShm_export(mesh, job->shm) == TRUE,
+        "Failed to export the mesh.");
+  }
+  else if ( job->writer != NULL )
+  {
+    check( tmMesh_writeBinaryTo(mesh, job->writer) == TRUE,
+        "Failed to write the mesh.");
+  }
+  else if ( cache != NULL )
+  {
+    check( writeMesh(mesh, outFormat, tmCache_tmpPath(cache)) == TRUE,
+        "Failed to write the mesh to the cache.");
+    check( tmCache_store(cache) == TRUE && 
+           tmCache_fetch(cache, outPath) == TRUE,
+        "Failed to write the mesh from the cache.");
+  }
+  else
+    check( writeMesh(mesh, outFormat, outPath) == TRUE,
+        "Failed to write the mesh.");
 
 
-  tmPrint("----------------------------------------------\n");
-  tmPrint("TMesh finished\n");
-  tmPrint("----------------------------------------------\n");
-  tmPrint("Number of elements: %d\n", mesh->no_tris);
-  tmPrint("Meshing time      : %e sec\n", 
-      (double) (tic_2 - tic_1) / CLOCKS_PER_SEC );
-  tmPrint("----------------------------------------------\n");
+  if ( verbose == TRUE )
+  {
+    tmPrint("----------------------------------------------\n");
+    tmPrint("TMesh finished\n");
+    tmPrint("----------------------------------------------\n");
+    tmPrint("Number of elements: %d\n", mesh->no_tris);
+    tmPrint("Meshing time      : %e sec\n", tic_2 - tic_1);
+    tmPrint("Saved size evals  : %ld\n", mesh->n_size_saved);
+    tmPrint("----------------------------------------------\n");
+  }
+
+  job->no_tris = mesh->no_tris;
 
   tmMesh_destroy(mesh);
 
+  if ( mem > 0 )
+    releaseMemory(batch, mem);
+
 
 
-  te_free(expr);
+  tmExpr_destroy(expr);
   free(globBbox);
+  free(symLine);
+  free(symRot);
+  free(tiling);
+  free(batchPath);
   bdestroy(sizeFunExpr);
+  bdestroy(binFile);
+  bdestroy(vtuFile);
+  bdestroy(mshFile);
+  bdestroy(shmName);
+  bdestroy(outFile);
+  bdestroy(renumbering);
+  bdestroy(subdivision);
+  bdestroy(cacheDir);
+  tmCache_destroy(cache);
 
-  free(nodes);
   free(nodes_ptr);
 
-  free(extBdryEdges);
-  free(extBdryEdgeMarker);
-  free(extBdryRefinement);
-
-  for (i = 0; i < nIntrBdrys; i++)
-  {
-    free(intrEdges[i]);
-    free(intrEdgeMarkers[i]);
-    free(intrEdgeRefinements[i]);
-  }
-  free(intrEdges);
-  free(intrEdgeMarkers);
-  free(intrEdgeRefinements);
-  free(nIntrEdges);
-  free(intrBdryMarkers);
+  tmParamFile_destroy( file );
 
-  tmParam_destroy( file );
+  job->status = 0;
+  job->time   = wallTime() - t_0;
 
   return 0;
 
@@ -271,30 +890,713 @@ int main(int argc, char *argv[])
 
 error:
 
-  te_free(expr);
+  if ( mesh != NULL )
+    tmMesh_destroy(mesh);
+
+  if ( mem > 0 )
+    releaseMemory(batch, mem);
+
+  tmExpr_destroy(expr);
   free(globBbox);
+  free(symLine);
+  free(symRot);
+  free(tiling);
+  free(batchPath);
   bdestroy(sizeFunExpr);
+  bdestroy(binFile);
+  bdestroy(vtuFile);
+  bdestroy(mshFile);
+  bdestroy(shmName);
+  bdestroy(outFile);
+  bdestroy(renumbering);
+  bdestroy(subdivision);
+  bdestroy(cacheDir);
+  tmCache_destroy(cache);
+
+  free(nodes_ptr);
+
+  tmParamFile_destroy( file );
 
-  free(nodes);
-  
-  free(extBdryEdges);
-  free(extBdryEdgeMarker);
-  free(extBdryRefinement);
+  job->status = 1;
+  job->time   = wallTime() - t_0;
 
-  for (i = 0; i < nIntrBdrys; i++)
+  return 1;
+
+} /* meshFile() */
+
+/*************************************************************
+* Loop body of the worker pool in batch mode
+*************************************************************/
+static void meshBatchJobs(void *data,
+                          size_t i_beg, size_t i_end,
+                          int thread_id)
+{
+  MeshBatch *batch = (MeshBatch*) data;
+  size_t     i;
+
+  (void) thread_id;
+
+  for (i = i_beg; i < i_end; i++)
+    meshFile(&batch->jobs[i], batch->useCache, batch);
+}
+
+/*************************************************************
+* Appends an input file to a growing list of inputs
+*************************************************************/
+static tmBool addInput(char ***inputs, int *n, int *n_max,
+                       const char *path)
+{
+  if ( *n == *n_max )
+  {
+    int    n_new = ( *n_max > 0 ) ? 2 * (*n_max) : 64;
+    char **tmp   = (char**) realloc(*inputs, n_new * sizeof(char*));
+    check_mem(tmp);
+    *inputs = tmp;
+    *n_max  = n_new;
+  }
+
+  (*inputs)[*n] = (char*) malloc(strlen(path) + 1);
+  check_mem((*inputs)[*n]);
+  strcpy((*inputs)[*n], path);
+  (*n)++;
+
+  return TRUE;
+
+error:
+  return FALSE;
+}
+
+/*************************************************************
+* Adds the inputs of a command line argument, which is
+* either a file, a glob pattern or a list file "@<file>"
+* with one file or pattern per line
+*************************************************************/
+static tmBool addInputs(char ***inputs, int *n, int *n_max,
+                        const char *arg, tmBool isList)
+{
+  FILE  *fp   = NULL;
+  char  *line = NULL;
+  size_t cap  = 0;
+  glob_t paths;
+  size_t k;
+
+  if ( isList == TRUE )
+  {
+    fp = fopen(arg, "r");
+    check( fp != NULL, "Failed to open input list %s", arg);
+
+    while ( getline(&line, &cap, fp) != -1 )
+    {
+      char *beg = line;
+      char *end = line + strlen(line);
+
+      while ( isspace((unsigned char) *beg) )
+        beg++;
+      while ( end > beg && isspace((unsigned char) end[-1]) )
+        end--;
+      *end = '\0';
+
+      if ( *beg == '\0' || *beg == '#' )
+        continue;
+
+      check( addInputs(inputs, n, n_max, beg, FALSE) == TRUE,
+          "Failed to read input list %s", arg);
+    }
+
+    free(line);
+    fclose(fp);
+    return TRUE;
+  }
+
+  if ( strpbrk(arg, "*?[") == NULL )
+    return addInput(inputs, n, n_max, arg);
+
+  if ( glob(arg, 0, NULL, &paths) != 0 )
+  {
+    log_warn("No input files match %s", arg);
+    return TRUE;
+  }
+
+  for (k = 0; k < paths.gl_pathc; k++)
+    if ( addInput(inputs, n, n_max, paths.gl_pathv[k]) == FALSE )
+    {
+      globfree(&paths);
+      return FALSE;
+    }
+
+  globfree(&paths);
+  return TRUE;
+
+error:
+  free(line);
+  if ( fp != NULL )
+    fclose(fp);
+  return FALSE;
+}
+
+/*************************************************************
+* Returns the output file name of an input file, which is
+* its base name without extension. Names, which are already
+* used by a previous job, are extended by the job index.
+*************************************************************/
+static char *jobName(MeshJob *jobs, int i_job, const char *input)
+{
+  const char *beg = strrchr(input, '/');
+  const char *end;
+  char       *name;
+  size_t      len;
+  int         i;
+
+  beg = ( beg != NULL ) ? beg + 1 : input;
+  end = strrchr(beg, '.');
+
+  if ( end == NULL || end == beg )
+    end = beg + strlen(beg);
+
+  len  = (size_t) (end - beg);
+  name = (char*) malloc(len + 16);
+  check_mem(name);
+
+  memcpy(name, beg, len);
+  name[len] = '\0';
+
+  for (i = 0; i < i_job; i++)
+    if ( strcmp(jobs[i].name, name) == 0 )
+    {
+      sprintf(name + len, "_%d", i_job + 1);
+      break;
+    }
+
+  return name;
+
+error:
+  return NULL;
+}
+
+/*************************************************************
+* Batch mode:
+* Meshes all input files concurrently in independent meshes
+* and writes them to an output directory
+*************************************************************/
+static int meshBatch(int argc, char *argv[])
+{
+  MeshBatch batch = { 0 };
+  tmPool   *pool     = NULL;
+  char    **inputs   = NULL;
+  int       n_inputs = 0;
+  int       n_max    = 0;
+  int       nWorkers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+  long      memoryMB = 0;
+  int       n_ok = 0, n_cached = 0, n_failed = 0;
+  double    t_0, t_1, t_jobs = 0.0;
+  int       i, k;
+
+  batch.outDir   = argv[2];
+  batch.useCache = TRUE;
+
+  for (k = 3; k < argc; k++)
+  {
+    if ( strcmp(argv[k], "--no-cache") == 0 )
+      batch.useCache = FALSE;
+    else if ( strcmp(argv[k], "--jobs") == 0 && k+1 < argc )
+      nWorkers = atoi(argv[++k]);
+    else if ( strcmp(argv[k], "--memory") == 0 && k+1 < argc )
+      memoryMB = atol(argv[++k]);
+    else
+    {
+      tmBool isList = ( argv[k][0] == '@' );
+      check( addInputs(&inputs, &n_inputs, &n_max,
+                       argv[k] + isList, isList) == TRUE,
+          "Failed to add the inputs of %s", argv[k]);
+    }
+  }
+
+  check( n_inputs > 0, "No input files for the batch mode.");
+  check( nWorkers > 0, "Invalid number of jobs.");
+
+  check( mkdir(batch.outDir, 0777) == 0 || errno == EEXIST,
+      "Failed to create output directory %s", batch.outDir);
+
+  /*----------------------------------------------------------
+  | The memory budget defaults to the physical memory
+  ----------------------------------------------------------*/
+  if ( memoryMB > 0 )
+    batch.budget = memoryMB * 1024 * 1024;
+  else
+    batch.budget = (long) sysconf(_SC_PHYS_PAGES)
+                 * (long) sysconf(_SC_PAGESIZE);
+
+  if ( batch.budget <= 0 )
+    batch.budget = LONG_MAX;
+
+  /*----------------------------------------------------------
+  | Create the jobs
+  ----------------------------------------------------------*/
+  batch.jobs = (MeshJob*) calloc(n_inputs, sizeof(MeshJob));
+  check_mem(batch.jobs);
+
+  for (i = 0; i < n_inputs; i++)
+  {
+    batch.jobs[i].input = inputs[i];
+    batch.jobs[i].name  = jobName(batch.jobs, i, inputs[i]);
+    check( batch.jobs[i].name != NULL, "Failed to create job.");
+    batch.n_jobs++;
+  }
+
+  if ( nWorkers > n_inputs )
+    nWorkers = n_inputs;
+
+  /*----------------------------------------------------------
+  | Process the jobs on the worker pool, where every worker
+  | fetches one job at a time
+  ----------------------------------------------------------*/
+  pthread_mutex_init(&batch.lock, NULL);
+  pthread_cond_init(&batch.cond, NULL);
+
+  t_0 = wallTime();
+
+  pool = tmPool_create(nWorkers);
+  tmPool_parallelFor(pool, (size_t) n_inputs, 1,
+                     meshBatchJobs, &batch);
+  tmPool_destroy(pool);
+
+  t_1 = wallTime();
+
+  pthread_cond_destroy(&batch.cond);
+  pthread_mutex_destroy(&batch.lock);
+
+  /*----------------------------------------------------------
+  | Print the timing summary of all jobs
+  ----------------------------------------------------------*/
+  tmPrint("----------------------------------------------");
+  tmPrint("TMesh batch finished");
+  tmPrint("----------------------------------------------");
+  tmPrint("%6s  %-7s %10s %10s %10s  %s",
+          "Job", "Status", "Elements", "Mem. [MB]", "Time [s]",
+          "Input");
+
+  for (i = 0; i < n_inputs; i++)
+  {
+    MeshJob    *job    = &batch.jobs[i];
+    const char *status = "ok";
+
+    if ( job->status != 0 )
+    {
+      status = "failed";
+      n_failed++;
+    }
+    else if ( job->cached == TRUE )
+    {
+      status = "cached";
+      n_cached++;
+    }
+    else
+      n_ok++;
+
+    t_jobs += job->time;
+
+    tmPrint("%6d  %-7s %10d %10.1f %10.4f  %s",
+            i+1, status, job->no_tris,
+            (double) job->mem / (1024.0 * 1024.0), job->time,
+            job->input);
+  }
+
+  tmPrint("----------------------------------------------");
+  tmPrint("Jobs              : %d meshed, %d cached, %d failed",
+          n_ok, n_cached, n_failed);
+  tmPrint("Workers           : %d", nWorkers);
+  tmPrint("Memory budget     : %.1f MB",
+          (double) batch.budget / (1024.0 * 1024.0));
+  tmPrint("Wall time         : %e sec", t_1 - t_0);
+  tmPrint("Sum of job times  : %e sec", t_jobs);
+  tmPrint("----------------------------------------------");
+
+  for (i = 0; i < n_inputs; i++)
+  {
+    free(batch.jobs[i].name);
+    free(inputs[i]);
+  }
+  free(batch.jobs);
+  free(inputs);
+
+  return ( n_failed > 0 ) ? 1 : 0;
+
+error:
+  if ( batch.jobs != NULL )
+    for (i = 0; i < batch.n_jobs; i++)
+      free(batch.jobs[i].name);
+  for (i = 0; i < n_inputs; i++)
+    free(inputs[i]);
+  free(batch.jobs);
+  free(inputs);
+
+  return 1;
+
+} /* meshBatch() */
+
+/*************************************************************
+* MeshServer: Daemon, whose workers accept connections on
+*             a Unix domain socket and mesh the parameter
+*             files of their requests
+*************************************************************/
+typedef struct MeshServer {
+
+  int         fd;          /* Listening socket              */
+  MeshBatch   batch;       /* Memory budget of the requests */
+  int         shutdown;    /* Set by a shutdown request     */
+  long        n_requests;  /* Number of processed requests  */
+  int         timeout;     /* Idle timeout of a connection  */
+
+  int        *clients;     /* Connection of each worker     */
+  int         n_clients;   /* or -1, guarded by lock        */
+  pthread_mutex_t lock;
+
+} MeshServer;
+
+/*************************************************************
+* Shuts the daemon down: No further connections are 
+* accepted, and the workers return, once their current 
+* request is answered. Idle connections are closed for 
+* reading, which wakes up the workers waiting on them.
+*************************************************************/
+static void stopServer(MeshServer *server)
+{
+  int i;
+
+  pthread_mutex_lock(&server->lock);
+
+  tmAtomic_storeInt(&server->shutdown, 1);
+  shutdown(server->fd, SHUT_RDWR);
+
+  for (i = 0; i < server->n_clients; i++)
+    if ( server->clients[i] >= 0 )
+      shutdown(server->clients[i], SHUT_RD);
+
+  pthread_mutex_unlock(&server->lock);
+}
+
+/*************************************************************
+* Checks, if the peer of a connection runs as the user of 
+* the daemon. Without SO_PEERCRED, no peer is trusted.
+*************************************************************/
+static tmBool isOwner(int fd)
+{
+#if defined(SO_PEERCRED)
+  struct ucred cred;
+  socklen_t    len = sizeof(cred);
+
+  if ( getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &cred, &len) != 0 )
+    return FALSE;
+
+  return ( cred.uid == geteuid() ) ? TRUE : FALSE;
+#else
+  (void) fd;
+  return FALSE;
+#endif
+}
+
+/*************************************************************
+* Processes the requests of a connection until it is closed.
+* A connection is closed after server->timeout seconds 
+* without a request, such that idle clients can not block 
+* the workers of the daemon.
+* The memory writer of the binary meshes is reused for all
+* requests of the connection. Meshes of shared memory 
+* requests are exported to the requested segment instead.
+* Only clients of the daemon's user may shut it down.
+*************************************************************/
+static void serveClient(MeshServer *server, int fd)
+{
+  static const char errMesh[]  = "Failed to mesh the parameter file.";
+  static const char errType[]  = "Invalid request.";
+  static const char errOwner[] = "Permission denied.";
+
+  tmWriter   *writer = tmWriter_create(-1);
+  MeshJob     job;
+  const char *name, *para;
+  void       *data;
+  uint64_t    len;
+  uint32_t    type;
+  tmBool      ok;
+
+  check( writer != NULL, "Failed to create writer.");
+
+  while ( tmClient_recvMsg(fd, TM_MSG_REQUEST, 
+                           &type, &data, &len) == TRUE )
+  {
+    if ( type == TM_REQUEST_SHUTDOWN )
+    {
+      free(data);
+
+      if ( isOwner(fd) == FALSE )
+      {
+        if ( tmClient_sendMsg(fd, TM_MSG_RESPONSE, TM_RESPONSE_ERROR,
+                              errOwner, sizeof(errOwner)) == FALSE )
+          break;
+        continue;
+      }
+
+      stopServer(server);
+      tmClient_sendMsg(fd, TM_MSG_RESPONSE, TM_RESPONSE_OK, NULL, 0);
+      break;
+    }
+
+    if ( type == TM_REQUEST_SHM )
+    {
+      name = (const char*) data;
+      para = (const char*) memchr(data, '\0', (size_t) len);
+      para = ( para != NULL ) ? para + 1 : NULL;
+    }
+    else
+    {
+      name = NULL;
+      para = (const char*) data;
+    }
+
+    if ( (type != TM_REQUEST_PARA && type != TM_REQUEST_SHM) 
+        || para == NULL )
+    {
+      ok = tmClient_sendMsg(fd, TM_MSG_RESPONSE, TM_RESPONSE_ERROR,
+                            errType, sizeof(errType));
+      free(data);
+
+      if ( ok == FALSE )
+        break;
+      continue;
+    }
+
+    memset(&job, 0, sizeof(MeshJob));
+    job.input  = "<request>";
+    job.data   = para;
+    job.length = (long) len - (long) (para - (const char*) data);
+    job.writer = writer;
+    job.shm    = name;
+
+    writer->n  = 0;
+    writer->ok = TRUE;
+
+    meshFile(&job, FALSE, &server->batch);
+    tmAtomic_addLong(&server->n_requests, 1);
+
+    if ( job.status == 0 && name != NULL )
+      ok = tmClient_sendMsg(fd, TM_MSG_RESPONSE, TM_RESPONSE_OK,
+                            NULL, 0);
+    else if ( job.status == 0 && writer->ok == TRUE )
+      ok = tmClient_sendMsg(fd, TM_MSG_RESPONSE, TM_RESPONSE_OK,
+                            writer->buf, writer->n);
+    else
+      ok = tmClient_sendMsg(fd, TM_MSG_RESPONSE, TM_RESPONSE_ERROR,
+                            errMesh, sizeof(errMesh));
+    free(data);
+
+    if ( ok == FALSE )
+      break;
+  }
+
+  tmWriter_destroy(writer);
+
+error:
+  return;
+}
+
+/*************************************************************
+* Loop body of the daemon's worker pool, where every worker
+* accepts connections until the daemon is shut down
+*************************************************************/
+static void serveClients(void *data,
+                         size_t i_beg, size_t i_end,
+                         int thread_id)
+{
+  MeshServer *server = (MeshServer*) data;
+  int         fd;
+
+  (void) i_beg;
+  (void) i_end;
+
+  while ( tmAtomic_loadInt(&server->shutdown) == 0 )
+  {
+    fd = accept(server->fd, NULL, NULL);
+
+    if ( fd < 0 )
+    {
+      if ( errno == EINTR || errno == ECONNABORTED )
+        continue;
+      break;
+    }
+
+    /*--------------------------------------------------------
+    | Register the connection, unless the daemon has been 
+    | shut down in the meantime
+    --------------------------------------------------------*/
+    pthread_mutex_lock(&server->lock);
+
+    if ( tmAtomic_loadInt(&server->shutdown) != 0 )
+    {
+      pthread_mutex_unlock(&server->lock);
+      close(fd);
+      break;
+    }
+
+    server->clients[thread_id] = fd;
+    pthread_mutex_unlock(&server->lock);
+
+    if ( server->timeout > 0 )
+    {
+      struct timeval tv = { server->timeout, 0 };
+      setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    }
+
+    serveClient(server, fd);
+
+    pthread_mutex_lock(&server->lock);
+    server->clients[thread_id] = -1;
+    pthread_mutex_unlock(&server->lock);
+
+    close(fd);
+  }
+}
+
+/*************************************************************
+* Daemon mode:
+* Meshes the parameter files, which are sent by clients
+* over a Unix domain socket (see tmClient.h), in a pool of 
+* workers and returns the binary meshes
+*************************************************************/
+static int meshServe(int argc, char *argv[])
+{
+  MeshServer         server   = { 0 };
+  struct sockaddr_un addr;
+  struct stat        st;
+  tmPool            *pool     = NULL;
+  const char        *path     = argv[2];
+  int                nWorkers = (int) sysconf(_SC_NPROCESSORS_ONLN);
+  long               memoryMB = 0;
+  int                k;
+
+  server.fd      = -1;
+  server.timeout = TM_SERVE_TIMEOUT;
+
+  for (k = 3; k < argc; k++)
   {
-    free(intrEdges[i]);
-    free(intrEdgeMarkers[i]);
-    free(intrEdgeRefinements[i]);
+    if ( strcmp(argv[k], "--jobs") == 0 && k+1 < argc )
+      nWorkers = atoi(argv[++k]);
+    else if ( strcmp(argv[k], "--memory") == 0 && k+1 < argc )
+      memoryMB = atol(argv[++k]);
+    else if ( strcmp(argv[k], "--timeout") == 0 && k+1 < argc )
+      server.timeout = atoi(argv[++k]);
   }
-  free(intrEdges);
-  free(intrEdgeMarkers);
-  free(intrEdgeRefinements);
-  free(nIntrEdges);
-  free(intrBdryMarkers);
 
-  tmParam_destroy( file );
+  check( nWorkers > 0, "Invalid number of jobs.");
+  check( server.timeout >= 0, "Invalid timeout.");
+  check( strlen(path) < sizeof(addr.sun_path),
+      "Socket path %s is too long", path);
+
+  if ( memoryMB > 0 )
+    server.batch.budget = memoryMB * 1024 * 1024;
+  else
+    server.batch.budget = (long) sysconf(_SC_PHYS_PAGES)
+                        * (long) sysconf(_SC_PAGESIZE);
+
+  if ( server.batch.budget <= 0 )
+    server.batch.budget = LONG_MAX;
+
+  server.batch.maxDomains = TM_SERVE_MAX_DOMAINS;
+
+  /*----------------------------------------------------------
+  | Replace the socket of a previous daemon
+  ----------------------------------------------------------*/
+  if ( lstat(path, &st) == 0 && S_ISSOCK(st.st_mode) )
+    unlink(path);
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  server.fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  check( server.fd >= 0, "Failed to create socket.");
+
+  check( bind(server.fd, (struct sockaddr*) &addr, 
+              sizeof(addr)) == 0 && 
+         listen(server.fd, SOMAXCONN) == 0,
+      "Failed to listen on %s", path);
+
+  tmPrint("TMesh daemon: listening on %s with %d workers", 
+          path, nWorkers);
+
+  /*----------------------------------------------------------
+  | Every worker of the pool serves one connection at a time
+  ----------------------------------------------------------*/
+  server.clients = (int*) malloc( nWorkers * sizeof(int) );
+  check_mem(server.clients);
+
+  for (k = 0; k < nWorkers; k++)
+    server.clients[k] = -1;
+  server.n_clients = nWorkers;
+
+  pthread_mutex_init(&server.lock, NULL);
+  pthread_mutex_init(&server.batch.lock, NULL);
+  pthread_cond_init(&server.batch.cond, NULL);
+
+  pool = tmPool_create(nWorkers);
+  check( pool != NULL, "Failed to create worker pool.");
+
+  tmPool_parallelFor(pool, (size_t) nWorkers, 1, 
+                     serveClients, &server);
+  tmPool_destroy(pool);
+
+  pthread_cond_destroy(&server.batch.cond);
+  pthread_mutex_destroy(&server.batch.lock);
+  pthread_mutex_destroy(&server.lock);
+  free(server.clients);
+
+  close(server.fd);
+  unlink(path);
+
+  tmPrint("TMesh daemon: shut down after %ld requests", 
+          server.n_requests);
+
+  return 0;
+
+error:
+  if ( server.fd >= 0 )
+    close(server.fd);
+  free(server.clients);
 
   return 1;
 
+} /* meshServe() */
+
+/*************************************************************
+*
+*************************************************************/
+int main(int argc, char *argv[])
+{
+  if ( argc >= 3 && strcmp(argv[1], "--batch") == 0 )
+    return meshBatch(argc, argv);
+
+  if ( argc >= 3 && strcmp(argv[1], "--serve") == 0 )
+    return meshServe(argc, argv);
+
+  if (argc < 2)
+  {
+    tmPrint("tmesh <Input-File> [--no-cache]");
+    tmPrint("tmesh --batch <Output-Dir> [--jobs N] [--memory MB] "
+            "[--no-cache] <Input-Files | Patterns | @List-File>...");
+    tmPrint("tmesh --serve <Socket> [--jobs N] [--memory MB] "
+            "[--timeout S]");
+    return 0;
+  }
+
+  MeshJob job = { 0 };
+  tmBool  useCache = TRUE;
+
+  for (int k = 2; k < argc; k++)
+    if ( strcmp(argv[k], "--no-cache") == 0 )
+      useCache = FALSE;
+
+  job.input = argv[1];
+
+  return meshFile(&job, useCache, NULL);
+
 }
+
@@ -0,0 +1,20 @@
+/*
+ * This source file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include "tmesh/tmAtomic.h"
+
+#if defined(TM_ATOMIC_PTHREAD)
+/**********************************************************
+* Global lock of the mutex fallback of tmAtomic.h
+**********************************************************/
+pthread_mutex_t tmAtomic_lock = PTHREAD_MUTEX_INITIALIZER;
+#else
+/**********************************************************
+* ISO C forbids an empty translation unit
+**********************************************************/
+typedef int tmAtomic_unused;
+#endif
@@ -119,6 +119,8 @@ tmEdge *tmBdry_edgeCreate(tmBdry  *bdry,
   edge->bdry_marker = marker;
   edge->sizeFac     = edgeSize;
 
+  return edge;
+
 } /*tmBdry_edgeCreate() */
 
 
@@ -137,7 +139,8 @@ tmListNode *tmBdry_addEdge(tmBdry *bdry, tmEdge *edge)
   bdry->edges_head  = edge;
 
   tmList_push(bdry->edges_stack, edge);
-  tmQtree_addObj(bdry->edges_qtree, edge);
+  if ( bdry->mesh->qtree_defer == FALSE )
+    tmQtree_addObj(bdry->edges_qtree, edge);
   edge_pos = tmList_last_node(bdry->edges_stack);
   
   return edge_pos;
@@ -376,50 +379,218 @@ tmEdge *tmBdry_splitEdge(tmBdry *bdry, tmEdge *edge)
 
 } /* tmEdge_split() */
 
+/**********************************************************
+* Function: tmBdry_subdivide()
+*----------------------------------------------------------
+* Subdivides all edges of a boundary in one pass
+* according to the integral of the size function along 
+* the edges (see tmEdge_subdivide()). 
+* The new nodes and edges are bulk-loaded into the qtrees.
+*----------------------------------------------------------
+* @param *bdry: pointer to bdry
+* @return: FALSE on errors
+**********************************************************/
+static tmBool tmBdry_subdivide(tmBdry *bdry)
+{
+  tmMesh     *mesh  = bdry->mesh;
+  tmListNode *cur;
+  tmEdge    **edges = NULL;
+  void      **nodes_new = NULL;
+  void      **edges_new = NULL;
+  int        *off   = NULL;
+  tmDouble  (*xy)[2] = NULL;
+  tmBool      success = FALSE;
+  int i, j, n = 0, n_nodes = 0, n_edges = 0;
+
+  edges = malloc( (bdry->no_edges+1) * sizeof(tmEdge*) );
+  off   = malloc( (bdry->no_edges+1) * sizeof(int) );
+  check_mem(edges);
+  check_mem(off);
+
+  for (cur = bdry->edges_stack->first; 
+       cur != NULL; cur = cur->next)
+    edges[n++] = (tmEdge*) cur->value;
+
+  check( tmEdge_subdivide(mesh, edges, n, TM_BDRY_REFINE_FAC, 
+                          off, &xy) == TRUE,
+      "Failed to subdivide the boundary edges.");
+
+  nodes_new = malloc( (off[n]+1) * sizeof(void*) );
+  edges_new = malloc( (off[n]+n+1) * sizeof(void*) );
+  check_mem(nodes_new);
+  check_mem(edges_new);
+
+  /*-------------------------------------------------------
+  | Replace every edge by a chain of new edges, which are
+  | appended to the boundary
+  -------------------------------------------------------*/
+  mesh->qtree_defer = TRUE;
+
+  for (i = 0; i < n; i++)
+  {
+    if ( off[i+1] == off[i] )
+      continue;
+
+    tmNode  *n1      = edges[i]->n1;
+    tmNode  *n2      = edges[i]->n2;
+    tmIndex  marker  = edges[i]->bdry_marker;
+    tmDouble sizeFac = edges[i]->sizeFac;
+    tmNode  *prev    = n1;
+
+    tmEdge_destroy(edges[i]);
+
+    for (j = off[i]; j <= off[i+1]; j++)
+    {
+      tmNode *next = n2;
+
+      if ( j < off[i+1] )
+      {
+        next = tmNode_create(mesh, xy[j]);
+        nodes_new[n_nodes++] = next;
+      }
+
+      edges_new[n_edges++] = tmBdry_edgeCreate(bdry, prev, next, 
+                                               marker, sizeFac);
+      prev = next;
+    }
+  }
+
+  mesh->qtree_defer = FALSE;
+
+  check( tmQtree_addObjs(mesh->nodes_qtree, nodes_new, n_nodes)
+      && tmQtree_addObjs(bdry->edges_qtree, edges_new, n_edges),
+      "Failed to add subdivided boundary edges to the qtrees.");
+
+  success = TRUE;
+
+error:
+  mesh->qtree_defer = FALSE;
+  free(edges);
+  free(off);
+  free(xy);
+  free(nodes_new);
+  free(edges_new);
+  return success;
+
+} /* tmBdry_subdivide() */
+
 /**********************************************************
 * Function: tmBdry_refine()
 *----------------------------------------------------------
 * Refine the edges of a boundary structure according to
-* a size function
+* a size function by bisection, which may be preceded by
+* a subdivision of all edges in one pass 
+* (see tmMesh_setSubdivision())
 *----------------------------------------------------------
 * @param *bdry: pointer to bdry
 * @return: 
 **********************************************************/
 void tmBdry_refine(tmBdry *bdry)
 {
+  tmMesh *mesh = bdry->mesh;
+  tmListNode *cur;
+  int i, n, n_split;
+  int size = 0;
 
-  tmListNode *cur, *nxt;
-  int counter = 0;
+  tmEdge  **edges = NULL;
+  tmDouble (*xy)[2] = NULL;
+  tmDouble *rho = NULL;
 
-  cur = nxt = bdry->edges_stack->first;
+  /*-------------------------------------------------------
+  | The one-pass subdivision uses the size function of the
+  | unrefined boundary, which depends on its edge lengths.
+  | Hence, it is followed by bisection, which splits the 
+  | remaining edges, that are too long.
+  -------------------------------------------------------*/
+  if ( mesh->subdivision == TM_SUBDIVIDE_INTEGRAL && 
+       tmBdry_subdivide(bdry) == FALSE )
+  {
+    log_warn("Failed to subdivide the boundary edges, "
+             "falling back to bisection.");
+  }
 
-  tmSizeFun sizeFun = bdry->mesh->sizeFun;
+  /*-------------------------------------------------------
+  | The edges are refined in passes: the size function
+  | is evaluated for all edges of a pass at once and the 
+  | edges, which result from splitting, are appended to 
+  | the list and form the next pass.
+  | This is the same order as walking through the list 
+  | until all edges are fine enough.
+  -------------------------------------------------------*/
+  cur = bdry->edges_stack->first;
+  n   = bdry->no_edges;
 
-  while ( counter < bdry->no_edges )
+  while ( n > 0 )
   {
-    nxt = cur->next;
+    if ( n > size )
+    {
+      size = 2 * n;
 
-    tmDouble *xy_1 = ((tmEdge*)cur->value)->n1->xy;
-    tmDouble *xy_m = ((tmEdge*)cur->value)->xy;
+      tmEdge **edges_new = realloc(edges, size * sizeof(tmEdge*));
+      check_mem(edges_new);
+      edges = edges_new;
 
-    tmDouble rho_1 = sizeFun(bdry->mesh, xy_1);
-    tmDouble rho_m = sizeFun(bdry->mesh, xy_m);
-    tmDouble rho   = TM_BDRY_REFINE_FAC * (rho_1 + rho_m);
-    check( rho > TM_MIN_SIZE,
-        "Size function return value lower than defined minimum scale.");
+      tmDouble (*xy_new)[2] = realloc(xy, 2 * size * sizeof(*xy));
+      check_mem(xy_new);
+      xy = xy_new;
 
-    if ( ((tmEdge*)cur->value)->len > rho )
-      tmBdry_splitEdge(bdry, cur->value);
-    else
-      counter += 1;
+      tmDouble *rho_new = realloc(rho, 2 * size * sizeof(tmDouble));
+      check_mem(rho_new);
+      rho = rho_new;
+    }
 
-    cur = nxt;
+    /*-----------------------------------------------------
+    | Gather the edges of this pass
+    -----------------------------------------------------*/
+    for (i = 0; i < n; i++)
+    {
+      edges[i] = (tmEdge*) cur->value;
+
+      xy[2*i  ][0] = edges[i]->n1->xy[0];
+      xy[2*i  ][1] = edges[i]->n1->xy[1];
+      xy[2*i+1][0] = edges[i]->xy[0];
+      xy[2*i+1][1] = edges[i]->xy[1];
+
+      cur = cur->next;
+    }
+
+    mesh->sizeFunBatch(mesh, 2*n, xy, rho);
+
+    /*-----------------------------------------------------
+    | Split all edges, which are too long 
+    -----------------------------------------------------*/
+    n_split = 0;
 
-    if (cur == NULL)
-      cur = bdry->edges_stack->first;
+    for (i = 0; i < n; i++)
+    {
+      tmDouble rho_e = TM_BDRY_REFINE_FAC * (rho[2*i] + rho[2*i+1]);
+      check( rho_e > TM_MIN_SIZE,
+          "Size function return value lower than defined minimum scale.");
+
+      if ( edges[i]->len > rho_e )
+      {
+        tmBdry_splitEdge(bdry, edges[i]);
+        n_split += 1;
+      }
+    }
+
+    /*-----------------------------------------------------
+    | The new edges are located at the end of the list
+    -----------------------------------------------------*/
+    n = 2 * n_split;
+
+    if ( n > 0 )
+    {
+      cur = bdry->edges_stack->last;
+      for (i = 1; i < n; i++)
+        cur = cur->prev;
+    }
   }
 
 error:
+  if (edges != NULL) free(edges);
+  if (xy    != NULL) free(xy);
+  if (rho   != NULL) free(rho);
   return;
 
 } /* tmBdry_refine() */
@@ -0,0 +1,489 @@
+/*
+ * This source file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tmCache.h"
+
+/**********************************************************
+* FNV-1a hash parameters 
+**********************************************************/
+#define TM_CACHE_FNV_BASIS ( 14695981039346656037ULL )
+#define TM_CACHE_FNV_PRIME ( 1099511628211ULL )
+
+/**********************************************************
+* Function: tmCache_create()
+*----------------------------------------------------------
+* Create a new tmCache structure for the directory dir, 
+* which is created if it does not exist
+*----------------------------------------------------------
+* @param dir: cache directory
+* @param max_bytes: size limit of all cache entries
+* @return: Pointer to a new tmCache structure or NULL,
+*          if the directory can not be used
+**********************************************************/
+tmCache *tmCache_create(const char *dir, long max_bytes)
+{
+  tmCache *cache = (tmCache*) calloc(1, sizeof(tmCache));
+  check_mem(cache);
+
+  check( mkdir(dir, 0777) == 0 || errno == EEXIST,
+      "Failed to create cache directory %s", dir);
+
+  cache->dir = (char*) malloc(strlen(dir) + 1);
+  check_mem(cache->dir);
+  strcpy(cache->dir, dir);
+
+  /*-------------------------------------------------------
+  | Path buffers for "<dir>/<key>.<pid>.<id>.tmp", where 
+  | the address of the cache structure serves as id to 
+  | distinguish concurrent caches of a process
+  -------------------------------------------------------*/
+  cache->path     = (char*) calloc(strlen(dir) + 64, sizeof(char));
+  cache->tmp_path = (char*) calloc(strlen(dir) + 64, sizeof(char));
+  check_mem(cache->path);
+  check_mem(cache->tmp_path);
+
+  cache->max_bytes = max_bytes;
+  cache->hash      = TM_CACHE_FNV_BASIS;
+
+  /*-------------------------------------------------------
+  | Entries of other library versions are never used
+  -------------------------------------------------------*/
+  check( tmCache_updateKey(cache, TM_VERSION, 
+                           strlen(TM_VERSION)) == TRUE,
+      "Failed to create the cache key.");
+
+  return cache;
+
+error:
+  tmCache_destroy(cache);
+  return NULL;
+
+} /* tmCache_create() */
+
+/**********************************************************
+* Function: tmCache_destroy()
+*----------------------------------------------------------
+* Removes an unfinished new entry and frees the memory
+* of a tmCache structure
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache to destroy
+**********************************************************/
+void tmCache_destroy(tmCache *cache)
+{
+  if ( cache == NULL )
+    return;
+
+  if ( cache->tmp_path != NULL && cache->tmp_path[0] != '\0' )
+    unlink(cache->tmp_path);
+
+  free(cache->dir);
+  free(cache->path);
+  free(cache->tmp_path);
+  free(cache->input);
+  free(cache);
+
+} /* tmCache_destroy() */
+
+/**********************************************************
+* Function: tmCache_updateKey()
+*----------------------------------------------------------
+* Adds data to the key of the current entry
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache
+* @param data, n: bytes to add
+* @return: FALSE, if the data can not be stored
+**********************************************************/
+tmBool tmCache_updateKey(tmCache *cache, const void *data, size_t n)
+{
+  const unsigned char *bytes = (const unsigned char*) data;
+  size_t i;
+
+  /*-------------------------------------------------------
+  | Keep the input for the comparison with the entries
+  -------------------------------------------------------*/
+  if ( cache->n_input + n > cache->size_input )
+  {
+    size_t size = 2 * (cache->n_input + n) + 64;
+    unsigned char *input = (unsigned char*) realloc(cache->input, 
+                                                    size);
+    check_mem(input);
+
+    cache->input      = input;
+    cache->size_input = size;
+  }
+
+  if ( n > 0 )
+    memcpy(cache->input + cache->n_input, bytes, n);
+  cache->n_input += n;
+
+  for (i = 0; i < n; i++)
+  {
+    cache->hash ^= (uint64_t) bytes[i];
+    cache->hash *= TM_CACHE_FNV_PRIME;
+  }
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmCache_updateKey() */
+
+/**********************************************************
+* Function: tmCache_key()
+*----------------------------------------------------------
+* Returns the key of the current entry as hex string
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache
+* @param key: returns the key (17 characters)
+**********************************************************/
+void tmCache_key(tmCache *cache, char key[17])
+{
+  const char *digits = "0123456789abcdef";
+  int i;
+
+  for (i = 0; i < 16; i++)
+    key[i] = digits[(cache->hash >> (60 - 4*i)) & 0xf];
+
+  key[16] = '\0';
+
+} /* tmCache_key() */
+
+/**********************************************************
+* Function: tmCache_setPath()
+*----------------------------------------------------------
+* Sets the file path of the current entry
+**********************************************************/
+static void tmCache_setPath(tmCache *cache)
+{
+  char key[17];
+
+  tmCache_key(cache, key);
+  sprintf(cache->path, "%s/%s.tmc", cache->dir, key);
+
+} /* tmCache_setPath() */
+
+/**********************************************************
+* Function: tmCache_fetch()
+*----------------------------------------------------------
+* Copies the current entry from the mapped cache file
+* to a file and marks it as used
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache
+* @param path: output file, NULL for the standard output
+* @return: FALSE, if there is no entry for the input or 
+*          the output has failed
+**********************************************************/
+tmBool tmCache_fetch(tmCache *cache, const char *path)
+{
+  struct stat st;
+  char    *data = MAP_FAILED;
+  int      fd   = -1;
+  int      out  = -1;
+  size_t   n;
+  uint64_t n_input;
+
+  tmCache_setPath(cache);
+
+  fd = open(cache->path, O_RDONLY);
+  if ( fd < 0 )
+    return FALSE;
+
+  check( fstat(fd, &st) == 0, "Failed to access %s", cache->path);
+
+  /*-------------------------------------------------------
+  | The entry must start with the input of this key
+  -------------------------------------------------------*/
+  n = sizeof(n_input) + cache->n_input;
+
+  if ( (size_t) st.st_size < n )
+  {
+    close(fd);
+    return FALSE;
+  }
+
+  data = (char*) mmap(NULL, (size_t) st.st_size, PROT_READ, 
+                      MAP_PRIVATE, fd, 0);
+  check( data != MAP_FAILED, "Failed to map %s", cache->path);
+
+  memcpy(&n_input, data, sizeof(n_input));
+
+  if ( n_input != (uint64_t) cache->n_input ||
+       memcmp(data + sizeof(n_input), cache->input, 
+              cache->n_input) != 0 )
+  {
+    log_warn("Cache entry %s belongs to another input.", 
+             cache->path);
+    munmap(data, (size_t) st.st_size);
+    close(fd);
+    return FALSE;
+  }
+
+  if ( path == NULL )
+  {
+    fflush(stdout);
+    out = STDOUT_FILENO;
+  }
+  else
+  {
+    out = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0666);
+    check( out >= 0, "Failed to open file %s", path);
+  }
+
+  while ( n < (size_t) st.st_size )
+  {
+    ssize_t m = write(out, data + n, (size_t) st.st_size - n);
+
+    if ( m < 0 && errno == EINTR )
+      continue;
+
+    check( m > 0, "Failed to write cached mesh.");
+    n += (size_t) m;
+  }
+
+  /*-------------------------------------------------------
+  | Mark the entry as recently used
+  -------------------------------------------------------*/
+  futimens(fd, NULL);
+
+  if ( path != NULL )
+    check( close(out) == 0, "Failed to write file %s", path);
+
+  if ( data != MAP_FAILED )
+    munmap(data, (size_t) st.st_size);
+  close(fd);
+
+  return TRUE;
+
+error:
+  if ( out >= 0 && path != NULL )
+    close(out);
+  if ( data != MAP_FAILED )
+    munmap(data, (size_t) st.st_size);
+  close(fd);
+  return FALSE;
+
+} /* tmCache_fetch() */
+
+/**********************************************************
+* Function: tmCache_tmpPath()
+*----------------------------------------------------------
+* Returns the path of a temporary file, to which a new
+* entry for the current key is written before 
+* tmCache_store()
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache
+* @return: temporary file path
+**********************************************************/
+const char *tmCache_tmpPath(tmCache *cache)
+{
+  char key[17];
+
+  tmCache_key(cache, key);
+  sprintf(cache->tmp_path, "%s/%s.%ld.%lx.tmp", 
+          cache->dir, key, (long) getpid(), 
+          (unsigned long) (uintptr_t) cache);
+
+  return cache->tmp_path;
+
+} /* tmCache_tmpPath() */
+
+/**********************************************************
+* tmCacheEntry: Cache file for the eviction 
+**********************************************************/
+typedef struct tmCacheEntry {
+  char   name[32];
+  time_t mtime;
+  long   size;
+} tmCacheEntry;
+
+/**********************************************************
+* Function: tmCacheEntry_compare()
+*----------------------------------------------------------
+* Compares two cache entries by their last use
+**********************************************************/
+static int tmCacheEntry_compare(const void *a, const void *b)
+{
+  const tmCacheEntry *ea = (const tmCacheEntry*) a;
+  const tmCacheEntry *eb = (const tmCacheEntry*) b;
+
+  if ( ea->mtime != eb->mtime )
+    return ( ea->mtime < eb->mtime ) ? -1 : 1;
+
+  return strcmp(ea->name, eb->name);
+
+} /* tmCacheEntry_compare() */
+
+/**********************************************************
+* Function: tmCache_evict()
+*----------------------------------------------------------
+* Removes the least recently used entries except for the
+* current one, until all entries fit into the size limit
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache
+**********************************************************/
+static void tmCache_evict(tmCache *cache)
+{
+  DIR           *dir;
+  struct dirent *ent;
+  struct stat    st;
+  tmCacheEntry  *entries = NULL;
+  char          *path    = NULL;
+  const char    *current = strrchr(cache->path, '/') + 1;
+  int  n_entries = 0;
+  int  n_max     = 64;
+  long total     = 0;
+  int  i;
+
+  dir = opendir(cache->dir);
+  check( dir != NULL, "Failed to open cache directory %s", cache->dir);
+
+  path    = (char*) calloc(strlen(cache->dir) + 64, sizeof(char));
+  entries = (tmCacheEntry*) calloc(n_max, sizeof(tmCacheEntry));
+  check_mem(path);
+  check_mem(entries);
+
+  while ( (ent = readdir(dir)) != NULL )
+  {
+    size_t len = strlen(ent->d_name);
+
+    if ( len < 4 || len >= sizeof(entries->name) ||
+         strcmp(ent->d_name + len - 4, ".tmc") != 0 )
+      continue;
+
+    sprintf(path, "%s/%s", cache->dir, ent->d_name);
+
+    if ( stat(path, &st) != 0 )
+      continue;
+
+    if ( n_entries == n_max )
+    {
+      tmCacheEntry *tmp = (tmCacheEntry*) realloc(entries, 
+                            2 * n_max * sizeof(tmCacheEntry));
+      check_mem(tmp);
+      entries = tmp;
+      n_max  *= 2;
+    }
+
+    strcpy(entries[n_entries].name, ent->d_name);
+    entries[n_entries].mtime = st.st_mtime;
+    entries[n_entries].size  = (long) st.st_size;
+    total += (long) st.st_size;
+    n_entries += 1;
+  }
+
+  qsort(entries, n_entries, sizeof(tmCacheEntry), 
+        tmCacheEntry_compare);
+
+  for (i = 0; i < n_entries && total > cache->max_bytes; i++)
+  {
+    if ( strcmp(entries[i].name, current) == 0 )
+      continue;
+
+    sprintf(path, "%s/%s", cache->dir, entries[i].name);
+
+    if ( unlink(path) == 0 )
+      total -= entries[i].size;
+  }
+
+error:
+  if ( dir != NULL )
+    closedir(dir);
+  free(entries);
+  free(path);
+  return;
+
+} /* tmCache_evict() */
+
+/**********************************************************
+* Function: tmCache_store()
+*----------------------------------------------------------
+* Moves the temporary file behind the hashed input into 
+* the cache as current entry and removes the least 
+* recently used entries, until all entries fit into the
+* size limit
+*----------------------------------------------------------
+* @param cache: pointer to a tmCache
+* @return: FALSE, if the entry can not be stored
+**********************************************************/
+tmBool tmCache_store(tmCache *cache)
+{
+  char    *path   = NULL;
+  FILE    *in     = NULL;
+  FILE    *out    = NULL;
+  uint64_t n_input = (uint64_t) cache->n_input;
+  char     buf[BUFSIZ];
+  size_t   n;
+
+  tmCache_setPath(cache);
+
+  check( cache->tmp_path[0] != '\0',
+      "No new cache entry has been written.");
+
+  /*-------------------------------------------------------
+  | Write the entry next to the temporary file and move
+  | it into place, so that it is never seen incomplete
+  -------------------------------------------------------*/
+  path = (char*) malloc(strlen(cache->tmp_path) + 2);
+  check_mem(path);
+  sprintf(path, "%sh", cache->tmp_path);
+
+  in  = fopen(cache->tmp_path, "rb");
+  check( in != NULL, "Failed to open file %s", cache->tmp_path);
+  out = fopen(path, "wb");
+  check( out != NULL, "Failed to open file %s", path);
+
+  check( fwrite(&n_input, sizeof(n_input), 1, out) == 1 &&
+         fwrite(cache->input, 1, cache->n_input, out) 
+           == cache->n_input,
+      "Failed to write cache entry %s", path);
+
+  while ( (n = fread(buf, 1, sizeof(buf), in)) > 0 )
+    check( fwrite(buf, 1, n, out) == n,
+        "Failed to write cache entry %s", path);
+
+  check( ferror(in) == 0, "Failed to read file %s", cache->tmp_path);
+
+  fclose(in);
+  in = NULL;
+  check( fclose(out) == 0, "Failed to write cache entry %s", path);
+  out = NULL;
+
+  check( rename(path, cache->path) == 0,
+      "Failed to store cache entry %s", cache->path);
+
+  unlink(cache->tmp_path);
+  cache->tmp_path[0] = '\0';
+  free(path);
+
+  tmCache_evict(cache);
+
+  return TRUE;
+
+error:
+  if ( in != NULL )
+    fclose(in);
+  if ( out != NULL )
+    fclose(out);
+  if ( path != NULL )
+    unlink(path);
+  free(path);
+  return FALSE;
+
+} /* tmCache_store() */
@@ -0,0 +1,412 @@
+/*
+ * This source file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tmClient.h"
+#include "tmesh/tmMesh.h"
+#include "tmesh/tmMeshIO.h"
+#include "tmesh/tmMeshLoad.h"
+
+/**********************************************************
+* Function: tmClient_connect()
+*----------------------------------------------------------
+* Connects to the TMesh daemon at a socket path
+*----------------------------------------------------------
+* @param path: path of the daemon's socket
+* @return: Pointer to a new tmClient structure or NULL,
+*          if the daemon can not be reached
+**********************************************************/
+tmClient *tmClient_connect(const char *path)
+{
+  struct sockaddr_un addr;
+  tmClient *client = NULL;
+
+  check( strlen(path) < sizeof(addr.sun_path),
+      "Socket path %s is too long", path);
+
+  client = (tmClient*) calloc(1, sizeof(tmClient));
+  check_mem(client);
+
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+
+  client->fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  check( client->fd >= 0, "Failed to create socket.");
+
+  check( connect(client->fd, (struct sockaddr*) &addr,
+                 sizeof(addr)) == 0,
+      "Failed to connect to %s", path);
+
+  return client;
+
+error:
+  tmClient_destroy(client);
+  return NULL;
+
+} /* tmClient_connect() */
+
+/**********************************************************
+* Function: tmClient_destroy()
+*----------------------------------------------------------
+* Closes the connection and frees the tmClient memory
+*----------------------------------------------------------
+* @param client: pointer to a tmClient to destroy
+**********************************************************/
+void tmClient_destroy(tmClient *client)
+{
+  if ( client == NULL )
+    return;
+
+  if ( client->fd >= 0 )
+    close(client->fd);
+
+  free(client);
+
+} /* tmClient_destroy() */
+
+/**********************************************************
+* Function: tmClient_mesh()
+*----------------------------------------------------------
+* Sends the content of a parameter file to the daemon
+* and receives the generated mesh.
+* The mesh must be freed with tmClientMesh_free().
+*----------------------------------------------------------
+* @param client: pointer to a tmClient
+* @param para, len: content of a parameter file
+* @param mesh: returns the mesh
+* @return: FALSE, if the mesh could not be generated
+**********************************************************/
+tmBool tmClient_mesh(tmClient     *client,
+                     const char   *para,
+                     size_t        len,
+                     tmClientMesh *mesh)
+{
+  void     *data = NULL;
+  uint64_t  size;
+  uint32_t  status;
+
+  memset(mesh, 0, sizeof(tmClientMesh));
+
+  check( tmClient_sendMsg(client->fd, TM_MSG_REQUEST,
+                          TM_REQUEST_PARA, para, len) == TRUE,
+      "Failed to send request.");
+
+  check( tmClient_recvMsg(client->fd, TM_MSG_RESPONSE,
+                          &status, &data, &size) == TRUE,
+      "Failed to receive response.");
+
+  check( status == TM_RESPONSE_OK, "TMesh daemon: %s",
+      (char*) data);
+
+  return tmClientMesh_init(mesh, data, (size_t) size);
+
+error:
+  free(data);
+  return FALSE;
+
+} /* tmClient_mesh() */
+
+/**********************************************************
+* Function: tmClient_meshShm()
+*----------------------------------------------------------
+* Sends the content of a parameter file to the daemon,
+* which exports the generated mesh to the shared memory
+* segment name. The mesh can be mapped with tmShm_map().
+*----------------------------------------------------------
+* @param client: pointer to a tmClient
+* @param para, len: content of a parameter file
+* @param name: shared memory segment name
+* @return: FALSE, if the mesh could not be generated
+**********************************************************/
+tmBool tmClient_meshShm(tmClient   *client,
+                        const char *para,
+                        size_t      len,
+                        const char *name)
+{
+  size_t    n_name = strlen(name) + 1;
+  char     *msg    = NULL;
+  void     *data   = NULL;
+  uint64_t  size;
+  uint32_t  status;
+
+  msg = (char*) malloc(n_name + len);
+  check_mem(msg);
+
+  memcpy(msg, name, n_name);
+  memcpy(msg + n_name, para, len);
+
+  check( tmClient_sendMsg(client->fd, TM_MSG_REQUEST,
+                          TM_REQUEST_SHM, msg, n_name + len) == TRUE,
+      "Failed to send request.");
+
+  check( tmClient_recvMsg(client->fd, TM_MSG_RESPONSE,
+                          &status, &data, &size) == TRUE,
+      "Failed to receive response.");
+
+  check( status == TM_RESPONSE_OK, "TMesh daemon: %s",
+      (char*) data);
+
+  free(msg);
+  free(data);
+  return TRUE;
+
+error:
+  free(msg);
+  free(data);
+  return FALSE;
+
+} /* tmClient_meshShm() */
+
+/**********************************************************
+* Function: tmClient_shutdown()
+*----------------------------------------------------------
+* Requests the daemon to stop accepting connections, 
+* which is only granted to clients of the daemon's user
+*----------------------------------------------------------
+* @param client: pointer to a tmClient
+* @return: FALSE, if the request has failed or was denied
+**********************************************************/
+tmBool tmClient_shutdown(tmClient *client)
+{
+  void     *data = NULL;
+  uint64_t  size;
+  uint32_t  status;
+
+  check( tmClient_sendMsg(client->fd, TM_MSG_REQUEST,
+                          TM_REQUEST_SHUTDOWN, NULL, 0) == TRUE,
+      "Failed to send request.");
+
+  check( tmClient_recvMsg(client->fd, TM_MSG_RESPONSE,
+                          &status, &data, &size) == TRUE,
+      "Failed to receive response.");
+
+  check( status == TM_RESPONSE_OK, "TMesh daemon: %s",
+      (char*) data);
+
+  free(data);
+  return TRUE;
+
+error:
+  free(data);
+  return FALSE;
+
+} /* tmClient_shutdown() */
+
+/**********************************************************
+* Function: tmClientMesh_init()
+*----------------------------------------------------------
+* Sets the arrays of a mesh from binary mesh data
+* (see TM_BIN_MAGIC), which is owned by the mesh
+* afterwards. The data must be aligned to 8 bytes.
+* Only little-endian hosts are supported.
+*----------------------------------------------------------
+* @param mesh: mesh to initialize
+* @param data, size: binary mesh data
+* @return: FALSE, if the data is invalid
+**********************************************************/
+tmBool tmClientMesh_init(tmClientMesh *mesh,
+                         void         *data,
+                         size_t        size)
+{
+  const uint16_t one = 1;
+  unsigned char *buf = (unsigned char*) data;
+  uint64_t       n[3], off[7];
+
+  memset(mesh, 0, sizeof(tmClientMesh));
+  mesh->data = buf;
+  mesh->size = size;
+
+  check( *(const unsigned char*) &one == 1,
+      "Binary meshes require a little-endian host.");
+
+  check( tmMesh_checkBinHeader(buf, size, n, off) == TRUE,
+      "Invalid binary mesh.");
+
+  mesh->n_nodes      = (int) n[0];
+  mesh->n_tris       = (int) n[1];
+  mesh->n_bdry       = (int) n[2];
+
+  mesh->nodes        = (const double  (*)[2]) (buf + off[0]);
+  mesh->tris         = (const int32_t (*)[3]) (buf + off[1]);
+  mesh->nbrs         = (const int32_t (*)[3]) (buf + off[2]);
+  mesh->bdry_edges   = (const int32_t (*)[2]) (buf + off[3]);
+  mesh->bdry_markers = (const int32_t *)      (buf + off[4]);
+  mesh->bdry_ids     = (const int32_t *)      (buf + off[5]);
+
+  return TRUE;
+
+error:
+  tmClientMesh_free(mesh);
+  return FALSE;
+
+} /* tmClientMesh_init() */
+
+/**********************************************************
+* Function: tmClientMesh_free()
+*----------------------------------------------------------
+* Frees the data of a mesh
+*----------------------------------------------------------
+* @param mesh: pointer to a tmClientMesh
+**********************************************************/
+void tmClientMesh_free(tmClientMesh *mesh)
+{
+  free(mesh->data);
+  memset(mesh, 0, sizeof(tmClientMesh));
+
+} /* tmClientMesh_free() */
+
+/**********************************************************
+* Function: tmClient_sendAll()
+*----------------------------------------------------------
+* Sends n bytes over a socket. A closed connection
+* does not raise SIGPIPE.
+**********************************************************/
+static tmBool tmClient_sendAll(int fd, const void *data, size_t n)
+{
+  const char *pos = (const char*) data;
+
+  while ( n > 0 )
+  {
+    ssize_t k = send(fd, pos, n, MSG_NOSIGNAL);
+
+    if ( k < 0 )
+    {
+      if ( errno == EINTR )
+        continue;
+      return FALSE;
+    }
+
+    pos += k;
+    n   -= (size_t) k;
+  }
+
+  return TRUE;
+
+} /* tmClient_sendAll() */
+
+/**********************************************************
+* Function: tmClient_recvAll()
+*----------------------------------------------------------
+* Receives n bytes from a socket
+* @return: FALSE on errors or if the connection is closed
+**********************************************************/
+static tmBool tmClient_recvAll(int fd, void *data, size_t n)
+{
+  char *pos = (char*) data;
+
+  while ( n > 0 )
+  {
+    ssize_t k = recv(fd, pos, n, 0);
+
+    if ( k < 0 && errno == EINTR )
+      continue;
+
+    if ( k <= 0 )
+      return FALSE;
+
+    pos += k;
+    n   -= (size_t) k;
+  }
+
+  return TRUE;
+
+} /* tmClient_recvAll() */
+
+/**********************************************************
+* Function: tmClient_sendMsg()
+*----------------------------------------------------------
+* Sends a message over a socket
+*----------------------------------------------------------
+* @param fd: socket
+* @param magic: TM_MSG_REQUEST or TM_MSG_RESPONSE
+* @param type: request type or response status
+* @param data, len: message data
+* @return: FALSE, if the message could not be sent
+**********************************************************/
+tmBool tmClient_sendMsg(int         fd,
+                        const char *magic,
+                        uint32_t    type,
+                        const void *data,
+                        uint64_t    len)
+{
+  unsigned char hdr[TM_MSG_HEADER_SIZE];
+
+  memcpy(hdr,     magic, 4);
+  memcpy(hdr + 4, &type, 4);
+  memcpy(hdr + 8, &len,  8);
+
+  if ( tmClient_sendAll(fd, hdr, TM_MSG_HEADER_SIZE) == FALSE )
+    return FALSE;
+
+  if ( len == 0 )
+    return TRUE;
+
+  return tmClient_sendAll(fd, data, (size_t) len);
+
+} /* tmClient_sendMsg() */
+
+/**********************************************************
+* Function: tmClient_recvMsg()
+*----------------------------------------------------------
+* Receives a message from a socket. The data is
+* terminated by an additional null character and must
+* be freed by the caller.
+*----------------------------------------------------------
+* @param fd: socket
+* @param magic: TM_MSG_REQUEST or TM_MSG_RESPONSE
+* @param type: returns the request type or status
+* @param data, len: returns the message data
+* @return: FALSE on errors or if the connection is
+*          closed
+**********************************************************/
+tmBool tmClient_recvMsg(int          fd,
+                        const char  *magic,
+                        uint32_t    *type,
+                        void       **data,
+                        uint64_t    *len)
+{
+  unsigned char hdr[TM_MSG_HEADER_SIZE];
+  char         *buf = NULL;
+
+  *data = NULL;
+  *len  = 0;
+
+  if ( tmClient_recvAll(fd, hdr, TM_MSG_HEADER_SIZE) == FALSE )
+    return FALSE;
+
+  memcpy(type, hdr + 4, 4);
+  memcpy(len,  hdr + 8, 8);
+
+  check( memcmp(hdr, magic, 4) == 0 && *len <= TM_MSG_MAX_BYTES,
+      "Invalid message header.");
+
+  buf = (char*) malloc( (size_t) *len + 1 );
+  check_mem(buf);
+
+  check( tmClient_recvAll(fd, buf, (size_t) *len) == TRUE,
+      "Connection closed during message.");
+
+  buf[*len] = '\0';
+  *data     = buf;
+
+  return TRUE;
+
+error:
+  free(buf);
+  *len = 0;
+  return FALSE;
+
+} /* tmClient_recvMsg() */
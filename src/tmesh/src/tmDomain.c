@@ -0,0 +1,2176 @@
+/*
+ * This source file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include <string.h>
+
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tmList.h"
+#include "tmesh/tmQtree.h"
+#include "tmesh/tmNode.h"
+#include "tmesh/tmEdge.h"
+#include "tmesh/tmTri.h"
+#include "tmesh/tmBdry.h"
+#include "tmesh/tmMesh.h"
+#include "tmesh/tmPool.h"
+#include "tmesh/tmDomain.h"
+
+/**********************************************************
+* tmDomainCross: Crossing of a boundary loop segment 
+*                with a cut
+**********************************************************/
+typedef struct tmDomainCross {
+  int      loop;     /* Crossed loop                       */
+  int      seg;      /* Crossed segment of the loop        */
+  tmBool   to_pos;   /* Crossing into n*xy > c             */
+  tmDouble xy[2];
+  tmDouble t;        /* Location along the cut             */
+  tmDouble rho;      /* Size function value                */
+  tmNode  *node;     /* Loop node on the cut or NULL       */
+} tmDomainCross;
+
+/**********************************************************
+* tmDomainCut: Data of a cut n*xy = c through a domain,
+*              where n is the unit normal of the cut
+*              line. Axis-aligned cuts xy[axis] = c have
+*              the normal of the axis.
+**********************************************************/
+typedef struct tmDomainCut {
+  tmDomain      *dom;
+  int            axis;      /* Cut axis or -1              */
+  tmDouble       n[2];      /* Unit normal of the cut      */
+  tmDouble       dir[2];    /* Direction along the cut     */
+  tmDouble       c;
+  tmBool         snap;      /* Loop vertices on the cut    */
+                            /* are shared with the cut     */
+  tmBool         bend;      /* Crossings are moved onto    */
+                            /* close loop vertices         */
+  const tmDouble *pin;      /* Location of a cut node      */
+  tmBool         pin_sym;   /* Cut nodes are symmetric     */
+                            /* to the pin                  */
+  const tmDouble (*ref)[3]; /* Prescribed cut nodes        */
+  int            n_ref;     /* (x, y, size) or NULL        */
+
+  tmDomainCross *cross;     /* Crossings sorted along cut  */
+  int            n_cross;
+  tmDomainLoop  *ivls;      /* Nodes of the cut intervals  */
+
+  int           *offset;    /* First vertex of every loop  */
+  int           *seg_cross; /* Crossing of every segment   */
+  tmBool        *visited;   /* Traced loop vertices        */
+} tmDomainCut;
+
+/**********************************************************
+* Function: tmDomain_alloc()
+*----------------------------------------------------------
+* Allocates a tmDomain structure with n_loops empty loops
+*----------------------------------------------------------
+* @param *mesh: pointer to parent mesh
+* @param n_loops: number of boundary loops
+* @return: Pointer to a new tmDomain structure
+**********************************************************/
+static tmDomain *tmDomain_alloc(tmMesh *mesh, int n_loops)
+{
+  tmDomain *dom = (tmDomain*) calloc( 1, sizeof(tmDomain) );
+  check_mem(dom);
+
+  dom->mesh    = mesh;
+  dom->n_loops = n_loops;
+  dom->loops   = (tmDomainLoop*) calloc( MAX(n_loops, 1),
+                                         sizeof(tmDomainLoop) );
+  check_mem(dom->loops);
+
+  dom->samples   = NULL;
+  dom->n_samples = 0;
+  dom->work      = 0.0;
+
+  dom->sub      = NULL;
+  dom->node_map = NULL;
+  dom->tri_map  = NULL;
+
+  dom->source      = NULL;
+  dom->trafo[0][0] = 1.0;
+  dom->trafo[1][1] = 1.0;
+
+  return dom;
+
+error:
+  free(dom);
+  return NULL;
+
+} /* tmDomain_alloc() */
+
+/**********************************************************
+* Function: tmDomain_mapCoords()
+*----------------------------------------------------------
+* Maps coordinates by an affine transformation
+*----------------------------------------------------------
+* @param trafo: transformation xy -> trafo * (xy, 1)
+* @param xy: coordinates to map
+* @param out: returns the mapped coordinates
+**********************************************************/
+static inline void tmDomain_mapCoords(const tmDouble trafo[2][3],
+                                      const tmDouble xy[2],
+                                      tmDouble       out[2])
+{
+  out[0] = trafo[0][0]*xy[0] + trafo[0][1]*xy[1] + trafo[0][2];
+  out[1] = trafo[1][0]*xy[0] + trafo[1][1]*xy[1] + trafo[1][2];
+
+} /* tmDomain_mapCoords() */
+
+/**********************************************************
+* Function: tmDomain_findNode()
+*----------------------------------------------------------
+* Returns the node of a mesh, which is located closest
+* to a location within a given distance
+*----------------------------------------------------------
+* @param *mesh: pointer to mesh
+* @param xy: location
+* @param tol: maximum distance
+* @return: node or NULL, if there is none
+**********************************************************/
+static tmNode *tmDomain_findNode(tmMesh  *mesh,
+                                 tmDouble xy[2],
+                                 tmDouble tol)
+{
+  tmList     *found = tmQtree_getObjCirc(mesh->nodes_qtree, xy, tol);
+  tmListNode *cur;
+  tmNode     *best   = NULL;
+  tmDouble    d_best = 0.0;
+
+  if (found == NULL)
+    return NULL;
+
+  for (cur = found->first; cur != NULL; cur = cur->next)
+  {
+    tmNode  *n = (tmNode*) cur->value;
+    tmDouble d = SQR(n->xy[0] - xy[0]) + SQR(n->xy[1] - xy[1]);
+
+    if (best == NULL || d < d_best)
+    {
+      best   = n;
+      d_best = d;
+    }
+  }
+
+  tmList_destroy(found);
+
+  return best;
+
+} /* tmDomain_findNode() */
+
+/**********************************************************
+* Function: tmDomain_loopArea()
+*----------------------------------------------------------
+* Computes the signed area of a boundary loop
+*----------------------------------------------------------
+* @param *loop: boundary loop
+* @return: area (> 0 for counter-clockwise loops)
+**********************************************************/
+static tmDouble tmDomain_loopArea(tmDomainLoop *loop)
+{
+  tmDouble area = 0.0;
+  int i;
+
+  for (i = 0; i < loop->n_verts; i++)
+  {
+    tmDouble *p = loop->verts[i].node->xy;
+    tmDouble *q = loop->verts[(i+1)%loop->n_verts].node->xy;
+    area += 0.5 * (p[0] * q[1] - p[1] * q[0]);
+  }
+
+  return area;
+
+} /* tmDomain_loopArea() */
+
+/**********************************************************
+* Function: tmDomain_calcGeometry()
+*----------------------------------------------------------
+* Computes the area and the bounding box of a domain
+*----------------------------------------------------------
+* @param *dom: pointer to domain
+**********************************************************/
+static void tmDomain_calcGeometry(tmDomain *dom)
+{
+  int i, j;
+
+  dom->area = 0.0;
+
+  for (i = 0; i < dom->n_loops; i++)
+    dom->area += tmDomain_loopArea(&dom->loops[i]);
+
+  /*-------------------------------------------------------
+  | Holes are located within the exterior loop
+  -------------------------------------------------------*/
+  tmDomainLoop *ext = &dom->loops[0];
+
+  dom->xy_min[0] = dom->xy_max[0] = ext->verts[0].node->xy[0];
+  dom->xy_min[1] = dom->xy_max[1] = ext->verts[0].node->xy[1];
+
+  for (j = 1; j < ext->n_verts; j++)
+  {
+    tmDouble *p = ext->verts[j].node->xy;
+    dom->xy_min[0] = MIN(dom->xy_min[0], p[0]);
+    dom->xy_min[1] = MIN(dom->xy_min[1], p[1]);
+    dom->xy_max[0] = MAX(dom->xy_max[0], p[0]);
+    dom->xy_max[1] = MAX(dom->xy_max[1], p[1]);
+  }
+
+} /* tmDomain_calcGeometry() */
+
+/**********************************************************
+* Function: tmDomain_cmpSamplesX(), tmDomain_cmpSamplesY()
+*----------------------------------------------------------
+* Sorts size function samples by their x- / y-coordinate
+**********************************************************/
+static int tmDomain_cmpSamplesX(const void *a, const void *b)
+{
+  const tmDouble *sa = (const tmDouble*) a;
+  const tmDouble *sb = (const tmDouble*) b;
+
+  return (sa[0] > sb[0]) - (sa[0] < sb[0]);
+
+} /* tmDomain_cmpSamplesX() */
+
+static int tmDomain_cmpSamplesY(const void *a, const void *b)
+{
+  const tmDouble *sa = (const tmDouble*) a;
+  const tmDouble *sb = (const tmDouble*) b;
+
+  return (sa[1] > sb[1]) - (sa[1] < sb[1]);
+
+} /* tmDomain_cmpSamplesY() */
+
+/**********************************************************
+* Function: tmDomain_medianCut()
+*----------------------------------------------------------
+* Returns the location of an axis-aligned line, which
+* divides the estimated number of elements of a domain
+* into two equal parts (weighted median of the size
+* function samples). The samples are sorted along the
+* axis. Without samples, the domain is cut in the 
+* middle.
+*----------------------------------------------------------
+* @param *dom: pointer to domain
+* @param axis: 0 -> x-axis, 1 -> y-axis
+**********************************************************/
+static tmDouble tmDomain_medianCut(tmDomain *dom, int axis)
+{
+  tmDouble sum = 0.0;
+  int i;
+
+  if (dom->n_samples < 2)
+    return 0.5 * (dom->xy_min[axis] + dom->xy_max[axis]);
+
+  qsort(dom->samples, dom->n_samples, sizeof(*dom->samples),
+        (axis == 0) ? tmDomain_cmpSamplesX 
+                    : tmDomain_cmpSamplesY);
+
+  for (i = 0; i < dom->n_samples - 1; i++)
+  {
+    sum += dom->samples[i][2];
+
+    if (sum >= 0.5 * dom->work)
+      break;
+  }
+
+  return 0.5 * (dom->samples[i][axis] + dom->samples[i+1][axis]);
+
+} /* tmDomain_medianCut() */
+
+/**********************************************************
+* Function: tmDomain_evalSamples()
+*----------------------------------------------------------
+* Parallel loop body, which evaluates the size function
+* samples [i_beg, i_end). Samples outside of the domain
+* get the weight zero, all others the estimated number 
+* of elements in their cell, which is proportional to 
+* cell_area / rho^2.
+*----------------------------------------------------------
+* @param data: pointer to tmDomain
+**********************************************************/
+static void tmDomain_evalSamples(void  *data, 
+                                 size_t i_beg, 
+                                 size_t i_end,
+                                 int    thread_id)
+{
+  tmDomain *dom  = (tmDomain*) data;
+  tmMesh   *mesh = dom->mesh;
+  size_t    i;
+
+  (void) thread_id;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmDouble *s = dom->samples[i];
+
+    if ( tmMesh_objInside(mesh, s) == FALSE )
+    {
+      s[2] = 0.0;
+      continue;
+    }
+
+    tmDouble rho = mesh->sizeFun(mesh, s);
+    s[2] = s[2] / MAX(rho*rho, TM_MIN_SIZE);
+  }
+
+} /* tmDomain_evalSamples() */
+
+/**********************************************************
+* Function: tmDomain_initSamples()
+*----------------------------------------------------------
+* Samples the size function of the parent mesh on a 
+* regular grid of about n_samples cells, which covers 
+* the domain. The samples are used to estimate the 
+* number of elements of the domain and its subdomains.
+*----------------------------------------------------------
+* @param *dom: pointer to domain
+* @param n_samples: number of samples
+**********************************************************/
+static void tmDomain_initSamples(tmDomain *dom, int n_samples)
+{
+  tmDouble dx = dom->xy_max[0] - dom->xy_min[0];
+  tmDouble dy = dom->xy_max[1] - dom->xy_min[1];
+  int i, j, k;
+
+  int nx = MAX(1, (int) sqrt( (tmDouble) n_samples * dx / dy ));
+  int ny = MAX(1, n_samples / nx);
+
+  tmDouble hx = dx / (tmDouble) nx;
+  tmDouble hy = dy / (tmDouble) ny;
+
+  dom->samples = calloc( nx * ny, sizeof(*dom->samples) );
+  check_mem(dom->samples);
+
+  for (j = 0, k = 0; j < ny; j++)
+  {
+    for (i = 0; i < nx; i++, k++)
+    {
+      dom->samples[k][0] = dom->xy_min[0] + ((tmDouble)i + 0.5) * hx;
+      dom->samples[k][1] = dom->xy_min[1] + ((tmDouble)j + 0.5) * hy;
+      dom->samples[k][2] = hx * hy;
+    }
+  }
+
+  tmPool_parallelFor(dom->mesh->pool, nx * ny, 
+                     TM_POOL_CHUNK_SIZE / 8, 
+                     tmDomain_evalSamples, dom);
+
+  /*-------------------------------------------------------
+  | Only keep samples inside of the domain
+  -------------------------------------------------------*/
+  dom->n_samples = 0;
+  dom->work      = 0.0;
+
+  for (k = 0; k < nx * ny; k++)
+  {
+    if ( dom->samples[k][2] <= 0.0 )
+      continue;
+
+    dom->samples[dom->n_samples][0] = dom->samples[k][0];
+    dom->samples[dom->n_samples][1] = dom->samples[k][1];
+    dom->samples[dom->n_samples][2] = dom->samples[k][2];
+    dom->work      += dom->samples[k][2];
+    dom->n_samples += 1;
+  }
+
+error:
+  return;
+
+} /* tmDomain_initSamples() */
+
+/**********************************************************
+* Function: tmDomain_nextBdryEdge()
+*----------------------------------------------------------
+* Returns the boundary edge, which follows a given edge
+* within its boundary loop
+*----------------------------------------------------------
+* @param *edge: current boundary edge
+* @param *first: first edge of the current loop
+* @return: next edge or NULL, if the loop is not closed
+**********************************************************/
+static tmEdge *tmDomain_nextBdryEdge(tmEdge *edge,
+                                     tmEdge *first)
+{
+  tmListNode *cur;
+
+  for (cur = edge->n2->bdry_edges->first;
+       cur != NULL; cur = cur->next)
+  {
+    tmEdge *nxt = (tmEdge*) cur->value;
+
+    if ( nxt->n1 != edge->n2 || nxt->bdry != edge->bdry )
+      continue;
+
+    if ( nxt->indBuf == 0 || nxt == first )
+      return nxt;
+  }
+
+  return NULL;
+
+} /* tmDomain_nextBdryEdge() */
+
+/**********************************************************
+* Function: tmDomain_create()
+*----------------------------------------------------------
+* Create a new tmDomain structure from the boundaries
+* of a mesh. The mesh must be defined by exactly one
+* exterior boundary loop. The boundary size functions
+* of the mesh must be initialized.
+* The size function is sampled at about n_samples 
+* locations in order to estimate the number of elements
+* of the domain and its subdomains.
+*----------------------------------------------------------
+* @param *mesh: pointer to parent mesh
+* @param n_samples: number of size function samples
+* @return: Pointer to a new tmDomain structure or NULL,
+*          if the boundaries are not supported
+**********************************************************/
+tmDomain *tmDomain_create(tmMesh *mesh, int n_samples)
+{
+  tmListNode *cur, *cur_bdry;
+  tmDomain   *dom   = tmDomain_alloc(mesh, 0);
+  int         n_ext = 0;
+  int         i;
+
+  check(dom != NULL, "Failed to create domain.");
+
+  for (cur_bdry = mesh->bdry_stack->first;
+       cur_bdry != NULL; cur_bdry = cur_bdry->next)
+  {
+    tmBdry *bdry = (tmBdry*) cur_bdry->value;
+
+    for (cur = bdry->edges_stack->first;
+         cur != NULL; cur = cur->next)
+      ((tmEdge*)cur->value)->indBuf = 0;
+
+    /*-----------------------------------------------------
+    | Collect all closed loops of this boundary
+    -----------------------------------------------------*/
+    for (cur = bdry->edges_stack->first;
+         cur != NULL; cur = cur->next)
+    {
+      tmEdge *first = (tmEdge*) cur->value;
+      tmEdge *edge  = first;
+
+      if (first->indBuf != 0)
+        continue;
+
+      dom->loops = (tmDomainLoop*) realloc( dom->loops,
+          (dom->n_loops + 1) * sizeof(tmDomainLoop) );
+      check_mem(dom->loops);
+
+      tmDomainLoop *loop = &dom->loops[dom->n_loops];
+      dom->n_loops += 1;
+
+      loop->index       = bdry->index;
+      loop->is_interior = bdry->is_interior;
+      loop->n_verts     = 0;
+      loop->verts       = (tmDomainVert*) calloc( bdry->no_edges,
+                                          sizeof(tmDomainVert) );
+      check_mem(loop->verts);
+
+      do
+      {
+        tmDomainVert *v = &loop->verts[loop->n_verts];
+        v->node    = edge->n1;
+        v->rho     = mesh->sizeFun(mesh, edge->n1->xy);
+        v->marker  = edge->bdry_marker;
+        v->sizeFac = edge->sizeFac;
+
+        loop->n_verts += 1;
+        edge->indBuf   = 1;
+        edge = tmDomain_nextBdryEdge(edge, first);
+      }
+      while ( edge != NULL && edge != first );
+
+      if (edge == NULL)
+      {
+        log_warn("Boundary %d is not closed.", bdry->index);
+        goto error;
+      }
+
+      if (loop->is_interior == FALSE)
+        n_ext += 1;
+    }
+  }
+
+  if (n_ext != 1)
+  {
+    log_warn("Domain must be defined by one exterior boundary loop.");
+    goto error;
+  }
+
+  /*-------------------------------------------------------
+  | Exterior loop is the first loop
+  -------------------------------------------------------*/
+  for (i = 0; i < dom->n_loops; i++)
+  {
+    if (dom->loops[i].is_interior == FALSE)
+    {
+      tmDomainLoop tmp = dom->loops[0];
+      dom->loops[0] = dom->loops[i];
+      dom->loops[i] = tmp;
+      break;
+    }
+  }
+
+  tmDomain_calcGeometry(dom);
+  tmDomain_initSamples(dom, n_samples);
+
+  return dom;
+
+error:
+  if (dom != NULL)
+    tmDomain_destroy(dom);
+  return NULL;
+
+} /* tmDomain_create() */
+
+/**********************************************************
+* Function: tmDomain_destroy()
+*----------------------------------------------------------
+* Destroys a tmDomain structure, its subdomain mesh
+* and frees all its memory.
+*----------------------------------------------------------
+* @param *dom: pointer to a tmDomain to destroy
+**********************************************************/
+void tmDomain_destroy(tmDomain *dom)
+{
+  int i;
+
+  if (dom->sub != NULL)
+    tmMesh_destroy(dom->sub);
+
+  for (i = 0; i < dom->n_loops; i++)
+    free(dom->loops[i].verts);
+
+  free(dom->loops);
+  free(dom->samples);
+  free(dom->node_map);
+  free(dom->tri_map);
+  free(dom);
+
+} /* tmDomain_destroy() */
+
+/**********************************************************
+* Function: tmDomain_pushVert()
+*----------------------------------------------------------
+* Appends a vertex to a boundary loop, whose vertex 
+* array is enlarged if required
+*----------------------------------------------------------
+* @param *loop: boundary loop
+* @param *max: current size of the vertex array
+* @param *v: vertex to append
+**********************************************************/
+static void tmDomain_pushVert(tmDomainLoop *loop, 
+                              int          *max,
+                              tmDomainVert *v)
+{
+  if (loop->n_verts == *max)
+  {
+    *max = MAX(2 * (*max), 16);
+    loop->verts = (tmDomainVert*) realloc( loop->verts, 
+                                (*max) * sizeof(tmDomainVert) );
+    check_mem(loop->verts);
+  }
+
+  loop->verts[loop->n_verts] = *v;
+  loop->n_verts += 1;
+
+error:
+  return;
+
+} /* tmDomain_pushVert() */
+
+/**********************************************************
+* Function: tmDomain_pushTraced()
+*----------------------------------------------------------
+* Appends a vertex to a traced loop. A vertex, whose 
+* node equals the node of the last vertex, replaces the 
+* last vertex, since it belongs to the following segment
+* (see tmDomain_findCrossings() for vertices on cuts).
+*----------------------------------------------------------
+* @param *loop: traced loop
+* @param *max: current size of the vertex array
+* @param *v: vertex to append
+**********************************************************/
+static void tmDomain_pushTraced(tmDomainLoop *loop, 
+                                int          *max,
+                                tmDomainVert *v)
+{
+  if ( loop->n_verts > 0 && 
+       loop->verts[loop->n_verts-1].node == v->node )
+  {
+    loop->verts[loop->n_verts-1] = *v;
+    return;
+  }
+
+  tmDomain_pushVert(loop, max, v);
+
+} /* tmDomain_pushTraced() */
+
+/**********************************************************
+* Function: tmDomain_loopInside()
+*----------------------------------------------------------
+* Checks if a location is enclosed by a boundary loop
+* (see tmBdry_isInside())
+*----------------------------------------------------------
+* @param *loop: boundary loop
+* @param xy: location to check for
+* @return: TRUE, if xy is enclosed by the loop
+**********************************************************/
+static tmBool tmDomain_loopInside(tmDomainLoop *loop, 
+                                  tmDouble      xy[2])
+{
+  int count = 0;
+  int i;
+
+  for (i = 0; i < loop->n_verts; i++)
+  {
+    tmDouble *e0 = loop->verts[i].node->xy;
+    tmDouble *e1 = loop->verts[(i+1)%loop->n_verts].node->xy;
+
+    if (  (xy[1]>e1[1] && xy[1]<=e0[1])
+       || (xy[1]>e0[1] && xy[1]<=e1[1]) )
+    {
+      if (e1[0] + (xy[1]-e1[1])/(e0[1]-e1[1])*(e0[0]-e1[0]) < xy[0])
+        count++;
+    }
+  }
+
+  return count&1;
+
+} /* tmDomain_loopInside() */
+
+/**********************************************************
+* Function: tmDomain_cmpCross()
+*----------------------------------------------------------
+* Sorts crossings by their location along the cut
+**********************************************************/
+static int tmDomain_cmpCross(const void *a, const void *b)
+{
+  const tmDomainCross *ca = (const tmDomainCross*) a;
+  const tmDomainCross *cb = (const tmDomainCross*) b;
+
+  return (ca->t > cb->t) - (ca->t < cb->t);
+
+} /* tmDomain_cmpCross() */
+
+/**********************************************************
+* Function: tmDomain_cutDist()
+*----------------------------------------------------------
+* Returns the signed distance of a location to a cut
+**********************************************************/
+static inline tmDouble tmDomain_cutDist(tmDomainCut *cut, 
+                                        const tmDouble xy[2])
+{
+  return cut->n[0] * xy[0] + cut->n[1] * xy[1] - cut->c;
+
+} /* tmDomain_cutDist() */
+
+/**********************************************************
+* Function: tmDomain_vertDist()
+*----------------------------------------------------------
+* Returns the signed distance of a loop vertex to a cut,
+* which is zero for vertices on snapping cuts.
+* Vertices on the cut belong to the side n*xy > c.
+**********************************************************/
+static inline tmDouble tmDomain_vertDist(tmDomainCut  *cut,
+                                         tmDomainVert *v)
+{
+  tmDouble s = tmDomain_cutDist(cut, v->node->xy);
+
+  if ( cut->snap == TRUE && 
+       ABS(s) < 0.5 * TM_DOMAIN_SNAP_FAC * v->rho )
+    return 0.0;
+
+  return s;
+
+} /* tmDomain_vertDist() */
+
+/**********************************************************
+* Function: tmDomain_findCrossings()
+*----------------------------------------------------------
+* Computes all crossings of the boundary loops with
+* the line xy[axis] = c and sorts them along the line.
+* Every pair of consecutive crossings (0,1), (2,3), ...
+* encloses an interval of the cut within the domain.
+* The cut is rejected, if loop vertices are located too
+* close to the line, if it crosses a loop at a sharp
+* angle or if an interval is too short with respect to 
+* the local element size.
+* Snapping cuts accept loop vertices on the line, which
+* become the end of their intervals, and domains, which
+* are not crossed at all.
+* Bending cuts move crossings, which are located close 
+* to a vertex of the crossed segment, onto the vertex 
+* in order to avoid short loop segments.
+*----------------------------------------------------------
+* @param *cut: cut data
+* @return: TRUE if the cut is valid
+**********************************************************/
+static tmBool tmDomain_findCrossings(tmDomainCut *cut)
+{
+  tmDomain *dom  = cut->dom;
+  tmMesh   *mesh = dom->mesh;
+  int       axis = cut->axis;
+  int       i, j, k;
+
+  cut->n_cross = 0;
+
+  for (j = 0; j < dom->n_loops; j++)
+  {
+    tmDomainLoop *loop = &dom->loops[j];
+
+    for (i = 0; i < loop->n_verts; i++)
+    {
+      tmDomainVert *v  = &loop->verts[i];
+      tmDomainVert *w  = &loop->verts[(i+1)%loop->n_verts];
+      tmDouble      sv = tmDomain_vertDist(cut, v);
+      tmDouble      sw = tmDomain_vertDist(cut, w);
+
+      if ( cut->snap == FALSE && 
+           ABS(sv) < TM_DOMAIN_CUT_FAC * v->rho )
+        return FALSE;
+
+      if ( (sv < 0.0) != (sw < 0.0) )
+        cut->n_cross += 1;
+    }
+  }
+
+  if ( cut->n_cross < 2 && 
+       (cut->snap == FALSE || cut->n_cross > 0) )
+    return FALSE;
+
+  cut->cross = (tmDomainCross*) calloc( MAX(cut->n_cross, 1), 
+                                        sizeof(tmDomainCross) );
+  check_mem(cut->cross);
+
+  /*-------------------------------------------------------
+  | Compute crossings
+  -------------------------------------------------------*/
+  k = 0;
+  for (j = 0; j < dom->n_loops; j++)
+  {
+    tmDomainLoop *loop = &dom->loops[j];
+
+    for (i = 0; i < loop->n_verts; i++)
+    {
+      tmDomainVert *vp = &loop->verts[i];
+      tmDomainVert *vq = &loop->verts[(i+1)%loop->n_verts];
+      tmDouble     *p  = vp->node->xy;
+      tmDouble     *q  = vq->node->xy;
+      tmDouble      sp = tmDomain_vertDist(cut, vp);
+      tmDouble      sq = tmDomain_vertDist(cut, vq);
+
+      if ( (sp < 0.0) == (sq < 0.0) )
+        continue;
+
+      /*---------------------------------------------------
+      | Avoid sharp angles between the loop and the cut
+      ---------------------------------------------------*/
+      tmDouble len = sqrt( SQR(q[0]-p[0]) + SQR(q[1]-p[1]) );
+
+      if ( ABS(sq - sp) < TM_DOMAIN_CUT_SIN * len )
+        return FALSE;
+
+      tmDomainCross *cx = &cut->cross[k++];
+      tmDouble       t  = sp / (sp - sq);
+
+      cx->loop     = j;
+      cx->seg      = i;
+      cx->to_pos   = (sp < 0.0);
+      cx->node     = NULL;
+      cx->xy[0]    = p[0] + t * (q[0] - p[0]);
+      cx->xy[1]    = p[1] + t * (q[1] - p[1]);
+
+      /*---------------------------------------------------
+      | Vertices on the cut are used as crossing nodes
+      ---------------------------------------------------*/
+      if ( sp == 0.0 || sq == 0.0 )
+      {
+        cx->node  = (sp == 0.0) ? vp->node : vq->node;
+        cx->xy[0] = cx->node->xy[0];
+        cx->xy[1] = cx->node->xy[1];
+      }
+      else if ( axis >= 0 )
+        cx->xy[axis] = cut->c;
+      else
+      {
+        tmDouble s = tmDomain_cutDist(cut, cx->xy);
+        cx->xy[0] -= s * cut->n[0];
+        cx->xy[1] -= s * cut->n[1];
+      }
+
+      if ( cx->node == NULL && cut->bend == TRUE )
+      {
+        tmDouble dp = sqrt( SQR(cx->xy[0]-p[0]) + SQR(cx->xy[1]-p[1]) );
+        tmDouble dq = sqrt( SQR(cx->xy[0]-q[0]) + SQR(cx->xy[1]-q[1]) );
+
+        if ( dp <= dq && dp < TM_DOMAIN_BEND_FAC * vp->rho )
+          cx->node = vp->node;
+        else if ( dq < dp && dq < TM_DOMAIN_BEND_FAC * vq->rho )
+          cx->node = vq->node;
+
+        if ( cx->node != NULL )
+        {
+          cx->xy[0] = cx->node->xy[0];
+          cx->xy[1] = cx->node->xy[1];
+        }
+      }
+
+      cx->t        = cut->dir[0] * cx->xy[0] + cut->dir[1] * cx->xy[1];
+      cx->rho      = mesh->sizeFun(mesh, cx->xy);
+    }
+  }
+
+  qsort(cut->cross, cut->n_cross, sizeof(tmDomainCross), 
+        tmDomain_cmpCross);
+
+  /*-------------------------------------------------------
+  | Check the intervals within the domain
+  -------------------------------------------------------*/
+  if (cut->n_cross % 2 != 0)
+    return FALSE;
+
+  for (k = 0; k < cut->n_cross; k += 2)
+  {
+    tmDomainCross *c0 = &cut->cross[k];
+    tmDomainCross *c1 = &cut->cross[k+1];
+
+    if ( c0->to_pos == c1->to_pos )
+      return FALSE;
+
+    if ( c1->t - c0->t < TM_DOMAIN_CUT_FAC * (c0->rho + c1->rho) )
+      return FALSE;
+  }
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmDomain_findCrossings() */
+
+/**********************************************************
+* Function: tmDomain_pushPos()
+*----------------------------------------------------------
+* Appends a node location (x, y, size) to an array, 
+* which is enlarged if required
+**********************************************************/
+static void tmDomain_pushPos(tmDouble      (**pos)[3],
+                             int            *n_pos,
+                             int            *max,
+                             const tmDouble  xy[2],
+                             tmDouble        rho)
+{
+  if (*n_pos >= *max)
+  {
+    *max = MAX(2 * (*max), 16);
+    *pos = realloc(*pos, (*max) * sizeof(**pos));
+    check_mem(*pos);
+  }
+
+  (*pos)[*n_pos][0] = xy[0];
+  (*pos)[*n_pos][1] = xy[1];
+  (*pos)[*n_pos][2] = rho;
+  *n_pos += 1;
+
+error:
+  return;
+
+} /* tmDomain_pushPos() */
+
+/**********************************************************
+* Function: tmDomain_refineCut()
+*----------------------------------------------------------
+* Refines the segment (a,b) of a cut recursively
+* according to the size function of the parent mesh 
+* and appends the new node locations in the order 
+* from a to b.
+* The criterion is stricter than the one of
+* tmFront_refine(), such that the cut segments are not
+* refined again in either of the adjacent subdomains.
+* With a shift, the size is the minimum of the size 
+* function at the cut and at the shifted cut, such that
+* the nodes suit both of them (periodic domain sides).
+*----------------------------------------------------------
+* @param *mesh: pointer to parent mesh
+* @param xy_a, rho_a: coordinates / size at a
+* @param xy_b, rho_b: coordinates / size at b
+* @param shift: shift of the cut or NULL
+* @param **pos: node locations of the cut
+* @param *n_pos, *max: number / array size of pos
+**********************************************************/
+static void tmDomain_refineCut(tmMesh         *mesh,
+                               tmDouble        xy_a[2],
+                               tmDouble        rho_a,
+                               tmDouble        xy_b[2],
+                               tmDouble        rho_b,
+                               const tmDouble *shift,
+                               tmDouble      (**pos)[3],
+                               int            *n_pos,
+                               int            *max)
+{
+  tmDouble xy_m[2] = { 0.5 * (xy_a[0] + xy_b[0]),
+                       0.5 * (xy_a[1] + xy_b[1]) };
+
+  const tmDouble dx  = xy_b[0] - xy_a[0];
+  const tmDouble dy  = xy_b[1] - xy_a[1];
+  const tmDouble len = sqrt(dx*dx + dy*dy);
+
+  tmDouble rho_m = mesh->sizeFun(mesh, xy_m);
+
+  if (shift != NULL)
+  {
+    tmDouble xy_s[2] = { xy_m[0] + shift[0], xy_m[1] + shift[1] };
+    rho_m = MIN(rho_m, mesh->sizeFun(mesh, xy_s));
+  }
+
+  tmDouble rho   = TM_FRONT_REFINE_FAC * (MIN(rho_a, rho_b) + rho_m);
+  check( rho > TM_MIN_SIZE,
+      "Size function return value lower than defined minimum scale.");
+
+  if ( len <= rho )
+    return;
+
+  tmDomain_refineCut(mesh, xy_a, rho_a, xy_m, rho_m, shift,
+                     pos, n_pos, max);
+
+  tmDomain_pushPos(pos, n_pos, max, xy_m, rho_m);
+
+  tmDomain_refineCut(mesh, xy_m, rho_m, xy_b, rho_b, shift,
+                     pos, n_pos, max);
+
+error:
+  return;
+
+} /* tmDomain_refineCut() */
+
+/**********************************************************
+* Function: tmDomain_trace()
+*----------------------------------------------------------
+* Traces the boundary loops of the domain on one side 
+* of a cut. Whenever a loop leaves this side, the 
+* tracing continues along the cut interval to the loop,
+* which enters the side at the other end of the interval.
+*----------------------------------------------------------
+* @param *cut: cut data
+* @param pos: TRUE -> trace side xy[axis] > c
+* @return: list of the traced tmDomainLoops
+**********************************************************/
+static tmList *tmDomain_trace(tmDomainCut *cut, tmBool pos)
+{
+  tmDomain *dom   = cut->dom;
+  tmList   *loops = tmList_create();
+  int l0, i0, k;
+
+  for (l0 = 0; l0 < dom->n_loops; l0++)
+  {
+    for (i0 = 0; i0 < dom->loops[l0].n_verts; i0++)
+    {
+      tmDomainVert *v0 = &dom->loops[l0].verts[i0];
+
+      if ( cut->visited[cut->offset[l0] + i0] || 
+           (tmDomain_vertDist(cut, v0) >= 0.0) != pos )
+        continue;
+
+      tmDomainLoop *out = (tmDomainLoop*) calloc( 1, 
+                                      sizeof(tmDomainLoop) );
+      check_mem(out);
+      tmList_push(loops, out);
+
+      int max = 0;
+      int l   = l0;
+      int i   = i0;
+
+      do
+      {
+        tmDomainLoop *loop = &dom->loops[l];
+        int           x    = cut->seg_cross[cut->offset[l] + i];
+
+        cut->visited[cut->offset[l] + i] = TRUE;
+        tmDomain_pushTraced(out, &max, &loop->verts[i]);
+
+        if (x < 0)
+        {
+          i = (i+1) % loop->n_verts;
+          continue;
+        }
+
+        /*-------------------------------------------------
+        | Follow the cut interval to the partner crossing
+        -------------------------------------------------*/
+        int           y   = (x % 2 == 0) ? x + 1 : x - 1;
+        tmDomainCross *cy = &cut->cross[y];
+        tmDomainLoop *ivl = &cut->ivls[x / 2];
+
+        for (k = 0; k < ivl->n_verts; k++)
+        {
+          int kk = (x < y) ? k : ivl->n_verts - 1 - k;
+          tmDomain_pushTraced(out, &max, &ivl->verts[kk]);
+        }
+
+        /*-------------------------------------------------
+        | Last node continues on the crossed segment
+        -------------------------------------------------*/
+        tmDomainVert *v_y = &dom->loops[cy->loop].verts[cy->seg];
+        out->verts[out->n_verts-1].marker  = v_y->marker;
+        out->verts[out->n_verts-1].sizeFac = v_y->sizeFac;
+
+        l = cy->loop;
+        i = (cy->seg + 1) % dom->loops[l].n_verts;
+      }
+      while ( l != l0 || i != i0 );
+
+      if ( out->n_verts > 1 && 
+           out->verts[out->n_verts-1].node == out->verts[0].node )
+        out->n_verts -= 1;
+
+      /*---------------------------------------------------
+      | Loops with cut intervals are always exterior loops
+      | of the subdomains, all others are kept unchanged
+      ---------------------------------------------------*/
+      out->is_interior = (tmDomain_loopArea(out) < 0.0);
+      out->index       = (out->is_interior == TRUE) 
+                       ? dom->loops[l0].index : dom->loops[0].index;
+    }
+  }
+
+  return loops;
+
+error:
+  return loops;
+
+} /* tmDomain_trace() */
+
+/**********************************************************
+* Function: tmDomain_addComponents()
+*----------------------------------------------------------
+* Creates subdomains from the traced loops of one side
+* of a cut. Every exterior loop defines a new subdomain,
+* the interior loops are assigned to the subdomain 
+* which encloses them. The size function samples of 
+* that side are distributed onto the new subdomains.
+* The traced loops pass their vertices to the 
+* subdomains.
+*----------------------------------------------------------
+* @param *cut: cut data
+* @param *loops: list of traced loops
+* @param pos: TRUE -> side xy[axis] > c
+* @param *subs: list to which the subdomains are added
+**********************************************************/
+static void tmDomain_addComponents(tmDomainCut *cut,
+                                   tmList      *loops,
+                                   tmBool       pos,
+                                   tmList      *subs)
+{
+  tmDomain   *dom = cut->dom;
+  tmListNode *cur, *cur_e;
+  tmList     *comps = tmList_create();
+  int i;
+
+  /*-------------------------------------------------------
+  | Every exterior loop defines a subdomain
+  -------------------------------------------------------*/
+  for (cur = loops->first; cur != NULL; cur = cur->next)
+  {
+    tmDomainLoop *loop = (tmDomainLoop*) cur->value;
+
+    if (loop->is_interior == TRUE)
+      continue;
+
+    tmDomain *d = tmDomain_alloc(dom->mesh, 1);
+    check(d != NULL, "Failed to create subdomain.");
+
+    d->loops[0] = *loop;
+    loop->verts = NULL;
+
+    d->samples = calloc( MAX(dom->n_samples, 1), 
+                         sizeof(*dom->samples) );
+    check_mem(d->samples);
+
+    tmList_push(comps, d);
+  }
+
+  /*-------------------------------------------------------
+  | Interior loops are assigned to enclosing subdomains
+  -------------------------------------------------------*/
+  for (cur = loops->first; cur != NULL; cur = cur->next)
+  {
+    tmDomainLoop *loop = (tmDomainLoop*) cur->value;
+
+    if (loop->verts == NULL || loop->is_interior == FALSE)
+      continue;
+
+    for (cur_e = comps->first; cur_e != NULL; cur_e = cur_e->next)
+    {
+      tmDomain *d = (tmDomain*) cur_e->value;
+
+      if ( comps->count > 1 && 
+           !tmDomain_loopInside(&d->loops[0], 
+                                loop->verts[0].node->xy) )
+        continue;
+
+      d->loops = (tmDomainLoop*) realloc( d->loops, 
+                    (d->n_loops + 1) * sizeof(tmDomainLoop) );
+      check_mem(d->loops);
+
+      d->loops[d->n_loops] = *loop;
+      d->n_loops += 1;
+      loop->verts = NULL;
+      break;
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Distribute size function samples
+  -------------------------------------------------------*/
+  for (i = 0; i < dom->n_samples; i++)
+  {
+    tmDouble *smp = dom->samples[i];
+
+    if ( (tmDomain_cutDist(cut, smp) > 0.0) != pos )
+      continue;
+
+    for (cur_e = comps->first; cur_e != NULL; cur_e = cur_e->next)
+    {
+      tmDomain *d = (tmDomain*) cur_e->value;
+
+      if ( comps->count > 1 && 
+           !tmDomain_loopInside(&d->loops[0], smp) )
+        continue;
+
+      d->samples[d->n_samples][0] = smp[0];
+      d->samples[d->n_samples][1] = smp[1];
+      d->samples[d->n_samples][2] = smp[2];
+      d->work      += smp[2];
+      d->n_samples += 1;
+      break;
+    }
+  }
+
+  for (cur_e = comps->first; cur_e != NULL; cur_e = cur_e->next)
+  {
+    tmDomain_calcGeometry( (tmDomain*) cur_e->value );
+    tmList_push(subs, cur_e->value);
+  }
+
+error:
+  tmList_destroy(comps);
+  return;
+
+} /* tmDomain_addComponents() */
+
+/**********************************************************
+* Function: tmDomain_cut()
+*----------------------------------------------------------
+* Cuts a domain along the line of a cut.
+* The nodes on the cut intervals are created in the 
+* parent mesh and are shared by the subdomains on both 
+* sides of the cut. Snapping cuts only keep the side
+* n*xy > c. 
+*
+*                  xy[axis] < c  |  xy[axis] > c
+*                                |
+*               +<-------------- Q <-------------+
+*               |                |               |
+*               |         +----- H2 <----+       |
+*               |         |      |       |       |
+*               |         +----> H1 -----+       |
+*               |                |               |
+*               +--------------> P ------------->+
+*
+* Both sides may consist of several subdomains.
+*----------------------------------------------------------
+* @param *cut: cut data, which defines the domain and 
+*              the line of the cut
+* @return: list of subdomains or NULL, if the cut is
+*          not valid
+**********************************************************/
+static tmList *tmDomain_cut(tmDomainCut *cut)
+{
+  tmDomain   *dom  = cut->dom;
+  tmMesh     *mesh = dom->mesh;
+  tmList     *subs = NULL;
+  tmListNode *cur;
+  int        *first   = NULL;
+  tmDouble  (*pos)[3] = NULL;
+  tmDouble  (*ref)[3] = NULL;
+  int         n_pos   = 0;
+  int         max_pos = 0;
+  int         n_ref   = 0;
+  tmDouble    t_pin   = 0.0;
+  tmDouble    r_pin   = 0.0;
+  int i, j, k;
+
+  if ( tmDomain_findCrossings(cut) == FALSE )
+    goto error;
+
+  /*-------------------------------------------------------
+  | Distribute the nodes on the cut intervals -> the 
+  | locations of the interior nodes of interval k are 
+  | pos[first[k]] ... pos[first[k+1]-1]
+  -------------------------------------------------------*/
+  int n_ivls = cut->n_cross / 2;
+
+  first     = (int*) calloc( n_ivls + 1, sizeof(int) );
+  cut->ivls = (tmDomainLoop*) calloc( MAX(n_ivls, 1), 
+                                      sizeof(tmDomainLoop) );
+  check_mem(first);
+  check_mem(cut->ivls);
+
+  if (cut->pin != NULL)
+  {
+    t_pin = cut->dir[0] * cut->pin[0] + cut->dir[1] * cut->pin[1];
+    r_pin = mesh->sizeFun(mesh, (tmDouble*) cut->pin);
+  }
+
+  if (cut->ref == NULL)
+  {
+    for (k = 0; k < n_ivls; k++)
+    {
+      tmDomainCross *c0 = &cut->cross[2*k];
+      tmDomainCross *c1 = &cut->cross[2*k+1];
+
+      first[k] = n_pos;
+
+      /*---------------------------------------------------
+      | A pinned location within the interval becomes a 
+      | node of the cut
+      ---------------------------------------------------*/
+      if ( cut->pin != NULL &&
+           t_pin - c0->t > TM_DOMAIN_SNAP_FAC * r_pin &&
+           c1->t - t_pin > TM_DOMAIN_SNAP_FAC * r_pin )
+      {
+        tmDouble xy_pin[2] = { cut->pin[0], cut->pin[1] };
+
+        tmDomain_refineCut(mesh, c0->xy, c0->rho, xy_pin, r_pin, 
+                           NULL, &pos, &n_pos, &max_pos);
+        tmDomain_pushPos(&pos, &n_pos, &max_pos, xy_pin, r_pin);
+        tmDomain_refineCut(mesh, xy_pin, r_pin, c1->xy, c1->rho, 
+                           NULL, &pos, &n_pos, &max_pos);
+      }
+      else
+        tmDomain_refineCut(mesh, c0->xy, c0->rho, c1->xy, c1->rho, 
+                           NULL, &pos, &n_pos, &max_pos);
+    }
+    first[n_ivls] = n_pos;
+  }
+
+  /*-------------------------------------------------------
+  | Symmetric cuts prescribe the nodes on the side 
+  | t > t_pin and their images on the other side
+  -------------------------------------------------------*/
+  if (cut->ref == NULL && cut->pin_sym == TRUE && cut->pin != NULL)
+  {
+    ref = calloc( 2 * n_pos + 1, sizeof(*ref) );
+    check_mem(ref);
+
+    ref[n_ref][0] = cut->pin[0];
+    ref[n_ref][1] = cut->pin[1];
+    ref[n_ref][2] = r_pin;
+    n_ref += 1;
+
+    for (i = 0; i < n_pos; i++)
+    {
+      tmDouble t = cut->dir[0] * pos[i][0] + cut->dir[1] * pos[i][1];
+
+      if ( t - t_pin <= TM_DOMAIN_SNAP_FAC * pos[i][2] )
+        continue;
+
+      ref[n_ref][0] = pos[i][0];
+      ref[n_ref][1] = pos[i][1];
+      ref[n_ref][2] = pos[i][2];
+      ref[n_ref+1][0] = 2.0 * cut->pin[0] - pos[i][0];
+      ref[n_ref+1][1] = 2.0 * cut->pin[1] - pos[i][1];
+      ref[n_ref+1][2] = pos[i][2];
+      n_ref += 2;
+    }
+
+    cut->ref   = (const tmDouble (*)[3]) ref;
+    cut->n_ref = n_ref;
+  }
+
+  /*-------------------------------------------------------
+  | Prescribed nodes are sorted along the cut and 
+  | assigned to the intervals, which contain them
+  -------------------------------------------------------*/
+  if (cut->ref != NULL)
+  {
+    tmDouble (*srt)[4] = calloc( MAX(cut->n_ref, 1), sizeof(*srt) );
+    check_mem(srt);
+
+    for (i = 0; i < cut->n_ref; i++)
+    {
+      srt[i][0] = cut->dir[0] * cut->ref[i][0] 
+                + cut->dir[1] * cut->ref[i][1];
+      srt[i][1] = cut->ref[i][0];
+      srt[i][2] = cut->ref[i][1];
+      srt[i][3] = cut->ref[i][2];
+    }
+
+    qsort(srt, cut->n_ref, sizeof(*srt), tmDomain_cmpSamplesX);
+
+    n_pos = 0;
+    for (k = 0, i = 0; k < n_ivls; k++)
+    {
+      tmDomainCross *c0 = &cut->cross[2*k];
+      tmDomainCross *c1 = &cut->cross[2*k+1];
+
+      first[k] = n_pos;
+
+      for (; i < cut->n_ref; i++)
+      {
+        tmDouble tol = TM_DOMAIN_SNAP_FAC * srt[i][3];
+
+        if ( srt[i][0] >= c1->t - tol )
+          break;
+
+        if ( srt[i][0] > c0->t + tol )
+          tmDomain_pushPos(&pos, &n_pos, &max_pos, 
+                           &srt[i][1], srt[i][3]);
+      }
+    }
+    first[n_ivls] = n_pos;
+
+    free(srt);
+  }
+
+  /*-------------------------------------------------------
+  | Create the interval nodes
+  -------------------------------------------------------*/
+  for (k = 0; k < n_ivls; k++)
+  {
+    tmDomainLoop  *ivl = &cut->ivls[k];
+    tmDomainCross *c0  = &cut->cross[2*k];
+    tmDomainCross *c1  = &cut->cross[2*k+1];
+    int            max = 0;
+
+    tmDomainVert v0 = { c0->node, c0->rho, TM_DOMAIN_MARKER, 1.0 };
+    tmDomainVert v1 = { c1->node, c1->rho, TM_DOMAIN_MARKER, 1.0 };
+
+    if (v0.node == NULL)
+      v0.node = tmNode_create(mesh, c0->xy);
+
+    tmDomain_pushVert(ivl, &max, &v0);
+
+    for (i = first[k]; i < first[k+1]; i++)
+    {
+      tmDomainVert v = { tmNode_create(mesh, pos[i]), pos[i][2], 
+                         TM_DOMAIN_MARKER, 1.0 };
+      tmDomain_pushVert(ivl, &max, &v);
+    }
+
+    if (v1.node == NULL)
+      v1.node = tmNode_create(mesh, c1->xy);
+
+    tmDomain_pushVert(ivl, &max, &v1);
+  }
+
+  /*-------------------------------------------------------
+  | Crossings of every loop segment
+  -------------------------------------------------------*/
+  cut->offset = (int*) calloc( dom->n_loops + 1, sizeof(int) );
+  check_mem(cut->offset);
+
+  for (j = 0; j < dom->n_loops; j++)
+    cut->offset[j+1] = cut->offset[j] + dom->loops[j].n_verts;
+
+  cut->seg_cross = (int*)    calloc( cut->offset[dom->n_loops], 
+                                     sizeof(int) );
+  cut->visited   = (tmBool*) calloc( cut->offset[dom->n_loops], 
+                                     sizeof(tmBool) );
+  check_mem(cut->seg_cross);
+  check_mem(cut->visited);
+
+  for (i = 0; i < cut->offset[dom->n_loops]; i++)
+    cut->seg_cross[i] = -1;
+
+  for (k = 0; k < cut->n_cross; k++)
+    cut->seg_cross[ cut->offset[cut->cross[k].loop] 
+                  + cut->cross[k].seg ] = k;
+
+  /*-------------------------------------------------------
+  | Trace both sides of the cut
+  -------------------------------------------------------*/
+  subs = tmList_create();
+
+  for (k = (cut->snap == TRUE) ? 1 : 0; k < 2; k++)
+  {
+    tmList *loops = tmDomain_trace(cut, (tmBool) k);
+
+    tmDomain_addComponents(cut, loops, (tmBool) k, subs);
+
+    for (cur = loops->first; cur != NULL; cur = cur->next)
+    {
+      free( ((tmDomainLoop*)cur->value)->verts );
+      free( cur->value );
+    }
+    tmList_destroy(loops);
+  }
+
+error:
+  if (cut->ivls != NULL)
+    for (k = 0; k < cut->n_cross / 2; k++)
+      free(cut->ivls[k].verts);
+
+  free(cut->ivls);
+  free(first);
+  free(pos);
+  free(ref);
+  free(cut->cross);
+  free(cut->offset);
+  free(cut->seg_cross);
+  free(cut->visited);
+
+  return subs;
+
+} /* tmDomain_cut() */
+
+/**********************************************************
+* Function: tmDomain_split()
+*----------------------------------------------------------
+* Splits a domain along a straight axis-aligned cut
+* into subdomains with a similar estimated number
+* of elements. 
+* Nodes on the cut are distributed according to the 
+* size function of the parent mesh and are shared by 
+* the subdomains on both sides.
+* Usually, two subdomains are created, but depending on
+* the domain shape, the cut may result in more.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain to split
+* @return: list of subdomains or NULL, if no suitable
+*          cut has been found
+**********************************************************/
+tmList *tmDomain_split(tmDomain *dom)
+{
+  tmList *subs;
+  int i, k;
+
+  tmDouble dx = dom->xy_max[0] - dom->xy_min[0];
+  tmDouble dy = dom->xy_max[1] - dom->xy_min[1];
+
+  /*-------------------------------------------------------
+  | Try to cut along the longer side first
+  -------------------------------------------------------*/
+  int axes[2] = { 0, 1 };
+  if (dy > dx)
+  {
+    axes[0] = 1;
+    axes[1] = 0;
+  }
+
+  for (i = 0; i < 2; i++)
+  {
+    int      axis = axes[i];
+    tmDouble c0   = tmDomain_medianCut(dom, axis);
+    tmDouble h    = TM_DOMAIN_CUT_STEP
+                  * (dom->xy_max[axis] - dom->xy_min[axis]);
+
+    /*-----------------------------------------------------
+    | Shift the cut alternately, if it is not valid
+    -----------------------------------------------------*/
+    for (k = 0; k <= 2*TM_DOMAIN_CUT_TRIES; k++)
+    {
+      tmDouble s = (k % 2 == 0) ? -1.0 : 1.0;
+      tmDouble c = c0 + s * (tmDouble)((k+1)/2) * h;
+
+      if ( c <= dom->xy_min[axis] || c >= dom->xy_max[axis] )
+        continue;
+
+      tmDomainCut cut;
+      memset(&cut, 0, sizeof(tmDomainCut));
+      cut.dom         = dom;
+      cut.axis        = axis;
+      cut.n[axis]     = 1.0;
+      cut.dir[1-axis] = 1.0;
+      cut.c           = c;
+
+      subs = tmDomain_cut(&cut);
+
+      if (subs != NULL)
+        return subs;
+    }
+  }
+
+  return NULL;
+
+} /* tmDomain_split() */
+
+/**********************************************************
+* Function: tmDomain_clip()
+*----------------------------------------------------------
+* Clips a domain to the half plane n*xy >= c.
+* Nodes on the clipping line are distributed according
+* to the size function of the parent mesh. Loop vertices
+* on the line are kept as nodes of the line, such that
+* the mirror image of the clipped domain matches it 
+* along the line, unless the line is bent.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain to clip
+* @param n: unit normal of the clipping line
+* @param c: location of the clipping line
+* @param bend: TRUE -> crossings of the line with loop 
+*              segments, which are located close to a 
+*              loop vertex, are moved onto the vertex
+* @param pin: location on the line, which becomes a node
+*             of the line, or NULL
+* @param pin_sym: TRUE -> the nodes on the line are 
+*                 point symmetric to the pin
+* @param ref: prescribed locations (x, y, size) of the 
+*             nodes on the line or NULL
+* @param n_ref: number of prescribed locations
+* @return: list of subdomains (empty, if the domain is 
+*          located outside of the half plane) or NULL, 
+*          if the line can not be used as cut
+**********************************************************/
+tmList *tmDomain_clip(tmDomain       *dom, 
+                      const tmDouble  n[2], 
+                      tmDouble        c,
+                      tmBool          bend,
+                      const tmDouble *pin,
+                      tmBool          pin_sym,
+                      const tmDouble (*ref)[3],
+                      int             n_ref)
+{
+  tmDomainCut cut;
+
+  memset(&cut, 0, sizeof(tmDomainCut));
+  cut.dom     = dom;
+  cut.axis    = -1;
+  cut.n[0]    =  n[0];
+  cut.n[1]    =  n[1];
+  cut.dir[0]  = -n[1];
+  cut.dir[1]  =  n[0];
+  cut.c       = c;
+  cut.snap    = TRUE;
+  cut.bend    = bend;
+  cut.pin     = pin;
+  cut.pin_sym = pin_sym;
+  cut.ref     = ref;
+  cut.n_ref   = n_ref;
+
+  return tmDomain_cut(&cut);
+
+} /* tmDomain_clip() */
+
+/**********************************************************
+* Function: tmDomain_isInvariant()
+*----------------------------------------------------------
+* Checks if the boundary loops of a domain are mapped 
+* onto themselves by an isometry, i.e. if every loop 
+* segment is mapped onto a loop segment with the same
+* boundary marker.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+* @param trafo: isometry xy -> trafo * (xy, 1)
+* @return: TRUE, if the loops are invariant
+**********************************************************/
+tmBool tmDomain_isInvariant(tmDomain       *dom,
+                            const tmDouble  trafo[2][3])
+{
+  tmMesh     *mesh = dom->mesh;
+  tmListNode *cur;
+  tmBool      mirrored = ( trafo[0][0] * trafo[1][1] 
+                         - trafo[0][1] * trafo[1][0] < 0.0 );
+  int         i, j;
+
+  for (i = 0; i < dom->n_loops; i++)
+  {
+    tmDomainLoop *loop = &dom->loops[i];
+
+    for (j = 0; j < loop->n_verts; j++)
+    {
+      tmDomainVert *v = &loop->verts[j];
+      tmDomainVert *w = &loop->verts[(j+1)%loop->n_verts];
+      tmDouble      xy_v[2], xy_w[2];
+
+      tmDomain_mapCoords(trafo, v->node->xy, xy_v);
+      tmDomain_mapCoords(trafo, w->node->xy, xy_w);
+
+      tmNode *n1 = tmDomain_findNode(mesh, xy_v, 
+                                     TM_DOMAIN_SNAP_FAC * v->rho);
+      tmNode *n2 = tmDomain_findNode(mesh, xy_w, 
+                                     TM_DOMAIN_SNAP_FAC * w->rho);
+
+      if (n1 == NULL || n2 == NULL)
+        return FALSE;
+
+      /*---------------------------------------------------
+      | Mirror images have the opposite orientation
+      ---------------------------------------------------*/
+      if (mirrored == TRUE)
+      {
+        tmNode *tmp = n1;
+        n1 = n2;
+        n2 = tmp;
+      }
+
+      for (cur = n1->bdry_edges->first; cur != NULL; cur = cur->next)
+      {
+        tmEdge *e = (tmEdge*) cur->value;
+
+        if ( e->n1 == n1 && e->n2 == n2 && 
+             e->bdry_marker == v->marker )
+          break;
+      }
+
+      if (cur == NULL)
+        return FALSE;
+    }
+  }
+
+  return TRUE;
+
+} /* tmDomain_isInvariant() */
+
+/**********************************************************
+* Function: tmDomain_createImage()
+*----------------------------------------------------------
+* Creates the image of a domain under an isometry.
+* The image has no loops and no mesh of its own, but 
+* merges the mesh of its source domain, mapped by the 
+* isometry, into the parent mesh. 
+*----------------------------------------------------------
+* @param *dom: pointer to the source domain
+* @param trafo: isometry xy -> trafo * (xy, 1)
+* @return: pointer to the new image domain
+**********************************************************/
+tmDomain *tmDomain_createImage(tmDomain       *dom,
+                               const tmDouble  trafo[2][3])
+{
+  tmDomain *img = tmDomain_alloc(dom->mesh, 0);
+  check(img != NULL, "Failed to create domain image.");
+
+  img->source = dom;
+  memcpy(img->trafo, trafo, sizeof(img->trafo));
+
+  img->area = dom->area;
+  img->work = dom->work;
+
+  return img;
+
+error:
+  return NULL;
+
+} /* tmDomain_createImage() */
+
+/**********************************************************
+* Function: tmDomain_matchSides()
+*----------------------------------------------------------
+* Distributes nodes on the sides of a rectangular 
+* domain, such that opposite sides have the same nodes
+* up to a translation by the domain width / height.
+* The nodes suit the size function on both sides.
+* Hence, translated copies of the domain share their
+* nodes on common sides (periodic cells).
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+* @return: FALSE, if the exterior loop is not an 
+*          axis-aligned rectangle
+**********************************************************/
+tmBool tmDomain_matchSides(tmDomain *dom)
+{
+  tmMesh       *mesh      = dom->mesh;
+  tmDomainLoop *ext       = &dom->loops[0];
+  tmDomainLoop  loop      = *ext;
+  tmDouble    (*par)[3]   = NULL;
+  tmDouble    (*pos[2])[3] = { NULL, NULL };
+  int           n_pos[2]  = { 0, 0 };
+  int           max[2]    = { 0, 0 };
+  int          *sides     = NULL;
+  int           n_par     = 0;
+  int           max_par   = 0;
+  int           max_verts = 0;
+  tmBool        success   = FALSE;
+  int           c, i, j, k;
+
+  tmDouble size[2] = { dom->xy_max[0] - dom->xy_min[0],
+                       dom->xy_max[1] - dom->xy_min[1] };
+
+  sides = (int*) calloc(ext->n_verts, sizeof(int));
+  check_mem(sides);
+
+  /*-------------------------------------------------------
+  | Bit 2*c+s of sides[j] marks vertex j to be located on 
+  | the side xy[c] = xy_min[c] (s = 0) or xy_max[c] (s = 1)
+  -------------------------------------------------------*/
+  for (j = 0; j < ext->n_verts; j++)
+  {
+    tmDomainVert *v   = &ext->verts[j];
+    tmDouble      tol = TM_DOMAIN_SNAP_FAC * v->rho;
+
+    for (c = 0; c < 2; c++)
+    {
+      if ( fabs(v->node->xy[c] - dom->xy_min[c]) <= tol )
+        sides[j] |= 1 << (2*c);
+      if ( fabs(v->node->xy[c] - dom->xy_max[c]) <= tol )
+        sides[j] |= 1 << (2*c+1);
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Every segment must be located on a side of the 
+  | bounding box and the loop must enclose all of it
+  -------------------------------------------------------*/
+  for (j = 0; j < ext->n_verts; j++)
+    if ( (sides[j] & sides[(j+1)%ext->n_verts]) == 0 )
+      goto error;
+
+  if ( fabs(tmDomain_loopArea(ext) - size[0] * size[1]) > 
+       TM_DOMAIN_SNAP_FAC * size[0] * size[1] )
+    goto error;
+
+  /*-------------------------------------------------------
+  | Merge the vertices of opposite sides xy[c] = const
+  | and refine the intervals between them according to
+  | the size function on both sides
+  -------------------------------------------------------*/
+  for (c = 0; c < 2; c++)
+  {
+    int      p        = 1 - c;
+    tmDouble shift[2] = { 0.0, 0.0 };
+    shift[c] = size[c];
+
+    n_par = 0;
+
+    for (j = 0; j < ext->n_verts; j++)
+    {
+      if ( (sides[j] & (3 << (2*c))) == 0 )
+        continue;
+
+      tmDouble xy[2], xy_s[2];
+      xy[c]   = dom->xy_min[c];
+      xy[p]   = ext->verts[j].node->xy[p];
+      xy_s[c] = dom->xy_max[c];
+      xy_s[p] = xy[p];
+
+      tmDomain_pushPos(&par, &n_par, &max_par, xy,
+                       MIN(mesh->sizeFun(mesh, xy), 
+                           mesh->sizeFun(mesh, xy_s)));
+    }
+
+    qsort(par, n_par, sizeof(*par), 
+          (p == 0) ? tmDomain_cmpSamplesX : tmDomain_cmpSamplesY);
+
+    for (i = 0; i < n_par; i++)
+    {
+      if (n_pos[c] > 0)
+      {
+        tmDouble *q     = pos[c][n_pos[c]-1];
+        tmDouble  xy[2] = { q[0], q[1] };
+        tmDouble  rho   = q[2];
+
+        if ( par[i][p] - xy[p] <= TM_DOMAIN_SNAP_FAC * par[i][2] )
+          continue;
+
+        tmDomain_refineCut(mesh, xy, rho, par[i], par[i][2], shift,
+                           &pos[c], &n_pos[c], &max[c]);
+      }
+
+      tmDomain_pushPos(&pos[c], &n_pos[c], &max[c], 
+                       par[i], par[i][2]);
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Insert the nodes into the segments of the loop
+  -------------------------------------------------------*/
+  loop.verts   = NULL;
+  loop.n_verts = 0;
+
+  for (j = 0; j < ext->n_verts; j++)
+  {
+    tmDomainVert *v    = &ext->verts[j];
+    tmDomainVert *w    = &ext->verts[(j+1)%ext->n_verts];
+    int           side = sides[j] & sides[(j+1)%ext->n_verts];
+
+    tmDomain_pushVert(&loop, &max_verts, v);
+
+    c = ( (side & 3) != 0 ) ? 0 : 1;
+
+    int      p   = 1 - c;
+    tmDouble s_v = v->node->xy[p];
+    tmDouble s_w = w->node->xy[p];
+    tmDouble dir = (s_w > s_v) ? 1.0 : -1.0;
+
+    for (i = 0; i < n_pos[c]; i++)
+    {
+      k = (dir > 0.0) ? i : n_pos[c] - 1 - i;
+
+      tmDouble *q   = pos[c][k];
+      tmDouble  tol = TM_DOMAIN_SNAP_FAC * q[2];
+
+      if ( dir * (q[p] - s_v) <= tol || dir * (s_w - q[p]) <= tol )
+        continue;
+
+      tmDouble xy[2];
+      xy[c] = v->node->xy[c];
+      xy[p] = q[p];
+
+      tmDomainVert u = { tmNode_create(mesh, xy), q[2], 
+                         v->marker, v->sizeFac };
+      tmDomain_pushVert(&loop, &max_verts, &u);
+    }
+  }
+
+  free(ext->verts);
+  *ext    = loop;
+  success = TRUE;
+
+error:
+  free(sides);
+  free(par);
+  free(pos[0]);
+  free(pos[1]);
+  return success;
+
+} /* tmDomain_matchSides() */
+
+/**********************************************************
+* Function: tmDomain_createMesh()
+*----------------------------------------------------------
+* Creates the mesh of a subdomain with boundaries
+* according to the subdomain loops.
+* The mesh evaluates the size function of its parent.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+* @return: pointer to the subdomain mesh
+**********************************************************/
+tmMesh *tmDomain_createMesh(tmDomain *dom)
+{
+  tmMesh *mesh = dom->mesh;
+  int i, j;
+
+  tmDouble d = 0.05 * MAX(dom->xy_max[0] - dom->xy_min[0],
+                          dom->xy_max[1] - dom->xy_min[1]);
+
+  tmDouble xy_min[2] = { dom->xy_min[0] - d, dom->xy_min[1] - d };
+  tmDouble xy_max[2] = { dom->xy_max[0] + d, dom->xy_max[1] + d };
+
+  tmMesh *sub = tmMesh_create(xy_min, xy_max,
+                              mesh->qtree_max_obj,
+                              mesh->globSize,
+                              mesh->sizeFunUser);
+  check(sub != NULL, "Failed to create subdomain mesh.");
+  sub->parent      = mesh;
+  sub->subdivision = mesh->subdivision;
+
+  dom->sub          = sub;
+  dom->n_bdry_nodes = 0;
+
+  /*-------------------------------------------------------
+  | The boundary nodes are the first nodes of the mesh
+  -------------------------------------------------------*/
+  for (i = 0; i < dom->n_loops; i++)
+  {
+    tmDomainLoop *loop = &dom->loops[i];
+    tmBdry *bdry = tmMesh_addBdry(sub, loop->is_interior,
+                                  loop->index);
+
+    tmNode *first = tmNode_create(sub, loop->verts[0].node->xy);
+    tmNode *prev  = first;
+
+    for (j = 1; j <= loop->n_verts; j++)
+    {
+      tmNode *node = first;
+
+      if (j < loop->n_verts)
+        node = tmNode_create(sub, loop->verts[j].node->xy);
+
+      tmBdry_edgeCreate(bdry, prev, node,
+                        loop->verts[j-1].marker,
+                        loop->verts[j-1].sizeFac);
+      prev = node;
+    }
+
+    dom->n_bdry_nodes += loop->n_verts;
+  }
+
+  return sub;
+
+error:
+  return NULL;
+
+} /* tmDomain_createMesh() */
+
+/**********************************************************
+* Function: tmDomain_mergeTris()
+*----------------------------------------------------------
+* Copies the nodes and triangles of a meshed subdomain
+* to its parent mesh. Boundary nodes of the subdomain
+* are mapped onto the existing parent nodes.
+* Images copy the mesh of their source domain, where 
+* the boundary nodes are mapped onto the parent nodes
+* at their image locations or created, if there are none.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+**********************************************************/
+void tmDomain_mergeTris(tmDomain *dom)
+{
+  tmDomain   *src  = (dom->source != NULL) ? dom->source : dom;
+  tmMesh     *mesh = dom->mesh;
+  tmMesh     *sub  = src->sub;
+  tmListNode *cur;
+  int i, j, k;
+
+  tmBool mirrored = ( dom->trafo[0][0] * dom->trafo[1][1] 
+                    - dom->trafo[0][1] * dom->trafo[1][0] < 0.0 );
+
+  dom->node_map = (tmNode**) calloc( sub->no_nodes,
+                                     sizeof(tmNode*) );
+  dom->tri_map  = (tmTri**)  calloc( sub->no_tris,
+                                     sizeof(tmTri*) );
+  check_mem(dom->node_map);
+  check_mem(dom->tri_map);
+
+  /*-------------------------------------------------------
+  | Map boundary nodes onto parent nodes
+  -------------------------------------------------------*/
+  k = 0;
+  for (i = 0; i < src->n_loops; i++)
+  {
+    for (j = 0; j < src->loops[i].n_verts; j++)
+    {
+      tmDomainVert *v = &src->loops[i].verts[j];
+
+      if (dom->source == NULL)
+        dom->node_map[k] = v->node;
+      else
+      {
+        tmDouble xy[2];
+        tmDomain_mapCoords(dom->trafo, v->node->xy, xy);
+        dom->node_map[k] = tmDomain_findNode(mesh, xy, 
+                                   TM_DOMAIN_SNAP_FAC * v->rho);
+      }
+      k += 1;
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Copy all other nodes
+  -------------------------------------------------------*/
+  for (cur = sub->nodes_stack->first, k = 0;
+       cur != NULL; cur = cur->next, k++)
+  {
+    tmNode *node = (tmNode*) cur->value;
+    node->index  = k;
+
+    if (dom->source == NULL && k >= src->n_bdry_nodes)
+    {
+      dom->node_map[k] = tmNode_create(mesh, node->xy);
+      dom->node_map[k]->size = node->size;
+    }
+    else if (dom->source != NULL && dom->node_map[k] == NULL)
+    {
+      tmDouble xy[2];
+      tmDomain_mapCoords(dom->trafo, node->xy, xy);
+      dom->node_map[k] = tmNode_create(mesh, xy);
+      dom->node_map[k]->size = node->size;
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Copy triangles
+  -------------------------------------------------------*/
+  for (cur = sub->tris_stack->first, k = 0;
+       cur != NULL; cur = cur->next, k++)
+  {
+    tmTri  *tri = (tmTri*) cur->value;
+    tmNode *n2  = dom->node_map[tri->n2->index];
+    tmNode *n3  = dom->node_map[tri->n3->index];
+    tri->index  = k;
+
+    /*-----------------------------------------------------
+    | Mirror images have the opposite orientation
+    -----------------------------------------------------*/
+    if (mirrored == TRUE)
+    {
+      n2 = dom->node_map[tri->n3->index];
+      n3 = dom->node_map[tri->n2->index];
+    }
+
+    dom->tri_map[k] = tmTri_create(mesh,
+                                   dom->node_map[tri->n1->index],
+                                   n2, n3);
+  }
+
+error:
+  return;
+
+} /* tmDomain_mergeTris() */
+
+/**********************************************************
+* Function: tmDomain_getTriLeft()
+*----------------------------------------------------------
+* Returns the triangle, which is located to the left
+* of the edge (n1,n2)
+*----------------------------------------------------------
+* @param *n1, *n2: edge nodes
+* @return: triangle or NULL, if there is none
+**********************************************************/
+static tmTri *tmDomain_getTriLeft(tmNode *n1, tmNode *n2)
+{
+  tmListNode *cur;
+
+  for (cur = n1->tris->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *t = (tmTri*) cur->value;
+
+    if ( (t->n1 == n1 && t->n2 == n2) ||
+         (t->n2 == n1 && t->n3 == n2) ||
+         (t->n3 == n1 && t->n1 == n2) )
+      return t;
+  }
+
+  return NULL;
+
+} /* tmDomain_getTriLeft() */
+
+/**********************************************************
+* Function: tmDomain_mergeEdges()
+*----------------------------------------------------------
+* Copies the edges of a meshed subdomain to its parent
+* mesh. Edges on subdomain interfaces and boundary 
+* edges, which are shared with another subdomain, are 
+* created only once and are connected to the triangles
+* on both sides. This requires, that all subdomains have
+* been merged with tmDomain_mergeTris() before.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+* @return: FALSE, if an interface edge does not match
+**********************************************************/
+tmBool tmDomain_mergeEdges(tmDomain *dom)
+{
+  tmDomain   *src  = (dom->source != NULL) ? dom->source : dom;
+  tmMesh     *mesh = dom->mesh;
+  tmMesh     *sub  = src->sub;
+  tmListNode *cur;
+
+  tmBool mirrored = ( dom->trafo[0][0] * dom->trafo[1][1] 
+                    - dom->trafo[0][1] * dom->trafo[1][0] < 0.0 );
+
+  for (cur = sub->edges_stack->first;
+       cur != NULL; cur = cur->next)
+  {
+    tmEdge *e  = (tmEdge*) cur->value;
+    tmNode *n1 = dom->node_map[e->n1->index];
+    tmNode *n2 = dom->node_map[e->n2->index];
+    tmTri  *t1 = NULL;
+    tmTri  *t2 = NULL;
+    tmIndex marker = e->bdry_marker;
+
+    if (e->t1 != NULL)
+      t1 = dom->tri_map[e->t1->index];
+    if (e->t2 != NULL)
+      t2 = dom->tri_map[e->t2->index];
+
+    /*-----------------------------------------------------
+    | t1 remains to the left of mirrored edges 
+    -----------------------------------------------------*/
+    if (mirrored == TRUE)
+    {
+      n1 = dom->node_map[e->n2->index];
+      n2 = dom->node_map[e->n1->index];
+    }
+
+    /*-----------------------------------------------------
+    | Interface edges are created by the subdomain,
+    | for which the edge nodes are in ascending order.
+    | The triangle to the right belongs to the
+    | neighboring subdomain.
+    -----------------------------------------------------*/
+    if (marker == TM_DOMAIN_MARKER)
+    {
+      if (n1->index > n2->index)
+        continue;
+
+      t2 = tmDomain_getTriLeft(n2, n1);
+      check(t2 != NULL,
+          "Subdomain interface edge (%d,%d) does not match.",
+          n1->index, n2->index);
+
+      marker = -1;
+    }
+    /*-----------------------------------------------------
+    | Boundary edges, which are shared by translated 
+    | copies of a periodic domain, become interior edges
+    -----------------------------------------------------*/
+    else if ( t2 == NULL && 
+              (t2 = tmDomain_getTriLeft(n2, n1)) != NULL )
+    {
+      if (n1->index > n2->index)
+        continue;
+
+      marker = -1;
+    }
+
+    tmMesh_edgeCreate(mesh, n1, n2, t1, t2, marker);
+  }
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmDomain_mergeEdges() */
+
+/**********************************************************
+* Function: tmDomain_mergeBdrys()
+*----------------------------------------------------------
+* Copies the boundary loops of a meshed domain or image
+* to its parent mesh. Every interior loop becomes a new
+* interior boundary. Exterior loop segments are added to
+* the boundary ext, unless they are shared with another
+* subdomain. This requires, that all subdomains have been
+* merged with tmDomain_mergeEdges() before.
+*----------------------------------------------------------
+* @param *dom: pointer to the domain
+* @param *ext: exterior boundary of the parent mesh
+**********************************************************/
+void tmDomain_mergeBdrys(tmDomain *dom, tmBdry *ext)
+{
+  tmDomain *src  = (dom->source != NULL) ? dom->source : dom;
+  tmMesh   *mesh = dom->mesh;
+  int i, j, k;
+
+  tmBool mirrored = ( dom->trafo[0][0] * dom->trafo[1][1] 
+                    - dom->trafo[0][1] * dom->trafo[1][0] < 0.0 );
+
+  for (i = 0, k = 0; i < src->n_loops; i++)
+  {
+    tmDomainLoop *loop = &src->loops[i];
+    tmBdry       *bdry = ext;
+
+    if (loop->is_interior == TRUE)
+      bdry = tmMesh_addBdry(mesh, TRUE, loop->index);
+
+    for (j = 0; j < loop->n_verts; j++)
+    {
+      tmDomainVert *v  = &loop->verts[j];
+      tmNode       *n1 = dom->node_map[k + j];
+      tmNode       *n2 = dom->node_map[k + (j+1) % loop->n_verts];
+
+      if (mirrored == TRUE)
+      {
+        n1 = dom->node_map[k + (j+1) % loop->n_verts];
+        n2 = dom->node_map[k + j];
+      }
+
+      if ( loop->is_interior == FALSE && 
+           tmDomain_getTriLeft(n2, n1) != NULL )
+        continue;
+
+      tmBdry_edgeCreate(bdry, n1, n2, v->marker, v->sizeFac);
+    }
+
+    k += loop->n_verts;
+  }
+
+} /* tmDomain_mergeBdrys() */
@@ -5,6 +5,8 @@
  * Refer to the accompanying documentation for details
  * on usage and license.
  */
+#include <limits.h>
+
 #include "tmesh/tmTypedefs.h"
 #include "tmesh/tmList.h"
 #include "tmesh/tmMesh.h"
@@ -13,6 +15,87 @@
 #include "tmesh/tmBdry.h"
 #include "tmesh/tmFront.h"
 #include "tmesh/tmTri.h"
+#include "tmesh/tmQtree.h"
+#include "tmesh/tmAtomic.h"
+
+/**********************************************************
+* Function: tmEdge_calcGeometry()
+*----------------------------------------------------------
+* Computes centroid, length, tangential and normal 
+* vectors of an edge from its nodes
+*----------------------------------------------------------
+* @param edge: pointer to edge
+**********************************************************/
+static void tmEdge_calcGeometry(tmEdge *edge);
+
+/**********************************************************
+*
+**********************************************************/
+static void tmEdge_calcGeometry(tmEdge *edge)
+{
+  edge->xy[0] = 0.5 * (edge->n1->xy[0] + edge->n2->xy[0]);
+  edge->xy[1] = 0.5 * (edge->n1->xy[1] + edge->n2->xy[1]);
+  edge->size  = 0.0;
+
+  const tmDouble dx = edge->n2->xy[0] - edge->n1->xy[0];
+  const tmDouble dy = edge->n2->xy[1] - edge->n1->xy[1];
+
+  edge->len = sqrt(dx*dx + dy*dy);
+
+  edge->dxy_t[0] = dx / edge->len;
+  edge->dxy_t[1] = dy / edge->len;
+
+  edge->dxy_n[0] =-dy / edge->len;
+  edge->dxy_n[1] = dx / edge->len;
+
+} /* tmEdge_calcGeometry() */
+
+/**********************************************************
+* Function: tmEdge_setTriNbrs()
+*----------------------------------------------------------
+* Sets the neighbors of a triangle from the mesh edges
+* it is adjacent to and updates the neighbor references 
+* of the adjacent triangles accordingly. 
+* Triangle sides without neighbor refer to the triangle
+* itself (as done by tmMesh_setTriNeighbors()).
+*----------------------------------------------------------
+* @param tri: pointer to triangle
+**********************************************************/
+void tmEdge_setTriNbrs(tmTri *tri)
+{
+  int i;
+  tmEdge *edges[3] = { tri->e1, tri->e2, tri->e3 };
+  tmTri  *nbrs[3]  = { tri, tri, tri };
+
+  for (i = 0; i < 3; i++)
+  {
+    tmEdge *e = edges[i];
+
+    if ( e == NULL )
+      continue;
+
+    tmTri *t_nb = (e->t1 == tri) ? e->t2 : e->t1;
+
+    if ( t_nb == NULL )
+      continue;
+
+    nbrs[i] = t_nb;
+
+    if ( t_nb->e1 == e )
+      t_nb->t1 = tri;
+    else if ( t_nb->e2 == e )
+      t_nb->t2 = tri;
+    else if ( t_nb->e3 == e )
+      t_nb->t3 = tri;
+    else
+      log_err("Wrong triangle-edge connectivity");
+  }
+
+  tri->t1 = nbrs[0];
+  tri->t2 = nbrs[1];
+  tri->t3 = nbrs[2];
+
+} /* tmEdge_setTriNbrs() */
 
 
 /**********************************************************
@@ -54,7 +137,7 @@ tmEdge *tmEdge_create(tmMesh  *mesh,
   edge->is_on_bdry        = FALSE;
   edge->is_on_front       = FALSE;
   edge->is_on_mesh        = FALSE;
-  edge->is_local_delaunay = FALSE;
+  edge->is_local_delaunay = TRUE;
   edge->bdry_marker       = -1;
 
   /*-------------------------------------------------------
@@ -78,19 +161,7 @@ tmEdge *tmEdge_create(tmMesh  *mesh,
   /*-------------------------------------------------------
   | Init geometric edge properties
   -------------------------------------------------------*/
-  edge->xy[0] = 0.5 * (n1->xy[0] + n2->xy[0]);
-  edge->xy[1] = 0.5 * (n1->xy[1] + n2->xy[1]);
-
-  const tmDouble dx = n2->xy[0] - n1->xy[0];
-  const tmDouble dy = n2->xy[1] - n1->xy[1];
-
-  edge->len = sqrt(dx*dx + dy*dy);
-
-  edge->dxy_t[0] = dx / edge->len;
-  edge->dxy_t[1] = dy / edge->len;
-
-  edge->dxy_n[0] =-dy / edge->len;
-  edge->dxy_n[1] = dx / edge->len;
+  tmEdge_calcGeometry(edge);
 
   /*-------------------------------------------------------
   | Sizefunction and local mesh size 
@@ -251,19 +322,7 @@ void tmEdge_init(tmEdge *edge, tmBdry *bdry, tmFront *front)
   /*-------------------------------------------------------
   | Init geometric edge properties
   -------------------------------------------------------*/
-  edge->xy[0] = 0.5 * (edge->n1->xy[0] + edge->n2->xy[0]);
-  edge->xy[1] = 0.5 * (edge->n1->xy[1] + edge->n2->xy[1]);
-
-  const tmDouble dx = edge->n2->xy[0] - edge->n1->xy[0];
-  const tmDouble dy = edge->n2->xy[1] - edge->n1->xy[1];
-
-  edge->len = sqrt(dx*dx + dy*dy);
-
-  edge->dxy_t[0] = dx / edge->len;
-  edge->dxy_t[1] = dy / edge->len;
-
-  edge->dxy_n[0] =-dy / edge->len;
-  edge->dxy_n[1] = dx / edge->len;
+  tmEdge_calcGeometry(edge);
 
   /*-------------------------------------------------------
   | Init boundary edge
@@ -301,6 +360,57 @@ void tmEdge_init(tmEdge *edge, tmBdry *bdry, tmFront *front)
 } /* tmEdge_init()*/
 
 
+/**********************************************************
+* Function: tmEdge_setNodes()
+*----------------------------------------------------------
+* Redefines the nodes of an existing mesh edge in place.
+* The edge lists of the nodes are updated and the edge 
+* geometry is recomputed.
+* The edge's location in the mesh qtree is not updated
+* -> this is left to the caller (see tmQtree_updateObj()).
+* This function can also be used to update an edge, 
+* whose node coordinates have been moved.
+*----------------------------------------------------------
+* @param edge: pointer to mesh edge
+* @param n1,n2: new start and ending nodes of the edge
+**********************************************************/
+void tmEdge_setNodes(tmEdge *edge, tmNode *n1, tmNode *n2)
+{
+  check( edge->is_on_mesh == TRUE, 
+      "Only mesh edges can be redefined.");
+
+  if ( edge->n1 != n1 )
+  {
+    tmList_remove(edge->n1->mesh_edges, edge->n1_pos);
+    edge->n1->n_mesh_edges -= 1;
+
+    tmList_push(n1->mesh_edges, edge);
+    edge->n1_pos = tmList_last_node(n1->mesh_edges);
+    n1->n_mesh_edges += 1;
+
+    edge->n1 = n1;
+  }
+
+  if ( edge->n2 != n2 )
+  {
+    tmList_remove(edge->n2->mesh_edges, edge->n2_pos);
+    edge->n2->n_mesh_edges -= 1;
+
+    tmList_push(n2->mesh_edges, edge);
+    edge->n2_pos = tmList_last_node(n2->mesh_edges);
+    n2->n_mesh_edges += 1;
+
+    edge->n2 = n2;
+  }
+
+  tmEdge_calcGeometry(edge);
+
+error:
+  return;
+
+} /* tmEdge_setNodes() */
+
+
 /**********************************************************
 * Function: tmEdge_isLeft()
 *----------------------------------------------------------
@@ -453,10 +563,8 @@ tmNode *tmEdge_createNode(tmEdge *edge)
   tmDouble *xy_e  = edge->xy;
   tmDouble *dxy_n = edge->dxy_n;
 
-  tmSizeFun sizeFun = edge->mesh->sizeFun;
-
   tmDouble fac    = TM_NEW_NODE_DIST_FAC;
-  tmDouble d      = fac * sizeFun(edge->mesh, xy_e);
+  tmDouble d      = fac * tmEdge_getSize(edge);
 
   tmDouble xy_n[2]  = { xy_e[0] + d * dxy_n[0], 
                         xy_e[1] + d * dxy_n[1] };
@@ -471,8 +579,8 @@ tmNode *tmEdge_createNode(tmEdge *edge)
 * Function: tmEdge_isLocalDelaunay()
 *----------------------------------------------------------
 * Check if an edge is locally delaunay
-* If yes, put edge on the non-delaunay edge stack of the
-* mesh
+* If not, put edge on the non-delaunay edge stack of the
+* mesh, unless it is already located there
 *----------------------------------------------------------
 * @param edge: pointer to edge
 * 
@@ -552,8 +660,12 @@ void tmEdge_isDelaunay(tmEdge *edge)
 
   /*-------------------------------------------------------
   | Both triangles are delauany
+  | -> (Nearly) cocircular nodes are treated as delaunay,
+  |    otherwise round-off errors lead to endless flips
   -------------------------------------------------------*/
-  if (r2_l >= circ2_r && r2_r >= circ2_l)
+  const tmDouble fac = 1.0 - TM_DELAUNAY_TOL;
+
+  if (r2_l >= fac * circ2_r && r2_r >= fac * circ2_l)
   {
     edge->is_local_delaunay = TRUE;
     return;
@@ -566,7 +678,12 @@ void tmEdge_isDelaunay(tmEdge *edge)
   
   /*-------------------------------------------------------
   | Mark edge als non-delaunay and add it to the stack
+  | -> Edges which are already marked as non-delaunay are
+  |    still located on the stack and are not added twice
   -------------------------------------------------------*/
+  if ( edge->is_local_delaunay == FALSE )
+    return;
+
   edge->is_local_delaunay = FALSE;
   tmList_push(edge->mesh->delaunay_stack, edge);
 
@@ -579,10 +696,18 @@ error:
 
 
 /**********************************************************
-* Function: tmEdge_flipEdge()
+* Function: tmEdge_swapEdge()
 *----------------------------------------------------------
-* Perform an edge flip, in order to get a new edge
-* which satisfies the delaunay constraint.
+* Swaps an edge to the other diagonal of the quadrilateral
+* formed by its two adjacent triangles.
+* The swap is done in place: The edge and both adjacent 
+* triangles keep their memory and are only rewired.
+* Only the nodes, edges and triangles of the quadrilateral
+* and the neighbor pointers of the triangles adjacent to 
+* it are modified. The mesh area, the mesh qtrees and the 
+* delaunay stack are left untouched (see 
+* tmEdge_finishFlip()). Hence, edges whose quadrilaterals
+* do not share any node can be swapped concurrently.
 * Definition:
 *
 *                    n2
@@ -613,12 +738,11 @@ error:
 *            
 *----------------------------------------------------------
 * @param edge: pointer to edge to flip
-* @return : pointer to new edge
+* @return : pointer to the swapped edge
 * 
 **********************************************************/
-tmEdge *tmEdge_flipEdge(tmEdge *e)
+tmEdge *tmEdge_swapEdge(tmEdge *e)
 {
-  tmMesh *mesh = e->mesh;
   tmNode *p1, *p2;
   tmEdge *e11, *e12, *e21, *e22;
 
@@ -689,24 +813,24 @@ tmEdge *tmEdge_flipEdge(tmEdge *e)
     log_err("Wrong triangle definition.");
 
   /*-----------------------------------------------------
-  | Create new triangles t1*, t2* and remove old ones
+  | Redefine triangles t1*, t2* in place 
   | t1* = (n1, p1, p2)
   | t2* = (n2, p2, p1)
   -----------------------------------------------------*/
-  tmTri_destroy(t1);
-  tmTri_destroy(t2);
-  t1 = tmTri_create(mesh, n1, p1, p2);
-  t2 = tmTri_create(mesh, n2, p2, p1);
-
-  /*-----------------------------------------------------
-  | Create new edge e* = (p1, p2) and remove old one
-  -----------------------------------------------------*/
 #if (TM_DEBUG > 1)
   tmPrint("FLIPPING EDGE (%d,%d) to (%d,%d)",
       e->n1->index, e->n2->index, p1->index, p2->index);
 #endif
-  tmEdge_destroy(e);
-  e = tmMesh_edgeCreate(mesh, p1, p2, t1, t2, -1);
+  tmTri_setNodes(t1, n1, p1, p2);
+  tmTri_setNodes(t2, n2, p2, p1);
+
+  /*-----------------------------------------------------
+  | Redefine edge e* = (p1, p2) in place
+  | -> t1* is located to its left, t2* to its right
+  -----------------------------------------------------*/
+  tmEdge_setNodes(e, p1, p2);
+  e->t1 = t1;
+  e->t2 = t2;
 
   /*-----------------------------------------------------
   | Update adjacency of triangles t1*, t2* in 
@@ -759,18 +883,335 @@ tmEdge *tmEdge_flipEdge(tmEdge *e)
   t2->e2 = e22;
   t2->e3 = e11;
 
+  /*-----------------------------------------------------
+  | Update triangle neighbors of t1*, t2* and of the 
+  | triangles adjacent to them
+  -----------------------------------------------------*/
+  tmEdge_setTriNbrs(t1);
+  tmEdge_setTriNbrs(t2);
+
+  return e;
+
+error:
+  return NULL;
+
+} /* tmEdge_swapEdge() */
+
+/**********************************************************
+* Function: tmEdge_finishFlip()
+*----------------------------------------------------------
+* Completes the flip of an edge, which has been swapped
+* with tmEdge_swapEdge(): 
+* The mesh area and the locations of the edge and its 
+* adjacent triangles in the mesh qtrees are updated.
+* Then all edges of the new triangles are checked for the 
+* delaunay property and put on the delaunay stack if 
+* necessary.
+*----------------------------------------------------------
+* @param e: pointer to swapped edge
+* @param area_old: area of both triangles before the swap
+* 
+**********************************************************/
+void tmEdge_finishFlip(tmEdge *e, tmDouble area_old)
+{
+  tmMesh *mesh = e->mesh;
+  tmTri  *t1   = e->t1;
+  tmTri  *t2   = e->t2;
+
+  /*-----------------------------------------------------
+  | Update mesh area and qtree locations
+  | -> Both triangles have moved, so both must be detached
+  |    before any of them is inserted again
+  -----------------------------------------------------*/
+  mesh->areaTris += t1->area + t2->area - area_old;
+
+  tmQtree_detachObj(mesh->tris_qtree, t1);
+  tmQtree_detachObj(mesh->tris_qtree, t2);
+
+  tmQtree_updateObj(mesh->tris_qtree, t1);
+  tmQtree_updateObj(mesh->tris_qtree, t2);
+  tmQtree_updateObj(mesh->edges_qtree, e);
+
+  /*-----------------------------------------------------
+  | The flipped edge should be delaunay now 
+  -----------------------------------------------------*/
+  e->is_local_delaunay = TRUE;
+  tmEdge_isDelaunay(e);
+
   /*-----------------------------------------------------
   | Check if edges e11, e12,.. are locally delaunay
   | if not -> add them to the list
+  | -> t1* = (e, e12, e21), t2* = (e, e22, e11)
   -----------------------------------------------------*/
-  tmEdge_isDelaunay(e11);
-  tmEdge_isDelaunay(e12);
-  tmEdge_isDelaunay(e21);
-  tmEdge_isDelaunay(e22);
+  tmEdge_isDelaunay(t1->e2);
+  tmEdge_isDelaunay(t1->e3);
+  tmEdge_isDelaunay(t2->e2);
+  tmEdge_isDelaunay(t2->e3);
+
+} /* tmEdge_finishFlip() */
+
+/**********************************************************
+* Function: tmEdge_flipEdge()
+*----------------------------------------------------------
+* Perform an edge flip, in order to get a new edge
+* which satisfies the delaunay constraint.
+* The flip is done in place (see tmEdge_swapEdge()).
+*----------------------------------------------------------
+* @param edge: pointer to edge to flip
+* @return : pointer to the flipped edge
+* 
+**********************************************************/
+tmEdge *tmEdge_flipEdge(tmEdge *e)
+{
+  tmDouble area_old = e->t1->area + e->t2->area;
+
+  if ( tmEdge_swapEdge(e) == NULL )
+    return NULL;
+
+  tmEdge_finishFlip(e, area_old);
 
   return e;
 
+} /* tmEdge_flipEdge() */
+
+/**********************************************************
+* Function: tmEdge_getSize()
+*----------------------------------------------------------
+* Returns the value of the size function at the edge 
+* centroid. The value is evaluated once and cached on 
+* the edge, until one of its nodes is moved or the size 
+* function changes (see tmMesh_resetSizes()).
+* The function may be called concurrently.
+*----------------------------------------------------------
+* @param edge: pointer to edge
+* @return: size function value at the edge centroid
+**********************************************************/
+tmDouble tmEdge_getSize(tmEdge *edge)
+{
+  tmMesh  *mesh = edge->mesh;
+  tmDouble size;
+
+  size = tmAtomic_loadDouble(&edge->size);
+
+  if ( size > 0.0 )
+  {
+    tmAtomic_addLong(&mesh->n_size_saved, 1);
+    return size;
+  }
+
+  size = mesh->sizeFun(mesh, edge->xy);
+  tmAtomic_storeDouble(&edge->size, size);
+
+  return size;
+
+} /* tmEdge_getSize() */
+
+/**********************************************************
+* Function: tmEdge_sampleSizeFun()
+*----------------------------------------------------------
+* Evaluates the size function on m[i]+1 equidistant 
+* points of every edge i and computes the cumulative
+* integral of the inverse element size along the edges
+* with the trapezoidal rule.
+*----------------------------------------------------------
+* @param mesh: mesh of the edges
+* @param edges: edges to sample
+* @param n: number of edges
+* @param fac: refinement factor of the edges
+* @param m: number of sample intervals per edge
+* @param beg: returns the offsets of the samples of every
+*             edge in cum (size n+1)
+* @return: cumulative integrals for all samples or NULL
+**********************************************************/
+static tmDouble *tmEdge_sampleSizeFun(tmMesh    *mesh, 
+                                      tmEdge   **edges, 
+                                      int        n, 
+                                      tmDouble   fac,
+                                      const int *m,
+                                      int       *beg)
+{
+  tmDouble (*xy)[2] = NULL;
+  tmDouble  *cum    = NULL;
+  int i, j;
+
+  beg[0] = 0;
+  for (i = 0; i < n; i++)
+    beg[i+1] = beg[i] + m[i] + 1;
+
+  xy  = malloc( (beg[n]+1) * sizeof(*xy) );
+  cum = malloc( (beg[n]+1) * sizeof(tmDouble) );
+  check_mem(xy);
+  check_mem(cum);
+
+  for (i = 0; i < n; i++)
+  {
+    const tmDouble *xy_1 = edges[i]->n1->xy;
+    const tmDouble *xy_2 = edges[i]->n2->xy;
+
+    for (j = 0; j <= m[i]; j++)
+    {
+      const tmDouble s = (tmDouble) j / (tmDouble) m[i];
+      xy[beg[i]+j][0] = xy_1[0] + s * (xy_2[0] - xy_1[0]);
+      xy[beg[i]+j][1] = xy_1[1] + s * (xy_2[1] - xy_1[1]);
+    }
+  }
+
+  mesh->sizeFunBatch(mesh, beg[n], xy, cum);
+
+  /*-------------------------------------------------------
+  | Integrate 1 / (2 * fac * rho) along the edges
+  -------------------------------------------------------*/
+  for (i = 0; i < n; i++)
+  {
+    const tmDouble ds  = edges[i]->len / (tmDouble) m[i];
+    tmDouble       h_0 = 1.0 / (2.0 * fac * cum[beg[i]]);
+    tmDouble       sum = 0.0;
+
+    check( fac * cum[beg[i]] > TM_MIN_SIZE,
+        "Size function return value lower than defined minimum scale.");
+
+    cum[beg[i]] = 0.0;
+
+    for (j = 1; j <= m[i]; j++)
+    {
+      tmDouble *rho = &cum[beg[i]+j];
+      check( fac * (*rho) > TM_MIN_SIZE,
+          "Size function return value lower than defined minimum scale.");
+
+      tmDouble h_1 = 1.0 / (2.0 * fac * (*rho));
+      sum += 0.5 * ds * (h_0 + h_1);
+      h_0  = h_1;
+      *rho = sum;
+    }
+  }
+
+  free(xy);
+  return cum;
+
 error:
+  free(xy);
+  free(cum);
   return NULL;
 
-} /* tmEdge_flipEdge() */
+} /* tmEdge_sampleSizeFun() */
+
+/**********************************************************
+* Function: tmEdge_subdivide()
+*----------------------------------------------------------
+* Computes the new nodes of n edges, which are subdivided
+* according to the size function of the mesh. 
+* The inverse element size 1 / (2 * fac * rho) is 
+* integrated along every edge and the edge is split into 
+* as many segments as the integral indicates, where all 
+* segments cover an equal part of the integral. 
+* The size function is first evaluated on 
+* TM_SUBDIV_SAMPLES points per edge and then on 
+* TM_SUBDIV_SAMPLES points per segment for all edges at 
+* once (see tmMesh_sizeFunBatch()).
+*----------------------------------------------------------
+* @param mesh: mesh of the edges
+* @param edges: edges to subdivide
+* @param n: number of edges
+* @param fac: refinement factor of the edges
+* @param off: returns the offsets of the new nodes of 
+*             edge i in xy_new, off[i] ... off[i+1]-1
+*             (size n+1)
+* @param xy_new: returns the coordinates of all new nodes,
+*                which must be freed by the caller
+* @return: FALSE on errors
+**********************************************************/
+tmBool tmEdge_subdivide(tmMesh    *mesh, 
+                        tmEdge   **edges, 
+                        int        n, 
+                        tmDouble   fac,
+                        int       *off,
+                        tmDouble (**xy_new)[2])
+{
+  int      *m   = calloc( n+1, sizeof(int) );
+  int      *beg = calloc( n+1, sizeof(int) );
+  tmDouble *cum = NULL;
+  tmDouble (*xy)[2] = NULL;
+  int i, j, k;
+
+  *xy_new = NULL;
+
+  check_mem(m);
+  check_mem(beg);
+
+  /*-------------------------------------------------------
+  | Estimate the number of segments with a coarse sampling
+  | and resample every edge with TM_SUBDIV_SAMPLES points
+  | per segment
+  -------------------------------------------------------*/
+  for (i = 0; i < n; i++)
+    m[i] = TM_SUBDIV_SAMPLES;
+
+  cum = tmEdge_sampleSizeFun(mesh, edges, n, fac, m, beg);
+  check( cum != NULL, "Failed to sample the size function.");
+
+  for (i = 0; i < n; i++)
+  {
+    tmDouble n_seg = ceil( cum[beg[i+1]-1] - TM_SUBDIV_TOL );
+    check( n_seg < (tmDouble) (INT_MAX / (4 * TM_SUBDIV_SAMPLES)),
+        "Too many edge segments.");
+    m[i] = TM_SUBDIV_SAMPLES * MAX(1, (int) n_seg);
+  }
+
+  free(cum);
+  cum = tmEdge_sampleSizeFun(mesh, edges, n, fac, m, beg);
+  check( cum != NULL, "Failed to sample the size function.");
+
+  /*-------------------------------------------------------
+  | Number of new nodes per edge
+  -------------------------------------------------------*/
+  off[0] = 0;
+
+  for (i = 0; i < n; i++)
+  {
+    int n_seg = (int) ceil( cum[beg[i+1]-1] - TM_SUBDIV_TOL );
+    off[i+1] = off[i] + MAX(1, n_seg) - 1;
+  }
+
+  xy = malloc( (off[n]+1) * sizeof(*xy) );
+  check_mem(xy);
+
+  /*-------------------------------------------------------
+  | Place the new nodes at equal parts of the integral
+  -------------------------------------------------------*/
+  for (i = 0; i < n; i++)
+  {
+    const tmDouble *xy_1  = edges[i]->n1->xy;
+    const tmDouble *xy_2  = edges[i]->n2->xy;
+    const tmDouble *c     = &cum[beg[i]];
+    const int       n_seg = off[i+1] - off[i] + 1;
+
+    for (j = 1, k = 0; j < n_seg; j++)
+    {
+      const tmDouble target = c[m[i]] * (tmDouble) j / (tmDouble) n_seg;
+
+      while ( k < m[i]-1 && c[k+1] < target )
+        k += 1;
+
+      tmDouble t = (target - c[k]) / (c[k+1] - c[k]);
+      tmDouble s = ( (tmDouble) k + t ) / (tmDouble) m[i];
+
+      xy[off[i]+j-1][0] = xy_1[0] + s * (xy_2[0] - xy_1[0]);
+      xy[off[i]+j-1][1] = xy_1[1] + s * (xy_2[1] - xy_1[1]);
+    }
+  }
+
+  *xy_new = xy;
+
+  free(m);
+  free(beg);
+  free(cum);
+  return TRUE;
+
+error:
+  free(m);
+  free(beg);
+  free(cum);
+  free(xy);
+  return FALSE;
+
+} /* tmEdge_subdivide() */
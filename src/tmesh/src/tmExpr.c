@@ -0,0 +1,457 @@
+/*
+ * This source file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include <string.h>
+
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tinyexpr.h"
+#include "tmesh/tmExpr.h"
+
+#define TM_EXPR_IS_FUN(type) ( ((type) & (TE_FUNCTION0|TE_CLOSURE0)) != 0 )
+#define TM_EXPR_ARITY(type)  ( (type) & 0x7 )
+
+/**********************************************************
+* tmExprCompiler: State for the lowering of a tinyexpr
+*                 syntax tree. Temporary registers are
+*                 numbered -1, -2, ... until the number
+*                 of constants is known.
+**********************************************************/
+typedef struct tmExprCompiler {
+
+  tmExpr         *expr;
+  int             size_code;
+  int             size_consts;
+
+  const tmDouble *x;    /* Variables bound by tinyexpr   */
+  const tmDouble *y;
+
+  const void     *add;  /* Operator functions of tinyexpr*/
+  const void     *sub;
+  const void     *mul;
+  const void     *div;
+  const void     *neg;
+  const void     *comma;
+
+  int             top;  /* Next free temporary register  */
+  int             n_tmp;
+  tmBool          error;
+
+} tmExprCompiler;
+
+/**********************************************************
+* Function: tmExpr_probe()
+*----------------------------------------------------------
+* Returns the function of the root node of an expression.
+* This is used to identify the operator functions, which
+* are private to tinyexpr.
+**********************************************************/
+static const void *tmExpr_probe(const char *str,
+                                const te_variable *vars)
+{
+  const void *fun = NULL;
+  int         err;
+  te_expr    *n = te_compile(str, vars, 2, &err);
+
+  if ( n != NULL && TM_EXPR_IS_FUN(n->type) )
+    fun = n->function;
+
+  te_free(n);
+
+  return fun;
+
+} /* tmExpr_probe() */
+
+/**********************************************************
+* Function: tmExpr_addConst()
+*----------------------------------------------------------
+* Adds a constant register, equal constants share one
+* register
+* @return: register of the constant
+**********************************************************/
+static int tmExpr_addConst(tmExprCompiler *c, tmDouble value)
+{
+  tmExpr *expr = c->expr;
+  int     i;
+
+  for (i = 0; i < expr->n_consts; i++)
+    if ( memcmp(&expr->consts[i], &value, sizeof(tmDouble)) == 0 )
+      return 2 + i;
+
+  if ( expr->n_consts == c->size_consts )
+  {
+    int       size   = (c->size_consts > 0) ? 2*c->size_consts : 8;
+    tmDouble *consts = realloc(expr->consts, size*sizeof(tmDouble));
+    check_mem(consts);
+
+    expr->consts   = consts;
+    c->size_consts = size;
+  }
+
+  expr->consts[expr->n_consts] = value;
+
+  return 2 + expr->n_consts++;
+
+error:
+  c->error = TRUE;
+  return 0;
+
+} /* tmExpr_addConst() */
+
+/**********************************************************
+* Function: tmExpr_emit()
+*----------------------------------------------------------
+* Appends the instruction r[dst] = op(r[a], r[b]), where
+* dst is a new temporary register
+* @return: register of the result
+**********************************************************/
+static int tmExpr_emit(tmExprCompiler *c, int op, int a, int b,
+                       const void *fun)
+{
+  tmExpr      *expr = c->expr;
+  tmExprInstr *instr;
+
+  if ( expr->n_code == c->size_code )
+  {
+    int          size = (c->size_code > 0) ? 2*c->size_code : 16;
+    tmExprInstr *code = realloc(expr->code,
+                                size*sizeof(tmExprInstr));
+    check_mem(code);
+
+    expr->code   = code;
+    c->size_code = size;
+  }
+
+  instr = &expr->code[expr->n_code++];
+
+  instr->op   = op;
+  instr->dst  = -(++c->top);
+  instr->a    = a;
+  instr->b    = b;
+  instr->fun1 = NULL;
+
+  if ( op == TM_EXPR_CALL1 )
+    instr->fun1 = (tmExprFun1) fun;
+  else if ( op == TM_EXPR_CALL2 )
+    instr->fun2 = (tmExprFun2) fun;
+
+  c->n_tmp = MAX(c->n_tmp, c->top);
+
+  return instr->dst;
+
+error:
+  c->error = TRUE;
+  return 0;
+
+} /* tmExpr_emit() */
+
+/**********************************************************
+* Function: tmExpr_lower()
+*----------------------------------------------------------
+* Lowers a node of a tinyexpr syntax tree to instructions.
+* The temporary registers of the arguments are released
+* after their use, such that the number of registers
+* is bounded by the depth of the tree.
+* @return: register of the result
+**********************************************************/
+static int tmExpr_lower(tmExprCompiler *c, const te_expr *n)
+{
+  const int base = c->top;
+  const void *fun;
+  int a, b, op;
+
+  if ( c->error == TRUE )
+    return 0;
+
+  /*-------------------------------------------------------
+  | Constants and variables
+  -------------------------------------------------------*/
+  if ( TM_EXPR_IS_FUN(n->type) == FALSE )
+  {
+    if ( n->type == TE_VARIABLE && n->bound == c->x )
+      return 0;
+    if ( n->type == TE_VARIABLE && n->bound == c->y )
+      return 1;
+    if ( n->type != TE_VARIABLE )
+      return tmExpr_addConst(c, n->value);
+
+    c->error = TRUE;
+    return 0;
+  }
+
+  /*-------------------------------------------------------
+  | Functions with one or two arguments
+  -------------------------------------------------------*/
+  fun = n->function;
+
+  if ( (n->type & TE_CLOSURE0) != 0 )
+  {
+    c->error = TRUE;
+    return 0;
+  }
+
+  if ( TM_EXPR_ARITY(n->type) == 1 )
+  {
+    a  = tmExpr_lower(c, n->parameters[0]);
+    op = (fun == c->neg) ? TM_EXPR_NEG : TM_EXPR_CALL1;
+
+    c->top = base;
+    return tmExpr_emit(c, op, a, a, fun);
+  }
+
+  if ( TM_EXPR_ARITY(n->type) == 2 )
+  {
+    /* The left operand of "," has no effect                */
+    if ( fun == c->comma )
+      return tmExpr_lower(c, n->parameters[1]);
+
+    a = tmExpr_lower(c, n->parameters[0]);
+    b = tmExpr_lower(c, n->parameters[1]);
+
+    if ( fun == c->add )
+      op = TM_EXPR_ADD;
+    else if ( fun == c->sub )
+      op = TM_EXPR_SUB;
+    else if ( fun == c->mul )
+      op = TM_EXPR_MUL;
+    else if ( fun == c->div )
+      op = TM_EXPR_DIV;
+    else
+      op = TM_EXPR_CALL2;
+
+    c->top = base;
+    return tmExpr_emit(c, op, a, b, fun);
+  }
+
+  c->error = TRUE;
+  return 0;
+
+} /* tmExpr_lower() */
+
+/**********************************************************
+* Function: tmExpr_compile()
+*----------------------------------------------------------
+* Parses an expression of the variables x and y with
+* tinyexpr, which folds all constant subexpressions, and
+* lowers the syntax tree to a register bytecode
+* @return: Pointer to a new tmExpr structure or NULL
+**********************************************************/
+tmExpr *tmExpr_compile(const char *str, int *error)
+{
+  tmExprCompiler c;
+  tmDouble       x = 0.0;
+  tmDouble       y = 0.0;
+  te_variable    vars[] = { {"x", &x, TE_VARIABLE, NULL},
+                            {"y", &y, TE_VARIABLE, NULL} };
+  te_expr       *root = NULL;
+  int            i, err;
+
+  memset(&c, 0, sizeof(tmExprCompiler));
+  *error = 0;
+
+  root = te_compile(str, vars, 2, &err);
+
+  if ( root == NULL )
+  {
+    *error = err;
+    return NULL;
+  }
+
+  c.expr = calloc(1, sizeof(tmExpr));
+  check_mem(c.expr);
+
+  c.x     = &x;
+  c.y     = &y;
+  c.add   = tmExpr_probe("x+y", vars);
+  c.sub   = tmExpr_probe("x-y", vars);
+  c.mul   = tmExpr_probe("x*y", vars);
+  c.div   = tmExpr_probe("x/y", vars);
+  c.neg   = tmExpr_probe("-x",  vars);
+  c.comma = tmExpr_probe("x,y", vars);
+
+  check( c.add != NULL && c.sub != NULL && c.mul != NULL &&
+         c.div != NULL && c.neg != NULL && c.comma != NULL,
+      "Failed to identify expression operators.");
+
+  /*-------------------------------------------------------
+  | Lower the tree and number the temporary registers
+  | behind the constants
+  -------------------------------------------------------*/
+  c.expr->result = tmExpr_lower(&c, root);
+
+  check( c.error == FALSE,
+      "Failed to compile expression %s", str);
+
+#define TM_EXPR_REG(r) ( (r) < 0 ? 1 + c.expr->n_consts - (r) : (r) )
+
+  for (i = 0; i < c.expr->n_code; i++)
+  {
+    tmExprInstr *instr = &c.expr->code[i];
+    instr->dst = TM_EXPR_REG(instr->dst);
+    instr->a   = TM_EXPR_REG(instr->a);
+    instr->b   = TM_EXPR_REG(instr->b);
+  }
+
+  c.expr->result = TM_EXPR_REG(c.expr->result);
+
+#undef TM_EXPR_REG
+
+  c.expr->n_regs = 2 + c.expr->n_consts + c.n_tmp;
+
+  check( c.expr->n_regs <= TM_EXPR_MAX_REGS,
+      "Expression requires too many registers.");
+
+  te_free(root);
+
+  return c.expr;
+
+error:
+  if ( *error == 0 )
+    *error = (int) strlen(str) + 1;
+  te_free(root);
+  tmExpr_destroy(c.expr);
+  return NULL;
+
+} /* tmExpr_compile() */
+
+/**********************************************************
+* Function: tmExpr_destroy()
+*----------------------------------------------------------
+* Frees the memory of a tmExpr structure
+**********************************************************/
+void tmExpr_destroy(tmExpr *expr)
+{
+  if ( expr == NULL )
+    return;
+
+  free(expr->code);
+  free(expr->consts);
+  free(expr);
+
+} /* tmExpr_destroy() */
+
+/**********************************************************
+* Function: tmExpr_eval()
+*----------------------------------------------------------
+* Evaluates an expression at a point.
+* The result equals the one of te_eval() and the
+* function may be called concurrently.
+**********************************************************/
+tmDouble tmExpr_eval(const tmExpr *expr, const tmDouble xy[2])
+{
+  const tmExprInstr *instr = expr->code;
+  const tmExprInstr *end   = expr->code + expr->n_code;
+  tmDouble r[TM_EXPR_MAX_REGS];
+
+  r[0] = xy[0];
+  r[1] = xy[1];
+  if ( expr->n_consts > 0 )
+    memcpy(&r[2], expr->consts, expr->n_consts * sizeof(tmDouble));
+
+  for ( ; instr < end; instr++)
+  {
+    const tmDouble a = r[instr->a];
+    const tmDouble b = r[instr->b];
+
+    switch ( instr->op )
+    {
+      case TM_EXPR_ADD:   r[instr->dst] = a + b;             break;
+      case TM_EXPR_SUB:   r[instr->dst] = a - b;             break;
+      case TM_EXPR_MUL:   r[instr->dst] = a * b;             break;
+      case TM_EXPR_DIV:   r[instr->dst] = a / b;             break;
+      case TM_EXPR_NEG:   r[instr->dst] = -a;                break;
+      case TM_EXPR_CALL1: r[instr->dst] = instr->fun1(a);    break;
+      case TM_EXPR_CALL2: r[instr->dst] = instr->fun2(a, b); break;
+    }
+  }
+
+  return r[expr->result];
+
+} /* tmExpr_eval() */
+
+/**********************************************************
+* Function: tmExpr_evalBatch()
+*----------------------------------------------------------
+* Evaluates an expression at n points, where every
+* instruction is applied to TM_EXPR_BATCH_SIZE points
+* at once
+* @return: FALSE on memory errors
+**********************************************************/
+tmBool tmExpr_evalBatch(const tmExpr *expr, int n,
+                        const tmDouble (*xy)[2],
+                        tmDouble *out)
+{
+  const int B = TM_EXPR_BATCH_SIZE;
+  tmDouble *r = NULL;
+  int i, j, k, m;
+
+  if ( n <= 0 )
+    return TRUE;
+
+  r = malloc(expr->n_regs * B * sizeof(tmDouble));
+  check_mem(r);
+
+  /*-------------------------------------------------------
+  | Constant registers are filled once for all points
+  -------------------------------------------------------*/
+  for (k = 0; k < expr->n_consts; k++)
+    for (i = 0; i < B; i++)
+      r[(2+k)*B + i] = expr->consts[k];
+
+  for (j = 0; j < n; j += B)
+  {
+    m = MIN(B, n - j);
+
+    for (i = 0; i < m; i++)
+    {
+      r[i]     = xy[j+i][0];
+      r[B + i] = xy[j+i][1];
+    }
+
+    for (k = 0; k < expr->n_code; k++)
+    {
+      const tmExprInstr *instr = &expr->code[k];
+      tmDouble       *d = &r[instr->dst * B];
+      const tmDouble *a = &r[instr->a * B];
+      const tmDouble *b = &r[instr->b * B];
+
+      switch ( instr->op )
+      {
+        case TM_EXPR_ADD:
+          for (i = 0; i < m; i++) d[i] = a[i] + b[i];
+          break;
+        case TM_EXPR_SUB:
+          for (i = 0; i < m; i++) d[i] = a[i] - b[i];
+          break;
+        case TM_EXPR_MUL:
+          for (i = 0; i < m; i++) d[i] = a[i] * b[i];
+          break;
+        case TM_EXPR_DIV:
+          for (i = 0; i < m; i++) d[i] = a[i] / b[i];
+          break;
+        case TM_EXPR_NEG:
+          for (i = 0; i < m; i++) d[i] = -a[i];
+          break;
+        case TM_EXPR_CALL1:
+          for (i = 0; i < m; i++) d[i] = instr->fun1(a[i]);
+          break;
+        case TM_EXPR_CALL2:
+          for (i = 0; i < m; i++) d[i] = instr->fun2(a[i], b[i]);
+          break;
+      }
+    }
+
+    memcpy(&out[j], &r[expr->result * B], m * sizeof(tmDouble));
+  }
+
+  free(r);
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmExpr_evalBatch() */
@@ -5,15 +5,19 @@
  * Refer to the accompanying documentation for details
  * on usage and license.
  */
+#include <string.h>
+
 #include "tmesh/tmTypedefs.h"
 #include "tmesh/tmList.h"
 #include "tmesh/tmMesh.h"
+#include "tmesh/tmMeshIO.h"
 #include "tmesh/tmEdge.h"
 #include "tmesh/tmNode.h"
 #include "tmesh/tmBdry.h"
 #include "tmesh/tmQtree.h"
 #include "tmesh/tmFront.h"
 #include "tmesh/tmTri.h"
+#include "tmesh/tmPool.h"
 
 /**********************************************************
 * Function: tmFront_create()
@@ -136,7 +140,8 @@ tmListNode *tmFront_addEdge(tmFront *front, tmEdge *edge)
   front->no_edges += 1;
 
   tmList_push(front->edges_stack, edge);
-  tmQtree_addObj(front->edges_qtree, edge);
+  if ( front->mesh->qtree_defer == FALSE )
+    tmQtree_addObj(front->edges_qtree, edge);
   edge_pos = tmList_last_node(front->edges_stack);
 
   return edge_pos;
@@ -178,6 +183,23 @@ void tmFront_remEdge(tmFront *front, tmEdge *edge)
 
 } /* tmFront_remEdge() */
 
+/**********************************************************
+* Function: tmFront_postponeEdge()
+*----------------------------------------------------------
+* Moves an edge to the end of the front edge stack, such
+* that it is advanced after all other current front edges
+*----------------------------------------------------------
+* @param front: advancing front structure
+* @param edge: front edge to move
+**********************************************************/
+void tmFront_postponeEdge(tmFront *front, tmEdge *edge)
+{
+  tmList_remove(front->edges_stack, edge->stack_pos);
+  tmList_push(front->edges_stack, edge);
+  edge->stack_pos = tmList_last_node(front->edges_stack);
+
+} /* tmFront_postponeEdge() */
+
 /**********************************************************
 * Function: tmFront_init()
 *----------------------------------------------------------
@@ -265,11 +287,152 @@ error:
 
 } /* tmFront_sortEdges() */
 
+/**********************************************************
+* Function: tmFront_probeTri()
+*----------------------------------------------------------
+* Initializes a triangle, which is not added to the mesh,
+* in order to check its validity
+*----------------------------------------------------------
+* @param *tri: triangle to initialize
+* @param mesh: pointer to mesh structure
+* @param n1,n2,n3: nodes of the triangle
+**********************************************************/
+static void tmFront_probeTri(tmTri  *tri,
+                             tmMesh *mesh,
+                             tmNode *n1, 
+                             tmNode *n2, 
+                             tmNode *n3)
+{
+  memset(tri, 0, sizeof(tmTri));
+
+  tri->mesh = mesh;
+  tri->n1   = n1;
+  tri->n2   = n2;
+  tri->n3   = n3;
+
+  tmTri_calcProperties(tri);
+
+} /* tmFront_probeTri() */
+
+/**********************************************************
+* tmFrontNbrCheck: Neighbor nodes of a front edge, which 
+*                  are checked concurrently
+**********************************************************/
+typedef struct tmFrontNbrCheck {
+  tmMesh  *mesh;
+  tmEdge  *e_ad;
+  tmNode **nodes;
+  tmBool  *valid;
+} tmFrontNbrCheck;
+
+/**********************************************************
+* Function: tmFront_checkNbrs()
+*----------------------------------------------------------
+* Parallel loop body, which checks the potential 
+* triangles of a front edge with the neighbor nodes 
+* [i_beg, i_end). The mesh is not modified.
+*----------------------------------------------------------
+* @param data: tmFrontNbrCheck structure
+**********************************************************/
+static void tmFront_checkNbrs(void  *data, 
+                              size_t i_beg, 
+                              size_t i_end,
+                              int    thread_id)
+{
+  tmFrontNbrCheck *chk = (tmFrontNbrCheck*) data;
+  tmTri nt;
+  size_t i;
+
+  (void) thread_id;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmFront_probeTri(&nt, chk->mesh, 
+                     chk->e_ad->n1, chk->e_ad->n2, chk->nodes[i]);
+    chk->valid[i] = tmTri_isValid(&nt);
+  }
+
+} /* tmFront_checkNbrs() */
+
+/**********************************************************
+* Function: tmFront_checkNbrsParallel()
+*----------------------------------------------------------
+* Checks the potential triangles of a front edge with 
+* the remaining neighbor nodes, starting at cur. 
+* Batches of mesh->adv_n_cands nodes are checked 
+* concurrently on the thread pool of the mesh and the 
+* closest node with a valid triangle is returned.
+* Hence, the same node is found as in a serial search.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param e_ad: front edge to advance
+* @param nn: new node of the front edge
+* @param cur: first list node of the remaining neighbors
+* @return: closest valid node or NULL
+**********************************************************/
+static tmNode *tmFront_checkNbrsParallel(tmMesh     *mesh,
+                                         tmEdge     *e_ad,
+                                         tmNode     *nn,
+                                         tmListNode *cur)
+{
+  tmFrontNbrCheck chk;
+  tmNode *found = NULL;
+  int     n_max = mesh->adv_n_cands;
+  int     n, i;
+
+  chk.mesh  = mesh;
+  chk.e_ad  = e_ad;
+  chk.nodes = (tmNode**) calloc(n_max, sizeof(tmNode*));
+  chk.valid = (tmBool*)  calloc(n_max, sizeof(tmBool));
+  check_mem(chk.nodes);
+  check_mem(chk.valid);
+
+  while (cur != NULL && found == NULL)
+  {
+    /*----------------------------------------------------
+    | Gather the next batch of potential nodes
+    ----------------------------------------------------*/
+    for (n = 0; cur != NULL && n < n_max; cur = cur->next)
+    {
+      tmNode *cn = (tmNode*) cur->value;
+
+      if ( cn->on_front == FALSE || cn == nn )
+        continue;
+
+      if (ORIENTATION(e_ad->n1->xy,e_ad->n2->xy,cn->xy) == 0) 
+        continue;
+
+      chk.nodes[n++] = cn;
+    }
+
+    tmPool_parallelFor(mesh->pool, n, 1, tmFront_checkNbrs, &chk);
+
+    for (i = 0; i < n; i++)
+    {
+      if ( chk.valid[i] == TRUE )
+      {
+        found = chk.nodes[i];
+        break;
+      }
+    }
+  }
+
+error:
+  free(chk.nodes);
+  free(chk.valid);
+
+  return found;
+
+} /* tmFront_checkNbrsParallel() */
+
 /**********************************************************
 * Function: tmFront_advance()
 *----------------------------------------------------------
 * Function to advance the front edges 
-* by one step
+* by one step.
+* If the first mesh->adv_n_serial neighbor nodes fail,
+* the remaining nodes are checked in batches on the 
+* thread pool of the mesh.
 *----------------------------------------------------------
 * @parameter mesh:  pointer to mesh structure
 * @parameter eStart: pointer to advancing front edge
@@ -319,6 +482,29 @@ tmBool tmFront_advance(tmMesh *mesh, tmEdge *e_ad)
           ((tmNode*)cur->value)->index);
 #endif
 
+      /*----------------------------------------------------
+      | Difficult front edge -> check the remaining 
+      | nodes in batches on the thread pool
+      ----------------------------------------------------*/
+      if ( mesh->pool != NULL && mesh->adv_n_cands > 1 && 
+           iter > mesh->adv_n_serial )
+      {
+        cn = tmFront_checkNbrsParallel(mesh, e_ad, nn, cur);
+
+        if ( cn != NULL )
+        {
+          nt = tmTri_create(mesh, e_ad->n1, e_ad->n2, cn);
+          tmFront_update(mesh, cn, e_ad, nt);
+
+          tmNode_destroy(nn);
+          tmList_destroy(nn_nb);
+
+          return TRUE;
+        }
+
+        break;
+      }
+
       nxt = cur->next;
       cn  = (tmNode*)cur->value;
 
@@ -433,6 +619,281 @@ tmBool tmFront_advance(tmMesh *mesh, tmEdge *e_ad)
 
 } /* tmFront_advance() */
 
+/**********************************************************
+* tmFrontNbr: Node in the vicinity of a new node
+**********************************************************/
+typedef struct tmFrontNbr {
+  tmNode  *node;
+  tmDouble dist2;
+  int      pos;     /* Position in the qtree query result */
+} tmFrontNbr;
+
+/**********************************************************
+* Function: tmFront_cmpNbrs()
+*----------------------------------------------------------
+* Sorts neighbor nodes by their distance 
+**********************************************************/
+static int tmFront_cmpNbrs(const void *a, const void *b)
+{
+  const tmFrontNbr *na = (const tmFrontNbr*) a;
+  const tmFrontNbr *nb = (const tmFrontNbr*) b;
+
+  if (na->dist2 != nb->dist2)
+    return (na->dist2 > nb->dist2) ? 1 : -1;
+
+  return na->pos - nb->pos;
+
+} /* tmFront_cmpNbrs() */
+
+/**********************************************************
+* Function: tmFront_addToBbox()
+*----------------------------------------------------------
+* Enlarges the bounding box of a candidate by a circle
+*----------------------------------------------------------
+* @param cand: candidate
+* @param xy, r: circle centroid and radius
+**********************************************************/
+static void tmFront_addToBbox(tmFrontCand *cand,
+                              tmDouble     xy[2],
+                              tmDouble     r)
+{
+  cand->xy_min[0] = MIN(cand->xy_min[0], xy[0] - r);
+  cand->xy_min[1] = MIN(cand->xy_min[1], xy[1] - r);
+  cand->xy_max[0] = MAX(cand->xy_max[0], xy[0] + r);
+  cand->xy_max[1] = MAX(cand->xy_max[1], xy[1] + r);
+
+} /* tmFront_addToBbox() */
+
+/**********************************************************
+* Function: tmFront_evalAdvance()
+*----------------------------------------------------------
+* Evaluates the advancement of a front edge in the same 
+* way as tmFront_advance(), but without modifying the 
+* mesh. Hence, several front edges can be evaluated 
+* concurrently, as long as no objects are added to or 
+* removed from the mesh at the same time.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param cand: candidate with the front edge to advance
+* @return: TRUE, if a valid triangle has been found
+**********************************************************/
+tmBool tmFront_evalAdvance(tmMesh *mesh, tmFrontCand *cand)
+{
+  tmEdge     *e_ad    = cand->edge;
+  tmFrontNbr *nbrs    = NULL;
+  int         n_nbrs  = 0;
+  tmListNode *cur;
+  tmNode      nn;
+  tmTri       nt;
+  int i;
+
+  cand->is_valid = FALSE;
+  cand->node     = NULL;
+
+  /*--------------------------------------------------------
+  | The new node is not added to the mesh, hence it is 
+  | not found by any qtree query (see tmEdge_createNode())
+  --------------------------------------------------------*/
+  tmDouble d = TM_NEW_NODE_DIST_FAC * tmEdge_getSize(e_ad);
+
+  cand->xy[0] = e_ad->xy[0] + d * e_ad->dxy_n[0];
+  cand->xy[1] = e_ad->xy[1] + d * e_ad->dxy_n[1];
+
+  memset(&nn, 0, sizeof(tmNode));
+  nn.mesh      = mesh;
+  nn.xy[0]     = cand->xy[0];
+  nn.xy[1]     = cand->xy[1];
+  nn.index     = -1;
+  nn.is_active = FALSE;
+
+  /*--------------------------------------------------------
+  | Get nodes in vicinity of nn, sorted by their distance
+  --------------------------------------------------------*/
+  tmDouble r = TM_NODE_NBR_DIST_FAC * tmNode_getSize(&nn);
+  tmList *nn_nb = tmQtree_getObjCirc(mesh->nodes_qtree, nn.xy, r);
+
+  if (nn_nb != NULL)
+  {
+    nbrs = (tmFrontNbr*) calloc( nn_nb->count, sizeof(tmFrontNbr) );
+    check_mem(nbrs);
+
+    for (cur = nn_nb->first; cur != NULL; cur = cur->next)
+    {
+      tmNode *n = (tmNode*) cur->value;
+
+      nbrs[n_nbrs].node  = n;
+      nbrs[n_nbrs].dist2 = (n->xy[0]-nn.xy[0])*(n->xy[0]-nn.xy[0]) 
+                         + (n->xy[1]-nn.xy[1])*(n->xy[1]-nn.xy[1]);
+      nbrs[n_nbrs].pos   = n_nbrs;
+      n_nbrs += 1;
+    }
+
+    tmList_destroy(nn_nb);
+    qsort(nbrs, n_nbrs, sizeof(tmFrontNbr), tmFront_cmpNbrs);
+  }
+
+  /*--------------------------------------------------------
+  | Form potential triangle with found nodes 
+  | -> Begin with closest
+  --------------------------------------------------------*/
+  for (i = 0; i < n_nbrs; i++)
+  {
+    tmNode *cn = nbrs[i].node;
+
+    if ( cn->on_front == FALSE )
+      continue;
+
+    if (ORIENTATION(e_ad->n1->xy,e_ad->n2->xy,cn->xy) == 0) 
+      continue;
+
+    tmFront_probeTri(&nt, mesh, e_ad->n1, e_ad->n2, cn);
+
+    if ( tmTri_isValid(&nt) == TRUE ) 
+    {
+      cand->node     = cn;
+      cand->is_valid = TRUE;
+      break;
+    }
+  }
+
+  free(nbrs);
+
+  /*--------------------------------------------------------
+  | Form potential triangle with new node
+  --------------------------------------------------------*/
+  if ( cand->is_valid == FALSE )
+  {
+    nn.is_active = TRUE;
+
+    if ( tmNode_isValid(&nn) == TRUE )
+    {
+      tmFront_probeTri(&nt, mesh, e_ad->n1, e_ad->n2, &nn);
+
+      if ( tmTri_isValid(&nt) == TRUE ) 
+        cand->is_valid = TRUE;
+    }
+
+    if ( cand->is_valid == FALSE )
+      return FALSE;
+  }
+
+  /*--------------------------------------------------------
+  | The validity of the triangle depends on all objects 
+  | within the regions, which have been queried by 
+  | tmTri_isValid() and tmNode_isValid()
+  --------------------------------------------------------*/
+  cand->xy_min[0] = cand->xy_max[0] = nt.xy[0];
+  cand->xy_min[1] = cand->xy_max[1] = nt.xy[1];
+
+  tmFront_addToBbox(cand, nt.xy, TM_TRI_RANGE_FAC * nt.circ_r);
+  tmFront_addToBbox(cand, e_ad->n1->xy, 0.0);
+  tmFront_addToBbox(cand, e_ad->n2->xy, 0.0);
+  tmFront_addToBbox(cand, cand->xy, 0.0);
+
+  cand->size = nn.size;
+
+  if (cand->node == NULL)
+    tmFront_addToBbox(cand, nn.xy, tmNode_getSize(&nn));
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmFront_evalAdvance() */
+
+/**********************************************************
+* Function: tmFront_commitAdvance()
+*----------------------------------------------------------
+* Creates the triangle of a valid candidate, which has 
+* been evaluated with tmFront_evalAdvance(), and 
+* updates the advancing front.
+* The caller must ensure, that the mesh has not been 
+* modified within the region of the candidate since 
+* its evaluation.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param cand: valid candidate
+* @return: the new triangle
+**********************************************************/
+tmTri *tmFront_commitAdvance(tmMesh *mesh, tmFrontCand *cand)
+{
+  tmEdge *e_ad = cand->edge;
+  tmNode *n    = cand->node;
+
+  if (n == NULL)
+  {
+    n = tmNode_create(mesh, cand->xy);
+    n->size = cand->size;
+  }
+
+  tmTri *t = tmTri_create(mesh, e_ad->n1, e_ad->n2, n);
+
+  tmFront_update(mesh, n, e_ad, t);
+
+  return t;
+
+} /* tmFront_commitAdvance() */
+
+/**********************************************************
+* Function: tmFront_closeLoop()
+*----------------------------------------------------------
+* Closes the first front loop, which consists of three 
+* edges and whose triangle is valid (see tmTri_isValid()).
+* This is used as last resort, if no front edge can be 
+* advanced anymore. The triangle must pass the same 
+* angle and quality limits as an advancement, hence 
+* the result does not depend on the advancement order
+* of the serial, speculative or parallel meshing.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @return: TRUE, if a front loop has been closed
+**********************************************************/
+tmBool tmFront_closeLoop(tmMesh *mesh)
+{
+  tmListNode *cur, *cur_2, *cur_3;
+
+  for (cur = mesh->front->edges_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmEdge *e_1 = (tmEdge*) cur->value;
+
+    for (cur_2 = e_1->n2->front_edges->first; 
+         cur_2 != NULL; cur_2 = cur_2->next)
+    {
+      tmEdge *e_2 = (tmEdge*) cur_2->value;
+
+      if ( e_2->n1 != e_1->n2 )
+        continue;
+
+      for (cur_3 = e_2->n2->front_edges->first; 
+           cur_3 != NULL; cur_3 = cur_3->next)
+      {
+        tmEdge *e_3 = (tmEdge*) cur_3->value;
+
+        if ( e_3->n1 != e_2->n2 || e_3->n2 != e_1->n1 )
+          continue;
+
+        if (ORIENTATION(e_1->n1->xy, e_1->n2->xy, e_2->n2->xy) != 1)
+          continue;
+
+        tmTri *t = tmTri_create(mesh, e_1->n1, e_1->n2, e_2->n2);
+
+        if ( tmTri_isValid(t) == TRUE )
+        {
+          tmFront_update(mesh, e_2->n2, e_1, t);
+          return TRUE;
+        }
+
+        tmTri_destroy(t);
+      }
+    }
+  }
+
+  return FALSE;
+
+} /* tmFront_closeLoop() */
+
 /**********************************************************
 * Function: tmFront_update()
 *----------------------------------------------------------
@@ -532,54 +993,234 @@ void tmFront_update(tmMesh *mesh,
   tmMesh_edgeCreate(mesh, e->n1, e->n2, t, e->t2, e->bdry_marker);
   tmEdge_destroy(e);
 
+  /*--------------------------------------------------------
+  | Pass nodes, which have left the front, to the sink
+  --------------------------------------------------------*/
+  tmMesh_sinkUpdate(mesh, t);
+
 } /* tmFront_update() */
 
 
+/**********************************************************
+* Function: tmFront_subdivide()
+*----------------------------------------------------------
+* Subdivides all edges of the advancing front in one pass
+* according to the integral of the size function along 
+* the edges (see tmEdge_subdivide()). 
+* The new nodes and edges are bulk-loaded into the qtrees.
+* Edges on the cuts of subdomains are not subdivided, 
+* since they have already been refined in the parent mesh.
+*----------------------------------------------------------
+* @param *mesh: pointer to mesh containing the front
+* @return: FALSE on errors
+**********************************************************/
+static tmBool tmFront_subdivide(tmMesh *mesh)
+{
+  tmFront    *front = mesh->front;
+  tmListNode *cur;
+  tmEdge    **edges = NULL;
+  void      **nodes_new = NULL;
+  void      **edges_new = NULL;
+  int        *off   = NULL;
+  tmDouble  (*xy)[2] = NULL;
+  tmBool      success = FALSE;
+  int i, j, n = 0, n_nodes = 0, n_edges = 0;
+
+  edges = malloc( (front->no_edges+1) * sizeof(tmEdge*) );
+  off   = malloc( (front->no_edges+1) * sizeof(int) );
+  check_mem(edges);
+  check_mem(off);
+
+  for (cur = front->edges_stack->first; 
+       cur != NULL; cur = cur->next)
+    if ( ((tmEdge*)cur->value)->bdry_marker != TM_DOMAIN_MARKER )
+      edges[n++] = (tmEdge*) cur->value;
+
+  check( tmEdge_subdivide(mesh, edges, n, TM_FRONT_REFINE_FAC, 
+                          off, &xy) == TRUE,
+      "Failed to subdivide the advancing front edges.");
+
+  nodes_new = malloc( (off[n]+1) * sizeof(void*) );
+  edges_new = malloc( (off[n]+n+1) * sizeof(void*) );
+  check_mem(nodes_new);
+  check_mem(edges_new);
+
+  /*-------------------------------------------------------
+  | Replace every edge by a chain of new edges, which are
+  | appended to the front
+  -------------------------------------------------------*/
+  mesh->qtree_defer = TRUE;
+
+  for (i = 0; i < n; i++)
+  {
+    if ( off[i+1] == off[i] )
+      continue;
+
+    tmNode *n1     = edges[i]->n1;
+    tmNode *n2     = edges[i]->n2;
+    int     marker = edges[i]->bdry_marker;
+    tmNode *prev   = n1;
+
+    tmEdge_destroy(edges[i]);
+
+    for (j = off[i]; j <= off[i+1]; j++)
+    {
+      tmNode *next = n2;
+
+      if ( j < off[i+1] )
+      {
+        next = tmNode_create(mesh, xy[j]);
+        nodes_new[n_nodes++] = next;
+      }
+
+      tmEdge *edge = tmFront_edgeCreate(front, prev, next, NULL);
+      edge->bdry_marker = marker;
+      edges_new[n_edges++] = edge;
+
+      prev = next;
+    }
+  }
+
+  mesh->qtree_defer = FALSE;
+
+  check( tmQtree_addObjs(mesh->nodes_qtree, nodes_new, n_nodes)
+      && tmQtree_addObjs(front->edges_qtree, edges_new, n_edges),
+      "Failed to add subdivided front edges to the qtrees.");
+
+  success = TRUE;
+
+error:
+  mesh->qtree_defer = FALSE;
+  free(edges);
+  free(off);
+  free(xy);
+  free(nodes_new);
+  free(edges_new);
+  return success;
+
+} /* tmFront_subdivide() */
+
 /**********************************************************
 * Function: tmFront_refine()
 *----------------------------------------------------------
 * Refine the edges of the advancing front structure 
-* according to a size function
+* according to a size function by bisection, which may
+* be preceded by a subdivision of all edges in one pass 
+* (see tmMesh_setSubdivision())
 *----------------------------------------------------------
 * @param *mesh: pointer to mesh containing the front
 * @return: 
 **********************************************************/
 void tmFront_refine(tmMesh *mesh)
 {
-  tmListNode *cur, *nxt;
-  int counter = 0;
-
   tmFront *front = mesh->front;
+  tmListNode *cur;
+  int i, n, n_split;
+  int size = 0;
 
-  cur = nxt = front->edges_stack->first;
+  tmEdge  **edges = NULL;
+  tmDouble (*xy)[2] = NULL;
+  tmDouble *rho = NULL;
+
+  /*-------------------------------------------------------
+  | The one-pass subdivision uses the size function of the
+  | unrefined advancing front, which depends on its edge lengths.
+  | Hence, it is followed by bisection, which splits the 
+  | remaining edges, that are too long.
+  -------------------------------------------------------*/
+  if ( mesh->subdivision == TM_SUBDIVIDE_INTEGRAL && 
+       tmFront_subdivide(mesh) == FALSE )
+  {
+    log_warn("Failed to subdivide the advancing front edges, "
+             "falling back to bisection.");
+  }
 
-  tmSizeFun sizeFun = front->mesh->sizeFun;
+  /*-------------------------------------------------------
+  | The edges are refined in passes: the size function
+  | is evaluated for all edges of a pass at once and the 
+  | edges, which result from splitting, are appended to 
+  | the list and form the next pass.
+  | This is the same order as walking through the list 
+  | until all edges are fine enough.
+  -------------------------------------------------------*/
+  cur = front->edges_stack->first;
+  n   = front->no_edges;
 
-  while ( counter < front->no_edges )
+  while ( n > 0 )
   {
-    nxt = cur->next;
+    if ( n > size )
+    {
+      size = 2 * n;
 
-    tmDouble *xy_1 = ((tmEdge*)cur->value)->n1->xy;
-    tmDouble *xy_m = ((tmEdge*)cur->value)->xy;
+      tmEdge **edges_new = realloc(edges, size * sizeof(tmEdge*));
+      check_mem(edges_new);
+      edges = edges_new;
 
-    tmDouble rho_1 = sizeFun(mesh, xy_1 );
-    tmDouble rho_m = sizeFun(mesh, xy_m );
-    tmDouble rho   = TM_FRONT_REFINE_FAC * (rho_1 + rho_m);
-    check( rho > TM_MIN_SIZE,
-        "Size function return value lower than defined minimum scale.");
+      tmDouble (*xy_new)[2] = realloc(xy, 2 * size * sizeof(*xy));
+      check_mem(xy_new);
+      xy = xy_new;
 
-    if ( ((tmEdge*)cur->value)->len > rho )
-      tmFront_splitEdge(front, cur->value);
-    else
-      counter += 1;
+      tmDouble *rho_new = realloc(rho, 2 * size * sizeof(tmDouble));
+      check_mem(rho_new);
+      rho = rho_new;
+    }
 
-    cur = nxt;
+    /*-----------------------------------------------------
+    | Gather the edges of this pass
+    -----------------------------------------------------*/
+    for (i = 0; i < n; i++)
+    {
+      edges[i] = (tmEdge*) cur->value;
+
+      xy[2*i  ][0] = edges[i]->n1->xy[0];
+      xy[2*i  ][1] = edges[i]->n1->xy[1];
+      xy[2*i+1][0] = edges[i]->xy[0];
+      xy[2*i+1][1] = edges[i]->xy[1];
+
+      cur = cur->next;
+    }
 
-    if (cur == NULL)
-      cur = front->edges_stack->first;
+    mesh->sizeFunBatch(mesh, 2*n, xy, rho);
+
+    /*-----------------------------------------------------
+    | Split all edges, which are too long 
+    -----------------------------------------------------*/
+    n_split = 0;
+
+    for (i = 0; i < n; i++)
+    {
+      tmDouble rho_e = TM_FRONT_REFINE_FAC * (rho[2*i] + rho[2*i+1]);
+      check( rho_e > TM_MIN_SIZE,
+          "Size function return value lower than defined minimum scale.");
+
+      edges[i]->n1->size = rho[2*i];
+
+      if ( edges[i]->len > rho_e )
+      {
+        tmFront_splitEdge(front, edges[i]);
+        n_split += 1;
+      }
+      else
+        edges[i]->size = rho[2*i+1];
+    }
+
+    /*-----------------------------------------------------
+    | The new edges are located at the end of the list
+    -----------------------------------------------------*/
+    n = 2 * n_split;
+
+    if ( n > 0 )
+    {
+      cur = front->edges_stack->last;
+      for (i = 1; i < n; i++)
+        cur = cur->prev;
+    }
   }
 
 error:
+  if (edges != NULL) free(edges);
+  if (xy    != NULL) free(xy);
+  if (rho   != NULL) free(rho);
   return;
 
 } /* tmFront_refine() */
@@ -5,15 +5,20 @@
  * Refer to the accompanying documentation for details
  * on usage and license.
  */
+#include <string.h>
+
 #include "tmesh/tmTypedefs.h"
 #include "tmesh/tmList.h"
 #include "tmesh/tmMesh.h"
+#include "tmesh/tmMeshIO.h"
 #include "tmesh/tmBdry.h"
 #include "tmesh/tmFront.h"
 #include "tmesh/tmEdge.h"
 #include "tmesh/tmNode.h"
 #include "tmesh/tmTri.h"
 #include "tmesh/tmQtree.h"
+#include "tmesh/tmPool.h"
+#include "tmesh/tmDomain.h"
 
 
 
@@ -75,6 +80,17 @@ tmMesh *tmMesh_create(tmDouble      xy_min[2],
   -------------------------------------------------------*/
   mesh->sizeFun            = &tmMesh_sizeFun;
   mesh->sizeFunUser        = sizeFunUser;
+  mesh->sizeFunBatch       = &tmMesh_sizeFunBatch;
+  mesh->sizeFunUserCtx     = NULL;
+  mesh->sizeFunUserBatch   = NULL;
+  mesh->sizeFunCtx         = NULL;
+  mesh->n_size_saved       = 0;
+  mesh->period[0]          = 0.0;
+  mesh->period[1]          = 0.0;
+  mesh->n_period[0]        = 0;
+  mesh->n_period[1]        = 0;
+  mesh->period_min[0]      = 0.0;
+  mesh->period_min[1]      = 0.0;
 
   /*-------------------------------------------------------
   | Mesh edges 
@@ -99,6 +115,27 @@ tmMesh *tmMesh_create(tmDouble      xy_min[2],
   mesh->tris_qtree        = tmQtree_create(mesh, TM_TRI);
   tmQtree_init(mesh->tris_qtree, NULL, 0, xy_min, xy_max);
 
+  /*-------------------------------------------------------
+  | Thread pool is created on demand
+  -------------------------------------------------------*/
+  mesh->n_threads         = 1;
+  mesh->pool              = NULL;
+
+  mesh->sink_node         = NULL;
+  mesh->sink_tri          = NULL;
+  mesh->sink_ctx          = NULL;
+  mesh->sink_n_nodes      = 0;
+  mesh->sink_n_tris       = 0;
+
+  mesh->adv_n_serial      = TM_ADV_SERIAL_CANDS;
+  mesh->subdivision       = TM_SUBDIVIDE_BISECT;
+  mesh->adv_n_cands       = TM_ADV_PARALLEL_CANDS;
+
+  mesh->qtree_defer       = FALSE;
+  mesh->verbose           = TRUE;
+
+  mesh->parent            = NULL;
+
 
   return mesh;
 error:
@@ -211,6 +248,11 @@ void tmMesh_destroy(tmMesh *mesh)
   tmList_destroy(mesh->bdry_stack);
   tmList_destroy(mesh->delaunay_stack);
 
+  /*-------------------------------------------------------
+  | Free thread pool
+  -------------------------------------------------------*/
+  tmPool_destroy(mesh->pool);
+
   /*-------------------------------------------------------
   | Finally free mesh structure memory
   -------------------------------------------------------*/
@@ -218,6 +260,204 @@ void tmMesh_destroy(tmMesh *mesh)
 
 } /* tmMesh_destroy() */
 
+/**********************************************************
+* Function: tmMesh_setThreads()
+*----------------------------------------------------------
+* Sets the number of threads, that are used for parallel
+* mesh operations (e.g. the delaunay edge flips). 
+* A thread pool is created for n_threads > 1.
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param n_threads: number of threads
+**********************************************************/
+void tmMesh_setThreads(tmMesh *mesh, int n_threads)
+{
+  check( n_threads > 0, "Invalid number of threads: %d", 
+      n_threads);
+
+  if ( n_threads == mesh->n_threads )
+    return;
+
+  tmPool_destroy(mesh->pool);
+  mesh->pool      = NULL;
+  mesh->n_threads = 1;
+
+  if ( n_threads > 1 )
+  {
+    mesh->pool = tmPool_create(n_threads);
+    check( mesh->pool != NULL, "Failed to create thread pool.");
+    mesh->n_threads = mesh->pool->n_threads;
+  }
+
+error:
+  return;
+
+} /* tmMesh_setThreads() */
+
+/**********************************************************
+* Function: tmMesh_setAdvanceCands()
+*----------------------------------------------------------
+* Sets the parameters for the parallel check of the 
+* neighbor nodes during the advancement of a front edge.
+* After n_serial nodes have been checked without success,
+* the remaining nodes are checked in batches of n_cands 
+* nodes on the thread pool of the mesh. 
+* The resulting mesh does not depend on these parameters.
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param n_cands: nodes per batch (1 disables batches)
+* @param n_serial: nodes, that are checked serially
+**********************************************************/
+void tmMesh_setAdvanceCands(tmMesh *mesh, int n_cands, int n_serial)
+{
+  check( n_cands > 0 && n_serial >= 0, 
+      "Invalid front advancement parameters: %d, %d", 
+      n_cands, n_serial);
+
+  mesh->adv_n_cands  = n_cands;
+  mesh->adv_n_serial = n_serial;
+
+error:
+  return;
+
+} /* tmMesh_setAdvanceCands() */
+
+/**********************************************************
+* Function: tmMesh_setSubdivision()
+*----------------------------------------------------------
+* Sets the method, which subdivides the boundary edges 
+* according to the size function before the meshing.
+* TM_SUBDIVIDE_BISECT halves every edge until it is 
+* shorter than the element size at its ends (default).
+* TM_SUBDIVIDE_INTEGRAL integrates the size function 
+* along every edge and places all new nodes at once
+* (see tmEdge_subdivide()), which gives a smoother size 
+* grading along the boundaries. Edges, which are still
+* too long for the refined boundaries, are then halved.
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param method: TM_SUBDIVIDE_BISECT or 
+*                TM_SUBDIVIDE_INTEGRAL
+**********************************************************/
+void tmMesh_setSubdivision(tmMesh *mesh, int method)
+{
+  check( method == TM_SUBDIVIDE_BISECT || 
+         method == TM_SUBDIVIDE_INTEGRAL, 
+      "Invalid edge subdivision method: %d", method);
+
+  mesh->subdivision = method;
+
+error:
+  return;
+
+} /* tmMesh_setSubdivision() */
+
+/**********************************************************
+* Function: tmMesh_setVerbose()
+*----------------------------------------------------------
+* Enables or disables the progress output of the 
+* meshing functions (enabled by default)
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param verbose: TRUE to print the progress
+**********************************************************/
+void tmMesh_setVerbose(tmMesh *mesh, tmBool verbose)
+{
+  mesh->verbose = verbose;
+
+} /* tmMesh_setVerbose() */
+
+/**********************************************************
+* Function: tmMesh_setSizeFunCtx()
+*----------------------------------------------------------
+* Sets a user-defined size function, which receives a 
+* context pointer. It replaces the size function of 
+* tmMesh_create(), such that the size function does not
+* depend on global state and several meshes with 
+* different size functions can be created concurrently.
+* The context is also passed to the function of 
+* tmMesh_setSizeFunBatch().
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param sizeFunUserCtx: user-defined size function 
+*                        (may be NULL)
+* @param ctx: context, which is passed to the functions
+**********************************************************/
+void tmMesh_setSizeFunCtx(tmMesh           *mesh, 
+                          tmSizeFunUserCtx  sizeFunUserCtx,
+                          void             *ctx)
+{
+  mesh->sizeFunUserCtx = sizeFunUserCtx;
+  mesh->sizeFunCtx     = ctx;
+
+} /* tmMesh_setSizeFunCtx() */
+
+/**********************************************************
+* Function: tmMesh_setSizeFunBatch()
+*----------------------------------------------------------
+* Sets a user-defined size function, which evaluates 
+* many points at once. It must return the same values 
+* as the size function of tmMesh_create() or 
+* tmMesh_setSizeFunCtx() and is used, when the mesh 
+* evaluates the size function for several points 
+* (see tmMesh_sizeFunBatch()).
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param sizeFunUserBatch: user-defined size function for
+*                          n points (may be NULL)
+**********************************************************/
+void tmMesh_setSizeFunBatch(tmMesh             *mesh, 
+                            tmSizeFunUserBatch  sizeFunUserBatch)
+{
+  mesh->sizeFunUserBatch = sizeFunUserBatch;
+
+} /* tmMesh_setSizeFunBatch() */
+
+/**********************************************************
+* Function: tmMesh_orderNodes()
+*----------------------------------------------------------
+* Sorts the mesh node list in the given order and sets 
+* the node indices accordingly
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param **nodes: all mesh nodes in their new order
+**********************************************************/
+void tmMesh_orderNodes(tmMesh *mesh, tmNode **nodes)
+{
+  int i;
+
+  for (i = 0; i < mesh->no_nodes; i++)
+  {
+    tmList_remove(mesh->nodes_stack, nodes[i]->stack_pos);
+    tmList_push(mesh->nodes_stack, nodes[i]);
+    nodes[i]->stack_pos = tmList_last_node(mesh->nodes_stack);
+    nodes[i]->index     = i;
+  }
+
+} /* tmMesh_orderNodes() */
+
+/**********************************************************
+* Function: tmMesh_orderTris()
+*----------------------------------------------------------
+* Sorts the mesh triangle list in the given order and 
+* sets the triangle indices accordingly
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param **tris: all mesh triangles in their new order
+**********************************************************/
+void tmMesh_orderTris(tmMesh *mesh, tmTri **tris)
+{
+  int i;
+
+  for (i = 0; i < mesh->no_tris; i++)
+  {
+    tmList_remove(mesh->tris_stack, tris[i]->stack_pos);
+    tmList_push(mesh->tris_stack, tris[i]);
+    tris[i]->stack_pos = tmList_last_node(mesh->tris_stack);
+    tris[i]->index     = i;
+  }
+
+} /* tmMesh_orderTris() */
 
 /**********************************************************
 * Function: tmMesh_addNode()
@@ -231,7 +471,8 @@ tmListNode *tmMesh_addNode(tmMesh *mesh, tmNode *node)
   tmListNode *node_pos;
   mesh->no_nodes += 1;
   tmList_push(mesh->nodes_stack, node);
-  tmQtree_addObj(mesh->nodes_qtree, node);
+  if ( mesh->qtree_defer == FALSE )
+    tmQtree_addObj(mesh->nodes_qtree, node);
   node_pos = tmList_last_node(mesh->nodes_stack);
   
   return node_pos;
@@ -313,7 +554,8 @@ tmListNode *tmMesh_addEdge(tmMesh *mesh, tmEdge *edge)
 
   mesh->no_edges += 1;
   tmList_push(mesh->edges_stack, edge);
-  tmQtree_addObj(mesh->edges_qtree, edge);
+  if ( mesh->qtree_defer == FALSE )
+    tmQtree_addObj(mesh->edges_qtree, edge);
   edge_pos = tmList_last_node(mesh->edges_stack);
 
   return edge_pos;
@@ -335,7 +577,8 @@ tmListNode *tmMesh_addTri(tmMesh *mesh, tmTri *tri)
   mesh->areaTris += tri->area;
 
   tmList_push(mesh->tris_stack, tri);
-  tmQtree_addObj(mesh->tris_qtree, tri);
+  if ( mesh->qtree_defer == FALSE )
+    tmQtree_addObj(mesh->tris_qtree, tri);
   tri_pos = tmList_last_node(mesh->tris_stack);
   
   return tri_pos;
@@ -512,283 +755,92 @@ tmBool tmMesh_objInside(tmMesh   *mesh, tmDouble xy[2])
 
 
 /**********************************************************
-* Function: tmMesh_printMesh()
+* Function: tmMesh_ADFInit()
 *----------------------------------------------------------
-* Fuction to print out the mesh data
+* Initializes the advancing front of a mesh from its 
+* boundaries
 *----------------------------------------------------------
 * @param mesh: pointer to mesh structure
+* @return: FALSE, if the mesh boundaries are invalid
 **********************************************************/
-void tmMesh_printMesh(tmMesh *mesh) 
+static tmBool tmMesh_ADFInit(tmMesh *mesh)
 {
-  tmListNode *cur, *cur_bdry;
-  int node_index = 0;
-  int edge_index = 0;
-  int tri_index  = 0;
-  int bdry_edge_index = 0;
+  tmListNode *cur;
 
   /*-------------------------------------------------------
-  | Set node indices and print node coordinates
+  | Initialize size function for boundaries
   -------------------------------------------------------*/
-  fprintf(stdout,"NODES %d\n", mesh->no_nodes);
-  for (cur = mesh->nodes_stack->first; 
+  for (cur = mesh->bdry_stack->first; 
        cur != NULL; cur = cur->next)
   {
-    tmDouble *xy = ((tmNode*)cur->value)->xy;
-    ((tmNode*)cur->value)->index = node_index;
-    fprintf(stdout,"%d\t%9.5f\t%9.5f\n", node_index, xy[0], xy[1]);
-    node_index += 1;
-  }
-
-  /*-------------------------------------------------------
-  | print boundary edges
-  -------------------------------------------------------*/
-  for (cur_bdry = mesh->bdry_stack->first; 
-       cur_bdry != NULL; cur_bdry = cur_bdry->next)
-  {
-    tmBdry *bdry = (tmBdry*)cur_bdry->value;
-
-    fprintf(stdout,"BOUNDARY %d %d\n", 
-        ((tmBdry*)cur_bdry->value)->index,
-        ((tmBdry*)cur_bdry->value)->no_edges);
-
-    for (cur = bdry->edges_stack->first; 
-         cur != NULL; cur = cur->next)
-    {
-      tmIndex ind1 = ((tmEdge*)cur->value)->n1->index;
-      tmIndex ind2 = ((tmEdge*)cur->value)->n2->index;
-      tmIndex marker = ((tmEdge*)cur->value)->bdry_marker;
-      ((tmEdge*)cur->value)->index = edge_index;
-      fprintf(stdout,"%d\t%9d\t%9d\t%9d\n", edge_index, 
-          ind1, ind2, marker);
-      edge_index += 1;
-    }
+    tmBdry_initSizeFun( (tmBdry*) cur->value );
   }
 
-  /*-------------------------------------------------------
-  | print front edges
-  -------------------------------------------------------*/
-  edge_index = 0;
-  fprintf(stdout,"FRONT %d\n", mesh->front->no_edges);
-  for (cur = mesh->front->edges_stack->first; 
-       cur != NULL; cur = cur->next)
-  {
-    tmIndex ind1 = ((tmEdge*)cur->value)->n1->index;
-    tmIndex ind2 = ((tmEdge*)cur->value)->n2->index;
-    ((tmEdge*)cur->value)->index = edge_index;
-    fprintf(stdout,"%d\t%9d\t%9d\n", edge_index, ind1, ind2);
-    edge_index += 1;
-  }
+  tmMesh_resetSizes(mesh);
 
   /*-------------------------------------------------------
-  | print triangles
+  | Initialize the front from mesh boundaries
   -------------------------------------------------------*/
-  fprintf(stdout,"TRIANGLES %d\n", mesh->no_tris);
-  for (cur = mesh->tris_stack->first; 
-       cur != NULL; cur = cur->next)
-  {
-    tmTri *curTri = (tmTri*)cur->value;
-    ((tmTri*)cur->value)->index = tri_index;
-
-    fprintf(stdout,"%d\t%d\t%d\t%d\n", 
-        tri_index, 
-        curTri->n1->index,
-        curTri->n2->index,
-        curTri->n3->index);
-
-    tri_index += 1;
-  }
-
-  /*-------------------------------------------------------
-  | Print mesh edges and triangle neighbors
-  -------------------------------------------------------*
-  fprintf(stdout,"MESH EDGES %d\n", mesh->no_edges);
-  edge_index = 0;
-  for (cur = mesh->edges_stack->first; 
-       cur != NULL; cur = cur->next)
-  {
-    tmIndex ind1 = ((tmEdge*)cur->value)->n1->index;
-    tmIndex ind2 = ((tmEdge*)cur->value)->n2->index;
-    ((tmEdge*)cur->value)->index = edge_index;
-
-    tmTri *t1 = ((tmEdge*)cur->value)->t1;
-    tmTri *t2 = ((tmEdge*)cur->value)->t2;
-
-    tmIndex i1 = -1;
-    tmIndex i2 = -1;
-
-    if (t1 != NULL)
-      i1 = t1->index;
-    if (t2 != NULL)
-      i2 = t2->index;
-
-    fprintf(stdout,"%d\t%9d\t%9d\t%9d\t%9d\n", 
-        edge_index, ind1, ind2, i1, i2);
-    edge_index += 1;
-  }*/
+  tmFront_init(mesh);
+  tmFront_refine(mesh);
+  tmFront_sortEdges(mesh);
 
   /*-------------------------------------------------------
-  | print triangles neighbors
+  | Compute mesh area
   -------------------------------------------------------*/
-  fprintf(stdout,"NEIGHBORS %d\n", mesh->no_tris);
-  tri_index = 0;
-  for (cur = mesh->tris_stack->first; 
-       cur != NULL; cur = cur->next)
-  {
-    tmTri *curTri = (tmTri*)cur->value;
-
-    tmTri *t1 = ((tmTri*)cur->value)->t1;
-    tmTri *t2 = ((tmTri*)cur->value)->t2;
-    tmTri *t3 = ((tmTri*)cur->value)->t3;
-
-    tmIndex i1 = -1;
-    tmIndex i2 = -1;
-    tmIndex i3 = -1;
-
-    if (t1 != NULL)
-    {
-      i1 = t1->index == tri_index ? -1 : t1->index;
-    }
-    if (t2 != NULL)
-    {
-      i2 = t2->index == tri_index ? -1 : t2->index;
-    }
-    if (t3 != NULL)
-    {
-      i3 = t3->index == tri_index ? -1 : t3->index;
-    }
+  tmMesh_calcArea(mesh);
+  check(mesh->areaBdry > 0.0, 
+      "Invalid mesh boundary. Domain area <= zero.");
 
-    fprintf(stdout,"%d\t%d\t%d\t%d\n", 
-        tri_index, i1, i2, i3);
-    
-    tri_index += 1;
-  } 
+  return TRUE;
 
-} /* tmMesh_printMesh() */
+error:
+  return FALSE;
 
+} /* tmMesh_ADFInit() */
 
 /**********************************************************
-* Function: tmMesh_printMeshIncomflow()
+* Function: tmMesh_ADFProgress()
 *----------------------------------------------------------
-* Fuction to print out the mesh data in the format for
-* the incomflow solver
+* Prints the progress of the advancing front meshing
 *----------------------------------------------------------
 * @param mesh: pointer to mesh structure
+* @param oldProgress: last printed progress
 **********************************************************/
-void tmMesh_printMeshIncomflow(tmMesh *mesh) 
+static void tmMesh_ADFProgress(tmMesh *mesh, int *oldProgress)
 {
-  tmListNode *cur;
-
-  int node_index = 0;
-  int edge_index = 0;
-  int tri_index  = 0;
-  int bdry_edge_index = 0;
-
-  /*-------------------------------------------------------
-  | Set node indices and print node coordinates
-  -------------------------------------------------------*/
-  fprintf(stdout,"NODES %d\n", mesh->no_nodes);
-  for (cur = mesh->nodes_stack->first; 
-       cur != NULL; cur = cur->next)
-  {
-    tmDouble *xy = ((tmNode*)cur->value)->xy;
-    ((tmNode*)cur->value)->index = node_index;
-    fprintf(stdout,"%d\t%9.5f\t%9.5f\n", node_index, xy[0], xy[1]);
-    node_index += 1;
-  }
+  int progress = (int) (mesh->areaTris * 100. / mesh->areaBdry);
 
-  /*-------------------------------------------------------
-  | print triangles
-  -------------------------------------------------------*/
-  fprintf(stdout,"TRIANGLES %d\n", mesh->no_tris);
-  for (cur = mesh->tris_stack->first; 
-       cur != NULL; cur = cur->next)
+  if (((progress % 10) == 0) && (progress > *oldProgress) 
+      && mesh->parent == NULL && mesh->verbose == TRUE)
   {
-    tmTri *curTri = (tmTri*)cur->value;
-    ((tmTri*)cur->value)->index = tri_index;
-
-    fprintf(stdout,"%d\t%d\t%d\t%d\n", 
-        tri_index, 
-        curTri->n1->index,
-        curTri->n2->index,
-        curTri->n3->index);
-
-    tri_index += 1;
+    *oldProgress = progress;
+    tmPrint("ADVANCING FRONT PROGRESS: %2d%%", progress);
   }
 
-  /*-------------------------------------------------------
-  | print triangles neighbors
-  -------------------------------------------------------*/
-  fprintf(stdout,"NEIGHBORS %d\n", mesh->no_tris);
-  tri_index = 0;
-  for (cur = mesh->tris_stack->first; 
-       cur != NULL; cur = cur->next)
-  {
-    tmTri *curTri = (tmTri*)cur->value;
-
-    tmTri *t1 = ((tmTri*)cur->value)->t1;
-    tmTri *t2 = ((tmTri*)cur->value)->t2;
-    tmTri *t3 = ((tmTri*)cur->value)->t3;
-
-    tmEdge *e1 = ((tmTri*)cur->value)->e1;
-    tmEdge *e2 = ((tmTri*)cur->value)->e2;
-    tmEdge *e3 = ((tmTri*)cur->value)->e3;
-
-    tmIndex i1 = t1->index != tri_index ? t1->index : -(e1->bdry_marker);
-    tmIndex i2 = t2->index != tri_index ? t2->index : -(e2->bdry_marker);
-    tmIndex i3 = t3->index != tri_index ? t3->index : -(e3->bdry_marker);
-
-    fprintf(stdout,"%d\t%d\t%d\t%d\n", 
-        tri_index, i1, i2, i3);
-    
-    tri_index += 1;
-  } 
-
-} /* tmMesh_printMeshIncomflow() */
-
+} /* tmMesh_ADFProgress() */
 
 /**********************************************************
-* Function: tmMesh_adfMeshing()
+* Function: tmMesh_ADFLoop()
 *----------------------------------------------------------
-* Function to perform the advancing front loop 
-* until either no edges are available anymore or until 
-* a final iteration is reached
+* Advances the front until either no edges are available
+* anymore, until no front edge can be advanced or until 
+* n_max triangles have been created
 *----------------------------------------------------------
-* 
+* @param mesh: pointer to mesh structure
+* @param oldProgress: last printed progress
+* @param n_max: maximum number of new triangles 
+*               (no limit for n_max < 0)
+* @return: number of new triangles
 **********************************************************/
-void tmMesh_ADFMeshing(tmMesh *mesh)
+static int tmMesh_ADFLoop(tmMesh *mesh, int *oldProgress, int n_max)
 {
   int      n            = 0;
-  int      progress     = 0;
-  int      oldProgress  = 0;
-  tmDouble area_inv     = 0.0;
+  int      n_tris       = 0;
 
   tmListNode *cur, *nxt;
   tmFront  *front = mesh->front;
 
-  /*-------------------------------------------------------
-  | Initialize size function for boundaries
-  -------------------------------------------------------*/
-  for (cur = mesh->bdry_stack->first; 
-       cur != NULL; cur = cur->next)
-  {
-    tmBdry_initSizeFun( (tmBdry*) cur->value );
-  }
-
-  /*-------------------------------------------------------
-  | Initialize the front from mesh boundaries
-  -------------------------------------------------------*/
-  tmFront_init(mesh);
-  tmFront_refine(mesh);
-  tmFront_sortEdges(mesh);
-
-  /*-------------------------------------------------------
-  | Compute mesh area
-  -------------------------------------------------------*/
-  tmMesh_calcArea(mesh);
-  check(mesh->areaBdry > 0.0, 
-      "Invalid mesh boundary. Domain area <= zero.");
-  area_inv = 100. / mesh->areaBdry;
-
   /*-------------------------------------------------------
   | Main loop for finding creating triangles
   -------------------------------------------------------*/
@@ -798,12 +850,7 @@ void tmMesh_ADFMeshing(tmMesh *mesh)
     /*-----------------------------------------------------
     | Print meshing progress
     -----------------------------------------------------*/
-    progress = (int) (mesh->areaTris  * area_inv);
-    if (((progress % 10) == 0) && (progress > oldProgress))
-    {
-      oldProgress = progress;
-      tmPrint("ADVANCING FRONT PROGRESS: %2d%%", progress);
-    }
+    tmMesh_ADFProgress(mesh, oldProgress);
 
     /*-----------------------------------------------------
     | Choose new base segment
@@ -822,19 +869,51 @@ void tmMesh_ADFMeshing(tmMesh *mesh)
     | Try to form new triangle with current base segment
     | -> go to next segment, if it failed
     -----------------------------------------------------*/
-    if ( tmFront_advance(mesh, curEdge) == TRUE )
+    tmBool success = tmFront_advance(mesh, curEdge);
+
+    if ( success == FALSE )
+    {
+      cur = nxt;
+      n += 1;
+
+      /*---------------------------------------------------
+      | No front edge can be advanced anymore
+      | -> Close remaining front loops of three edges
+      ---------------------------------------------------*/
+      if ( n == front->no_edges )
+        success = tmFront_closeLoop(mesh);
+    }
+
+    if ( success == TRUE )
     {
       //tmFront_sortEdges(mesh);
       cur = front->edges_stack->first;
       n = 0;
-    }
-    else
-    {
-      cur = nxt;
-      n += 1;
+
+      n_tris += 1;
+      if (n_tris == n_max)
+        break;
     }
   }
 
+  return n_tris;
+
+} /* tmMesh_ADFLoop() */
+
+/**********************************************************
+* Function: tmMesh_ADFFinish()
+*----------------------------------------------------------
+* Checks the result of the advancing front meshing and
+* sets the triangle-triangle connectivity
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+**********************************************************/
+static void tmMesh_ADFFinish(tmMesh *mesh)
+{
+  tmFront *front = mesh->front;
+
+  tmMesh_sinkFlush(mesh);
+
   /*-------------------------------------------------------
   | Compare mesh area to triangle areas
   -------------------------------------------------------*/
@@ -855,65 +934,1768 @@ void tmMesh_ADFMeshing(tmMesh *mesh)
 error:
   return;
 
-} /* tmMesh_adfMeshing() */
+} /* tmMesh_ADFFinish() */
+
+/**********************************************************
+* Function: tmMesh_adfMeshing()
+*----------------------------------------------------------
+* Function to perform the advancing front loop 
+* until either no edges are available anymore or until 
+* a final iteration is reached
+*----------------------------------------------------------
+* 
+**********************************************************/
+void tmMesh_ADFMeshing(tmMesh *mesh)
+{
+  int oldProgress = 0;
+
+  if ( tmMesh_ADFInit(mesh) == FALSE )
+    return;
 
+  tmMesh_ADFLoop(mesh, &oldProgress, -1);
+  tmMesh_ADFFinish(mesh);
 
+} /* tmMesh_adfMeshing() */
 
 /**********************************************************
-* Function: tmMesh_delaunayFlip()
+* Function: tmMesh_evalFrontCands()
 *----------------------------------------------------------
-* Function to perform the flip algorithm on a triangulated
-* mesh, in order to obtain a triangulation that is delaunay
+* Parallel loop body, which evaluates the advancement
+* of the front edge candidates [i_beg, i_end)
 *----------------------------------------------------------
-* 
+* @param data: array of tmFrontCands
 **********************************************************/
-void tmMesh_delaunayFlip(tmMesh *mesh)
+static void tmMesh_evalFrontCands(void  *data, 
+                                  size_t i_beg, 
+                                  size_t i_end,
+                                  int    thread_id)
 {
-  /*-------------------------------------------------------
-  | Create list of edges that are not locally delaunay
-  -------------------------------------------------------*/
-  int       n_flip = 0;
-  tmListNode *cur;
+  tmFrontCand *cands = (tmFrontCand*) data;
+  size_t i;
 
-  int n_edges  = mesh->edges_stack->count;
-  int flip_max = n_edges * n_edges;
+  (void) thread_id;
 
-#if (TM_DEBUG > 1)
+  for (i = i_beg; i < i_end; i++)
+    tmFront_evalAdvance(cands[i].edge->mesh, &cands[i]);
+
+} /* tmMesh_evalFrontCands() */
+
+/**********************************************************
+* Function: tmMesh_pickFrontEdges()
+*----------------------------------------------------------
+* Picks front edges in the order of the front edge stack,
+* whose estimated regions of influence do not overlap
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param cands: array for the picked candidates
+* @param n_max: maximum number of candidates
+* @return: number of picked candidates
+**********************************************************/
+static int tmMesh_pickFrontEdges(tmMesh      *mesh, 
+                                 tmFrontCand *cands,
+                                 int          n_max)
+{
+  tmListNode *cur;
+  int n      = 0;
+  int n_scan = 0;
+  int i;
+
+  for (cur = mesh->front->edges_stack->first; 
+       cur != NULL && n < n_max && n_scan < TM_ADF_SCAN_FAC * n_max;
+       cur = cur->next, n_scan++)
+  {
+    tmEdge  *e = (tmEdge*) cur->value;
+    tmDouble r = TM_ADF_REGION_FAC * e->len;
+
+    tmDouble xy_min[2] = { e->xy[0] - r, e->xy[1] - r };
+    tmDouble xy_max[2] = { e->xy[0] + r, e->xy[1] + r };
+
+    for (i = 0; i < n; i++)
+      if ( BBOX_OVERLAP(xy_min, xy_max, 
+                        cands[i].xy_min, cands[i].xy_max) )
+        break;
+
+    if (i < n)
+      continue;
+
+    cands[n].edge      = e;
+    cands[n].xy_min[0] = xy_min[0];
+    cands[n].xy_min[1] = xy_min[1];
+    cands[n].xy_max[0] = xy_max[0];
+    cands[n].xy_max[1] = xy_max[1];
+    n += 1;
+  }
+
+  return n;
+
+} /* tmMesh_pickFrontEdges() */
+
+/**********************************************************
+* Function: tmMesh_ADFMeshingSpeculative()
+*----------------------------------------------------------
+* Advancing front meshing, where front edges from 
+* separated regions are advanced concurrently:
+* In every step, a batch of front edges is evaluated in 
+* parallel without modifying the mesh. Afterwards, the 
+* new triangles are created in the order of the batch.
+* If a triangle has been created within the region of 
+* a candidate in the same step, the candidate may be 
+* outdated and its front edge is evaluated again later.
+* Front edges, which can not be advanced, are moved to 
+* the end of the front edge stack. If no edge of a batch 
+* can be advanced, all front edges are tried in serial 
+* as in tmMesh_ADFMeshing().
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+**********************************************************/
+void tmMesh_ADFMeshingSpeculative(tmMesh *mesh)
+{
+  tmFrontCand *cands = NULL;
+  tmDouble   (*boxes)[4] = NULL;
+  int          oldProgress = 0;
+  int          n_batch, n_cands, n_boxes;
+  int          i, j;
+
+  if (mesh->n_threads < 2)
+  {
+    tmMesh_ADFMeshing(mesh);
+    return;
+  }
+
+  if ( tmMesh_ADFInit(mesh) == FALSE )
+    return;
+
+  n_batch = TM_ADF_BATCH_SIZE * mesh->n_threads;
+
+  cands = (tmFrontCand*) calloc(n_batch, sizeof(tmFrontCand));
+  boxes = calloc(n_batch, sizeof(*boxes));
+  check_mem(cands);
+  check_mem(boxes);
+
+  while ( mesh->front->no_edges > 0 )
+  {
+    tmMesh_ADFProgress(mesh, &oldProgress);
+
+    n_cands = tmMesh_pickFrontEdges(mesh, cands, n_batch);
+
+    tmPool_parallelFor(mesh->pool, n_cands, 1, 
+                       tmMesh_evalFrontCands, cands);
+
+    /*-----------------------------------------------------
+    | Edges, which can not be advanced yet, are retried
+    | after all other front edges
+    -----------------------------------------------------*/
+    for (i = 0; i < n_cands; i++)
+      if (cands[i].is_valid == FALSE)
+        tmFront_postponeEdge(mesh->front, cands[i].edge);
+
+    /*-----------------------------------------------------
+    | Create the new triangles, unless another triangle 
+    | has been created in the region of a candidate
+    -----------------------------------------------------*/
+    n_boxes = 0;
+
+    for (i = 0; i < n_cands; i++)
+    {
+      tmFrontCand *c = &cands[i];
+
+      if (c->is_valid == FALSE)
+        continue;
+
+      for (j = 0; j < n_boxes; j++)
+        if ( BBOX_OVERLAP(c->xy_min, c->xy_max, 
+                          boxes[j], &boxes[j][2]) )
+          break;
+
+      if (j < n_boxes)
+        continue;
+
+      tmTri *t = tmFront_commitAdvance(mesh, c);
+
+      boxes[n_boxes][0] = MIN(t->n1->xy[0], MIN(t->n2->xy[0], t->n3->xy[0]));
+      boxes[n_boxes][1] = MIN(t->n1->xy[1], MIN(t->n2->xy[1], t->n3->xy[1]));
+      boxes[n_boxes][2] = MAX(t->n1->xy[0], MAX(t->n2->xy[0], t->n3->xy[0]));
+      boxes[n_boxes][3] = MAX(t->n1->xy[1], MAX(t->n2->xy[1], t->n3->xy[1]));
+      n_boxes += 1;
+    }
+
+    /*-----------------------------------------------------
+    | No edge of the batch can be advanced 
+    | -> try all front edges in serial
+    -----------------------------------------------------*/
+    if ( n_boxes == 0 && tmMesh_ADFLoop(mesh, &oldProgress, 1) == 0 )
+      break;
+  }
+
+  tmMesh_ADFFinish(mesh);
+
+error:
+  free(cands);
+  free(boxes);
+  return;
+
+} /* tmMesh_ADFMeshingSpeculative() */
+
+/**********************************************************
+* Function: tmMesh_ADFMeshingDomains()
+*----------------------------------------------------------
+* Parallel loop body, which meshes the subdomains 
+* [i_beg, i_end) with the advancing front method
+*----------------------------------------------------------
+* @param data: array of tmDomain pointers
+**********************************************************/
+static void tmMesh_ADFMeshingDomains(void  *data, 
+                                     size_t i_beg, 
+                                     size_t i_end,
+                                     int    thread_id)
+{
+  tmDomain **doms = (tmDomain**) data;
+  size_t i;
+
+  (void) thread_id;
+
+  for (i = i_beg; i < i_end; i++)
+    tmMesh_ADFMeshing(doms[i]->sub);
+
+} /* tmMesh_ADFMeshingDomains() */
+
+/**********************************************************
+* Function: tmMesh_destroyDomains()
+*----------------------------------------------------------
+* Parallel loop body, which destroys the meshes of the 
+* subdomains [i_beg, i_end)
+*----------------------------------------------------------
+* @param data: array of tmDomain pointers
+**********************************************************/
+static void tmMesh_destroyDomains(void  *data, 
+                                  size_t i_beg, 
+                                  size_t i_end,
+                                  int    thread_id)
+{
+  tmDomain **doms = (tmDomain**) data;
+  size_t i;
+
+  (void) thread_id;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmMesh_destroy(doms[i]->sub);
+    doms[i]->sub = NULL;
+  }
+
+} /* tmMesh_destroyDomains() */
+
+/**********************************************************
+* Function: tmMesh_cmpDomainWork()
+*----------------------------------------------------------
+* Sorts subdomains by their estimated number of elements
+* in descending order
+**********************************************************/
+static int tmMesh_cmpDomainWork(const void *a, const void *b)
+{
+  const tmDomain *da = *(tmDomain* const*) a;
+  const tmDomain *db = *(tmDomain* const*) b;
+
+  return (da->work < db->work) - (da->work > db->work);
+
+} /* tmMesh_cmpDomainWork() */
+
+/**********************************************************
+* Function: tmMesh_ADFMeshingParallel()
+*----------------------------------------------------------
+* Splits the mesh domain along straight cuts into 
+* n_domains subdomains with a similar estimated number 
+* of elements (see tmDomain.h)
+* and meshes every subdomain as an independent tmMesh 
+* with the advancing front method. The subdomains are 
+* distributed onto the threads of the mesh and their 
+* meshes are finally merged into the mesh. 
+* Interface edges are treated as interior edges.
+* Falls back to tmMesh_ADFMeshing(), if the domain can 
+* not be split.
+*----------------------------------------------------------
+* @param *mesh: pointer to mesh
+* @param n_domains: number of subdomains
+**********************************************************/
+void tmMesh_ADFMeshingParallel(tmMesh *mesh, int n_domains)
+{
+  tmListNode *cur;
+  tmDomain  **doms      = NULL;
+  tmBool     *can_split = NULL;
+  tmList     *subs;
+  int         n     = 0;
+  int         n_max = n_domains;
+  int         i;
+
+  if (n_domains < 2)
+  {
+    tmMesh_ADFMeshing(mesh);
+    return;
+  }
+
+  /*-------------------------------------------------------
+  | The size function is required to distribute the 
+  | nodes on the cuts
+  -------------------------------------------------------*/
+  for (cur = mesh->bdry_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmBdry_initSizeFun( (tmBdry*) cur->value );
+  }
+
+  tmMesh_resetSizes(mesh);
+
+  doms      = (tmDomain**) calloc(n_domains, sizeof(tmDomain*));
+  can_split = (tmBool*)    calloc(n_domains, sizeof(tmBool));
+  check_mem(doms);
+  check_mem(can_split);
+
+  doms[0] = tmDomain_create(mesh, TM_DOMAIN_SAMPLES * n_domains);
+
+  if (doms[0] != NULL)
+  {
+    can_split[0] = TRUE;
+    n = 1;
+  }
+
+  /*-------------------------------------------------------
+  | Split the subdomain with the most estimated elements
+  | until enough subdomains have been created
+  -------------------------------------------------------*/
+  while (n > 0 && n < n_domains)
+  {
+    int i_max = -1;
+
+    for (i = 0; i < n; i++)
+      if ( can_split[i] && 
+          (i_max < 0 || doms[i]->work > doms[i_max]->work) )
+        i_max = i;
+
+    if (i_max < 0)
+      break;
+
+    subs = tmDomain_split(doms[i_max]);
+
+    if (subs == NULL)
+    {
+      can_split[i_max] = FALSE;
+      continue;
+    }
+
+    /*-----------------------------------------------------
+    | A cut may result in more than two subdomains
+    -----------------------------------------------------*/
+    if (n + subs->count - 1 > n_max)
+    {
+      n_max     = n + subs->count - 1;
+      doms      = (tmDomain**) realloc(doms, 
+                                       n_max * sizeof(tmDomain*));
+      can_split = (tmBool*)    realloc(can_split, 
+                                       n_max * sizeof(tmBool));
+      check_mem(doms);
+      check_mem(can_split);
+    }
+
+    tmDomain_destroy(doms[i_max]);
+    doms[i_max] = (tmDomain*) subs->first->value;
+
+    for (cur = subs->first->next; cur != NULL; cur = cur->next)
+    {
+      doms[n]      = (tmDomain*) cur->value;
+      can_split[n] = TRUE;
+      n += 1;
+    }
+
+    tmList_destroy(subs);
+  }
+
+  if (n < 2)
+  {
+    log_warn("Mesh domain can not be split into subdomains.");
+
+    if (n == 1)
+      tmDomain_destroy(doms[0]);
+    n = 0;
+
+    tmMesh_ADFMeshing(mesh);
+    goto error;
+  }
+
+  if ( mesh->verbose == TRUE )
+    tmPrint("ADVANCING FRONT: %d SUBDOMAINS", n);
+
+  /*-------------------------------------------------------
+  | Mesh the subdomains in parallel -> the largest first
+  -------------------------------------------------------*/
+  qsort(doms, n, sizeof(tmDomain*), tmMesh_cmpDomainWork);
+
+  for (i = 0; i < n; i++)
+    check(tmDomain_createMesh(doms[i]) != NULL, 
+        "Failed to create mesh for subdomain %d.", i);
+
+  tmPool_parallelFor(mesh->pool, n, 1, 
+                     tmMesh_ADFMeshingDomains, doms);
+
+  /*-------------------------------------------------------
+  | Merge subdomain meshes
+  -------------------------------------------------------*/
+  for (i = 0; i < n; i++)
+  {
+    tmDomain_mergeTris(doms[i]);
+    mesh->n_size_saved += doms[i]->sub->n_size_saved;
+  }
+
+  for (i = 0; i < n; i++)
+    check( tmDomain_mergeEdges(doms[i]) == TRUE, 
+        "Failed to merge mesh of subdomain %d.", i);
+
+  tmPool_parallelFor(mesh->pool, n, 1, 
+                     tmMesh_destroyDomains, doms);
+
+  tmMesh_sinkFlush(mesh);
+
+  /*-------------------------------------------------------
+  | Compare mesh area to triangle areas
+  -------------------------------------------------------*/
+  tmMesh_calcArea(mesh);
+  check(mesh->areaBdry > 0.0, 
+      "Invalid mesh boundary. Domain area <= zero.");
+
+  tmDouble err_area = fabs(mesh->areaTris - mesh->areaBdry) / mesh->areaBdry;
+  check( err_area < 1e-5,
+      "Mesh area %.5f does not equal to sum of triangle area %.5f", mesh->areaBdry, mesh->areaTris);
+
+  /*-------------------------------------------------------
+  | Set triangle-triangle connectivity
+  -------------------------------------------------------*/
+  tmMesh_setTriNeighbors(mesh);
+
+error:
+  for (i = 0; i < n; i++)
+    tmDomain_destroy(doms[i]);
+
+  free(doms);
+  free(can_split);
+  return;
+
+} /* tmMesh_ADFMeshingParallel() */
+
+/**********************************************************
+* Function: tmMesh_symmetryTrafo()
+*----------------------------------------------------------
+* Returns the isometry xy -> trafo * (xy, 1) of a mirror
+* symmetry about the line through xy with the given 
+* angle or of a rotation about xy by the given angle
+**********************************************************/
+static void tmMesh_symmetryTrafo(int            type,
+                                 const tmDouble xy[2],
+                                 tmDouble       angle,
+                                 tmDouble       trafo[2][3])
+{
+  tmDouble c = cos(angle);
+  tmDouble s = sin(angle);
+
+  if (type == TM_SYMMETRY_MIRROR)
+  {
+    c = cos(2.0 * angle);
+    s = sin(2.0 * angle);
+
+    trafo[0][0] = c;   trafo[0][1] = s;
+    trafo[1][0] = s;   trafo[1][1] = -c;
+  }
+  else
+  {
+    trafo[0][0] = c;   trafo[0][1] = -s;
+    trafo[1][0] = s;   trafo[1][1] = c;
+  }
+
+  trafo[0][2] = xy[0] - trafo[0][0]*xy[0] - trafo[0][1]*xy[1];
+  trafo[1][2] = xy[1] - trafo[1][0]*xy[0] - trafo[1][1]*xy[1];
+
+} /* tmMesh_symmetryTrafo() */
+
+/**********************************************************
+* Function: tmMesh_ADFMeshingSymmetric()
+*----------------------------------------------------------
+* Meshes a symmetric domain by meshing only its 
+* fundamental sector with the advancing front method
+* and copying the sector mesh onto the other sectors.
+* TM_SYMMETRY_MIRROR: the domain is symmetric to the 
+*   line through xy with the given angle and the sector
+*   is located to the left of the line.
+* TM_SYMMETRY_ROTATION: the domain is invariant under 
+*   rotations by 2*pi/n about xy and the sector starts
+*   at the given angle.
+* The nodes on the sector sides are distributed, such
+* that they are mapped onto each other by the symmetry.
+* Hence, the sector meshes share their nodes on the 
+* sides and the whole mesh is exactly symmetric.
+* Sector components are meshed in parallel. 
+* Falls back to tmMesh_ADFMeshing(), if the boundaries 
+* are not symmetric or the sector can not be created.
+*----------------------------------------------------------
+* @param *mesh: pointer to mesh
+* @param type: TM_SYMMETRY_MIRROR or TM_SYMMETRY_ROTATION
+* @param xy: location on the symmetry line / center of 
+*            the rotation
+* @param angle: angle of the symmetry line / start angle
+*               of the sector in radians
+* @param n: number of sectors of rotational symmetries
+**********************************************************/
+void tmMesh_ADFMeshingSymmetric(tmMesh   *mesh, 
+                                int       type,
+                                tmDouble  xy[2],
+                                tmDouble  angle,
+                                int       n)
+{
+  tmListNode *cur;
+  tmDomain   *dom   = NULL;
+  tmDomain  **doms  = NULL;
+  tmList     *subs  = NULL;
+  tmDouble  (*ref)[3] = NULL;
+  int         n_sec = 0;
+  int         n_dom = 0;
+  int         n_ref = 0;
+  int         i, k;
+
+  tmDouble phi   = (type == TM_SYMMETRY_ROTATION) 
+                 ? 2.0 * PI_D / (tmDouble) MAX(n, 1) : 0.0;
+  int      n_cpy = (type == TM_SYMMETRY_ROTATION) ? n : 2;
+  tmDouble trafo[2][3];
+
+  if (type == TM_SYMMETRY_ROTATION && n < 2)
+  {
+    tmMesh_ADFMeshing(mesh);
+    return;
+  }
+
+  /*-------------------------------------------------------
+  | The size function is required to distribute the 
+  | nodes on the sector sides
+  -------------------------------------------------------*/
+  for (cur = mesh->bdry_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmBdry_initSizeFun( (tmBdry*) cur->value );
+  }
+
+  tmMesh_resetSizes(mesh);
+
+  dom = tmDomain_create(mesh, TM_DOMAIN_SAMPLES);
+
+  tmMesh_symmetryTrafo(type, xy, 
+                       (type == TM_SYMMETRY_MIRROR) ? angle : phi, 
+                       trafo);
+
+  if ( dom == NULL || tmDomain_isInvariant(dom, trafo) == FALSE )
+  {
+    log_warn("Mesh boundaries are not symmetric.");
+    tmMesh_ADFMeshing(mesh);
+    goto error;
+  }
+
+  /*-------------------------------------------------------
+  | Clip the domain to the fundamental sector -> the 
+  | first side of rotational sectors is symmetric to 
+  | the center, if there are only two sectors
+  -------------------------------------------------------*/
+  tmDouble n1[2] = { -sin(angle), cos(angle) };
+  tmDouble c1    = n1[0] * xy[0] + n1[1] * xy[1];
+
+  if (type == TM_SYMMETRY_MIRROR)
+    subs = tmDomain_clip(dom, n1, c1, FALSE, NULL, FALSE, NULL, 0);
+  else
+    subs = tmDomain_clip(dom, n1, c1, TRUE, xy, (n == 2), NULL, 0);
+
+  /*-------------------------------------------------------
+  | The nodes on the second side of rotational sectors
+  | are the rotated nodes of the first side
+  -------------------------------------------------------*/
+  if (subs != NULL && type == TM_SYMMETRY_ROTATION && n > 2)
+  {
+    tmList  *clipped = tmList_create();
+    tmDouble e[2]    = { cos(angle), sin(angle) };
+    tmDouble n2[2]   = { sin(angle + phi), -cos(angle + phi) };
+    tmDouble c2      = n2[0] * xy[0] + n2[1] * xy[1];
+    int      max     = 0;
+
+    for (cur = subs->first; cur != NULL; cur = cur->next)
+    {
+      tmDomain *d = (tmDomain*) cur->value;
+
+      for (i = 0; i < d->n_loops; i++)
+      {
+        int n_verts = d->loops[i].n_verts;
+
+        for (k = 0; k < n_verts; k++)
+        {
+          tmDomainVert *v   = &d->loops[i].verts[k];
+          tmDomainVert *u   = &d->loops[i].verts[(k+n_verts-1)%n_verts];
+          tmDouble      tol = TM_DOMAIN_SNAP_FAC * v->rho;
+          tmDouble      dx  = v->node->xy[0] - xy[0];
+          tmDouble      dy  = v->node->xy[1] - xy[1];
+
+          if ( v->marker != TM_DOMAIN_MARKER || 
+               u->marker != TM_DOMAIN_MARKER ||
+               e[0]*dx + e[1]*dy <= tol )
+            continue;
+
+          if (n_ref >= max)
+          {
+            max = MAX(2 * max, 16);
+            ref = realloc(ref, max * sizeof(*ref));
+            check_mem(ref);
+          }
+
+          ref[n_ref][0] = xy[0] + trafo[0][0]*dx + trafo[0][1]*dy;
+          ref[n_ref][1] = xy[1] + trafo[1][0]*dx + trafo[1][1]*dy;
+          ref[n_ref][2] = v->rho;
+          n_ref += 1;
+        }
+      }
+    }
+
+    while (subs->count > 0)
+    {
+      tmDomain *d = (tmDomain*) tmList_pop(subs);
+      tmList   *s = tmDomain_clip(d, n2, c2, TRUE, NULL, FALSE, 
+                                  (const tmDouble (*)[3]) ref, n_ref);
+      tmDomain_destroy(d);
+
+      if (s == NULL)
+      {
+        while (clipped->count > 0)
+          tmDomain_destroy( (tmDomain*) tmList_pop(clipped) );
+        tmList_destroy(clipped);
+        tmList_destroy(subs);
+        subs    = NULL;
+        clipped = NULL;
+        break;
+      }
+
+      while (s->count > 0)
+        tmList_push(clipped, tmList_pop(s));
+      tmList_destroy(s);
+    }
+
+    if (clipped != NULL)
+    {
+      tmList_destroy(subs);
+      subs = clipped;
+    }
+  }
+
+  if (subs == NULL || subs->count < 1)
+  {
+    log_warn("Symmetry sector of the mesh domain can not be created.");
+    tmMesh_ADFMeshing(mesh);
+    goto error;
+  }
+
+  n_sec = subs->count;
+
+  doms = (tmDomain**) calloc(n_sec * n_cpy, sizeof(tmDomain*));
+  check_mem(doms);
+
+  while (subs->count > 0)
+    doms[n_dom++] = (tmDomain*) tmList_pop(subs);
+
+  if ( mesh->verbose == TRUE )
+    tmPrint("ADVANCING FRONT: %d SYMMETRIC SECTORS", n_cpy);
+
+  /*-------------------------------------------------------
+  | Mesh the components of the sector in parallel
+  -------------------------------------------------------*/
+  qsort(doms, n_sec, sizeof(tmDomain*), tmMesh_cmpDomainWork);
+
+  for (i = 0; i < n_sec; i++)
+    check(tmDomain_createMesh(doms[i]) != NULL, 
+        "Failed to create mesh for sector domain %d.", i);
+
+  tmPool_parallelFor(mesh->pool, n_sec, 1, 
+                     tmMesh_ADFMeshingDomains, doms);
+
+  for (i = 0; i < n_sec; i++)
+  {
+    tmDomain_mergeTris(doms[i]);
+    mesh->n_size_saved += doms[i]->sub->n_size_saved;
+  }
+
+  /*-------------------------------------------------------
+  | Copy the sector mesh onto the other sectors
+  -------------------------------------------------------*/
+  for (k = 1; k < n_cpy; k++)
+  {
+    if (type == TM_SYMMETRY_ROTATION)
+      tmMesh_symmetryTrafo(type, xy, k * phi, trafo);
+
+    for (i = 0; i < n_sec; i++)
+    {
+      doms[n_dom] = tmDomain_createImage(doms[i], trafo);
+      check(doms[n_dom] != NULL, "Failed to create sector image.");
+      tmDomain_mergeTris(doms[n_dom]);
+      n_dom += 1;
+    }
+  }
+
+  for (i = 0; i < n_dom; i++)
+    check( tmDomain_mergeEdges(doms[i]) == TRUE, 
+        "Failed to merge mesh of sector domain %d.", i);
+
+  tmPool_parallelFor(mesh->pool, n_sec, 1, 
+                     tmMesh_destroyDomains, doms);
+
+  tmMesh_sinkFlush(mesh);
+
+  /*-------------------------------------------------------
+  | Compare mesh area to triangle areas
+  -------------------------------------------------------*/
+  tmMesh_calcArea(mesh);
+  check(mesh->areaBdry > 0.0, 
+      "Invalid mesh boundary. Domain area <= zero.");
+
+  tmDouble err_area = fabs(mesh->areaTris - mesh->areaBdry) / mesh->areaBdry;
+  check( err_area < 1e-5,
+      "Mesh area %.5f does not equal to sum of triangle area %.5f", mesh->areaBdry, mesh->areaTris);
+
+  /*-------------------------------------------------------
+  | Set triangle-triangle connectivity
+  -------------------------------------------------------*/
+  tmMesh_setTriNeighbors(mesh);
+
+error:
+  if (subs != NULL)
+  {
+    while (subs->count > 0)
+      tmDomain_destroy( (tmDomain*) tmList_pop(subs) );
+    tmList_destroy(subs);
+  }
+
+  for (i = 0; i < n_dom; i++)
+    if (doms[i] != NULL)
+      tmDomain_destroy(doms[i]);
+
+  if (dom != NULL)
+    tmDomain_destroy(dom);
+
+  free(doms);
+  free(ref);
+  return;
+
+} /* tmMesh_ADFMeshingSymmetric() */
+
+/**********************************************************
+* Function: tmMesh_ADFMeshingPeriodic()
+*----------------------------------------------------------
+* Meshes a domain, which consists of n_x * n_y copies of
+* a periodic cell. The cell is defined by the boundaries
+* of the mesh, where the exterior boundary must be an 
+* axis-aligned rectangle of width w and height h.
+* Only the cell is meshed with the advancing front 
+* method, where opposite cell sides get the same nodes.
+* The cell mesh is then copied onto the lattice 
+* (i*w, j*h) with 0 <= i < n_x and 0 <= j < n_y, such 
+* that neighboring copies share their nodes on common 
+* sides. Finally, the mesh boundaries are replaced by
+* the boundaries of the lattice. 
+* The mesh bounding box must contain the whole lattice.
+* The size function of the cell is the minimum of the
+* size function over the cell and its eight neighbors,
+* where it is only evaluated within the lattice and 
+* grows with TM_SIZEFUN_SLOPE outside of it.
+* Falls back to tmMesh_ADFMeshing(), if the cell is not
+* a rectangle.
+*----------------------------------------------------------
+* @param *mesh: pointer to mesh
+* @param n_x, n_y: number of cells in x- / y-direction
+**********************************************************/
+void tmMesh_ADFMeshingPeriodic(tmMesh *mesh, int n_x, int n_y)
+{
+  tmListNode *cur;
+  tmDomain   *dom   = NULL;
+  tmDomain  **imgs  = NULL;
+  tmBdry     *ext;
+  int         n_img = 0;
+  int         index;
+  int         i, j;
+
+  tmDouble trafo[2][3] = { { 1.0, 0.0, 0.0 }, 
+                           { 0.0, 1.0, 0.0 } };
+
+  check( n_x > 0 && n_y > 0, "Invalid number of periodic cells.");
+
+  /*-------------------------------------------------------
+  | The size function is required to distribute the 
+  | nodes on the cell sides
+  -------------------------------------------------------*/
+  for (cur = mesh->bdry_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmBdry_initSizeFun( (tmBdry*) cur->value );
+  }
+
+  tmMesh_resetSizes(mesh);
+
+  dom = tmDomain_create(mesh, TM_DOMAIN_SAMPLES);
+
+  if (dom == NULL)
+  {
+    log_warn("Mesh domain is not a rectangular periodic cell.");
+    tmMesh_ADFMeshing(mesh);
+    goto error;
+  }
+
+  tmDouble w = dom->xy_max[0] - dom->xy_min[0];
+  tmDouble h = dom->xy_max[1] - dom->xy_min[1];
+
+  check( dom->xy_min[0] >= mesh->xy_min[0] &&
+         dom->xy_min[1] >= mesh->xy_min[1] &&
+         dom->xy_min[0] + (tmDouble) n_x * w <= mesh->xy_max[0] &&
+         dom->xy_min[1] + (tmDouble) n_y * h <= mesh->xy_max[1],
+      "Mesh bounding box does not contain the lattice of "
+      "periodic cells.");
+
+  /*-------------------------------------------------------
+  | The cell is meshed with the minimum of the size 
+  | function over the cell and its neighbors, such that
+  | the element sizes match across the cell sides
+  -------------------------------------------------------*/
+  mesh->period[0]     = w;
+  mesh->period[1]     = h;
+  mesh->n_period[0]   = n_x;
+  mesh->n_period[1]   = n_y;
+  mesh->period_min[0] = dom->xy_min[0];
+  mesh->period_min[1] = dom->xy_min[1];
+  tmMesh_resetSizes(mesh);
+
+  if ( tmDomain_matchSides(dom) == FALSE )
+  {
+    log_warn("Mesh domain is not a rectangular periodic cell.");
+    tmMesh_ADFMeshing(mesh);
+    goto error;
+  }
+
+  if ( mesh->verbose == TRUE )
+    tmPrint("ADVANCING FRONT: %d x %d PERIODIC CELLS", n_x, n_y);
+
+  /*-------------------------------------------------------
+  | Mesh the cell
+  -------------------------------------------------------*/
+  check(tmDomain_createMesh(dom) != NULL, 
+      "Failed to create mesh for periodic cell.");
+
+  tmMesh_ADFMeshing(dom->sub);
+
+  mesh->period[0]   = 0.0;
+  mesh->period[1]   = 0.0;
+  mesh->n_period[0] = 0;
+  mesh->n_period[1] = 0;
+
+  check( dom->sub->front->no_edges == 0,
+      "Failed to mesh periodic cell.");
+
+  tmDomain_mergeTris(dom);
+  mesh->n_size_saved += dom->sub->n_size_saved;
+
+  /*-------------------------------------------------------
+  | Copy the cell mesh onto the other cells
+  -------------------------------------------------------*/
+  imgs = (tmDomain**) calloc(n_x * n_y, sizeof(tmDomain*));
+  check_mem(imgs);
+
+  for (j = 0; j < n_y; j++)
+  {
+    for (i = 0; i < n_x; i++)
+    {
+      if (i == 0 && j == 0)
+        continue;
+
+      trafo[0][2] = (tmDouble) i * w;
+      trafo[1][2] = (tmDouble) j * h;
+
+      imgs[n_img] = tmDomain_createImage(dom, trafo);
+      check(imgs[n_img] != NULL, "Failed to create cell image.");
+      tmDomain_mergeTris(imgs[n_img]);
+      n_img += 1;
+    }
+  }
+
+  check( tmDomain_mergeEdges(dom) == TRUE, 
+      "Failed to merge mesh of periodic cell.");
+
+  for (i = 0; i < n_img; i++)
+    check( tmDomain_mergeEdges(imgs[i]) == TRUE, 
+        "Failed to merge mesh of periodic cell %d.", i+1);
+
+  /*-------------------------------------------------------
+  | Replace the cell boundaries by the lattice boundaries
+  -------------------------------------------------------*/
+  index = dom->loops[0].index;
+
+  while (mesh->bdry_stack->first != NULL)
+    tmBdry_destroy( (tmBdry*) mesh->bdry_stack->first->value );
+
+  ext = tmMesh_addBdry(mesh, FALSE, index);
+
+  tmDomain_mergeBdrys(dom, ext);
+
+  for (i = 0; i < n_img; i++)
+    tmDomain_mergeBdrys(imgs[i], ext);
+
+  for (cur = mesh->bdry_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmBdry_initSizeFun( (tmBdry*) cur->value );
+  }
+
+  tmMesh_resetSizes(mesh);
+  tmMesh_sinkFlush(mesh);
+
+  /*-------------------------------------------------------
+  | Compare mesh area to triangle areas
+  -------------------------------------------------------*/
+  tmMesh_calcArea(mesh);
+  check(mesh->areaBdry > 0.0, 
+      "Invalid mesh boundary. Domain area <= zero.");
+
+  tmDouble err_area = fabs(mesh->areaTris - mesh->areaBdry) / mesh->areaBdry;
+  check( err_area < 1e-5,
+      "Mesh area %.5f does not equal to sum of triangle area %.5f", mesh->areaBdry, mesh->areaTris);
+
+  /*-------------------------------------------------------
+  | Set triangle-triangle connectivity
+  -------------------------------------------------------*/
+  tmMesh_setTriNeighbors(mesh);
+
+error:
+  mesh->period[0]   = 0.0;
+  mesh->period[1]   = 0.0;
+  mesh->n_period[0] = 0;
+  mesh->n_period[1] = 0;
+
+  for (i = 0; i < n_img; i++)
+    tmDomain_destroy(imgs[i]);
+
+  if (dom != NULL)
+    tmDomain_destroy(dom);
+
+  free(imgs);
+  return;
+
+} /* tmMesh_ADFMeshingPeriodic() */
+
+
+
+/**********************************************************
+* Function: tmMesh_getOppositeNode()
+*----------------------------------------------------------
+* Returns the node of a triangle, which is located 
+* opposite to one of its edges
+*----------------------------------------------------------
+* @param tri: triangle 
+* @param edge: edge of the triangle
+**********************************************************/
+static inline tmNode *tmMesh_getOppositeNode(tmTri  *tri, 
+                                             tmEdge *edge)
+{
+  if ( tri->e1 == edge )
+    return tri->n1;
+  if ( tri->e2 == edge )
+    return tri->n2;
+  return tri->n3;
+
+} /* tmMesh_getOppositeNode() */
+
+/**********************************************************
+* Data for the parallel edge swaps of an independent set
+**********************************************************/
+typedef struct tmFlipSet {
+  tmEdge   **edges;  /* Edges to swap                     */
+  tmDouble  *area;   /* Area of adjacent tris before swap */
+} tmFlipSet;
+
+/**********************************************************
+* Function: tmMesh_swapEdges()
+*----------------------------------------------------------
+* Loop body for the parallel swap of an independent set
+* of non-delaunay edges.
+* Edges, which can not be swapped, are removed from 
+* the set.
+*----------------------------------------------------------
+* @param data: tmFlipSet structure
+* @param i_beg, i_end: range of edges to swap
+* @param thread_id: id of the calling thread
+**********************************************************/
+static void tmMesh_swapEdges(void *data, 
+                             size_t i_beg, size_t i_end,
+                             int thread_id)
+{
+  tmFlipSet *set = (tmFlipSet*) data;
+  size_t     i;
+
+  (void) thread_id;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmEdge *edge = set->edges[i];
+
+    set->area[i] = edge->t1->area + edge->t2->area;
+
+    if ( tmEdge_swapEdge(edge) == NULL )
+      set->edges[i] = NULL;
+  }
+
+} /* tmMesh_swapEdges() */
+
+/**********************************************************
+* Function: tmMesh_delaunayFlipParallel()
+*----------------------------------------------------------
+* Parallel version of the flip algorithm.
+* The non-delaunay edges are processed in rounds:
+* 1) All edges are taken from the delaunay stack and are 
+*    greedily split into an independent set and into 
+*    deferred edges. Edges of the independent set have
+*    quadrilaterals that do not share any node, hence 
+*    they share no triangle and no adjacent triangle.
+* 2) The edges of the independent set are swapped 
+*    concurrently on the mesh's thread pool.
+* 3) The flips are completed serially in the order of 
+*    the set (qtree updates, delaunay checks), which 
+*    puts new non-delaunay edges on the stack for the 
+*    next round. 
+* Since the independent sets are chosen serially, the 
+* result does not depend on the number of threads.
+*----------------------------------------------------------
+* @param mesh: the mesh structure
+* @param flip_max: maximum number of edge flips
+* @return: number of edge flips
+**********************************************************/
+static size_t tmMesh_delaunayFlipParallel(tmMesh *mesh, 
+                                          size_t  flip_max)
+{
+  size_t    n_flip  = 0;
+  size_t    n_edges = (size_t) mesh->edges_stack->count;
+  size_t    n_cand, n_sel, n_def, i, j;
+  tmEdge   *edge;
+  tmNode   *quad[4];
+  tmFlipSet set = { NULL, NULL };
+
+  tmEdge **cand = (tmEdge**) calloc(n_edges, sizeof(tmEdge*));
+  check_mem(cand);
+
+  set.edges = (tmEdge**) calloc(n_edges, sizeof(tmEdge*));
+  set.area  = (tmDouble*) calloc(n_edges, sizeof(tmDouble));
+  check_mem(set.edges);
+  check_mem(set.area);
+
+  while ( mesh->delaunay_stack->count > 0 && n_flip < flip_max )
+  {
+    /*-----------------------------------------------------
+    | Take all non-delaunay edges from the stack and 
+    | reset the node marks of their quadrilaterals
+    -----------------------------------------------------*/
+    n_cand = 0;
+
+    while ( mesh->delaunay_stack->count > 0 )
+    {
+      edge = (tmEdge*)tmList_pop(mesh->delaunay_stack);
+
+      if ( edge->is_local_delaunay == TRUE )
+        continue;
+
+      edge->n1->indBuf = 0;
+      edge->n2->indBuf = 0;
+      tmMesh_getOppositeNode(edge->t1, edge)->indBuf = 0;
+      tmMesh_getOppositeNode(edge->t2, edge)->indBuf = 0;
+
+      cand[n_cand++] = edge;
+    }
+
+    /*-----------------------------------------------------
+    | Split into independent set and deferred edges
+    -----------------------------------------------------*/
+    n_sel = 0;
+    n_def = 0;
+
+    for (i = 0; i < n_cand; i++)
+    {
+      edge    = cand[i];
+      quad[0] = edge->n1;
+      quad[1] = edge->n2;
+      quad[2] = tmMesh_getOppositeNode(edge->t1, edge);
+      quad[3] = tmMesh_getOppositeNode(edge->t2, edge);
+
+      if (  quad[0]->indBuf == 1 || quad[1]->indBuf == 1 
+         || quad[2]->indBuf == 1 || quad[3]->indBuf == 1 
+         || n_flip + n_sel >= flip_max )
+      {
+        cand[n_def++] = edge;
+        continue;
+      }
+
+      for (j = 0; j < 4; j++)
+        quad[j]->indBuf = 1;
+
+      set.edges[n_sel++] = edge;
+    }
+
+    /*-----------------------------------------------------
+    | Deferred edges remain non-delaunay and go back 
+    | on the stack in their original order
+    -----------------------------------------------------*/
+    for (j = n_def; j > 0; j--)
+      tmList_push(mesh->delaunay_stack, cand[j-1]);
+
+    /*-----------------------------------------------------
+    | Swap independent set in parallel 
+    -----------------------------------------------------*/
+    tmPool_parallelFor(mesh->pool, n_sel, TM_POOL_CHUNK_SIZE,
+                       tmMesh_swapEdges, &set);
+
+    /*-----------------------------------------------------
+    | Complete flips serially
+    | -> All moved objects are detached from the qtrees
+    |    before any of them is inserted again
+    -----------------------------------------------------*/
+    for (i = 0; i < n_sel; i++)
+    {
+      if ( set.edges[i] == NULL )
+        continue;
+
+      tmQtree_detachObj(mesh->tris_qtree,  set.edges[i]->t1);
+      tmQtree_detachObj(mesh->tris_qtree,  set.edges[i]->t2);
+      tmQtree_detachObj(mesh->edges_qtree, set.edges[i]);
+    }
+
+    for (i = 0; i < n_sel; i++)
+    {
+      if ( set.edges[i] == NULL )
+        continue;
+
+      tmEdge_finishFlip(set.edges[i], set.area[i]);
+      n_flip += 1;
+    }
+
+    if ( n_sel == 0 )
+      break;
+  }
+
+  free(cand);
+  free(set.edges);
+  free(set.area);
+
+  return n_flip;
+
+error:
+  free(cand);
+  free(set.edges);
+  free(set.area);
+
+  return n_flip;
+
+} /* tmMesh_delaunayFlipParallel() */
+
+/**********************************************************
+* Function: tmMesh_delaunayFlip()
+*----------------------------------------------------------
+* Function to perform the flip algorithm on a triangulated
+* mesh, in order to obtain a triangulation that is delaunay
+* For mesh->n_threads > 1, independent sets of edges are
+* flipped in parallel.
+*----------------------------------------------------------
+* 
+**********************************************************/
+void tmMesh_delaunayFlip(tmMesh *mesh)
+{
+  /*-------------------------------------------------------
+  | Create list of edges that are not locally delaunay
+  -------------------------------------------------------*/
+  size_t      n_flip = 0;
+  tmListNode *cur;
+  tmEdge     *edge;
+
+  /*-------------------------------------------------------
+  | Every edge is located at most once on the stack, 
+  | hence the number of flips is bounded linearly by the 
+  | number of edges to avoid endless loops due to 
+  | round-off errors
+  -------------------------------------------------------*/
+  size_t n_edges  = (size_t) mesh->edges_stack->count;
+  size_t flip_max = TM_DELAUNAY_FLIP_FAC * n_edges;
+
+#if (TM_DEBUG > 1)
   tmPrint("-----------------------------------");
   tmPrint("NUMBER OF NON-DELAUNAY EDGES: %d",
       mesh->delaunay_stack->count);
   for (cur = mesh->delaunay_stack->first; 
        cur != NULL; cur = cur->next)
   {
-    tmIndex i1 = ((tmEdge*)cur->value)->n1->index;
-    tmIndex i2 = ((tmEdge*)cur->value)->n2->index;
-    tmPrint("  EDGE (%d,%d)", i1, i2);
+    tmIndex i1 = ((tmEdge*)cur->value)->n1->index;
+    tmIndex i2 = ((tmEdge*)cur->value)->n2->index;
+    tmPrint("  EDGE (%d,%d)", i1, i2);
+  }
+#endif
+
+  /*-------------------------------------------------------
+  | Flip non-delaunay edges 
+  -------------------------------------------------------*/
+  if ( mesh->n_threads > 1 )
+    n_flip = tmMesh_delaunayFlipParallel(mesh, flip_max);
+
+  while ( mesh->delaunay_stack->count > 0 && n_flip < flip_max)
+  {
+    edge = (tmEdge*)tmList_pop(mesh->delaunay_stack);
+
+    /*-----------------------------------------------------
+    | Skip edges that became delaunay in the meantime 
+    -----------------------------------------------------*/
+    if ( edge->is_local_delaunay == TRUE )
+      continue;
+
+    n_flip   += 1;
+    tmEdge_flipEdge( edge );
+  }
+
+  /*-------------------------------------------------------
+  | Triangle-triangle connectivity is updated within 
+  | every edge flip 
+  -------------------------------------------------------*/
+
+#if (TM_DEBUG > 1)
+  tmPrint("NUMBER OF DELAUNAY EDGE FLIPS: %zu", n_flip);
+  tmPrint("-----------------------------------");
+#endif
+
+error:
+  return;
+
+} /* tmMesh_delaunayFlip() */
+
+/**********************************************************
+* Data of the mesh smoothing, stored in compact arrays 
+* (structure of arrays), indexed by node->indBuf
+**********************************************************/
+typedef struct tmSmoothData {
+
+  /*-------------------------------------------------------
+  | Nodes and coordinates of current / next sweep
+  -------------------------------------------------------*/
+  int        n_nodes;
+  tmNode   **nodes;
+  tmDouble  *x,     *y;
+  tmDouble  *x_new, *y_new;
+  tmDouble  *xy_buf; /* Memory of x, y, x_new, y_new */
+
+  /*-------------------------------------------------------
+  | Ccw ordered node rings of movable nodes (CSR format)
+  | -> Fixed nodes have empty rings
+  -------------------------------------------------------*/
+  int       *ring_ptr;
+  int       *ring;
+
+  /*-------------------------------------------------------
+  | Triangles and their validity after a sweep
+  -------------------------------------------------------*/
+  int        n_tris;
+  tmTri    **tris;
+  int       *tri_nodes;
+  tmBool    *tri_valid;
+
+  /*-------------------------------------------------------
+  | Mesh edges
+  -------------------------------------------------------*/
+  int        n_edges;
+  tmEdge   **edges;
+
+} tmSmoothData;
+
+/**********************************************************
+* Function: tmMesh_smoothNodes()
+*----------------------------------------------------------
+* Loop body for a Jacobi sweep of the mesh smoothing.
+* The new node location is a blend of the Laplacian 
+* smoothing (centroid of the node ring) and of the 
+* angle-based smoothing (Zhou & Shimada), where the 
+* node is rotated around each of its ring nodes, such 
+* that it bisects the angle at the ring node.
+*----------------------------------------------------------
+* @param data: tmSmoothData structure
+* @param i_beg, i_end: range of nodes to smooth
+* @param thread_id: id of the calling thread
+**********************************************************/
+static void tmMesh_smoothNodes(void *data, 
+                               size_t i_beg, size_t i_end,
+                               int thread_id)
+{
+  tmSmoothData *sd = (tmSmoothData*) data;
+  const tmDouble w = TM_SMOOTH_ANGLE_FAC;
+  size_t i;
+  int    j, j_beg, j_end, n_ring;
+
+  (void) thread_id;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    j_beg  = sd->ring_ptr[i];
+    j_end  = sd->ring_ptr[i+1];
+    n_ring = j_end - j_beg;
+
+    sd->x_new[i] = sd->x[i];
+    sd->y_new[i] = sd->y[i];
+
+    if ( n_ring < 3 )
+      continue;
+
+    tmDouble px = sd->x[i];
+    tmDouble py = sd->y[i];
+
+    tmDouble lap_x = 0.0, lap_y = 0.0;
+    tmDouble ang_x = 0.0, ang_y = 0.0;
+
+    for (j = 0; j < n_ring; j++)
+    {
+      int k_cur = sd->ring[j_beg + j];
+      int k_prv = sd->ring[j_beg + (j + n_ring - 1) % n_ring];
+      int k_nxt = sd->ring[j_beg + (j + 1) % n_ring];
+
+      tmDouble cx = sd->x[k_cur];
+      tmDouble cy = sd->y[k_cur];
+
+      lap_x += cx;
+      lap_y += cy;
+
+      /*---------------------------------------------------
+      | The angle at the ring node, which contains the 
+      | smoothed node, is spanned ccw from the next to 
+      | the previous ring node 
+      ---------------------------------------------------*/
+      tmDouble u1x = sd->x[k_prv] - cx;
+      tmDouble u1y = sd->y[k_prv] - cy;
+      tmDouble u2x = sd->x[k_nxt] - cx;
+      tmDouble u2y = sd->y[k_nxt] - cy;
+      tmDouble l2  = sqrt(u2x*u2x + u2y*u2y);
+
+      if ( l2 < TM_MIN_SIZE )
+      {
+        ang_x += px;
+        ang_y += py;
+        continue;
+      }
+
+      tmDouble phi = atan2(u2x*u1y - u2y*u1x, 
+                           u2x*u1x + u2y*u1y);
+      if ( phi < 0.0 )
+        phi += 2.0 * PI_D;
+
+      tmDouble cs = cos(0.5 * phi);
+      tmDouble sn = sin(0.5 * phi);
+      tmDouble r  = sqrt( (px-cx)*(px-cx) + (py-cy)*(py-cy) );
+
+      ang_x += cx + r * (cs * u2x - sn * u2y) / l2;
+      ang_y += cy + r * (sn * u2x + cs * u2y) / l2;
+    }
+
+    sd->x_new[i] = ( (1.0 - w) * lap_x + w * ang_x ) / n_ring;
+    sd->y_new[i] = ( (1.0 - w) * lap_y + w * ang_y ) / n_ring;
+  }
+
+} /* tmMesh_smoothNodes() */
+
+/**********************************************************
+* Function: tmMesh_smoothCheckTris()
+*----------------------------------------------------------
+* Loop body to check the triangles after a smoothing 
+* sweep: A triangle is invalid, if its area shrinks 
+* below a fraction of its area before the sweep
+*----------------------------------------------------------
+* @param data: tmSmoothData structure
+* @param i_beg, i_end: range of triangles to check
+* @param thread_id: id of the calling thread
+**********************************************************/
+static void tmMesh_smoothCheckTris(void *data, 
+                                   size_t i_beg, size_t i_end,
+                                   int thread_id)
+{
+  tmSmoothData *sd = (tmSmoothData*) data;
+  size_t i;
+
+  (void) thread_id;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    int a = sd->tri_nodes[3*i  ];
+    int b = sd->tri_nodes[3*i+1];
+    int c = sd->tri_nodes[3*i+2];
+
+    tmDouble area_old = 
+      (sd->x[b]-sd->x[a]) * (sd->y[c]-sd->y[a]) 
+    - (sd->x[c]-sd->x[a]) * (sd->y[b]-sd->y[a]);
+
+    tmDouble area_new = 
+      (sd->x_new[b]-sd->x_new[a]) * (sd->y_new[c]-sd->y_new[a]) 
+    - (sd->x_new[c]-sd->x_new[a]) * (sd->y_new[b]-sd->y_new[a]);
+
+    sd->tri_valid[i] = ( area_new >= TM_SMOOTH_AREA_FAC * area_old );
+  }
+
+} /* tmMesh_smoothCheckTris() */
+
+/**********************************************************
+* Function: tmMesh_smoothUpdateGeometry()
+*----------------------------------------------------------
+* Loop body to recompute the properties of all 
+* triangles and edges after the smoothing.
+* Loop indices [0, n_tris) refer to triangles, indices
+* [n_tris, n_tris+n_edges) refer to edges.
+*----------------------------------------------------------
+* @param data: tmSmoothData structure
+* @param i_beg, i_end: range of objects to update
+* @param thread_id: id of the calling thread
+**********************************************************/
+static void tmMesh_smoothUpdateGeometry(void *data, 
+                                        size_t i_beg, 
+                                        size_t i_end,
+                                        int thread_id)
+{
+  tmSmoothData *sd = (tmSmoothData*) data;
+  size_t i;
+
+  (void) thread_id;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    if ( i < (size_t) sd->n_tris )
+    {
+      tmTri_calcProperties(sd->tris[i]);
+    }
+    else
+    {
+      tmEdge *e = sd->edges[i - sd->n_tris];
+      tmEdge_setNodes(e, e->n1, e->n2);
+    }
+  }
+
+} /* tmMesh_smoothUpdateGeometry() */
+
+/**********************************************************
+* Function: tmMesh_smoothRing()
+*----------------------------------------------------------
+* Stores the ccw ordered ring of nodes around a node
+* in ring. The ring is extracted from the triangles of 
+* the node.
+*----------------------------------------------------------
+* @param node: node for which the ring is extracted
+* @param ring: array of size node->n_tris 
+* @return: TRUE if the ring is closed, FALSE otherwise
+*          (e.g. for nodes on the domain boundary)
+**********************************************************/
+static tmBool tmMesh_smoothRing(tmNode *node, int *ring)
+{
+  int n = node->n_tris;
+  int i, j, k;
+  tmListNode *cur;
+
+  if ( n < 3 )
+    return FALSE;
+
+  /*-------------------------------------------------------
+  | Every ccw triangle (node, a, b) leads to the ring 
+  | segment a -> b 
+  -------------------------------------------------------*/
+  tmNode **seg_a = (tmNode**) calloc(2*n, sizeof(tmNode*));
+  tmNode **seg_b = seg_a + n;
+  check_mem(seg_a);
+
+  for (cur = node->tris->first, i = 0; 
+       cur != NULL && i < n; cur = cur->next, i++)
+  {
+    tmTri *t = (tmTri*) cur->value;
+
+    if ( t->n1 == node )
+    {
+      seg_a[i] = t->n2;
+      seg_b[i] = t->n3;
+    }
+    else if ( t->n2 == node )
+    {
+      seg_a[i] = t->n3;
+      seg_b[i] = t->n1;
+    }
+    else
+    {
+      seg_a[i] = t->n1;
+      seg_b[i] = t->n2;
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Chain the segments 
+  -------------------------------------------------------*/
+  tmNode *start = seg_a[0];
+  tmNode *cur_n = start;
+
+  for (k = 0; k < n; k++)
+  {
+    ring[k] = cur_n->indBuf;
+
+    for (j = 0; j < n; j++)
+      if ( seg_a[j] == cur_n )
+        break;
+
+    if ( j == n )
+      break;
+
+    cur_n = seg_b[j];
+  }
+
+  free(seg_a);
+
+  return ( k == n && cur_n == start );
+
+error:
+  return FALSE;
+
+} /* tmMesh_smoothRing() */
+
+/**********************************************************
+* Function: tmMesh_smooth()
+*----------------------------------------------------------
+* Optimizes the mesh quality by smoothing the locations
+* of all interior nodes, i.e. all nodes, which are not 
+* located on a boundary and whose triangles close a 
+* ring around them. 
+* Every iteration is a Jacobi sweep, which computes all 
+* new node locations from the previous ones in parallel
+* (see tmMesh_smoothNodes()). Node moves that would 
+* invert or collapse triangles are rejected.
+* All coordinates are kept in compact arrays during the 
+* sweeps, the mesh structures and qtrees are only 
+* updated once at the end. Afterwards, edges which are 
+* no longer delaunay are put on the delaunay stack, 
+* such that tmMesh_delaunayFlip() can be applied.
+*----------------------------------------------------------
+* @param mesh: the mesh structure
+* @param n_iter: number of smoothing sweeps
+**********************************************************/
+void tmMesh_smooth(tmMesh *mesh, int n_iter)
+{
+  tmSmoothData sd;
+  tmListNode  *cur;
+  int          i, j, iter, n_reset, n_ring;
+  tmDouble    *swap;
+
+  memset(&sd, 0, sizeof(tmSmoothData));
+
+  if ( n_iter < 1 || mesh->no_tris < 1 )
+    return;
+
+  sd.n_nodes = mesh->nodes_stack->count;
+  sd.n_tris  = mesh->tris_stack->count;
+  sd.n_edges = mesh->edges_stack->count;
+
+  sd.nodes     = (tmNode**)  calloc(sd.n_nodes, sizeof(tmNode*));
+  sd.xy_buf    = (tmDouble*) calloc(4*sd.n_nodes, sizeof(tmDouble));
+  sd.ring_ptr  = (int*)      calloc(sd.n_nodes+1, sizeof(int));
+  sd.tris      = (tmTri**)   calloc(sd.n_tris, sizeof(tmTri*));
+  sd.tri_nodes = (int*)      calloc(3*sd.n_tris, sizeof(int));
+  sd.tri_valid = (tmBool*)   calloc(sd.n_tris, sizeof(tmBool));
+  sd.edges     = (tmEdge**)  calloc(sd.n_edges+1, sizeof(tmEdge*));
+  check_mem(sd.nodes);
+  check_mem(sd.xy_buf);
+  check_mem(sd.ring_ptr);
+  check_mem(sd.tris);
+  check_mem(sd.tri_nodes);
+  check_mem(sd.tri_valid);
+  check_mem(sd.edges);
+
+  sd.x     = sd.xy_buf;
+  sd.y     = sd.xy_buf +   sd.n_nodes;
+  sd.x_new = sd.xy_buf + 2*sd.n_nodes;
+  sd.y_new = sd.xy_buf + 3*sd.n_nodes;
+
+  /*-------------------------------------------------------
+  | Gather nodes and their coordinates
+  -------------------------------------------------------*/
+  for (cur = mesh->nodes_stack->first, i = 0; 
+       cur != NULL; cur = cur->next, i++)
+  {
+    tmNode *node = (tmNode*) cur->value;
+    node->indBuf = i;
+    sd.nodes[i]  = node;
+    sd.x[i]      = node->xy[0];
+    sd.y[i]      = node->xy[1];
   }
-#endif
 
   /*-------------------------------------------------------
-  | Flip non-delaunay edges 
+  | Gather node rings 
+  | -> Boundary nodes and nodes without closed rings are 
+  |    fixed and get an empty ring
   -------------------------------------------------------*/
-  while ( mesh->delaunay_stack->count > 0 && n_flip < flip_max)
+  for (i = 0; i < sd.n_nodes; i++)
   {
-    n_flip   += 1;
-    tmEdge_flipEdge( (tmEdge*)tmList_pop(mesh->delaunay_stack) );
+    tmNode *node = sd.nodes[i];
+    n_ring = ( node->on_bdry == TRUE ) ? 0 : node->n_tris;
+    sd.ring_ptr[i+1] = sd.ring_ptr[i] + n_ring;
+  }
+
+  sd.ring = (int*) calloc(sd.ring_ptr[sd.n_nodes]+1, sizeof(int));
+  check_mem(sd.ring);
+
+  for (i = 0; i < sd.n_nodes; i++)
+  {
+    if ( sd.ring_ptr[i+1] == sd.ring_ptr[i] )
+      continue;
+
+    /*-----------------------------------------------------
+    | Nodes without closed ring are marked by a ring 
+    | that references only the node itself
+    -----------------------------------------------------*/
+    if ( tmMesh_smoothRing(sd.nodes[i], 
+                           &sd.ring[sd.ring_ptr[i]]) == FALSE )
+    {
+      for (j = sd.ring_ptr[i]; j < sd.ring_ptr[i+1]; j++)
+        sd.ring[j] = i;
+    }
   }
 
   /*-------------------------------------------------------
-  | Set triangle-triangle connectivity
+  | Compact the rings, such that fixed nodes have empty 
+  | rings 
   -------------------------------------------------------*/
-  tmMesh_setTriNeighbors(mesh);
+  int n_tot = 0;
+  for (i = 0; i < sd.n_nodes; i++)
+  {
+    int j_beg = sd.ring_ptr[i];
+    int j_end = sd.ring_ptr[i+1];
 
-#if (TM_DEBUG > 1)
-  tmPrint("NUMBER OF DELAUNAY EDGE FLIPS: %d", n_flip);
-  tmPrint("-----------------------------------");
-#endif
+    sd.ring_ptr[i] = n_tot;
+
+    if ( j_end > j_beg && sd.ring[j_beg] != i )
+      for (j = j_beg; j < j_end; j++)
+        sd.ring[n_tot++] = sd.ring[j];
+  }
+  sd.ring_ptr[sd.n_nodes] = n_tot;
+
+  /*-------------------------------------------------------
+  | Gather triangles and edges
+  -------------------------------------------------------*/
+  for (cur = mesh->tris_stack->first, i = 0; 
+       cur != NULL; cur = cur->next, i++)
+  {
+    tmTri *tri = (tmTri*) cur->value;
+    sd.tris[i]           = tri;
+    sd.tri_nodes[3*i  ]  = tri->n1->indBuf;
+    sd.tri_nodes[3*i+1]  = tri->n2->indBuf;
+    sd.tri_nodes[3*i+2]  = tri->n3->indBuf;
+  }
+
+  for (cur = mesh->edges_stack->first, i = 0; 
+       cur != NULL; cur = cur->next, i++)
+    sd.edges[i] = (tmEdge*) cur->value;
+
+  /*-------------------------------------------------------
+  | Jacobi sweeps
+  -------------------------------------------------------*/
+  for (iter = 0; iter < n_iter; iter++)
+  {
+    tmPool_parallelFor(mesh->pool, sd.n_nodes, 
+                       TM_POOL_CHUNK_SIZE,
+                       tmMesh_smoothNodes, &sd);
+
+    /*-----------------------------------------------------
+    | Reset nodes of invalid triangles to their previous
+    | location, until all triangles are valid
+    -----------------------------------------------------*/
+    do
+    {
+      n_reset = 0;
+
+      tmPool_parallelFor(mesh->pool, sd.n_tris, 
+                         TM_POOL_CHUNK_SIZE,
+                         tmMesh_smoothCheckTris, &sd);
+
+      for (i = 0; i < sd.n_tris; i++)
+      {
+        if ( sd.tri_valid[i] == TRUE )
+          continue;
+
+        for (j = 0; j < 3; j++)
+        {
+          int k = sd.tri_nodes[3*i+j];
+          if ( sd.x_new[k] != sd.x[k] || sd.y_new[k] != sd.y[k] )
+          {
+            sd.x_new[k] = sd.x[k];
+            sd.y_new[k] = sd.y[k];
+            n_reset += 1;
+          }
+        }
+      }
+
+    } while ( n_reset > 0 );
+
+    swap = sd.x; sd.x = sd.x_new; sd.x_new = swap;
+    swap = sd.y; sd.y = sd.y_new; sd.y_new = swap;
+  }
+
+  /*-------------------------------------------------------
+  | Copy coordinates back to the nodes and update 
+  | all geometric properties 
+  -------------------------------------------------------*/
+  for (i = 0; i < sd.n_nodes; i++)
+  {
+    if ( sd.nodes[i]->xy[0] != sd.x[i] || sd.nodes[i]->xy[1] != sd.y[i] )
+      sd.nodes[i]->size = 0.0;
+
+    sd.nodes[i]->xy[0] = sd.x[i];
+    sd.nodes[i]->xy[1] = sd.y[i];
+  }
+
+  tmPool_parallelFor(mesh->pool, sd.n_tris + sd.n_edges, 
+                     TM_POOL_CHUNK_SIZE,
+                     tmMesh_smoothUpdateGeometry, &sd);
+
+  /*-------------------------------------------------------
+  | Lazy update of the qtrees and the mesh area
+  | -> All moved objects are detached from the qtrees
+  |    before any of them is inserted again
+  -------------------------------------------------------*/
+  for (i = 0; i < sd.n_nodes; i++)
+    tmQtree_detachObj(mesh->nodes_qtree, sd.nodes[i]);
+  for (i = 0; i < sd.n_tris; i++)
+    tmQtree_detachObj(mesh->tris_qtree, sd.tris[i]);
+  for (i = 0; i < sd.n_edges; i++)
+    tmQtree_detachObj(mesh->edges_qtree, sd.edges[i]);
+
+  for (i = 0; i < sd.n_nodes; i++)
+    tmQtree_updateObj(mesh->nodes_qtree, sd.nodes[i]);
+
+  mesh->areaTris = 0.0;
+  for (i = 0; i < sd.n_tris; i++)
+  {
+    tmQtree_updateObj(mesh->tris_qtree, sd.tris[i]);
+    mesh->areaTris += sd.tris[i]->area;
+  }
+
+  for (i = 0; i < sd.n_edges; i++)
+    tmQtree_updateObj(mesh->edges_qtree, sd.edges[i]);
+
+  /*-------------------------------------------------------
+  | Check the delaunay property of all edges
+  -------------------------------------------------------*/
+  for (i = 0; i < sd.n_edges; i++)
+    tmEdge_isDelaunay(sd.edges[i]);
 
 error:
-  return;
+  free(sd.nodes);
+  free(sd.xy_buf);
+  free(sd.ring_ptr);
+  free(sd.ring);
+  free(sd.tris);
+  free(sd.tri_nodes);
+  free(sd.tri_valid);
+  free(sd.edges);
 
-} /* tmMesh_delaunayFlip() */
+} /* tmMesh_smooth() */
 
 /**********************************************************
 * Function: tmMesh_setTriNeighbors()
@@ -933,9 +2715,16 @@ void tmMesh_setTriNeighbors(tmMesh *mesh)
   {
     tmTri *tri = (tmTri*)cur->value;
 
-    tri->t1 = tmTri_findTriNeighbor(tri->n2, tri->n3, tri);
-    tri->t2 = tmTri_findTriNeighbor(tri->n3, tri->n1, tri);
-    tri->t3 = tmTri_findTriNeighbor(tri->n1, tri->n2, tri);
+    tmTri *t1 = tmTri_findTriNeighbor(tri->n2, tri->n3, tri);
+    tmTri *t2 = tmTri_findTriNeighbor(tri->n3, tri->n1, tri);
+    tmTri *t3 = tmTri_findTriNeighbor(tri->n1, tri->n2, tri);
+
+    /*-----------------------------------------------------
+    | Triangles refer to themselves at boundary edges
+    -----------------------------------------------------*/
+    tri->t1 = (t1 != NULL) ? t1 : tri;
+    tri->t2 = (t2 != NULL) ? t2 : tri;
+    tri->t3 = (t3 != NULL) ? t3 : tri;
   }
 
 } /* tmMesh_setTriNeighbors() */
@@ -1026,6 +2815,10 @@ tmTri* tmMesh_getTriFromCoords(tmMesh *mesh, tmDouble xy[2])
 *----------------------------------------------------------
 * Add a new node at a specified location in the mesh
 * and subsequently re-triangulate the mesh in this area.
+* The triangle, which contains the node, is split into 
+* three triangles and the Delaunay property is restored 
+* with edge flips. Nodes on existing edges are not 
+* inserted.
 *----------------------------------------------------------
 * @param mesh: the mesh structure
 * @param xy:   coordinates of the new node to insert
@@ -1033,6 +2826,12 @@ tmTri* tmMesh_getTriFromCoords(tmMesh *mesh, tmDouble xy[2])
 **********************************************************/
 void tmMesh_refineLocally(tmMesh *mesh, tmDouble xy[2])
 {
+  tmNode *nodes[3];
+  tmEdge *edges[3];
+  tmTri  *tris[3];
+  tmNode *node;
+  int     i;
+
   /*-------------------------------------------------------
   | Find triangle from that point 
   -------------------------------------------------------*/
@@ -1041,285 +2840,362 @@ void tmMesh_refineLocally(tmMesh *mesh, tmDouble xy[2])
   if (tri == NULL)
     return;
 
-  tmNode *n1 = tri->n1;
-  tmNode *n2 = tri->n2;
-  tmNode *n3 = tri->n3;
+  nodes[0] = tri->n1;
+  nodes[1] = tri->n2;
+  nodes[2] = tri->n3;
 
-  tmEdge *e1 = tri->e1;
-  tmEdge *e2 = tri->e2;
-  tmEdge *e3 = tri->e3;
+  edges[0] = tri->e1;
+  edges[1] = tri->e2;
+  edges[2] = tri->e3;
 
-  tmTri  *t1 = NULL;
-  tmTri  *t2 = NULL;
-  tmTri  *t3 = NULL;
+  for (i = 0; i < 3; i++)
+  {
+    if ( edges[i] == NULL || 
+         ORIENTATION(nodes[(i+1)%3]->xy, nodes[(i+2)%3]->xy, xy) != 1 )
+      return;
+  }
 
+  /*-------------------------------------------------------
+  | Replace the triangle by three triangles 
+  | tris[i] = (n_i+1, n_i+2, node), which are adjacent 
+  | to the edges e_i of the old triangle
+  -------------------------------------------------------*/
   tmTri_destroy(tri);
 
-  tmList *edges = tmList_create();
-
-  /*-----------------------------------------------------
-  | Add edges from tri neighbor 1
-  -----------------------------------------------------*/
-  if (n3 == e1->n1)
-    t1 = e1->t1;
-  else if (n3 == e1->n2)
-    t1 = e1->t2;
-  else
-    log_err("Wrong edge-node connectivity.");
+  node = tmNode_create(mesh, xy);
 
-  if (t1 != NULL)
+  for (i = 0; i < 3; i++)
   {
-    if (e1 == t1->e1) 
-    {
-      if (t1->e2 != NULL)
-        tmList_push(edges, t1->e2);
-      if (t1->e3 != NULL)
-        tmList_push(edges, t1->e3);
-    }
-    else if (e1 == t1->e2)
-    {
-      if (t1->e1 != NULL)
-        tmList_push(edges, t1->e1);
-      if (t1->e3 != NULL)
-        tmList_push(edges, t1->e3);
-    }
-    else if (e1 == t1->e3)
-    {
-      if (t1->e1 != NULL)
-        tmList_push(edges, t1->e1);
-      if (t1->e2 != NULL)
-        tmList_push(edges, t1->e2);
-    }
-    else
-      log_err("Wrong triangle-edge connectivity");
+    tris[i] = tmTri_create(mesh, nodes[(i+1)%3], nodes[(i+2)%3], node);
+    tris[i]->e3 = edges[i];
 
-    /*---------------------------------------------------
-    | Remove triangle 
-    ---------------------------------------------------*/
-    tmTri_destroy(t1);
+    if ( edges[i]->t1 == tri )
+      edges[i]->t1 = tris[i];
+    else
+      edges[i]->t2 = tris[i];
   }
-  /*-----------------------------------------------------
-  | Add edge 1 if no tri neighbor 1 exists
-  -----------------------------------------------------*/
-  else
+
+  /*-------------------------------------------------------
+  | New edges (node, n_i) with tris[i+1] to their left
+  -------------------------------------------------------*/
+  for (i = 0; i < 3; i++)
+    tmMesh_edgeCreate(mesh, node, nodes[i], 
+                      tris[(i+2)%3], tris[(i+1)%3], -1);
+
+  for (i = 0; i < 3; i++)
   {
-    tmList_push(edges, e1);
+    tmEdge_setTriNbrs(tris[i]);
+    tmEdge_isDelaunay(edges[i]);
   }
 
-  /*-----------------------------------------------------
-  | Get edges from tri neighbor 2
-  -----------------------------------------------------*/
-  if (n1 == e2->n1)
-    t2 = e2->t1;
-  else if (n1 == e2->n2)
-    t2 = e2->t2;
-  else
-    log_err("Wrong edge-node connectivity.");
+  tmMesh_delaunayFlip(mesh);
 
-  if (t2 != NULL)
-  {
-    if (e2 == t2->e1) 
-    {
-      if (t2->e2 != NULL)
-        tmList_push(edges, t2->e2);
-      if (t2->e3 != NULL)
-        tmList_push(edges, t2->e3);
-    }
-    else if (e2 == t2->e2)
-    {
-      if (t2->e1 != NULL)
-        tmList_push(edges, t2->e1);
-      if (t2->e3 != NULL)
-        tmList_push(edges, t2->e3);
-    }
-    else if (e2 == t2->e3)
-    {
-      if (t2->e1 != NULL)
-        tmList_push(edges, t2->e1);
-      if (t2->e2 != NULL)
-        tmList_push(edges, t2->e2);
-    }
-    else
-      log_err("Wrong triangle-edge connectivity");
+} /* tmMesh_refineLocally() */
 
-    /*---------------------------------------------------
-    | Remove triangle 
-    ---------------------------------------------------*/
-    tmTri_destroy(t2);
-  }
-  /*-----------------------------------------------------
-  | Add edge 2 if no tri neighbor 2 exists
-  -----------------------------------------------------*/
-  else
-  {
-    tmList_push(edges, e2);
-  }
 
+/**********************************************************
+* Function: tmMesh_evalSizeFun()
+*----------------------------------------------------------
+* Evaluates the user-defined size function and the 
+* boundary term of the global size function
+*----------------------------------------------------------
+* @param mesh: the mesh structure
+* @param xy:   coordinates to evaluate the size function
+*
+**********************************************************/
+static tmDouble tmMesh_evalSizeFun(tmMesh *mesh, tmDouble xy[2])
+{
+  tmListNode *cur_b, *cur_e;
+  tmBdry *bdry;
+  tmEdge *edge;
+  tmDouble rho0;
 
-  /*-----------------------------------------------------
-  | Get edges from tri neighbor 3
-  -----------------------------------------------------*/
-  if (n2 == e3->n1)
-    t3 = e3->t1;
-  else if (n2 == e3->n2)
-    t3 = e3->t2;
+  if (mesh->sizeFunUserCtx != NULL)
+    rho0 = mesh->sizeFunUserCtx(mesh->sizeFunCtx, xy);
+  else if (mesh->sizeFunUser != NULL)
+    rho0 = mesh->sizeFunUser(xy);
   else
-    log_err("Wrong edge-node connectivity.");
+    rho0 = mesh->globSize;
 
-  if (t3 != NULL)
+  for (cur_b = mesh->bdry_stack->first; 
+       cur_b != NULL; cur_b = cur_b->next)
   {
-    if (e3 == t3->e1) 
-    {
-      if (t3->e2 != NULL)
-        tmList_push(edges, t3->e2);
-      if (t3->e3 != NULL)
-        tmList_push(edges, t3->e3);
-    }
-    else if (e3 == t3->e2)
-    {
-      if (t3->e1 != NULL)
-        tmList_push(edges, t3->e1);
-      if (t3->e3 != NULL)
-        tmList_push(edges, t3->e3);
-    }
-    else if (e3 == t3->e3)
+    bdry = (tmBdry*) cur_b->value;
+
+    for (cur_e = bdry->edges_stack->first; 
+         cur_e != NULL; cur_e = cur_e->next)
     {
-      if (t3->e1 != NULL)
-        tmList_push(edges, t3->e1);
-      if (t3->e2 != NULL)
-        tmList_push(edges, t3->e2);
-    }
-    else
-      log_err("Wrong triangle-edge connectivity");
+      edge = (tmEdge*) cur_e->value;
+      const tmDouble dx  = 0.5*(edge->n1->xy[0]-xy[0]);
+      const tmDouble dy  = 0.5*(edge->n1->xy[1]-xy[1]);
+      const tmDouble r2  = dx*dx + dy*dy;
+      const tmDouble rho = edge->n1->rho + edge->n1->k * r2;
 
-    /*---------------------------------------------------
-    | Remove triangle 
-    ---------------------------------------------------*/
-    tmTri_destroy(t3);
+      if ( rho < rho0) 
+        rho0 = rho;
+    }
 
   }
-  /*-----------------------------------------------------
-  | Add edge 3 if no tri neighbor 3 exists
-  -----------------------------------------------------*/
-  else
-  {
-    tmList_push(edges, e3);
-  }
 
-  /*-----------------------------------------------------
-  | Add new node at location xy and create new triangles
-  -----------------------------------------------------*/
-  tmTri  *new_tri;
-  tmTri  *first_tri, *cur_tri;
+  return rho0;
 
-  tmNode *new_node = tmNode_create(mesh, xy);
-  tmEdge *base     = tmList_pop(edges);
-  tmNode *first_node;
+} /* tmMesh_evalSizeFun() */
 
-  if (ORIENTATION(base->n1->xy, base->n2->xy, xy) == 1) 
-  {
-    new_tri = tmTri_create(mesh, base->n1, 
-                           base->n2, new_node);
-    first_node  = base->n2;
-    base->t1    = new_tri;
-    new_tri->e3 = base;
-  }
-  else
+/**********************************************************
+* Function: tmMesh_latticePoint()
+*----------------------------------------------------------
+* Shifts a point of a periodic cell by i x j cells. 
+* If the shifted point lies outside of the lattice of 
+* periodic cells, it is moved onto the lattice boundary.
+*----------------------------------------------------------
+* @param mesh: the mesh structure
+* @param xy:   point of the cell
+* @param i, j: cell shift in x- / y-direction
+* @param xy_p: returns the shifted point
+* @return: distance of the shifted point to the lattice
+**********************************************************/
+static tmDouble tmMesh_latticePoint(tmMesh   *mesh, 
+                                    tmDouble  xy[2], 
+                                    int i, int j,
+                                    tmDouble  xy_p[2])
+{
+  const int shift[2] = { i, j };
+  tmDouble  d2       = 0.0;
+  int c;
+
+  for (c = 0; c < 2; c++)
   {
-    new_tri = tmTri_create(mesh, base->n2, 
-                           base->n1, new_node);
-    first_node = base->n1;
-    base->t2   = new_tri;
-    new_tri->e3 = base;
+    tmDouble lo = mesh->period_min[c];
+    tmDouble hi = lo + (tmDouble) mesh->n_period[c] * mesh->period[c];
+    tmDouble x  = xy[c] + (tmDouble) shift[c] * mesh->period[c];
+
+    xy_p[c] = MIN( MAX(x, lo), hi );
+    d2     += (x - xy_p[c]) * (x - xy_p[c]);
   }
 
-  tmEdge_isDelaunay(base);
+  return sqrt(d2);
 
-  first_tri = new_tri;
-  cur_tri   = new_tri;
+} /* tmMesh_latticePoint() */
 
-  tmListNode *cur;
-  tmNode   *cur_node;
-  tmEdge   *new_edge;
+/**********************************************************
+* Function: tmMesh_sizeFun()
+*----------------------------------------------------------
+* Define a global size function for the mesh
+*----------------------------------------------------------
+* @param mesh: the mesh structure
+* @param xy:   coordinates to evaluate the size function
+*
+**********************************************************/
+tmDouble tmMesh_sizeFun(tmMesh *mesh, tmDouble xy[2])
+{
+  tmDouble rho;
+  int i, j;
 
-  while (edges->count > 0)
-  {
-    base  = tmList_pop(edges);
+  /*-------------------------------------------------------
+  | Subdomain meshes use the size function of their parent
+  -------------------------------------------------------*/
+  if (mesh->parent != NULL)
+    return mesh->parent->sizeFun(mesh->parent, xy);
 
-    if (ORIENTATION(base->n1->xy, base->n2->xy, xy) == 1) 
-    {
-      new_tri = tmTri_create(mesh, base->n1, 
-                             base->n2, new_node);
-      cur_node    = base->n2;
-      base->t1    = new_tri;
-      new_tri->e3 = base;
-    }
-    else
+  rho = tmMesh_evalSizeFun(mesh, xy);
+
+  /*-------------------------------------------------------
+  | Periodic cells use the minimum over the cell and its
+  | eight neighbors, such that the size function is 
+  | continuous across the cell sides. The size function
+  | is only evaluated within the lattice: Outside of it,
+  | it grows with TM_SIZEFUN_SLOPE from the lattice 
+  | boundary.
+  -------------------------------------------------------*/
+  if (mesh->period[0] <= 0.0)
+    return rho;
+
+  for (j = -1; j <= 1; j++)
+  {
+    for (i = -1; i <= 1; i++)
     {
-      new_tri = tmTri_create(mesh, base->n2, 
-                             base->n1, new_node);
-      cur_node    = base->n1;
-      base->t2    = new_tri;
-      new_tri->e3 = base;
-    }
+      tmDouble xy_p[2];
+      tmDouble d;
 
-    new_edge = tmMesh_edgeCreate(mesh,
-                                 new_node, cur_node,
-                                 new_tri, cur_tri, -1);
+      if (i == 0 && j == 0)
+        continue;
 
-    cur_tri = new_tri;
-    tmEdge_isDelaunay(base);
-    tmPrint("tmList count: %d", edges->count);
+      d   = tmMesh_latticePoint(mesh, xy, i, j, xy_p);
+      rho = MIN(rho, tmMesh_evalSizeFun(mesh, xy_p) 
+                     + TM_SIZEFUN_SLOPE * d);
+    }
   }
 
-  new_edge = tmMesh_edgeCreate(mesh,
-                               new_node, first_node,
-                               first_tri, cur_tri, -1);
-
-} /* tmMesh_insertMeshNode() */
+  return rho;
 
+} /* tmMesh_sizeFun() */
 
 /**********************************************************
-* Function: tmMesh_sizeFun()
+* Function: tmMesh_resetSizes()
 *----------------------------------------------------------
-* Define a global size function for the mesh
+* Invalidates the size function values, which are cached
+* on the nodes and edges of the mesh (see 
+* tmNode_getSize()). This is required, whenever the 
+* size function changes, e.g. after the boundary size
+* functions have been initialized.
 *----------------------------------------------------------
 * @param mesh: the mesh structure
-* @param xy:   coordinates to evaluate the size function
-*
 **********************************************************/
-tmDouble tmMesh_sizeFun(tmMesh *mesh, tmDouble xy[2])
+void tmMesh_resetSizes(tmMesh *mesh)
 {
-  tmListNode *cur_b, *cur_e;
-  tmBdry *bdry;
-  tmEdge *edge;
-  tmDouble rho0;
+  tmListNode *cur, *cur_b;
 
-  if (mesh->sizeFunUser == NULL)
-    rho0 = mesh->globSize;
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+    ((tmNode*) cur->value)->size = 0.0;
+
+  for (cur = mesh->edges_stack->first; cur != NULL; cur = cur->next)
+    ((tmEdge*) cur->value)->size = 0.0;
+
+  for (cur = mesh->front->edges_stack->first; 
+       cur != NULL; cur = cur->next)
+    ((tmEdge*) cur->value)->size = 0.0;
+
+  for (cur_b = mesh->bdry_stack->first; 
+       cur_b != NULL; cur_b = cur_b->next)
+  {
+    tmBdry *bdry = (tmBdry*) cur_b->value;
+
+    for (cur = bdry->edges_stack->first; 
+         cur != NULL; cur = cur->next)
+      ((tmEdge*) cur->value)->size = 0.0;
+  }
+
+} /* tmMesh_resetSizes() */
+
+/**********************************************************
+* Function: tmMesh_evalSizeFunBatch()
+*----------------------------------------------------------
+* Evaluates the user-defined size function and the 
+* boundary term of the global size function for n points
+* (see tmMesh_sizeFunBatch())
+**********************************************************/
+static void tmMesh_evalSizeFunBatch(tmMesh *mesh, int n, 
+                                    tmDouble (*xy)[2], 
+                                    tmDouble *out)
+{
+  tmListNode *cur_b, *cur_e;
+  int i;
+
+  if (mesh->sizeFunUserBatch != NULL)
+    mesh->sizeFunUserBatch(mesh->sizeFunCtx, n, xy, out);
+  else if (mesh->sizeFunUserCtx != NULL)
+    for (i = 0; i < n; i++)
+      out[i] = mesh->sizeFunUserCtx(mesh->sizeFunCtx, xy[i]);
+  else if (mesh->sizeFunUser != NULL)
+    for (i = 0; i < n; i++)
+      out[i] = mesh->sizeFunUser(xy[i]);
   else
-    rho0 = mesh->sizeFunUser(xy);
+    for (i = 0; i < n; i++)
+      out[i] = mesh->globSize;
 
+  /*-------------------------------------------------------
+  | The boundary term is computed for all points of an 
+  | edge in a branch-free loop, which is vectorized 
+  -------------------------------------------------------*/
   for (cur_b = mesh->bdry_stack->first; 
        cur_b != NULL; cur_b = cur_b->next)
   {
-    bdry = (tmBdry*) cur_b->value;
+    tmBdry *bdry = (tmBdry*) cur_b->value;
 
     for (cur_e = bdry->edges_stack->first; 
          cur_e != NULL; cur_e = cur_e->next)
     {
-      edge = (tmEdge*) cur_e->value;
-      const tmDouble dx  = 0.5*(edge->n1->xy[0]-xy[0]);
-      const tmDouble dy  = 0.5*(edge->n1->xy[1]-xy[1]);
-      const tmDouble r2  = dx*dx + dy*dy;
-      const tmDouble rho = edge->n1->rho + edge->n1->k * r2;
+      const tmNode  *n1 = ((tmEdge*) cur_e->value)->n1;
+      const tmDouble x1 = n1->xy[0];
+      const tmDouble y1 = n1->xy[1];
+      const tmDouble r1 = n1->rho;
+      const tmDouble k1 = n1->k;
 
-      if ( rho < rho0) 
-        rho0 = rho;
+      for (i = 0; i < n; i++)
+      {
+        const tmDouble dx  = 0.5*(x1-xy[i][0]);
+        const tmDouble dy  = 0.5*(y1-xy[i][1]);
+        const tmDouble rho = r1 + k1 * (dx*dx + dy*dy);
+
+        out[i] = (rho < out[i]) ? rho : out[i];
+      }
     }
+  }
 
+} /* tmMesh_evalSizeFunBatch() */
+
+/**********************************************************
+* Function: tmMesh_sizeFunBatch()
+*----------------------------------------------------------
+* Evaluates the global size function of the mesh for 
+* n points at once. The results equal the ones of 
+* tmMesh_sizeFun(). 
+* The user-defined size function is evaluated with the 
+* function of tmMesh_setSizeFunBatch(), if it is set, 
+* and the boundary term is computed for all points per 
+* boundary edge.
+*----------------------------------------------------------
+* @param mesh: the mesh structure
+* @param n:    number of points
+* @param xy:   coordinates to evaluate the size function
+* @param out:  returns the n size function values
+*
+**********************************************************/
+void tmMesh_sizeFunBatch(tmMesh *mesh, int n, 
+                         tmDouble (*xy)[2], tmDouble *out)
+{
+  tmDouble (*xy_p)[2] = NULL;
+  tmDouble  *rho      = NULL;
+  tmDouble  *dist     = NULL;
+  int i, j, k;
+
+  /*-------------------------------------------------------
+  | Subdomain meshes use the size function of their parent
+  -------------------------------------------------------*/
+  if (mesh->parent != NULL)
+  {
+    mesh->parent->sizeFunBatch(mesh->parent, n, xy, out);
+    return;
   }
 
-  return rho0;
+  tmMesh_evalSizeFunBatch(mesh, n, xy, out);
 
-} /* tmMesh_sizeFun() */
+  /*-------------------------------------------------------
+  | Periodic cells use the minimum over the cell and its
+  | eight neighbors within the lattice 
+  | (see tmMesh_sizeFun())
+  -------------------------------------------------------*/
+  if (mesh->period[0] <= 0.0)
+    return;
+
+  xy_p = (tmDouble (*)[2]) malloc(n * sizeof(*xy_p));
+  rho  = (tmDouble *)      malloc(n * sizeof(tmDouble));
+  dist = (tmDouble *)      malloc(n * sizeof(tmDouble));
+  check_mem(xy_p);
+  check_mem(rho);
+  check_mem(dist);
+
+  for (j = -1; j <= 1; j++)
+  {
+    for (i = -1; i <= 1; i++)
+    {
+      if (i == 0 && j == 0)
+        continue;
+
+      for (k = 0; k < n; k++)
+        dist[k] = tmMesh_latticePoint(mesh, xy[k], i, j, xy_p[k]);
+
+      tmMesh_evalSizeFunBatch(mesh, n, xy_p, rho);
+
+      for (k = 0; k < n; k++)
+        out[k] = MIN(out[k], rho[k] + TM_SIZEFUN_SLOPE * dist[k]);
+    }
+  }
+
+error:
+  free(xy_p);
+  free(rho);
+  free(dist);
+  return;
+
+} /* tmMesh_sizeFunBatch() */
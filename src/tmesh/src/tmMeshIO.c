@@ -0,0 +1,1652 @@
+/*
+ * This source file is part of the tmesh library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tmList.h"
+#include "tmesh/tmMesh.h"
+#include "tmesh/tmMeshIO.h"
+#include "tmesh/tmBdry.h"
+#include "tmesh/tmFront.h"
+#include "tmesh/tmEdge.h"
+#include "tmesh/tmNode.h"
+#include "tmesh/tmTri.h"
+#include "tmesh/tmPool.h"
+#include "tmesh/tmWriter.h"
+
+/**********************************************************
+* Function: tmMesh_setSink()
+*----------------------------------------------------------
+* Sets the functions, which receive the nodes and 
+* triangles of the advancing front meshing as soon as 
+* they are final. A node is final, when it is no longer 
+* located on the advancing front, such that no further
+* triangles are connected to it. A triangle is passed 
+* after all of its nodes.
+* Nodes and triangles are numbered in the order of their
+* output. After the meshing, the mesh nodes and 
+* triangles are sorted in this order, such that the 
+* indices of any later mesh output are the same.
+* The functions are called from the meshing thread. 
+* Subdomain meshes of tmMesh_ADFMeshingParallel() are
+* passed after they have been merged.
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param nodeFun: function to receive nodes (may be NULL)
+* @param triFun: function to receive triangles (may be 
+*                NULL)
+* @param ctx: context, which is passed to the functions
+**********************************************************/
+void tmMesh_setSink(tmMesh        *mesh, 
+                    tmSinkNodeFun  nodeFun, 
+                    tmSinkTriFun   triFun,
+                    void          *ctx)
+{
+  mesh->sink_node = nodeFun;
+  mesh->sink_tri  = triFun;
+  mesh->sink_ctx  = ctx;
+
+} /* tmMesh_setSink() */
+
+/**********************************************************
+* Function: tmMesh_sinkTri()
+*----------------------------------------------------------
+* Passes a triangle to the sink, if all of its nodes 
+* have been passed before
+**********************************************************/
+static void tmMesh_sinkTri(tmMesh *mesh, tmTri *tri)
+{
+  if ( tri->stream_index >= 0         ||
+       tri->n1->stream_index < 0      ||
+       tri->n2->stream_index < 0      ||
+       tri->n3->stream_index < 0 )
+    return;
+
+  tri->stream_index = mesh->sink_n_tris++;
+
+  if (mesh->sink_tri != NULL)
+    mesh->sink_tri(mesh->sink_ctx, tri->stream_index, 
+                   tri->n1->stream_index, 
+                   tri->n2->stream_index, 
+                   tri->n3->stream_index);
+
+} /* tmMesh_sinkTri() */
+
+/**********************************************************
+* Function: tmMesh_sinkNode()
+*----------------------------------------------------------
+* Passes a node and its completed triangles to the sink
+**********************************************************/
+static void tmMesh_sinkNode(tmMesh *mesh, tmNode *node)
+{
+  tmListNode *cur;
+
+  if ( node->stream_index >= 0 )
+    return;
+
+  node->stream_index = mesh->sink_n_nodes++;
+
+  if (mesh->sink_node != NULL)
+    mesh->sink_node(mesh->sink_ctx, node->stream_index, node->xy);
+
+  for (cur = node->tris->first; cur != NULL; cur = cur->next)
+    tmMesh_sinkTri(mesh, (tmTri*) cur->value);
+
+} /* tmMesh_sinkNode() */
+
+/**********************************************************
+* Function: tmMesh_sinkUpdate()
+*----------------------------------------------------------
+* Passes the nodes of a new triangle, which are no longer
+* located on the advancing front, and their completed 
+* triangles to the sink of the mesh
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param *tri: new triangle
+**********************************************************/
+void tmMesh_sinkUpdate(tmMesh *mesh, tmTri *tri)
+{
+  tmNode *nodes[3] = { tri->n1, tri->n2, tri->n3 };
+  int i;
+
+  if ( mesh->sink_node == NULL && mesh->sink_tri == NULL )
+    return;
+
+  for (i = 0; i < 3; i++)
+    if ( nodes[i]->on_front == FALSE )
+      tmMesh_sinkNode(mesh, nodes[i]);
+
+} /* tmMesh_sinkUpdate() */
+
+/**********************************************************
+* Function: tmMesh_sinkFlush()
+*----------------------------------------------------------
+* Passes all remaining nodes and triangles to the sink 
+* of the mesh and sorts the mesh nodes and triangles 
+* in the order of their output
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+**********************************************************/
+void tmMesh_sinkFlush(tmMesh *mesh)
+{
+  tmListNode *cur;
+  tmNode    **nodes = NULL;
+  tmTri     **tris  = NULL;
+
+  if ( mesh->sink_node == NULL && mesh->sink_tri == NULL )
+    return;
+
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+    tmMesh_sinkNode(mesh, (tmNode*) cur->value);
+
+  /*-------------------------------------------------------
+  | Sort the mesh nodes and triangles in the order of 
+  | their output
+  -------------------------------------------------------*/
+  check( mesh->sink_n_nodes == mesh->no_nodes &&
+         mesh->sink_n_tris  == mesh->no_tris,
+      "Mesh sink has received %d/%d nodes and %d/%d triangles.",
+      mesh->sink_n_nodes, mesh->no_nodes, 
+      mesh->sink_n_tris, mesh->no_tris);
+
+  nodes = (tmNode**) calloc(mesh->no_nodes+1, sizeof(tmNode*));
+  tris  = (tmTri**)  calloc(mesh->no_tris+1,  sizeof(tmTri*));
+  check_mem(nodes);
+  check_mem(tris);
+
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+    nodes[((tmNode*)cur->value)->stream_index] = (tmNode*) cur->value;
+
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+    tris[((tmTri*)cur->value)->stream_index] = (tmTri*) cur->value;
+
+  tmMesh_orderNodes(mesh, nodes);
+  tmMesh_orderTris(mesh, tris);
+
+error:
+  free(nodes);
+  free(tris);
+  return;
+
+} /* tmMesh_sinkFlush() */
+
+/**********************************************************
+* tmMeshRows: Mesh nodes and triangles in the order of 
+*             their indices for the mesh output
+**********************************************************/
+typedef struct tmMeshRows {
+  tmNode **nodes;
+  tmTri  **tris;
+
+  /*-------------------------------------------------------
+  | Triangle sides on the boundaries, which are set by 
+  | tmMeshRows_getBdrySides()
+  -------------------------------------------------------*/
+  int       n_bdry;
+  tmNode  **bdry_nodes;   /* [n_bdry][2]                    */
+  tmIndex  *bdry_markers;
+  tmBdry  **bdrys;
+} tmMeshRows;
+
+/**********************************************************
+* Function: tmMeshRows_create()
+*----------------------------------------------------------
+* Sets the node and triangle indices of a mesh according 
+* to their order in the mesh lists and stores them in 
+* arrays
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param rows: arrays to fill
+* @return: FALSE, if the arrays can not be allocated
+**********************************************************/
+static tmBool tmMeshRows_create(tmMesh *mesh, tmMeshRows *rows)
+{
+  tmListNode *cur;
+  int index;
+
+  memset(rows, 0, sizeof(tmMeshRows));
+
+  rows->nodes = (tmNode**) calloc(mesh->no_nodes+1, sizeof(tmNode*));
+  rows->tris  = (tmTri**)  calloc(mesh->no_tris+1,  sizeof(tmTri*));
+  check_mem(rows->nodes);
+  check_mem(rows->tris);
+
+  index = 0;
+  for (cur = mesh->nodes_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    rows->nodes[index] = (tmNode*)cur->value;
+    rows->nodes[index]->index = index;
+    index += 1;
+  }
+
+  index = 0;
+  for (cur = mesh->tris_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    rows->tris[index] = (tmTri*)cur->value;
+    rows->tris[index]->index = index;
+    index += 1;
+  }
+
+  return TRUE;
+
+error:
+  free(rows->nodes);
+  free(rows->tris);
+  rows->nodes = NULL;
+  rows->tris  = NULL;
+  return FALSE;
+
+} /* tmMeshRows_create() */
+
+/**********************************************************
+* Function: tmMeshRows_destroy()
+*----------------------------------------------------------
+* Frees the arrays of tmMeshRows_create()
+**********************************************************/
+static void tmMeshRows_destroy(tmMeshRows *rows)
+{
+  free(rows->nodes);
+  free(rows->tris);
+  free(rows->bdry_nodes);
+  free(rows->bdry_markers);
+  free(rows->bdrys);
+
+  rows->nodes        = NULL;
+  rows->tris         = NULL;
+  rows->bdry_nodes   = NULL;
+  rows->bdry_markers = NULL;
+  rows->bdrys        = NULL;
+  rows->n_bdry       = 0;
+
+} /* tmMeshRows_destroy() */
+
+/**********************************************************
+* Function: tmMeshRows_getBdrySides()
+*----------------------------------------------------------
+* Collects the triangle sides without a neighbor, which
+* refine the edges of the mesh boundaries. 
+* The sides of each boundary edge are stored in the 
+* order of the boundary edges and take the marker of the
+* triangle edge. Boundary edges, which are not covered 
+* by triangle sides (e.g. after a failed meshing), 
+* are skipped.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param rows: indexed mesh of tmMeshRows_create()
+* @return: FALSE, if the arrays can not be allocated
+**********************************************************/
+static tmBool tmMeshRows_getBdrySides(tmMesh *mesh, tmMeshRows *rows)
+{
+  tmListNode *cur, *cur_bdry;
+  int        *next    = NULL;
+  int         n_sides = 0;
+  int         i, j, n, n_edge;
+
+  next = (int*) malloc( (mesh->no_nodes+1) * sizeof(int) );
+  check_mem(next);
+
+  for (i = 0; i < mesh->no_nodes; i++)
+    next[i] = -1;
+
+  /*-------------------------------------------------------
+  | Side j of a triangle is opposite to its node j and 
+  | starts at node j+1 in counter-clockwise direction
+  -------------------------------------------------------*/
+  for (i = 0; i < mesh->no_tris; i++)
+  {
+    tmTri  *t       = rows->tris[i];
+    tmTri  *nbrs[3] = { t->t1, t->t2, t->t3 };
+    tmNode *nods[3] = { t->n1, t->n2, t->n3 };
+
+    for (j = 0; j < 3; j++)
+    {
+      if ( nbrs[j] != NULL && nbrs[j] != t )
+        continue;
+
+      next[nods[(j+1)%3]->index] = 3 * i + j;
+      n_sides += 1;
+    }
+  }
+
+  rows->bdry_nodes   = (tmNode**) calloc(2*n_sides+1, sizeof(tmNode*));
+  rows->bdry_markers = (tmIndex*) calloc(n_sides+1,   sizeof(tmIndex));
+  rows->bdrys        = (tmBdry**) calloc(n_sides+1,   sizeof(tmBdry*));
+  check_mem(rows->bdry_nodes);
+  check_mem(rows->bdry_markers);
+  check_mem(rows->bdrys);
+
+  /*-------------------------------------------------------
+  | Walk along the sides from the start to the end node
+  | of every boundary edge
+  -------------------------------------------------------*/
+  for (cur_bdry = mesh->bdry_stack->first; 
+       cur_bdry != NULL; cur_bdry = cur_bdry->next)
+  {
+    tmBdry *bdry = (tmBdry*)cur_bdry->value;
+
+    for (cur = bdry->edges_stack->first; 
+         cur != NULL; cur = cur->next)
+    {
+      tmEdge *e = (tmEdge*)cur->value;
+
+      n      = e->n1->index;
+      n_edge = rows->n_bdry;
+
+      do
+      {
+        int     s = next[n];
+        tmTri  *t;
+        tmNode *nods[3];
+        tmEdge *edgs[3];
+
+        if ( s < 0 || rows->n_bdry >= n_sides )
+        {
+          rows->n_bdry = n_edge;
+          break;
+        }
+
+        t       = rows->tris[s/3];
+        nods[0] = t->n1; nods[1] = t->n2; nods[2] = t->n3;
+        edgs[0] = t->e1; edgs[1] = t->e2; edgs[2] = t->e3;
+
+        rows->bdry_nodes[2*rows->n_bdry]   = nods[(s%3+1)%3];
+        rows->bdry_nodes[2*rows->n_bdry+1] = nods[(s%3+2)%3];
+        rows->bdry_markers[rows->n_bdry]   = edgs[s%3] != NULL 
+                                           ? edgs[s%3]->bdry_marker
+                                           : e->bdry_marker;
+        rows->bdrys[rows->n_bdry]          = bdry;
+        rows->n_bdry += 1;
+
+        n = nods[(s%3+2)%3]->index;
+
+      } while ( n != e->n2->index );
+    }
+  }
+
+  free(next);
+  return TRUE;
+
+error:
+  free(next);
+  return FALSE;
+
+} /* tmMeshRows_getBdrySides() */
+
+/**********************************************************
+* Function: tmMesh_writeNodeRows()
+*----------------------------------------------------------
+* Writes the nodes [i_beg, i_end) as 
+* "index  x  y"
+*----------------------------------------------------------
+* @param data: tmMeshRows structure
+**********************************************************/
+static void tmMesh_writeNodeRows(void     *data,
+                                 tmWriter *w,
+                                 size_t    i_beg,
+                                 size_t    i_end)
+{
+  tmMeshRows *rows = (tmMeshRows*) data;
+  size_t i;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmDouble *xy = rows->nodes[i]->xy;
+
+    tmWriter_putInt(w, (long) i, 0);
+    tmWriter_putChar(w, '\t');
+    tmWriter_putFixed(w, xy[0], 9, 5);
+    tmWriter_putChar(w, '\t');
+    tmWriter_putFixed(w, xy[1], 9, 5);
+    tmWriter_putChar(w, '\n');
+  }
+
+} /* tmMesh_writeNodeRows() */
+
+/**********************************************************
+* Function: tmMesh_writeTriRows()
+*----------------------------------------------------------
+* Writes the triangles [i_beg, i_end) as 
+* "index  n1  n2  n3"
+*----------------------------------------------------------
+* @param data: tmMeshRows structure
+**********************************************************/
+static void tmMesh_writeTriRows(void     *data,
+                                tmWriter *w,
+                                size_t    i_beg,
+                                size_t    i_end)
+{
+  tmMeshRows *rows = (tmMeshRows*) data;
+  size_t i;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmTri *t = rows->tris[i];
+
+    tmWriter_putInt(w, (long) i, 0);
+    tmWriter_putChar(w, '\t');
+    tmWriter_putInt(w, t->n1->index, 0);
+    tmWriter_putChar(w, '\t');
+    tmWriter_putInt(w, t->n2->index, 0);
+    tmWriter_putChar(w, '\t');
+    tmWriter_putInt(w, t->n3->index, 0);
+    tmWriter_putChar(w, '\n');
+  }
+
+} /* tmMesh_writeTriRows() */
+
+/**********************************************************
+* Function: tmMesh_writeNbrRows()
+*----------------------------------------------------------
+* Writes the neighbors of the triangles [i_beg, i_end) as 
+* "index  t1  t2  t3", where missing neighbors are -1
+*----------------------------------------------------------
+* @param data: tmMeshRows structure
+**********************************************************/
+static void tmMesh_writeNbrRows(void     *data,
+                                tmWriter *w,
+                                size_t    i_beg,
+                                size_t    i_end)
+{
+  tmMeshRows *rows = (tmMeshRows*) data;
+  size_t i;
+  int    j;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmTri *t       = rows->tris[i];
+    tmTri *nbrs[3] = { t->t1, t->t2, t->t3 };
+
+    tmWriter_putInt(w, (long) i, 0);
+
+    for (j = 0; j < 3; j++)
+    {
+      tmIndex ind = -1;
+
+      if ( nbrs[j] != NULL && nbrs[j]->index != (tmIndex) i )
+        ind = nbrs[j]->index;
+
+      tmWriter_putChar(w, '\t');
+      tmWriter_putInt(w, ind, 0);
+    }
+
+    tmWriter_putChar(w, '\n');
+  }
+
+} /* tmMesh_writeNbrRows() */
+
+/**********************************************************
+* Function: tmMesh_writeNbrRowsIncomflow()
+*----------------------------------------------------------
+* Writes the neighbors of the triangles [i_beg, i_end) as 
+* "index  t1  t2  t3", where missing neighbors are 
+* replaced by the negative boundary marker of the edge
+*----------------------------------------------------------
+* @param data: tmMeshRows structure
+**********************************************************/
+static void tmMesh_writeNbrRowsIncomflow(void     *data,
+                                         tmWriter *w,
+                                         size_t    i_beg,
+                                         size_t    i_end)
+{
+  tmMeshRows *rows = (tmMeshRows*) data;
+  size_t i;
+  int    j;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmTri  *t       = rows->tris[i];
+    tmTri  *nbrs[3] = { t->t1, t->t2, t->t3 };
+    tmEdge *edgs[3] = { t->e1, t->e2, t->e3 };
+
+    tmWriter_putInt(w, (long) i, 0);
+
+    for (j = 0; j < 3; j++)
+    {
+      tmIndex ind = nbrs[j]->index != (tmIndex) i 
+                  ? nbrs[j]->index : -(edgs[j]->bdry_marker);
+
+      tmWriter_putChar(w, '\t');
+      tmWriter_putInt(w, ind, 0);
+    }
+
+    tmWriter_putChar(w, '\n');
+  }
+
+} /* tmMesh_writeNbrRowsIncomflow() */
+
+/**********************************************************
+* Function: tmMesh_writeMesh()
+*----------------------------------------------------------
+* Writes the mesh data in the format of 
+* tmMesh_printMesh(). 
+* Large tables are formatted on the threads of the mesh.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param w: writer for the output
+* @return: FALSE, if the output has failed
+**********************************************************/
+tmBool tmMesh_writeMesh(tmMesh *mesh, tmWriter *w)
+{
+  tmListNode *cur, *cur_bdry;
+  tmMeshRows  rows;
+  int edge_index = 0;
+
+  if ( tmMeshRows_create(mesh, &rows) == FALSE )
+    return FALSE;
+
+  /*-------------------------------------------------------
+  | Node coordinates
+  -------------------------------------------------------*/
+  tmWriter_putStr(w, "NODES ");
+  tmWriter_putInt(w, mesh->no_nodes, 0);
+  tmWriter_putChar(w, '\n');
+
+  tmWriter_writeRows(w, mesh->pool, mesh->no_nodes, 
+                     tmMesh_writeNodeRows, &rows);
+
+  /*-------------------------------------------------------
+  | Boundary edges
+  -------------------------------------------------------*/
+  for (cur_bdry = mesh->bdry_stack->first; 
+       cur_bdry != NULL; cur_bdry = cur_bdry->next)
+  {
+    tmBdry *bdry = (tmBdry*)cur_bdry->value;
+
+    tmWriter_putStr(w, "BOUNDARY ");
+    tmWriter_putInt(w, bdry->index, 0);
+    tmWriter_putChar(w, ' ');
+    tmWriter_putInt(w, bdry->no_edges, 0);
+    tmWriter_putChar(w, '\n');
+
+    for (cur = bdry->edges_stack->first; 
+         cur != NULL; cur = cur->next)
+    {
+      tmEdge *e = (tmEdge*)cur->value;
+      e->index  = edge_index;
+
+      tmWriter_putInt(w, edge_index, 0);
+      tmWriter_putChar(w, '\t');
+      tmWriter_putInt(w, e->n1->index, 9);
+      tmWriter_putChar(w, '\t');
+      tmWriter_putInt(w, e->n2->index, 9);
+      tmWriter_putChar(w, '\t');
+      tmWriter_putInt(w, e->bdry_marker, 9);
+      tmWriter_putChar(w, '\n');
+
+      edge_index += 1;
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Front edges
+  -------------------------------------------------------*/
+  edge_index = 0;
+
+  tmWriter_putStr(w, "FRONT ");
+  tmWriter_putInt(w, mesh->front->no_edges, 0);
+  tmWriter_putChar(w, '\n');
+
+  for (cur = mesh->front->edges_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmEdge *e = (tmEdge*)cur->value;
+    e->index  = edge_index;
+
+    tmWriter_putInt(w, edge_index, 0);
+    tmWriter_putChar(w, '\t');
+    tmWriter_putInt(w, e->n1->index, 9);
+    tmWriter_putChar(w, '\t');
+    tmWriter_putInt(w, e->n2->index, 9);
+    tmWriter_putChar(w, '\n');
+
+    edge_index += 1;
+  }
+
+  /*-------------------------------------------------------
+  | Triangles and their neighbors
+  -------------------------------------------------------*/
+  tmWriter_putStr(w, "TRIANGLES ");
+  tmWriter_putInt(w, mesh->no_tris, 0);
+  tmWriter_putChar(w, '\n');
+
+  tmWriter_writeRows(w, mesh->pool, mesh->no_tris, 
+                     tmMesh_writeTriRows, &rows);
+
+  tmWriter_putStr(w, "NEIGHBORS ");
+  tmWriter_putInt(w, mesh->no_tris, 0);
+  tmWriter_putChar(w, '\n');
+
+  tmWriter_writeRows(w, mesh->pool, mesh->no_tris, 
+                     tmMesh_writeNbrRows, &rows);
+
+  tmMeshRows_destroy(&rows);
+
+  return tmWriter_flush(w);
+
+} /* tmMesh_writeMesh() */
+
+/**********************************************************
+* Function: tmMesh_writeMeshIncomflow()
+*----------------------------------------------------------
+* Writes the mesh data in the format of 
+* tmMesh_printMeshIncomflow(). 
+* Large tables are formatted on the threads of the mesh.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param w: writer for the output
+* @return: FALSE, if the output has failed
+**********************************************************/
+tmBool tmMesh_writeMeshIncomflow(tmMesh *mesh, tmWriter *w)
+{
+  tmMeshRows rows;
+
+  if ( tmMeshRows_create(mesh, &rows) == FALSE )
+    return FALSE;
+
+  tmWriter_putStr(w, "NODES ");
+  tmWriter_putInt(w, mesh->no_nodes, 0);
+  tmWriter_putChar(w, '\n');
+
+  tmWriter_writeRows(w, mesh->pool, mesh->no_nodes, 
+                     tmMesh_writeNodeRows, &rows);
+
+  tmWriter_putStr(w, "TRIANGLES ");
+  tmWriter_putInt(w, mesh->no_tris, 0);
+  tmWriter_putChar(w, '\n');
+
+  tmWriter_writeRows(w, mesh->pool, mesh->no_tris, 
+                     tmMesh_writeTriRows, &rows);
+
+  tmWriter_putStr(w, "NEIGHBORS ");
+  tmWriter_putInt(w, mesh->no_tris, 0);
+  tmWriter_putChar(w, '\n');
+
+  tmWriter_writeRows(w, mesh->pool, mesh->no_tris, 
+                     tmMesh_writeNbrRowsIncomflow, &rows);
+
+  tmMeshRows_destroy(&rows);
+
+  return tmWriter_flush(w);
+
+} /* tmMesh_writeMeshIncomflow() */
+
+/**********************************************************
+* Function: tmMesh_printMesh()
+*----------------------------------------------------------
+* Fuction to print out the mesh data
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+**********************************************************/
+void tmMesh_printMesh(tmMesh *mesh) 
+{
+  tmWriter *w = tmWriter_createStdout();
+
+  if (w == NULL)
+    return;
+
+  tmMesh_writeMesh(mesh, w);
+  tmWriter_destroy(w);
+
+} /* tmMesh_printMesh() */
+
+
+/**********************************************************
+* Function: tmMesh_printMeshIncomflow()
+*----------------------------------------------------------
+* Fuction to print out the mesh data in the format for
+* the incomflow solver
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+**********************************************************/
+void tmMesh_printMeshIncomflow(tmMesh *mesh) 
+{
+  tmWriter *w = tmWriter_createStdout();
+
+  if (w == NULL)
+    return;
+
+  tmMesh_writeMeshIncomflow(mesh, w);
+  tmWriter_destroy(w);
+
+} /* tmMesh_printMeshIncomflow() */
+
+/**********************************************************
+* Function: tmMesh_putLE()
+*----------------------------------------------------------
+* Appends the lowest n_bytes bytes of a value in 
+* little-endian byte order
+**********************************************************/
+static void tmMesh_putLE(tmWriter *w, uint64_t v, int n_bytes)
+{
+  unsigned char bytes[8];
+  int i;
+
+  for (i = 0; i < n_bytes; i++)
+    bytes[i] = (unsigned char) (v >> (8*i));
+
+  tmWriter_putBytes(w, bytes, n_bytes);
+
+} /* tmMesh_putLE() */
+
+/**********************************************************
+* Function: tmMesh_putF64()
+*----------------------------------------------------------
+* Appends a 64 bit floating point value in little-endian
+* byte order
+**********************************************************/
+static void tmMesh_putF64(tmWriter *w, tmDouble v)
+{
+  uint64_t u;
+  double   d = (double) v;
+
+  memcpy(&u, &d, sizeof(u));
+  tmMesh_putLE(w, u, 8);
+
+} /* tmMesh_putF64() */
+
+/**********************************************************
+* Function: tmMesh_putPadding()
+*----------------------------------------------------------
+* Pads an array of n_bytes bytes with zeros to a 
+* multiple of 8 bytes
+**********************************************************/
+static void tmMesh_putPadding(tmWriter *w, uint64_t n_bytes)
+{
+  if (n_bytes % 8 != 0)
+    tmMesh_putLE(w, 0, 8 - n_bytes % 8);
+
+} /* tmMesh_putPadding() */
+
+/**********************************************************
+* Function: tmMesh_writeBinNodeRows()
+*----------------------------------------------------------
+* Writes the binary coordinates of the nodes 
+* [i_beg, i_end)
+*----------------------------------------------------------
+* @param data: tmMeshRows structure
+**********************************************************/
+static void tmMesh_writeBinNodeRows(void     *data,
+                                    tmWriter *w,
+                                    size_t    i_beg,
+                                    size_t    i_end)
+{
+  tmMeshRows *rows = (tmMeshRows*) data;
+  size_t i;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmMesh_putF64(w, rows->nodes[i]->xy[0]);
+    tmMesh_putF64(w, rows->nodes[i]->xy[1]);
+  }
+
+} /* tmMesh_writeBinNodeRows() */
+
+/**********************************************************
+* Function: tmMesh_writeBinTriRows()
+*----------------------------------------------------------
+* Writes the binary node indices of the triangles 
+* [i_beg, i_end)
+*----------------------------------------------------------
+* @param data: tmMeshRows structure
+**********************************************************/
+static void tmMesh_writeBinTriRows(void     *data,
+                                   tmWriter *w,
+                                   size_t    i_beg,
+                                   size_t    i_end)
+{
+  tmMeshRows *rows = (tmMeshRows*) data;
+  size_t i;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmTri *t = rows->tris[i];
+
+    tmMesh_putLE(w, (uint32_t) t->n1->index, 4);
+    tmMesh_putLE(w, (uint32_t) t->n2->index, 4);
+    tmMesh_putLE(w, (uint32_t) t->n3->index, 4);
+  }
+
+} /* tmMesh_writeBinTriRows() */
+
+/**********************************************************
+* Function: tmMesh_writeBinNbrRows()
+*----------------------------------------------------------
+* Writes the binary neighbor indices of the triangles 
+* [i_beg, i_end), where missing neighbors are -1
+*----------------------------------------------------------
+* @param data: tmMeshRows structure
+**********************************************************/
+static void tmMesh_writeBinNbrRows(void     *data,
+                                   tmWriter *w,
+                                   size_t    i_beg,
+                                   size_t    i_end)
+{
+  tmMeshRows *rows = (tmMeshRows*) data;
+  size_t i;
+  int    j;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmTri *t       = rows->tris[i];
+    tmTri *nbrs[3] = { t->t1, t->t2, t->t3 };
+
+    for (j = 0; j < 3; j++)
+    {
+      int32_t ind = -1;
+
+      if ( nbrs[j] != NULL && nbrs[j] != t )
+        ind = nbrs[j]->index;
+
+      tmMesh_putLE(w, (uint32_t) ind, 4);
+    }
+  }
+
+} /* tmMesh_writeBinNbrRows() */
+
+/**********************************************************
+* Function: tmMesh_writeBinaryTo()
+*----------------------------------------------------------
+* Writes the mesh data in the binary format 
+* (see TM_BIN_MAGIC) to a writer
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param w: writer
+* @return: FALSE, if the mesh could not be indexed
+**********************************************************/
+tmBool tmMesh_writeBinaryTo(tmMesh *mesh, tmWriter *w)
+{
+  tmMeshRows  rows;
+  uint64_t    n_nodes = mesh->no_nodes;
+  uint64_t    n_tris  = mesh->no_tris;
+  uint64_t    n_bdry  = 0;
+  uint64_t    off[7];
+  int         i;
+
+  rows.nodes = NULL;
+  rows.tris  = NULL;
+
+  check( tmMeshRows_create(mesh, &rows) == TRUE
+      && tmMeshRows_getBdrySides(mesh, &rows) == TRUE,
+      "Failed to index mesh for output.");
+
+  n_bdry = rows.n_bdry;
+
+  /*-------------------------------------------------------
+  | Array offsets -> each array is aligned to 8 bytes
+  -------------------------------------------------------*/
+  off[0] = TM_BIN_HEADER_SIZE;
+  off[1] = off[0] + 16 * n_nodes;
+  off[2] = off[1] + ((12 * n_tris + 7) / 8) * 8;
+  off[3] = off[2] + ((12 * n_tris + 7) / 8) * 8;
+  off[4] = off[3] + 8 * n_bdry;
+  off[5] = off[4] + ((4 * n_bdry + 7) / 8) * 8;
+  off[6] = off[5] + ((4 * n_bdry + 7) / 8) * 8;
+
+  /*-------------------------------------------------------
+  | Header
+  -------------------------------------------------------*/
+  tmWriter_putBytes(w, TM_BIN_MAGIC, 8);
+  tmMesh_putLE(w, TM_BIN_VERSION, 4);
+  tmMesh_putLE(w, TM_BIN_HEADER_SIZE, 4);
+  tmMesh_putLE(w, n_nodes, 8);
+  tmMesh_putLE(w, n_tris, 8);
+  tmMesh_putLE(w, n_bdry, 8);
+
+  for (i = 0; i < 7; i++)
+    tmMesh_putLE(w, off[i], 8);
+
+  /*-------------------------------------------------------
+  | Node coordinates, triangle nodes and neighbors
+  -------------------------------------------------------*/
+  tmWriter_writeRows(w, mesh->pool, n_nodes, 
+                     tmMesh_writeBinNodeRows, &rows);
+
+  tmWriter_writeRows(w, mesh->pool, n_tris, 
+                     tmMesh_writeBinTriRows, &rows);
+  tmMesh_putPadding(w, 12 * n_tris);
+
+  tmWriter_writeRows(w, mesh->pool, n_tris, 
+                     tmMesh_writeBinNbrRows, &rows);
+  tmMesh_putPadding(w, 12 * n_tris);
+
+  /*-------------------------------------------------------
+  | Boundary sides, markers and boundary indices
+  -------------------------------------------------------*/
+  for (i = 0; i < rows.n_bdry; i++)
+  {
+    tmMesh_putLE(w, (uint32_t) rows.bdry_nodes[2*i]->index, 4);
+    tmMesh_putLE(w, (uint32_t) rows.bdry_nodes[2*i+1]->index, 4);
+  }
+
+  for (i = 0; i < rows.n_bdry; i++)
+    tmMesh_putLE(w, (uint32_t) rows.bdry_markers[i], 4);
+  tmMesh_putPadding(w, 4 * n_bdry);
+
+  for (i = 0; i < rows.n_bdry; i++)
+    tmMesh_putLE(w, (uint32_t) rows.bdrys[i]->index, 4);
+  tmMesh_putPadding(w, 4 * n_bdry);
+
+  tmMeshRows_destroy(&rows);
+
+  return TRUE;
+
+error:
+  tmMeshRows_destroy(&rows);
+  return FALSE;
+
+} /* tmMesh_writeBinaryTo() */
+
+/**********************************************************
+* Function: tmMesh_writeBinary()
+*----------------------------------------------------------
+* Writes the mesh data to a binary file, which can be 
+* mapped into memory as a whole (see TM_BIN_MAGIC for
+* the file format)
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param path: path of the output file
+* @return: FALSE, if the file could not be written
+**********************************************************/
+tmBool tmMesh_writeBinary(tmMesh *mesh, const char *path)
+{
+  tmWriter *w = NULL;
+  tmBool    ok;
+
+  w = tmWriter_open(path);
+  check( w != NULL, "Failed to open file %s", path);
+
+  ok = tmMesh_writeBinaryTo(mesh, w);
+  ok = ( tmWriter_destroy(w) == TRUE ) && ok;
+  check( ok == TRUE, "Failed to write file %s", path);
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmMesh_writeBinary() */
+
+/**********************************************************
+* tmMeshVTUField: Triangle field for the VTU output
+**********************************************************/
+typedef struct tmMeshVTUField {
+  tmMeshRows *rows;
+  int         field;  /* 0: connectivity, 1: offsets,
+                         2: quality, 3: minAngle,
+                         4: maxAngle, 5: area         */
+} tmMeshVTUField;
+
+/**********************************************************
+* Function: tmMesh_writeBinNode3DRows()
+*----------------------------------------------------------
+* Writes the binary 3D coordinates of the nodes 
+* [i_beg, i_end)
+*----------------------------------------------------------
+* @param data: tmMeshRows structure
+**********************************************************/
+static void tmMesh_writeBinNode3DRows(void     *data,
+                                    tmWriter *w,
+                                    size_t    i_beg,
+                                    size_t    i_end)
+{
+  tmMeshRows *rows = (tmMeshRows*) data;
+  size_t i;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmMesh_putF64(w, rows->nodes[i]->xy[0]);
+    tmMesh_putF64(w, rows->nodes[i]->xy[1]);
+    tmMesh_putF64(w, 0.0);
+  }
+
+} /* tmMesh_writeBinNode3DRows() */
+
+/**********************************************************
+* Function: tmMesh_writeVTUTriRows()
+*----------------------------------------------------------
+* Writes a binary field of the triangles [i_beg, i_end)
+*----------------------------------------------------------
+* @param data: tmMeshVTUField structure
+**********************************************************/
+static void tmMesh_writeVTUTriRows(void     *data,
+                                   tmWriter *w,
+                                   size_t    i_beg,
+                                   size_t    i_end)
+{
+  tmMeshVTUField *f = (tmMeshVTUField*) data;
+  size_t i;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmTri *t = f->rows->tris[i];
+
+    switch ( f->field )
+    {
+      case 0:
+        tmMesh_putLE(w, (uint32_t) t->n1->index, 4);
+        tmMesh_putLE(w, (uint32_t) t->n2->index, 4);
+        tmMesh_putLE(w, (uint32_t) t->n3->index, 4);
+        break;
+      case 1:
+        tmMesh_putLE(w, (uint32_t) (3 * (i+1)), 4);
+        break;
+      case 2:
+        tmMesh_putF64(w, t->quality);
+        break;
+      case 3:
+        tmMesh_putF64(w, t->minAngle);
+        break;
+      case 4:
+        tmMesh_putF64(w, t->maxAngle);
+        break;
+      default:
+        tmMesh_putF64(w, t->area);
+    }
+  }
+
+} /* tmMesh_writeVTUTriRows() */
+
+/**********************************************************
+* Function: tmMesh_putVTUArray()
+*----------------------------------------------------------
+* Appends the XML entry of a data array in the appended
+* data section at the given offset
+**********************************************************/
+static void tmMesh_putVTUArray(tmWriter   *w,
+                               const char *type,
+                               const char *name,
+                               int         n_comps,
+                               uint64_t    offset)
+{
+  char buf[64];
+
+  tmWriter_putStr(w, "        <DataArray type=\"");
+  tmWriter_putStr(w, type);
+  tmWriter_putStr(w, "\"");
+
+  if ( name != NULL )
+  {
+    tmWriter_putStr(w, " Name=\"");
+    tmWriter_putStr(w, name);
+    tmWriter_putStr(w, "\"");
+  }
+
+  if ( n_comps > 1 )
+  {
+    tmWriter_putStr(w, " NumberOfComponents=\"");
+    tmWriter_putInt(w, n_comps, 0);
+    tmWriter_putStr(w, "\"");
+  }
+
+  snprintf(buf, sizeof(buf), "%" PRIu64, offset);
+  tmWriter_putStr(w, " format=\"appended\" offset=\"");
+  tmWriter_putStr(w, buf);
+  tmWriter_putStr(w, "\"/>\n");
+
+} /* tmMesh_putVTUArray() */
+
+/**********************************************************
+* Function: tmMesh_writeVTU()
+*----------------------------------------------------------
+* Writes the mesh to a VTK unstructured grid file (.vtu) 
+* with raw binary appended data
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param path: path of the output file
+* @return: FALSE, if the file could not be written
+**********************************************************/
+tmBool tmMesh_writeVTU(tmMesh *mesh, const char *path)
+{
+  tmMeshRows     rows;
+  tmMeshVTUField field;
+  tmWriter      *w       = NULL;
+  uint64_t       n_nodes = mesh->no_nodes;
+  uint64_t       n_tris  = mesh->no_tris;
+  uint64_t       n_bdry  = 0;
+  uint64_t       n_cells;
+  uint64_t       size[TM_VTU_N_ARRAYS];
+  uint64_t       off[TM_VTU_N_ARRAYS];
+  uint64_t       i;
+  tmBool         ok;
+  int            j;
+
+  const char *types[TM_VTU_N_ARRAYS] = { 
+    "Float64", "Int32", "Int32", "UInt8", 
+    "Int32", "Float64", "Float64", "Float64", "Float64" };
+  const char *names[TM_VTU_N_ARRAYS] = { 
+    NULL, "connectivity", "offsets", "types",
+    "bdry_marker", "quality", "minAngle", "maxAngle", "area" };
+
+  rows.nodes = NULL;
+  rows.tris  = NULL;
+
+  check( tmMeshRows_create(mesh, &rows) == TRUE
+      && tmMeshRows_getBdrySides(mesh, &rows) == TRUE,
+      "Failed to index mesh for output.");
+
+  n_bdry  = rows.n_bdry;
+  n_cells = n_tris + n_bdry;
+
+  /*-------------------------------------------------------
+  | Array sizes and offsets in the appended data section,
+  | each array is preceded by its size as UInt64
+  -------------------------------------------------------*/
+  size[0] = 24 * n_nodes;
+  size[1] = 4 * (3 * n_tris + 2 * n_bdry);
+  size[2] = 4 * n_cells;
+  size[3] = n_cells;
+  size[4] = 4 * n_cells;
+
+  for (j = 5; j < TM_VTU_N_ARRAYS; j++)
+    size[j] = 8 * n_cells;
+
+  off[0] = 0;
+  for (j = 1; j < TM_VTU_N_ARRAYS; j++)
+    off[j] = off[j-1] + 8 + size[j-1];
+
+  w = tmWriter_open(path);
+  check( w != NULL, "Failed to open file %s", path);
+
+  /*-------------------------------------------------------
+  | XML header
+  -------------------------------------------------------*/
+  tmWriter_putStr(w, "<?xml version=\"1.0\"?>\n"
+    "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" "
+    "byte_order=\"LittleEndian\" header_type=\"UInt64\">\n"
+    "  <UnstructuredGrid>\n"
+    "    <Piece NumberOfPoints=\"");
+  tmWriter_putInt(w, mesh->no_nodes, 0);
+  tmWriter_putStr(w, "\" NumberOfCells=\"");
+  tmWriter_putInt(w, (long) n_cells, 0);
+  tmWriter_putStr(w, "\">\n      <Points>\n");
+  tmMesh_putVTUArray(w, types[0], names[0], 3, off[0]);
+  tmWriter_putStr(w, "      </Points>\n      <Cells>\n");
+
+  for (j = 1; j < 4; j++)
+    tmMesh_putVTUArray(w, types[j], names[j], 1, off[j]);
+
+  tmWriter_putStr(w, "      </Cells>\n"
+                     "      <CellData Scalars=\"quality\">\n");
+
+  for (j = 4; j < TM_VTU_N_ARRAYS; j++)
+    tmMesh_putVTUArray(w, types[j], names[j], 1, off[j]);
+
+  tmWriter_putStr(w, "      </CellData>\n"
+                     "    </Piece>\n"
+                     "  </UnstructuredGrid>\n"
+                     "  <AppendedData encoding=\"raw\">\n   _");
+
+  /*-------------------------------------------------------
+  | Node coordinates
+  -------------------------------------------------------*/
+  field.rows = &rows;
+
+  tmMesh_putLE(w, size[0], 8);
+  tmWriter_writeRows(w, mesh->pool, n_nodes, 
+                     tmMesh_writeBinNode3DRows, &rows);
+
+  /*-------------------------------------------------------
+  | Connectivity and offsets of the triangles, followed
+  | by the boundary sides as line cells
+  -------------------------------------------------------*/
+  tmMesh_putLE(w, size[1], 8);
+  field.field = 0;
+  tmWriter_writeRows(w, mesh->pool, n_tris, 
+                     tmMesh_writeVTUTriRows, &field);
+
+  for (i = 0; i < n_bdry; i++)
+  {
+    tmMesh_putLE(w, (uint32_t) rows.bdry_nodes[2*i]->index, 4);
+    tmMesh_putLE(w, (uint32_t) rows.bdry_nodes[2*i+1]->index, 4);
+  }
+
+  tmMesh_putLE(w, size[2], 8);
+  field.field = 1;
+  tmWriter_writeRows(w, mesh->pool, n_tris, 
+                     tmMesh_writeVTUTriRows, &field);
+
+  for (i = 0; i < n_bdry; i++)
+    tmMesh_putLE(w, 3 * n_tris + 2 * (i+1), 4);
+
+  /*-------------------------------------------------------
+  | Cell types 
+  -------------------------------------------------------*/
+  tmMesh_putLE(w, size[3], 8);
+
+  for (i = 0; i < n_tris; i++)
+    tmWriter_putChar(w, TM_VTU_TRIANGLE);
+  for (i = 0; i < n_bdry; i++)
+    tmWriter_putChar(w, TM_VTU_LINE);
+
+  /*-------------------------------------------------------
+  | Boundary markers (-1 for triangles)
+  -------------------------------------------------------*/
+  tmMesh_putLE(w, size[4], 8);
+
+  for (i = 0; i < n_tris; i++)
+    tmMesh_putLE(w, (uint32_t) -1, 4);
+
+  for (i = 0; i < n_bdry; i++)
+    tmMesh_putLE(w, (uint32_t) rows.bdry_markers[i], 4);
+
+  /*-------------------------------------------------------
+  | Triangle properties (zero for boundary sides)
+  -------------------------------------------------------*/
+  for (j = 5; j < TM_VTU_N_ARRAYS; j++)
+  {
+    tmMesh_putLE(w, size[j], 8);
+    field.field = j - 3;
+    tmWriter_writeRows(w, mesh->pool, n_tris, 
+                       tmMesh_writeVTUTriRows, &field);
+
+    for (i = 0; i < n_bdry; i++)
+      tmMesh_putF64(w, 0.0);
+  }
+
+  tmWriter_putStr(w, "\n  </AppendedData>\n</VTKFile>\n");
+
+  tmMeshRows_destroy(&rows);
+
+  ok = tmWriter_destroy(w);
+  check( ok == TRUE, "Failed to write file %s", path);
+
+  return TRUE;
+
+error:
+  tmMeshRows_destroy(&rows);
+  return FALSE;
+
+} /* tmMesh_writeVTU() */
+
+/**********************************************************
+* tmMeshMshCurve: Boundary sides of one boundary with the
+*                 same marker, which are written as a 
+*                 curve entity of the MSH output
+**********************************************************/
+typedef struct tmMeshMshCurve {
+  tmBdry  *bdry;
+  tmIndex  marker;
+  int      marker_tag;  /* physical group of the marker   */
+  int      bdry_tag;    /* physical group of the boundary */
+  uint64_t n_edges;
+  tmDouble xy_min[2];
+  tmDouble xy_max[2];
+} tmMeshMshCurve;
+
+/**********************************************************
+* Function: tmMesh_getMshCurves()
+*----------------------------------------------------------
+* Collects the curve entities of the boundary sides, 
+* i.e. all pairs of boundary and marker
+*----------------------------------------------------------
+* @param rows: mesh with the boundary sides of 
+*              tmMeshRows_getBdrySides()
+* @param curves: returns the curve entities
+* @param n_curves: returns the number of curve entities
+* @return: FALSE, if the memory can not be allocated
+**********************************************************/
+static tmBool tmMesh_getMshCurves(tmMeshRows      *rows,
+                                  tmMeshMshCurve **curves,
+                                  int             *n_curves)
+{
+  tmMeshMshCurve *c;
+  int n     = 0;
+  int i_beg = 0;
+  int i, k;
+
+  c = (tmMeshMshCurve*) calloc(rows->n_bdry+1, sizeof(tmMeshMshCurve));
+  check_mem(c);
+
+  for (k = 0; k < rows->n_bdry; k++)
+  {
+    tmDouble *xy1 = rows->bdry_nodes[2*k]->xy;
+    tmDouble *xy2 = rows->bdry_nodes[2*k+1]->xy;
+
+    /*-----------------------------------------------------
+    | The sides are ordered by their boundaries
+    -----------------------------------------------------*/
+    if ( k > 0 && rows->bdrys[k] != rows->bdrys[k-1] )
+      i_beg = n;
+
+    for (i = i_beg; i < n; i++)
+      if ( c[i].marker == rows->bdry_markers[k] )
+        break;
+
+    if ( i == n )
+    {
+      c[n].bdry      = rows->bdrys[k];
+      c[n].marker    = rows->bdry_markers[k];
+      c[n].xy_min[0] = c[n].xy_max[0] = xy1[0];
+      c[n].xy_min[1] = c[n].xy_max[1] = xy1[1];
+      n += 1;
+    }
+
+    c[i].n_edges += 1;
+    c[i].xy_min[0] = MIN(c[i].xy_min[0], MIN(xy1[0], xy2[0]));
+    c[i].xy_min[1] = MIN(c[i].xy_min[1], MIN(xy1[1], xy2[1]));
+    c[i].xy_max[0] = MAX(c[i].xy_max[0], MAX(xy1[0], xy2[0]));
+    c[i].xy_max[1] = MAX(c[i].xy_max[1], MAX(xy1[1], xy2[1]));
+  }
+
+  *curves   = c;
+  *n_curves = n;
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmMesh_getMshCurves() */
+
+/**********************************************************
+* Function: tmMesh_putMshBox()
+*----------------------------------------------------------
+* Appends the bounding box of an entity as 
+* minX minY minZ maxX maxY maxZ
+**********************************************************/
+static void tmMesh_putMshBox(tmWriter *w, 
+                             tmDouble  xy_min[2], 
+                             tmDouble  xy_max[2])
+{
+  tmMesh_putF64(w, xy_min[0]);
+  tmMesh_putF64(w, xy_min[1]);
+  tmMesh_putF64(w, 0.0);
+  tmMesh_putF64(w, xy_max[0]);
+  tmMesh_putF64(w, xy_max[1]);
+  tmMesh_putF64(w, 0.0);
+
+} /* tmMesh_putMshBox() */
+
+/**********************************************************
+* Function: tmMesh_writeMshNodeTagRows()
+*----------------------------------------------------------
+* Writes the binary tags of the nodes [i_beg, i_end)
+**********************************************************/
+static void tmMesh_writeMshNodeTagRows(void     *data,
+                                       tmWriter *w,
+                                       size_t    i_beg,
+                                       size_t    i_end)
+{
+  size_t i;
+
+  (void) data;
+
+  for (i = i_beg; i < i_end; i++)
+    tmMesh_putLE(w, (uint64_t) (i+1), 8);
+
+} /* tmMesh_writeMshNodeTagRows() */
+
+/**********************************************************
+* Function: tmMesh_writeMshTriRows()
+*----------------------------------------------------------
+* Writes the binary element tags and node tags of the 
+* triangles [i_beg, i_end)
+*----------------------------------------------------------
+* @param data: tmMeshRows structure
+**********************************************************/
+static void tmMesh_writeMshTriRows(void     *data,
+                                   tmWriter *w,
+                                   size_t    i_beg,
+                                   size_t    i_end)
+{
+  tmMeshRows *rows = (tmMeshRows*) data;
+  size_t i;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmTri *t = rows->tris[i];
+
+    tmMesh_putLE(w, (uint64_t) (i+1), 8);
+    tmMesh_putLE(w, (uint64_t) (t->n1->index + 1), 8);
+    tmMesh_putLE(w, (uint64_t) (t->n2->index + 1), 8);
+    tmMesh_putLE(w, (uint64_t) (t->n3->index + 1), 8);
+  }
+
+} /* tmMesh_writeMshTriRows() */
+
+/**********************************************************
+* Function: tmMesh_writeMSH()
+*----------------------------------------------------------
+* Writes the mesh to a binary Gmsh MSH 4.1 file
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param path: path of the output file
+* @return: FALSE, if the file could not be written
+**********************************************************/
+tmBool tmMesh_writeMSH(tmMesh *mesh, const char *path)
+{
+  tmMeshRows      rows;
+  tmMeshMshCurve *curves   = NULL;
+  tmIndex        *markers  = NULL;
+  int            *tags     = NULL;
+  tmWriter       *w        = NULL;
+  uint64_t        n_nodes  = mesh->no_nodes;
+  uint64_t        n_tris   = mesh->no_tris;
+  uint64_t        n_bdry   = 0;
+  uint64_t        elem_tag;
+  int             n_curves = 0;
+  int             n_markers = 0;
+  int             n_groups  = 0;
+  int             tag_max   = 0;
+  int             i, j, k;
+  tmBool          ok;
+  char            buf[64];
+
+  rows.nodes = NULL;
+  rows.tris  = NULL;
+
+  check( tmMeshRows_create(mesh, &rows) == TRUE
+      && tmMeshRows_getBdrySides(mesh, &rows) == TRUE,
+      "Failed to index mesh for output.");
+
+  check( tmMesh_getMshCurves(&rows, &curves, &n_curves) == TRUE,
+      "Failed to collect boundary entities.");
+
+  n_bdry = rows.n_bdry;
+
+  /*-------------------------------------------------------
+  | Every boundary marker and every boundary becomes a 
+  | physical group. Gmsh requires positive tags: 
+  | positive markers are their own tag, all other markers
+  | and the boundaries are numbered after the largest 
+  | marker.
+  -------------------------------------------------------*/
+  markers = (tmIndex*) calloc(n_curves+1, sizeof(tmIndex));
+  tags    = (int*)     calloc(n_curves+1, sizeof(int));
+  check_mem(markers);
+  check_mem(tags);
+
+  for (i = 0; i < n_curves; i++)
+  {
+    for (j = 0; j < n_markers; j++)
+      if ( markers[j] == curves[i].marker )
+        break;
+
+    if ( j == n_markers )
+      markers[n_markers++] = curves[i].marker;
+
+    if ( curves[i].marker > 0 && curves[i].marker > tag_max )
+      tag_max = (int) curves[i].marker;
+  }
+
+  for (j = 0; j < n_markers; j++)
+  {
+    tags[j] = (markers[j] > 0) ? (int) markers[j] : ++tag_max;
+
+    for (i = 0; i < n_curves; i++)
+      if ( curves[i].marker == markers[j] )
+        curves[i].marker_tag = tags[j];
+  }
+
+  for (i = 0; i < n_curves; i++)
+  {
+    for (j = 0; j < i; j++)
+      if ( curves[j].bdry->index == curves[i].bdry->index )
+        break;
+
+    if ( j == i )
+    {
+      curves[i].bdry_tag = ++tag_max;
+      n_groups += 1;
+    }
+    else
+      curves[i].bdry_tag = curves[j].bdry_tag;
+  }
+
+  w = tmWriter_open(path);
+  check( w != NULL, "Failed to open file %s", path);
+
+  /*-------------------------------------------------------
+  | Header: version, file type and size of size_t
+  -------------------------------------------------------*/
+  tmWriter_putStr(w, "$MeshFormat\n4.1 1 8\n");
+  tmMesh_putLE(w, 1, 4);
+  tmWriter_putStr(w, "\n$EndMeshFormat\n");
+
+  /*-------------------------------------------------------
+  | Physical names of the markers and the domain
+  -------------------------------------------------------*/
+  tmWriter_putStr(w, "$PhysicalNames\n");
+  tmWriter_putInt(w, n_markers + n_groups + 1, 0);
+  tmWriter_putChar(w, '\n');
+
+  for (j = 0; j < n_markers; j++)
+  {
+    snprintf(buf, sizeof(buf), "1 %d \"marker_%d\"\n", 
+             tags[j], (int) markers[j]);
+    tmWriter_putStr(w, buf);
+  }
+
+  for (i = 0, k = 0; i < n_curves; i++)
+  {
+    if ( curves[i].bdry_tag <= k )
+      continue;
+
+    k = curves[i].bdry_tag;
+
+    snprintf(buf, sizeof(buf), "1 %d \"boundary_%d\"\n", 
+             curves[i].bdry_tag, (int) curves[i].bdry->index);
+    tmWriter_putStr(w, buf);
+  }
+
+  snprintf(buf, sizeof(buf), "2 %d \"domain\"\n", TM_MSH_DOMAIN_TAG);
+  tmWriter_putStr(w, buf);
+  tmWriter_putStr(w, "$EndPhysicalNames\n");
+
+  /*-------------------------------------------------------
+  | Entities: one curve for every pair of boundary and
+  | marker, one surface for the whole domain
+  -------------------------------------------------------*/
+  tmWriter_putStr(w, "$Entities\n");
+  tmMesh_putLE(w, 0, 8);
+  tmMesh_putLE(w, (uint64_t) n_curves, 8);
+  tmMesh_putLE(w, 1, 8);
+  tmMesh_putLE(w, 0, 8);
+
+  for (i = 0; i < n_curves; i++)
+  {
+    tmMesh_putLE(w, (uint32_t) (i+1), 4);
+    tmMesh_putMshBox(w, curves[i].xy_min, curves[i].xy_max);
+    tmMesh_putLE(w, 2, 8);
+    tmMesh_putLE(w, (uint32_t) curves[i].marker_tag, 4);
+    tmMesh_putLE(w, (uint32_t) curves[i].bdry_tag, 4);
+    tmMesh_putLE(w, 0, 8);
+  }
+
+  tmMesh_putLE(w, TM_MSH_DOMAIN_TAG, 4);
+  tmMesh_putMshBox(w, mesh->xy_min, mesh->xy_max);
+  tmMesh_putLE(w, 1, 8);
+  tmMesh_putLE(w, TM_MSH_DOMAIN_TAG, 4);
+  tmMesh_putLE(w, 0, 8);
+  tmWriter_putStr(w, "\n$EndEntities\n");
+
+  /*-------------------------------------------------------
+  | Nodes: a single block on the surface with the node 
+  | tags followed by all coordinates
+  -------------------------------------------------------*/
+  tmWriter_putStr(w, "$Nodes\n");
+  tmMesh_putLE(w, 1, 8);
+  tmMesh_putLE(w, n_nodes, 8);
+  tmMesh_putLE(w, (n_nodes > 0) ? 1 : 0, 8);
+  tmMesh_putLE(w, n_nodes, 8);
+
+  tmMesh_putLE(w, 2, 4);
+  tmMesh_putLE(w, TM_MSH_DOMAIN_TAG, 4);
+  tmMesh_putLE(w, 0, 4);
+  tmMesh_putLE(w, n_nodes, 8);
+
+  tmWriter_writeRows(w, mesh->pool, n_nodes, 
+                     tmMesh_writeMshNodeTagRows, NULL);
+  tmWriter_writeRows(w, mesh->pool, n_nodes, 
+                     tmMesh_writeBinNode3DRows, &rows);
+  tmWriter_putStr(w, "\n$EndNodes\n");
+
+  /*-------------------------------------------------------
+  | Elements: triangles with the tags 1 to n_tris, 
+  | followed by one block of lines for every curve
+  -------------------------------------------------------*/
+  tmWriter_putStr(w, "$Elements\n");
+  tmMesh_putLE(w, (uint64_t) n_curves + 1, 8);
+  tmMesh_putLE(w, n_tris + n_bdry, 8);
+  tmMesh_putLE(w, (n_tris + n_bdry > 0) ? 1 : 0, 8);
+  tmMesh_putLE(w, n_tris + n_bdry, 8);
+
+  tmMesh_putLE(w, 2, 4);
+  tmMesh_putLE(w, TM_MSH_DOMAIN_TAG, 4);
+  tmMesh_putLE(w, TM_MSH_TRIANGLE, 4);
+  tmMesh_putLE(w, n_tris, 8);
+
+  tmWriter_writeRows(w, mesh->pool, n_tris, 
+                     tmMesh_writeMshTriRows, &rows);
+
+  elem_tag = n_tris;
+
+  for (i = 0; i < n_curves; i++)
+  {
+    tmMesh_putLE(w, 1, 4);
+    tmMesh_putLE(w, (uint32_t) (i+1), 4);
+    tmMesh_putLE(w, TM_MSH_LINE, 4);
+    tmMesh_putLE(w, curves[i].n_edges, 8);
+
+    for (k = 0; k < rows.n_bdry; k++)
+    {
+      if ( rows.bdrys[k] != curves[i].bdry 
+        || rows.bdry_markers[k] != curves[i].marker )
+        continue;
+
+      elem_tag += 1;
+      tmMesh_putLE(w, elem_tag, 8);
+      tmMesh_putLE(w, (uint64_t) (rows.bdry_nodes[2*k]->index + 1), 8);
+      tmMesh_putLE(w, (uint64_t) (rows.bdry_nodes[2*k+1]->index + 1), 8);
+    }
+  }
+  tmWriter_putStr(w, "\n$EndElements\n");
+
+  ok = tmWriter_destroy(w);
+  check( ok == TRUE, "Failed to write file %s", path);
+
+  tmMeshRows_destroy(&rows);
+  free(curves);
+  free(markers);
+  free(tags);
+
+  return TRUE;
+
+error:
+  tmMeshRows_destroy(&rows);
+  free(curves);
+  free(markers);
+  free(tags);
+  return FALSE;
+
+} /* tmMesh_writeMSH() */
+
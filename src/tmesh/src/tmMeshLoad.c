@@ -0,0 +1,960 @@
+/*
+ * This source file is part of the tmesh library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tmList.h"
+#include "tmesh/tmMesh.h"
+#include "tmesh/tmMeshIO.h"
+#include "tmesh/tmMeshLoad.h"
+#include "tmesh/tmBdry.h"
+#include "tmesh/tmEdge.h"
+#include "tmesh/tmNode.h"
+#include "tmesh/tmTri.h"
+#include "tmesh/tmQtree.h"
+
+/**********************************************************
+* tmMeshData: Mesh arrays, which are read by tmMesh_load()
+**********************************************************/
+typedef struct tmMeshData {
+  int       n_nodes;
+  int       n_tris;
+  int       n_bdry;
+  tmDouble *xy;          /* node coordinates [n_nodes][2]  */
+  int      *tris;        /* triangle nodes   [n_tris][3]   */
+  int      *nbrs;        /* neighbors        [n_tris][3]   */
+  int      *bdry_edges;  /* boundary edges   [n_bdry][2]   */
+  int      *markers;     /* boundary edge markers          */
+  int      *bdry_ids;    /* boundary indices               */
+  int      *bdry_loops;  /* edges with the same loop are   
+                            added to the same boundary     */
+} tmMeshData;
+
+/**********************************************************
+* Function: tmMeshData_reserveBdry()
+*----------------------------------------------------------
+* Resizes the boundary edge arrays of a tmMeshData 
+* structure to n_bdry edges
+*----------------------------------------------------------
+* @return: FALSE, if the memory could not be allocated
+**********************************************************/
+static tmBool tmMeshData_reserveBdry(tmMeshData *data, int n_bdry)
+{
+  int *edges  = (int*) realloc(data->bdry_edges, (2*n_bdry+1) * sizeof(int));
+  check_mem(edges);
+  data->bdry_edges = edges;
+
+  edges = (int*) realloc(data->markers, (n_bdry+1) * sizeof(int));
+  check_mem(edges);
+  data->markers = edges;
+
+  edges = (int*) realloc(data->bdry_ids, (n_bdry+1) * sizeof(int));
+  check_mem(edges);
+  data->bdry_ids = edges;
+
+  edges = (int*) realloc(data->bdry_loops, (n_bdry+1) * sizeof(int));
+  check_mem(edges);
+  data->bdry_loops = edges;
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmMeshData_reserveBdry() */
+
+/**********************************************************
+* Function: tmMeshData_destroy()
+*----------------------------------------------------------
+* Frees the arrays of a tmMeshData structure
+**********************************************************/
+static void tmMeshData_destroy(tmMeshData *data)
+{
+  free(data->xy);
+  free(data->tris);
+  free(data->nbrs);
+  free(data->bdry_edges);
+  free(data->markers);
+  free(data->bdry_ids);
+  free(data->bdry_loops);
+
+} /* tmMeshData_destroy() */
+
+/**********************************************************
+* Function: tmMeshData_hasEdge()
+*----------------------------------------------------------
+* Checks, if the triangle t contains the edge (a,b) in 
+* counter-clockwise direction
+**********************************************************/
+static tmBool tmMeshData_hasEdge(const int *t, int a, int b)
+{
+  return (t[0] == a && t[1] == b) 
+      || (t[1] == a && t[2] == b) 
+      || (t[2] == a && t[0] == b);
+
+} /* tmMeshData_hasEdge() */
+
+/**********************************************************
+* Function: tmMeshData_check()
+*----------------------------------------------------------
+* Checks the indices of the mesh arrays
+*----------------------------------------------------------
+* @return: FALSE, if an index is out of range
+**********************************************************/
+static tmBool tmMeshData_check(tmMeshData *data)
+{
+  int i;
+
+  for (i = 0; i < 3 * data->n_tris; i++)
+  {
+    check( data->tris[i] >= 0 && data->tris[i] < data->n_nodes,
+        "Invalid node index %d of triangle %d.", data->tris[i], i/3);
+    check( data->nbrs[i] >= -1 && data->nbrs[i] < data->n_tris,
+        "Invalid neighbor index %d of triangle %d.", data->nbrs[i], i/3);
+  }
+
+  for (i = 0; i < 2 * data->n_bdry; i++)
+    check( data->bdry_edges[i] >= 0 && data->bdry_edges[i] < data->n_nodes,
+        "Invalid node index %d of boundary edge %d.", 
+        data->bdry_edges[i], i/2);
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmMeshData_check() */
+
+/**********************************************************
+* Function: tmMesh_getLE()
+*----------------------------------------------------------
+* Reads an unsigned integer of nbytes in little-endian 
+* byte order
+**********************************************************/
+static uint64_t tmMesh_getLE(const unsigned char *p, int nbytes)
+{
+  uint64_t v = 0;
+  int i;
+
+  for (i = nbytes-1; i >= 0; i--)
+    v = (v << 8) | p[i];
+
+  return v;
+
+} /* tmMesh_getLE() */
+
+/**********************************************************
+* Function: tmMesh_checkBinHeader()
+*----------------------------------------------------------
+* Reads and validates the header of binary mesh data 
+* (see TM_BIN_MAGIC). The offsets are checked one after 
+* another before the array sizes are compared to their
+* differences, such that no sum of header values can 
+* overflow.
+*----------------------------------------------------------
+* @param buf, len: binary mesh data
+* @param n: returns the numbers of nodes, triangles and
+*           boundary edges
+* @param off: returns the array offsets and the data size
+* @return: FALSE, if the header is invalid
+**********************************************************/
+tmBool tmMesh_checkBinHeader(const unsigned char *buf,
+                             size_t               len,
+                             uint64_t             n[3],
+                             uint64_t             off[7])
+{
+  int i;
+
+  check( len >= TM_BIN_HEADER_SIZE 
+      && memcmp(buf, TM_BIN_MAGIC, 8) == 0,
+      "Invalid binary mesh data.");
+  check( tmMesh_getLE(buf+8, 4) == TM_BIN_VERSION,
+      "Unsupported binary mesh file version.");
+
+  for (i = 0; i < 3; i++)
+    n[i] = tmMesh_getLE(buf + 16 + 8*i, 8);
+  for (i = 0; i < 7; i++)
+    off[i] = tmMesh_getLE(buf + 40 + 8*i, 8);
+
+  check( n[0] < INT32_MAX / 2 && n[1] < INT32_MAX / 3 
+      && n[2] < INT32_MAX / 2,
+      "Invalid binary mesh file header.");
+
+  check( off[0] >= TM_BIN_HEADER_SIZE && off[6] <= len,
+      "Invalid binary mesh file header.");
+
+  for (i = 0; i < 7; i++)
+    check( off[i] % 8 == 0 && ( i == 0 || off[i-1] <= off[i] ),
+        "Invalid binary mesh file header.");
+
+  check( 16 * n[0] <= off[1] - off[0]
+      && 12 * n[1] <= off[2] - off[1]
+      && 12 * n[1] <= off[3] - off[2]
+      &&  8 * n[2] <= off[4] - off[3]
+      &&  4 * n[2] <= off[5] - off[4]
+      &&  4 * n[2] <= off[6] - off[5],
+      "Invalid binary mesh file header.");
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmMesh_checkBinHeader() */
+
+/**********************************************************
+* Function: tmMesh_readFile()
+*----------------------------------------------------------
+* Reads an entire file into a null-terminated buffer
+*----------------------------------------------------------
+* @param path: path of the file
+* @param len: returns the file size
+* @return: buffer, which must be freed by the caller
+**********************************************************/
+static unsigned char *tmMesh_readFile(const char *path, size_t *len)
+{
+  unsigned char *buf = NULL;
+  FILE *fp   = fopen(path, "rb");
+  long  size = -1;
+
+  check( fp != NULL, "Failed to open file %s", path);
+
+  if ( fseek(fp, 0, SEEK_END) == 0 )
+    size = ftell(fp);
+  check( size >= 0, "Failed to read file %s", path);
+  rewind(fp);
+
+  buf = (unsigned char*) malloc(size + 1);
+  check_mem(buf);
+
+  check( fread(buf, 1, size, fp) == (size_t) size,
+      "Failed to read file %s", path);
+
+  buf[size] = '\0';
+  *len      = (size_t) size;
+
+  fclose(fp);
+  return buf;
+
+error:
+  if (fp != NULL)
+    fclose(fp);
+  free(buf);
+  return NULL;
+
+} /* tmMesh_readFile() */
+
+/**********************************************************
+* Function: tmMesh_loadBinary()
+*----------------------------------------------------------
+* Reads the arrays of a binary mesh file 
+* (see TM_BIN_MAGIC). Consecutive boundary edges with 
+* the same boundary index belong to the same boundary.
+*----------------------------------------------------------
+* @param buf, len: file content
+* @param data: tmMeshData structure to fill
+* @return: FALSE, if the file is invalid
+**********************************************************/
+static tmBool tmMesh_loadBinary(const unsigned char *buf, 
+                                size_t               len,
+                                tmMeshData          *data)
+{
+  uint64_t n[3], off[7];
+  int      i, loop;
+
+  if ( tmMesh_checkBinHeader(buf, len, n, off) == FALSE )
+    return FALSE;
+
+  data->n_nodes = (int) n[0];
+  data->n_tris  = (int) n[1];
+  data->n_bdry  = (int) n[2];
+
+  data->xy   = (tmDouble*) malloc( (2*data->n_nodes+1) * sizeof(tmDouble) );
+  data->tris = (int*) malloc( (3*data->n_tris+1) * sizeof(int) );
+  data->nbrs = (int*) malloc( (3*data->n_tris+1) * sizeof(int) );
+  check_mem(data->xy);
+  check_mem(data->tris);
+  check_mem(data->nbrs);
+
+  if ( tmMeshData_reserveBdry(data, data->n_bdry) == FALSE )
+    return FALSE;
+
+  for (i = 0; i < 2 * data->n_nodes; i++)
+  {
+    uint64_t bits = tmMesh_getLE(buf + off[0] + 8*i, 8);
+    double   v;
+
+    memcpy(&v, &bits, 8);
+    data->xy[i] = (tmDouble) v;
+  }
+
+  for (i = 0; i < 3 * data->n_tris; i++)
+  {
+    data->tris[i] = (int32_t) tmMesh_getLE(buf + off[1] + 4*i, 4);
+    data->nbrs[i] = (int32_t) tmMesh_getLE(buf + off[2] + 4*i, 4);
+  }
+
+  for (i = 0, loop = 0; i < data->n_bdry; i++)
+  {
+    data->bdry_edges[2*i]   = (int32_t) tmMesh_getLE(buf + off[3] + 8*i, 4);
+    data->bdry_edges[2*i+1] = (int32_t) tmMesh_getLE(buf + off[3] + 8*i+4, 4);
+    data->markers[i]        = (int32_t) tmMesh_getLE(buf + off[4] + 4*i, 4);
+    data->bdry_ids[i]       = (int32_t) tmMesh_getLE(buf + off[5] + 4*i, 4);
+
+    if ( i > 0 && data->bdry_ids[i] != data->bdry_ids[i-1] )
+      loop += 1;
+
+    data->bdry_loops[i] = loop;
+  }
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmMesh_loadBinary() */
+
+/**********************************************************
+* Function: tmMesh_getBdryLoops()
+*----------------------------------------------------------
+* Creates the boundary edges of a mesh in the format of
+* tmMesh_printMeshIncomflow(), where missing neighbors 
+* are replaced by the negative boundary marker of the 
+* edge. The boundary edges are sorted into closed loops, 
+* which are used as boundaries with the marker of their 
+* first edge as index.
+*----------------------------------------------------------
+* @param data: tmMeshData structure with the nodes,
+*              triangles and neighbors
+* @return: FALSE, if the boundary edges do not form
+*          closed loops
+**********************************************************/
+static tmBool tmMesh_getBdryLoops(tmMeshData *data)
+{
+  int   *edges   = NULL;
+  int   *next    = NULL;
+  tmBool success = FALSE;
+  int    n_bdry  = 0;
+  int    i, j, e, loop;
+
+  /*-------------------------------------------------------
+  | Triangle sides without a valid neighbor, that 
+  | shares this side, are boundary edges
+  -------------------------------------------------------*/
+  for (i = 0; i < 3 * data->n_tris; i++)
+  {
+    int t = data->nbrs[i];
+    int a = data->tris[3*(i/3) + (i%3+1)%3];
+    int b = data->tris[3*(i/3) + (i%3+2)%3];
+
+    if ( t >= 0 && t != i/3 && t < data->n_tris
+      && tmMeshData_hasEdge(&data->tris[3*t], b, a) )
+      continue;
+
+    n_bdry += 1;
+  }
+
+  edges = (int*) malloc( (3*n_bdry+1) * sizeof(int) );
+  next  = (int*) malloc( (data->n_nodes+1) * sizeof(int) );
+  check_mem(edges);
+  check_mem(next);
+
+  if ( tmMeshData_reserveBdry(data, n_bdry) == FALSE )
+    goto error;
+
+  for (i = 0; i < data->n_nodes; i++)
+    next[i] = -1;
+
+  for (i = 0, j = 0; i < 3 * data->n_tris; i++)
+  {
+    int t = data->nbrs[i];
+    int a = data->tris[3*(i/3) + (i%3+1)%3];
+    int b = data->tris[3*(i/3) + (i%3+2)%3];
+
+    if ( t >= 0 && t != i/3 && t < data->n_tris
+      && tmMeshData_hasEdge(&data->tris[3*t], b, a) )
+      continue;
+
+    edges[3*j]   = a;
+    edges[3*j+1] = b;
+    edges[3*j+2] = -t;
+    next[a]      = j;
+
+    data->nbrs[i] = -1;
+    j += 1;
+  }
+
+  /*-------------------------------------------------------
+  | Sort the boundary edges into closed loops 
+  | -> edges[3*e] is set to -1 for sorted edges
+  -------------------------------------------------------*/
+  for (i = 0, loop = 0; i < n_bdry; i++)
+  {
+    if ( edges[3*i] < 0 )
+      continue;
+
+    e = i;
+
+    do
+    {
+      check( e >= 0 && edges[3*e] >= 0,
+          "The boundary edges do not form closed loops.");
+
+      data->bdry_edges[2*data->n_bdry]   = edges[3*e];
+      data->bdry_edges[2*data->n_bdry+1] = edges[3*e+1];
+      data->markers[data->n_bdry]        = edges[3*e+2];
+      data->bdry_ids[data->n_bdry]       = edges[3*i+2];
+      data->bdry_loops[data->n_bdry]     = loop;
+      data->n_bdry += 1;
+
+      edges[3*e] = -1;
+      e = next[edges[3*e+1]];
+
+    } while ( e != i );
+
+    loop += 1;
+  }
+
+  success = TRUE;
+
+error:
+  free(edges);
+  free(next);
+  return success;
+
+} /* tmMesh_getBdryLoops() */
+
+/**********************************************************
+* Function: tmMesh_readWord()
+*----------------------------------------------------------
+* Reads the next section name of a text mesh file
+*----------------------------------------------------------
+* @return: FALSE, if the end of the file is reached
+**********************************************************/
+static tmBool tmMesh_readWord(char **p, char *word, int n_max)
+{
+  int n = 0;
+
+  while ( isspace((unsigned char) **p) )
+    *p += 1;
+
+  if ( **p == '\0' )
+    return FALSE;
+
+  while ( isalpha((unsigned char) **p) && n < n_max-1 )
+  {
+    word[n++] = **p;
+    *p += 1;
+  }
+
+  word[n] = '\0';
+
+  return TRUE;
+
+} /* tmMesh_readWord() */
+
+/**********************************************************
+* Function: tmMesh_readInts()
+*----------------------------------------------------------
+* Reads n integers of a text mesh file
+*----------------------------------------------------------
+* @return: FALSE, if the integers could not be read
+**********************************************************/
+static tmBool tmMesh_readInts(char **p, int *v, int n)
+{
+  int i;
+
+  for (i = 0; i < n; i++)
+  {
+    char *end;
+    long  l = strtol(*p, &end, 10);
+
+    if ( end == *p || l < INT32_MIN || l > INT32_MAX )
+      return FALSE;
+
+    v[i] = (int) l;
+    *p   = end;
+  }
+
+  return TRUE;
+
+} /* tmMesh_readInts() */
+
+/**********************************************************
+* Function: tmMesh_loadText()
+*----------------------------------------------------------
+* Reads the arrays of a text mesh file in the format of
+* tmMesh_printMesh() or tmMesh_printMeshIncomflow().
+*----------------------------------------------------------
+* @param buf: null-terminated file content
+* @param data: tmMeshData structure to fill
+* @return: FALSE, if the file is invalid
+**********************************************************/
+static tmBool tmMesh_loadText(char *buf, tmMeshData *data)
+{
+  char  *p      = buf;
+  tmBool is_inc = TRUE;
+  int    n_loop = 0;
+  char   word[16];
+  int    v[4];
+  int    i, n;
+
+  while ( tmMesh_readWord(&p, word, 16) == TRUE )
+  {
+    check( tmMesh_readInts(&p, &n, 1) == TRUE && n >= 0,
+        "Invalid section %s of text mesh file.", word);
+
+    /*-----------------------------------------------------
+    | Node coordinates: "index  x  y"
+    -----------------------------------------------------*/
+    if ( strcmp(word, "NODES") == 0 && data->xy == NULL )
+    {
+      data->n_nodes = n;
+      data->xy      = (tmDouble*) malloc( (2*n+1) * sizeof(tmDouble) );
+      check_mem(data->xy);
+
+      for (i = 0; i < 2*n; i++)
+      {
+        char *end;
+
+        if ( i % 2 == 0 )
+          check( tmMesh_readInts(&p, v, 1) == TRUE,
+              "Invalid node %d of text mesh file.", i/2);
+
+        data->xy[i] = (tmDouble) strtod(p, &end);
+        check( end != p, "Invalid node %d of text mesh file.", i/2);
+        p = end;
+      }
+    }
+    /*-----------------------------------------------------
+    | Boundary edges: "BOUNDARY  index  n" and 
+    | "i  n1  n2  marker"
+    -----------------------------------------------------*/
+    else if ( strcmp(word, "BOUNDARY") == 0 )
+    {
+      int index = n;
+
+      check( tmMesh_readInts(&p, &n, 1) == TRUE && n >= 0,
+          "Invalid boundary %d of text mesh file.", index);
+
+      if ( tmMeshData_reserveBdry(data, data->n_bdry + n) == FALSE )
+        return FALSE;
+
+      for (i = data->n_bdry; i < data->n_bdry + n; i++)
+      {
+        check( tmMesh_readInts(&p, v, 4) == TRUE,
+            "Invalid boundary edge %d of text mesh file.", i);
+
+        data->bdry_edges[2*i]   = v[1];
+        data->bdry_edges[2*i+1] = v[2];
+        data->markers[i]        = v[3];
+        data->bdry_ids[i]       = index;
+        data->bdry_loops[i]     = n_loop;
+      }
+
+      data->n_bdry += n;
+      n_loop       += 1;
+      is_inc        = FALSE;
+    }
+    /*-----------------------------------------------------
+    | Front edges are not required for a finished mesh
+    -----------------------------------------------------*/
+    else if ( strcmp(word, "FRONT") == 0 )
+    {
+      for (i = 0; i < n; i++)
+        check( tmMesh_readInts(&p, v, 3) == TRUE,
+            "Invalid front edge %d of text mesh file.", i);
+    }
+    /*-----------------------------------------------------
+    | Triangles: "index  n1  n2  n3"
+    -----------------------------------------------------*/
+    else if ( strcmp(word, "TRIANGLES") == 0 && data->tris == NULL )
+    {
+      data->n_tris = n;
+      data->tris   = (int*) malloc( (3*n+1) * sizeof(int) );
+      check_mem(data->tris);
+
+      for (i = 0; i < n; i++)
+      {
+        check( tmMesh_readInts(&p, v, 4) == TRUE,
+            "Invalid triangle %d of text mesh file.", i);
+        memcpy(&data->tris[3*i], &v[1], 3 * sizeof(int));
+      }
+    }
+    /*-----------------------------------------------------
+    | Neighbors: "index  t1  t2  t3"
+    -----------------------------------------------------*/
+    else if ( strcmp(word, "NEIGHBORS") == 0 && data->nbrs == NULL
+           && n == data->n_tris )
+    {
+      data->nbrs = (int*) malloc( (3*n+1) * sizeof(int) );
+      check_mem(data->nbrs);
+
+      for (i = 0; i < n; i++)
+      {
+        check( tmMesh_readInts(&p, v, 4) == TRUE,
+            "Invalid neighbors %d of text mesh file.", i);
+        memcpy(&data->nbrs[3*i], &v[1], 3 * sizeof(int));
+      }
+    }
+    else
+    {
+      log_err("Invalid section %s of text mesh file.", word);
+      return FALSE;
+    }
+  }
+
+  check( data->xy != NULL && data->tris != NULL && data->nbrs != NULL,
+      "Text mesh file misses nodes, triangles or neighbors.");
+
+  /*-------------------------------------------------------
+  | Without boundary sections, the boundary edges are
+  | given by the negative markers of the neighbors
+  -------------------------------------------------------*/
+  if ( is_inc == TRUE )
+    return tmMesh_getBdryLoops(data);
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmMesh_loadText() */
+
+/**********************************************************
+* Function: tmMesh_addQtreeObjs()
+*----------------------------------------------------------
+* Bulk-loads the objects of a stack into a qtree
+*----------------------------------------------------------
+* @return: FALSE, if an object is not added to the qtree
+**********************************************************/
+static tmBool tmMesh_addQtreeObjs(tmQtree *qtree, tmList *stack)
+{
+  tmListNode *cur;
+  void  **objs = (void**) malloc( (stack->count+1) * sizeof(void*) );
+  tmBool  added;
+  int     n = 0;
+
+  check_mem(objs);
+
+  for (cur = stack->first; cur != NULL; cur = cur->next)
+    objs[n++] = cur->value;
+
+  added = tmQtree_addObjs(qtree, objs, n);
+  free(objs);
+
+  return added;
+
+error:
+  return FALSE;
+
+} /* tmMesh_addQtreeObjs() */
+
+/**********************************************************
+* Function: tmMeshData_getSideMarkers()
+*----------------------------------------------------------
+* Returns the markers of the triangle sides without 
+* neighbor. Since boundary edges are refined only on the
+* advancing front, every boundary edge (n1,n2) is 
+* followed along these sides from n1 until n2.
+*----------------------------------------------------------
+* @param data: mesh arrays
+* @param side_markers: markers of the triangle sides
+* @return: FALSE, if the boundary edges do not cover 
+*          the triangle sides without neighbor
+**********************************************************/
+static tmBool tmMeshData_getSideMarkers(tmMeshData *data,
+                                        int        *side_markers)
+{
+  int   *next    = NULL;
+  tmBool success = FALSE;
+  int    n_sides = 0;
+  int    n_found = 0;
+  int    i, s, n;
+
+  next = (int*) malloc( (data->n_nodes+1) * sizeof(int) );
+  check_mem(next);
+
+  for (i = 0; i < data->n_nodes; i++)
+    next[i] = -1;
+
+  for (s = 0; s < 3 * data->n_tris; s++)
+  {
+    if ( data->nbrs[s] >= 0 )
+      continue;
+
+    next[data->tris[3*(s/3) + (s%3+1)%3]] = s;
+    n_sides += 1;
+  }
+
+  for (i = 0; i < data->n_bdry; i++)
+  {
+    n = data->bdry_edges[2*i];
+
+    do
+    {
+      s = next[n];
+      check( s >= 0 && n_found < n_sides,
+          "Boundary edge %d does not match the triangles.", i);
+
+      side_markers[s] = data->markers[i];
+      n_found += 1;
+
+      n = data->tris[3*(s/3) + (s%3+2)%3];
+
+    } while ( n != data->bdry_edges[2*i+1] );
+  }
+
+  check( n_found == n_sides, 
+      "The boundary edges do not match the triangles.");
+
+  success = TRUE;
+
+error:
+  free(next);
+  return success;
+
+} /* tmMeshData_getSideMarkers() */
+
+/**********************************************************
+* Function: tmMesh_createFromData()
+*----------------------------------------------------------
+* Creates a mesh from the arrays of tmMeshData. 
+* All objects are created without the qtrees, which are 
+* bulk-loaded at the end.
+*----------------------------------------------------------
+* @param data: mesh arrays
+* @param mesh: created mesh
+* @return: FALSE, if the mesh arrays are not consistent
+**********************************************************/
+static tmBool tmMesh_createFromData(tmMeshData *data, tmMesh *mesh)
+{
+  tmListNode *cur;
+  tmNode    **nodes = NULL;
+  tmTri     **tris  = NULL;
+  tmBdry     *bdry  = NULL;
+  int        *markers = NULL;
+  tmBool      success = FALSE;
+  int         i, j, k;
+
+  nodes   = (tmNode**) malloc( (data->n_nodes+1) * sizeof(tmNode*) );
+  tris    = (tmTri**)  malloc( (data->n_tris+1)  * sizeof(tmTri*) );
+  markers = (int*)     malloc( (3*data->n_tris+1) * sizeof(int) );
+  check_mem(nodes);
+  check_mem(tris);
+  check_mem(markers);
+
+  if ( tmMeshData_getSideMarkers(data, markers) == FALSE )
+    goto error;
+
+  mesh->qtree_defer = TRUE;
+
+  for (i = 0; i < data->n_nodes; i++)
+    nodes[i] = tmNode_create(mesh, &data->xy[2*i]);
+
+  /*-------------------------------------------------------
+  | Boundaries -> counter-clockwise loops are exterior
+  -------------------------------------------------------*/
+  for (i = 0; i < data->n_bdry; i = j)
+  {
+    tmDouble area = 0.0;
+
+    for (j = i; j < data->n_bdry 
+             && data->bdry_loops[j] == data->bdry_loops[i]; j++)
+    {
+      tmDouble *xy1 = &data->xy[2*data->bdry_edges[2*j]];
+      tmDouble *xy2 = &data->xy[2*data->bdry_edges[2*j+1]];
+      area += xy1[0] * xy2[1] - xy1[1] * xy2[0];
+    }
+
+    bdry = tmMesh_addBdry(mesh, area < 0.0, data->bdry_ids[i]);
+
+    for (k = i; k < j; k++)
+      tmBdry_edgeCreate(bdry, 
+                        nodes[data->bdry_edges[2*k]],
+                        nodes[data->bdry_edges[2*k+1]],
+                        data->markers[k], 1.0);
+  }
+
+  /*-------------------------------------------------------
+  | Triangles
+  -------------------------------------------------------*/
+  for (i = 0; i < data->n_tris; i++)
+  {
+    int *t = &data->tris[3*i];
+
+    tris[i] = tmTri_create(mesh, nodes[t[0]], nodes[t[1]], nodes[t[2]]);
+    check( tris[i] != NULL && tris[i]->area > 0.0,
+        "Triangle %d is not defined counter-clockwise.", i);
+  }
+
+  /*-------------------------------------------------------
+  | Triangle neighbors and mesh edges: 
+  | Side k of a triangle is opposite to its node k and 
+  | each edge is created by the triangle to its left, 
+  | whose index is lower than its neighbor's index
+  -------------------------------------------------------*/
+  for (i = 0; i < data->n_tris; i++)
+  {
+    tmTri *nbrs[3];
+
+    for (k = 0; k < 3; k++)
+    {
+      int     t  = data->nbrs[3*i+k];
+      tmNode *n1 = nodes[data->tris[3*i+(k+1)%3]];
+      tmNode *n2 = nodes[data->tris[3*i+(k+2)%3]];
+
+      if ( t < 0 )
+      {
+        nbrs[k] = tris[i];
+        tmMesh_edgeCreate(mesh, n1, n2, tris[i], NULL, markers[3*i+k]);
+        continue;
+      }
+
+      check( tmMeshData_hasEdge(&data->tris[3*t], n2->index, n1->index),
+          "Triangle %d is not a neighbor of triangle %d.", t, i);
+
+      nbrs[k] = tris[t];
+
+      if ( t > i )
+        tmMesh_edgeCreate(mesh, n1, n2, tris[i], tris[t], -1);
+    }
+
+    tris[i]->t1 = nbrs[0];
+    tris[i]->t2 = nbrs[1];
+    tris[i]->t3 = nbrs[2];
+  }
+
+  /*-------------------------------------------------------
+  | Bulk-load the qtrees 
+  -------------------------------------------------------*/
+  mesh->qtree_defer = FALSE;
+
+  check( tmMesh_addQtreeObjs(mesh->nodes_qtree, mesh->nodes_stack)
+      && tmMesh_addQtreeObjs(mesh->edges_qtree, mesh->edges_stack)
+      && tmMesh_addQtreeObjs(mesh->tris_qtree,  mesh->tris_stack),
+      "Failed to add mesh objects to the qtrees.");
+
+  for (cur = mesh->bdry_stack->first; cur != NULL; cur = cur->next)
+  {
+    bdry = (tmBdry*) cur->value;
+
+    check( tmMesh_addQtreeObjs(bdry->edges_qtree, bdry->edges_stack),
+        "Failed to add boundary edges to the qtrees.");
+
+    tmBdry_initSizeFun(bdry);
+  }
+
+  tmMesh_resetSizes(mesh);
+
+  /*-------------------------------------------------------
+  | Compare mesh area to triangle areas
+  -------------------------------------------------------*/
+  tmMesh_calcArea(mesh);
+
+  check( mesh->areaBdry > 0.0 
+      && fabs(mesh->areaTris - mesh->areaBdry) / mesh->areaBdry < 1e-5,
+      "Mesh area %.5f does not equal to sum of triangle area %.5f", 
+      mesh->areaBdry, mesh->areaTris);
+
+  success = TRUE;
+
+error:
+  mesh->qtree_defer = FALSE;
+  free(nodes);
+  free(tris);
+  free(markers);
+  return success;
+
+} /* tmMesh_createFromData() */
+
+/**********************************************************
+* Function: tmMesh_load()
+*----------------------------------------------------------
+* Creates a mesh from the binary output of 
+* tmMesh_writeBinary() or from the text output of 
+* tmMesh_printMesh() / tmMesh_printMeshIncomflow().
+*----------------------------------------------------------
+* @param path: path of the mesh file
+* @param qtree_max_obj: max. number of qtree objects
+* @param globSize: global element size
+* @param sizeFunUser: user-defined size function
+* @return: the mesh or NULL, if the file is invalid
+**********************************************************/
+tmMesh *tmMesh_load(const char    *path,
+                    int            qtree_max_obj,
+                    tmDouble       globSize,
+                    tmSizeFunUser  sizeFunUser)
+{
+  tmMeshData     data;
+  tmMesh        *mesh = NULL;
+  unsigned char *buf  = NULL;
+  size_t         len  = 0;
+  tmBool         ok;
+  tmDouble       xy_min[2], xy_max[2], dxy;
+  int            i;
+
+  memset(&data, 0, sizeof(tmMeshData));
+
+  buf = tmMesh_readFile(path, &len);
+  check( buf != NULL, "Failed to load mesh %s", path);
+
+  if ( len >= 8 && memcmp(buf, TM_BIN_MAGIC, 8) == 0 )
+    ok = tmMesh_loadBinary(buf, len, &data);
+  else
+    ok = tmMesh_loadText((char*) buf, &data);
+
+  free(buf);
+  buf = NULL;
+
+  check( ok == TRUE && tmMeshData_check(&data) == TRUE 
+      && data.n_nodes > 0,
+      "Failed to load mesh %s", path);
+
+  /*-------------------------------------------------------
+  | The qtrees cover the bounding box of the nodes
+  | with a small margin
+  -------------------------------------------------------*/
+  xy_min[0] = xy_max[0] = data.xy[0];
+  xy_min[1] = xy_max[1] = data.xy[1];
+
+  for (i = 1; i < data.n_nodes; i++)
+  {
+    xy_min[0] = MIN(xy_min[0], data.xy[2*i]);
+    xy_min[1] = MIN(xy_min[1], data.xy[2*i+1]);
+    xy_max[0] = MAX(xy_max[0], data.xy[2*i]);
+    xy_max[1] = MAX(xy_max[1], data.xy[2*i+1]);
+  }
+
+  dxy = 0.01 * MAX(xy_max[0] - xy_min[0], xy_max[1] - xy_min[1]);
+  xy_min[0] -= dxy;
+  xy_min[1] -= dxy;
+  xy_max[0] += dxy;
+  xy_max[1] += dxy;
+
+  mesh = tmMesh_create(xy_min, xy_max, qtree_max_obj, 
+                       globSize, sizeFunUser);
+  check( mesh != NULL, "Failed to create mesh.");
+
+  check( tmMesh_createFromData(&data, mesh) == TRUE,
+      "Failed to load mesh %s", path);
+
+  tmMeshData_destroy(&data);
+
+  return mesh;
+
+error:
+  free(buf);
+  tmMeshData_destroy(&data);
+  if (mesh != NULL)
+    tmMesh_destroy(mesh);
+  return NULL;
+
+} /* tmMesh_load() */
@@ -14,6 +14,7 @@
 #include "tmesh/tmQtree.h"
 #include "tmesh/tmBdry.h"
 #include "tmesh/tmFront.h"
+#include "tmesh/tmAtomic.h"
 
 #include <stdlib.h>
 
@@ -41,6 +42,7 @@ tmNode *tmNode_create(tmMesh *mesh, tmDouble xy[2])
   node->xy[0]     = xy[0];
   node->xy[1]     = xy[1];
   node->index     = mesh->no_nodes;
+  node->stream_index = -1;
   node->is_active = TRUE;
 
   /*-------------------------------------------------------
@@ -267,10 +269,8 @@ int tmNode_compareDblBuf(tmNode *n1, tmNode *n2)
 **********************************************************/
 tmList *tmNode_getNbrsFromSizeFun(tmNode *node)
 {
-  tmSizeFun sizeFun = node->mesh->sizeFun;
   tmDouble *xy      = node->xy;
-  tmMesh   *mesh    = node->mesh;
-  tmDouble  r       = TM_NODE_NBR_DIST_FAC*sizeFun(mesh,xy);
+  tmDouble  r       = TM_NODE_NBR_DIST_FAC*tmNode_getSize(node);
 
   tmList *inCirc = tmQtree_getObjCirc(node->mesh->nodes_qtree,
                                     node->xy,
@@ -284,9 +284,17 @@ tmList *tmNode_getNbrsFromSizeFun(tmNode *node)
 
   /*-------------------------------------------------------
   | Sort neighbors by distance to node
-  | -> Distance to node is already buffered in dblBuf 
-  |    of node by tmQtree_getObjCirc()
+  | -> Distance to node is buffered in dblBuf 
   -------------------------------------------------------*/
+  tmListNode *cur;
+
+  for (cur = inCirc->first; cur != NULL; cur = cur->next)
+  {
+    tmNode *n = (tmNode*) cur->value;
+    n->dblBuf = (n->xy[0]-xy[0])*(n->xy[0]-xy[0]) 
+              + (n->xy[1]-xy[1])*(n->xy[1]-xy[1]);
+  }
+
   tmList *inCirc_sorted;
   inCirc_sorted = tmList_merge_sort(inCirc,
                         (tmList_compare) tmNode_compareDblBuf);
@@ -383,8 +391,7 @@ tmBool tmNode_isValid(tmNode *node)
   tmDouble fac = TM_NODE_EDGE_DIST_FAC;
 
   tmMesh   *mesh    = node->mesh;
-  tmSizeFun sizeFun = mesh->sizeFun;
-  tmDouble  r       = sizeFun(mesh, node->xy);
+  tmDouble  r       = tmNode_getSize(node);
 
   tmDouble  dist    = r * fac;
   tmDouble  dist2   = dist * dist;
@@ -508,3 +515,39 @@ tmBool tmNode_isValid(tmNode *node)
 } /* tmNode_isValid() */
 
 
+
+/**********************************************************
+* Function: tmNode_getSize()
+*----------------------------------------------------------
+* Returns the value of the size function at a node. 
+* The value is evaluated once and cached on the node, 
+* until the node is moved or the size function changes
+* (see tmMesh_resetSizes()).
+* The function may be called concurrently.
+*----------------------------------------------------------
+* @param node: pointer to node
+* @return: size function value at the node
+**********************************************************/
+tmDouble tmNode_getSize(tmNode *node)
+{
+  tmMesh  *mesh = node->mesh;
+  tmDouble size;
+
+  /*-------------------------------------------------------
+  | Concurrent callers compute the same value, hence 
+  | relaxed atomic accesses are sufficient
+  -------------------------------------------------------*/
+  size = tmAtomic_loadDouble(&node->size);
+
+  if ( size > 0.0 )
+  {
+    tmAtomic_addLong(&mesh->n_size_saved, 1);
+    return size;
+  }
+
+  size = mesh->sizeFun(mesh, node->xy);
+  tmAtomic_storeDouble(&node->size, size);
+
+  return size;
+
+} /* tmNode_getSize() */
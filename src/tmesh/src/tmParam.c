@@ -5,6 +5,15 @@
  * Refer to the accompanying documentation for details
  * on usage and license.
  */
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
 #include "tmesh/dbg.h"
 #include "tmesh/bstrlib.h"
 #include "tmesh/tmParam.h"
@@ -255,6 +264,7 @@ struct bstrList *tmParam_removeComments(struct bstrList *txtlist,
       if ( fnd > 0)
       {
         btrunc(fl_ptr[i], fnd);
+        hits += 1;
         marker[i] = i;
       }
       else
@@ -840,3 +850,855 @@ error:
 
 } /* tmParam_readIntBdryData() */
 
+
+
+/*************************************************************
+* Exact powers of ten for the fast path of 
+* tmParam_parseDouble()
+*************************************************************/
+static const double tmParam_pow10[] = {
+  1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,
+  1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19,
+  1e20, 1e21, 1e22 };
+
+/*************************************************************
+* Tokenizer states of a mapped parameter file
+*************************************************************/
+enum { TM_PARAM_NONE, TM_PARAM_NODES, 
+       TM_PARAM_EXT_BDRY, TM_PARAM_INT_BDRY };
+
+/*************************************************************
+* Function: tmParam_nextLine()
+*------------------------------------------------------------
+* Returns the next line of the text in [*pos, end) without 
+* its comment and newline in <line>, <len> and moves *pos 
+* to the beginning of the following line
+* @return: FALSE, if there are no more lines
+*************************************************************/
+tmBool tmParam_nextLine(const char **pos, const char *end,
+                        const char **line, long *len)
+{
+  const char *str = *pos;
+  const char *eol, *cmt;
+
+  if ( str >= end )
+    return FALSE;
+
+  eol = memchr(str, '\n', (size_t) (end - str));
+  if ( eol == NULL )
+    eol = end;
+
+  cmt = memchr(str, '#', (size_t) (eol - str));
+
+  *line = str;
+  *len  = (cmt != NULL ? cmt : eol) - str;
+  *pos  = (eol < end) ? eol + 1 : end;
+
+  return TRUE;
+
+} /* tmParam_nextLine() */
+
+/*************************************************************
+* Function: tmParam_findStr()
+*------------------------------------------------------------
+* Searches for the string <fltr> in a line of length <len>
+* @return: pointer behind the first occurence of <fltr> or
+*          NULL, if it is not found
+*************************************************************/
+const char *tmParam_findStr(const char *line, long len,
+                            const char *fltr)
+{
+  const long  n   = (long) strlen(fltr);
+  const char *str = line;
+  const char *end = line + len - n;
+
+  if ( n == 0 || len < n )
+    return NULL;
+
+  while ( str <= end )
+  {
+    str = memchr(str, fltr[0], (size_t) (end - str + 1));
+
+    if ( str == NULL )
+      return NULL;
+
+    if ( memcmp(str, fltr, (size_t) n) == 0 )
+      return str + n;
+
+    str++;
+  }
+
+  return NULL;
+
+} /* tmParam_findStr() */
+
+/*************************************************************
+* Function: tmParam_skipSpace()
+*------------------------------------------------------------
+* Moves the pointer str behind all whitespaces in [str, end)
+*************************************************************/
+static inline const char *tmParam_skipSpace(const char *str, 
+                                            const char *end)
+{
+  while ( str < end && isspace((unsigned char) *str) )
+    str++;
+
+  return str;
+
+} /* tmParam_skipSpace() */
+
+/*************************************************************
+* Function: tmParam_parseDouble()
+*------------------------------------------------------------
+* Parses a floating point number from the text in 
+* [*pos, end) and moves *pos behind it. 
+* The result equals the one of strtod() for decimal 
+* numbers.
+*
+* Numbers with up to 15 significant digits and a decimal 
+* exponent of at most 22 are exactly representable and 
+* are computed by a single multiplication or division, 
+* which is correctly rounded (Clinger's fast path). 
+* All other numbers are passed to strtod().
+*
+* @return: FALSE, if there is no valid number
+*************************************************************/
+tmBool tmParam_parseDouble(const char **pos, const char *end,
+                           tmDouble *value)
+{
+  const char *str   = tmParam_skipSpace(*pos, end);
+  const char *start = str;
+
+  unsigned long long mant = 0;
+  int    n_digits = 0;
+  int    n_read   = 0;
+  int    exp10    = 0;
+  tmBool neg      = FALSE;
+  double v;
+
+  if ( str < end && (*str == '+' || *str == '-') )
+  {
+    neg = (*str == '-');
+    str++;
+  }
+
+  /*---------------------------------------------------------
+  | Integer and fraction digits, leading zeros are not 
+  | significant
+  ---------------------------------------------------------*/
+  for ( ; str < end && isdigit((unsigned char) *str); str++)
+  {
+    if ( mant > 0 || *str != '0' )
+    {
+      if ( n_digits < 19 )
+        mant = 10 * mant + (unsigned long long) (*str - '0');
+      else
+        exp10++;
+      n_digits++;
+    }
+    n_read++;
+  }
+
+  if ( str < end && *str == '.' )
+  {
+    for (str++; str < end && isdigit((unsigned char) *str); str++)
+    {
+      if ( mant > 0 || *str != '0' )
+      {
+        if ( n_digits < 19 )
+        {
+          mant = 10 * mant + (unsigned long long) (*str - '0');
+          exp10--;
+        }
+        n_digits++;
+      }
+      else
+        exp10--;
+      n_read++;
+    }
+  }
+
+  if ( n_read == 0 )
+    return FALSE;
+
+  /*---------------------------------------------------------
+  | Exponent, which is only part of the number if it 
+  | contains digits
+  ---------------------------------------------------------*/
+  if ( str < end && (*str == 'e' || *str == 'E') )
+  {
+    const char *exp_str = str + 1;
+    tmBool      exp_neg = FALSE;
+    int         e       = 0;
+
+    if ( exp_str < end && (*exp_str == '+' || *exp_str == '-') )
+    {
+      exp_neg = (*exp_str == '-');
+      exp_str++;
+    }
+
+    if ( exp_str < end && isdigit((unsigned char) *exp_str) )
+    {
+      for ( ; exp_str < end && isdigit((unsigned char) *exp_str); 
+            exp_str++)
+        if ( e < 100000 )
+          e = 10 * e + (*exp_str - '0');
+
+      exp10 += exp_neg ? -e : e;
+      str    = exp_str;
+    }
+  }
+
+  /*---------------------------------------------------------
+  | Fast path or strtod() for all other numbers
+  ---------------------------------------------------------*/
+  if ( mant == 0 )
+    v = 0.0;
+  else if ( n_digits <= 15 && exp10 >= -22 && exp10 <= 22 )
+  {
+    v = (double) mant;
+    if ( exp10 < 0 )
+      v /= tmParam_pow10[-exp10];
+    else
+      v *= tmParam_pow10[exp10];
+  }
+  else
+  {
+    /*-------------------------------------------------------
+    | strtod() needs a terminated copy of the number, which
+    | is only allocated for very long numbers
+    -------------------------------------------------------*/
+    char  buf[128];
+    char *num = buf;
+    const long n = (long) (str - start);
+
+    if ( n >= (long) sizeof(buf) )
+    {
+      num = (char*) malloc( (size_t) n + 1 );
+      check_mem(num);
+    }
+
+    memcpy(num, start, (size_t) n);
+    num[n] = '\0';
+
+    *value = strtod(num, NULL);
+    *pos   = str;
+
+    if ( num != buf )
+      free(num);
+
+    return TRUE;
+  }
+
+  *value = neg ? -v : v;
+  *pos   = str;
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmParam_parseDouble() */
+
+/*************************************************************
+* Function: tmParam_parseInt()
+*------------------------------------------------------------
+* Parses an integer from the text in [*pos, end) and moves 
+* *pos behind it
+* @return: FALSE, if there is no valid integer
+*************************************************************/
+tmBool tmParam_parseInt(const char **pos, const char *end,
+                        int *value)
+{
+  const char *str = tmParam_skipSpace(*pos, end);
+  tmBool    neg = FALSE;
+  long long v   = 0;
+
+  if ( str < end && (*str == '+' || *str == '-') )
+  {
+    neg = (*str == '-');
+    str++;
+  }
+
+  if ( str >= end || !isdigit((unsigned char) *str) )
+    return FALSE;
+
+  for ( ; str < end && isdigit((unsigned char) *str); str++)
+  {
+    v = 10 * v + (*str - '0');
+
+    if ( v > (long long) INT_MAX + 1 )
+      return FALSE;
+  }
+
+  if ( neg == FALSE && v > INT_MAX )
+    return FALSE;
+
+  *value = (int) (neg ? -v : v);
+  *pos   = str;
+
+  return TRUE;
+
+} /* tmParam_parseInt() */
+
+/*************************************************************
+* Function: tmParam_parseSep()
+*------------------------------------------------------------
+* Moves *pos behind the separator <sep>, which may be 
+* surrounded by whitespaces. Use sep = '\0' to check for 
+* the end of the text.
+* @return: FALSE, if the separator is not found
+*************************************************************/
+static inline tmBool tmParam_parseSep(const char **pos, 
+                                      const char *end,
+                                      char sep)
+{
+  const char *str = tmParam_skipSpace(*pos, end);
+
+  if ( sep == '\0' )
+    return (str == end);
+
+  if ( str >= end || *str != sep )
+    return FALSE;
+
+  *pos = str + 1;
+
+  return TRUE;
+
+} /* tmParam_parseSep() */
+
+/*************************************************************
+* Function: tmParamFile_addParam()
+*------------------------------------------------------------
+* Adds a line to the parameter lines of a mapped file
+*************************************************************/
+static tmBool tmParamFile_addParam(tmParamFile *file,
+                                   const char *line, long len)
+{
+  if ( file->nParams == file->sizeParams )
+  {
+    int size = (file->sizeParams > 0) ? 2*file->sizeParams : 64;
+    tmParamLine *params = realloc(file->params, 
+                                  size * sizeof(tmParamLine));
+    check_mem(params);
+
+    file->params     = params;
+    file->sizeParams = size;
+  }
+
+  file->params[file->nParams].str = line;
+  file->params[file->nParams].len = len;
+  file->nParams++;
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmParamFile_addParam() */
+
+/*************************************************************
+* Function: tmParamFile_addNode()
+*------------------------------------------------------------
+* Parses the node coordinates "x, y" of a line into the 
+* node array of a mapped file
+*************************************************************/
+static tmBool tmParamFile_addNode(tmParamFile *file,
+                                  const char *str, 
+                                  const char *end)
+{
+  if ( file->nNodes == file->sizeNodes )
+  {
+    int size = (file->sizeNodes > 0) ? 2*file->sizeNodes : 1024;
+    tmDouble (*nodes)[2] = realloc(file->nodes, 
+                                   size * 2 * sizeof(tmDouble));
+    check_mem(nodes);
+
+    file->nodes     = nodes;
+    file->sizeNodes = size;
+  }
+
+  tmDouble *xy = file->nodes[file->nNodes];
+
+  if ( tmParam_parseDouble(&str, end, &xy[0]) == FALSE 
+    || tmParam_parseSep(&str, end, ',')       == FALSE
+    || tmParam_parseDouble(&str, end, &xy[1]) == FALSE 
+    || tmParam_parseSep(&str, end, '\0')      == FALSE )
+    return FALSE;
+
+  file->nNodes++;
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmParamFile_addNode() */
+
+/*************************************************************
+* Function: tmParamBdry_addEdge()
+*------------------------------------------------------------
+* Parses the edge "iStart, iEnd, edgeMarker, edgeRefinement"
+* of a line into the edge arrays of a boundary
+*************************************************************/
+static tmBool tmParamBdry_addEdge(tmParamBdry *bdry,
+                                  const char *str, 
+                                  const char *end)
+{
+  if ( bdry->nEdges == bdry->size )
+  {
+    int size = (bdry->size > 0) ? 2*bdry->size : 256;
+    int     (*edges)[2]  = realloc(bdry->edges, 
+                                   size * 2 * sizeof(int));
+    check_mem(edges);
+    bdry->edges = edges;
+
+    int      *marker     = realloc(bdry->edgeMarker, 
+                                   size * sizeof(int));
+    check_mem(marker);
+    bdry->edgeMarker = marker;
+
+    tmDouble *refine     = realloc(bdry->edgeRefine, 
+                                   size * sizeof(tmDouble));
+    check_mem(refine);
+    bdry->edgeRefine = refine;
+
+    bdry->size = size;
+  }
+
+  const int i = bdry->nEdges;
+
+  if ( tmParam_parseInt(&str, end, &bdry->edges[i][0])   == FALSE 
+    || tmParam_parseSep(&str, end, ',')                  == FALSE
+    || tmParam_parseInt(&str, end, &bdry->edges[i][1])   == FALSE 
+    || tmParam_parseSep(&str, end, ',')                  == FALSE
+    || tmParam_parseInt(&str, end, &bdry->edgeMarker[i]) == FALSE 
+    || tmParam_parseSep(&str, end, ',')                  == FALSE
+    || tmParam_parseDouble(&str, end, &bdry->edgeRefine[i])==FALSE 
+    || tmParam_parseSep(&str, end, '\0')                 == FALSE )
+    return FALSE;
+
+  bdry->nEdges++;
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmParamBdry_addEdge() */
+
+/*************************************************************
+* Function: tmParamFile_startBdry()
+*------------------------------------------------------------
+* Starts a new boundary definition, whose marker follows
+* the start identifier in [str, end)
+* @return: the new boundary or NULL on errors
+*************************************************************/
+static tmParamBdry *tmParamFile_startBdry(tmParamFile *file,
+                                          tmBool is_interior,
+                                          const char *str,
+                                          const char *end)
+{
+  tmParamBdry *bdry;
+
+  if ( is_interior == FALSE )
+  {
+    check( file->hasExtBdry == FALSE, 
+        "Multiple exterior boundary definitions.");
+    file->hasExtBdry = TRUE;
+    bdry = &file->extBdry;
+  }
+  else
+  {
+    if ( file->nIntBdrys == file->sizeIntBdrys )
+    {
+      int size = (file->sizeIntBdrys > 0) ? 
+                 2*file->sizeIntBdrys : 8;
+      tmParamBdry *bdrys = realloc(file->intBdrys, 
+                                   size * sizeof(tmParamBdry));
+      check_mem(bdrys);
+
+      file->intBdrys     = bdrys;
+      file->sizeIntBdrys = size;
+    }
+
+    bdry = &file->intBdrys[file->nIntBdrys++];
+    memset(bdry, 0, sizeof(tmParamBdry));
+  }
+
+  check( tmParam_parseInt(&str, end, &bdry->marker) == TRUE &&
+         tmParam_parseSep(&str, end, '\0') == TRUE,
+      "Wrong boundary marker definition.");
+
+  return bdry;
+
+error:
+  return NULL;
+
+} /* tmParamFile_startBdry() */
+
+/*************************************************************
+* Function: tmParamFile_tokenize()
+*------------------------------------------------------------
+* Reads all lines of a mapped parameter file in a single 
+* pass. Lines between "Define nodes:" and "End nodes" are
+* parsed as node coordinates, lines between 
+* "Define exterior/interior boundary:" and 
+* "End exterior/interior boundary" as boundary edges. 
+* All other non-empty lines are stored as parameter lines.
+*************************************************************/
+static tmBool tmParamFile_tokenize(tmParamFile *file)
+{
+  const char  *pos   = file->data;
+  const char  *end   = file->data + file->length;
+  const char  *line, *str, *eol, *fnd;
+  long         len;
+  int          state = TM_PARAM_NONE;
+  int          lnum  = 0;
+  tmParamBdry *bdry  = NULL;
+
+  while ( tmParam_nextLine(&pos, end, &line, &len) == TRUE )
+  {
+    lnum++;
+
+    str = tmParam_skipSpace(line, line + len);
+    eol = line + len;
+
+    if ( str == eol )
+      continue;
+
+    /*-------------------------------------------------------
+    | Node coordinates and boundary edges
+    -------------------------------------------------------*/
+    if ( state != TM_PARAM_NONE &&
+         ( isdigit((unsigned char) *str) || *str == '-' || 
+           *str == '+' || *str == '.' ) )
+    {
+      if ( state == TM_PARAM_NODES )
+      {
+        check( tmParamFile_addNode(file, str, eol) == TRUE,
+            "Wrong definition for node coordinates in line %d.",
+            lnum);
+      }
+      else
+      {
+        check( tmParamBdry_addEdge(bdry, str, eol) == TRUE,
+            "Wrong definition for boundary edge in line %d.",
+            lnum);
+      }
+      continue;
+    }
+
+    if ( state == TM_PARAM_NODES )
+    {
+      check( tmParam_findStr(str, eol-str, "End nodes") != NULL, 
+          "Wrong definition for node coordinates in line %d.",
+          lnum);
+      state = TM_PARAM_NONE;
+      continue;
+    }
+
+    if ( state == TM_PARAM_EXT_BDRY || state == TM_PARAM_INT_BDRY )
+    {
+      const char *bdry_end = (state == TM_PARAM_EXT_BDRY) ? 
+                             "End exterior boundary" : 
+                             "End interior boundary";
+
+      check( tmParam_findStr(str, eol-str, bdry_end) != NULL, 
+          "Wrong definition for boundary edge in line %d.",
+          lnum);
+      state = TM_PARAM_NONE;
+      continue;
+    }
+
+    /*-------------------------------------------------------
+    | Start of definitions or parameter line
+    -------------------------------------------------------*/
+    if ( tmParam_findStr(str, eol-str, "Define nodes:") != NULL )
+    {
+      state = TM_PARAM_NODES;
+    }
+    else if ( (fnd = tmParam_findStr(str, eol-str, 
+                     "Define exterior boundary:")) != NULL )
+    {
+      bdry = tmParamFile_startBdry(file, FALSE, fnd, eol);
+      check( bdry != NULL, "Wrong definition in line %d.", lnum);
+      state = TM_PARAM_EXT_BDRY;
+    }
+    else if ( (fnd = tmParam_findStr(str, eol-str, 
+                     "Define interior boundary:")) != NULL )
+    {
+      bdry = tmParamFile_startBdry(file, TRUE, fnd, eol);
+      check( bdry != NULL, "Wrong definition in line %d.", lnum);
+      state = TM_PARAM_INT_BDRY;
+    }
+    else
+    {
+      check( tmParamFile_addParam(file, line, len) == TRUE,
+          "Failed to read line %d.", lnum);
+    }
+  }
+
+  check( state == TM_PARAM_NONE, 
+      "Missing end of node or boundary definition.");
+
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmParamFile_tokenize() */
+
+/*************************************************************
+* Function: tmParamFile_create()
+*------------------------------------------------------------
+* Maps the parameter file at file_path into memory and 
+* reads its node and boundary definitions in a single pass
+* @return: NULL on errors
+*************************************************************/
+tmParamFile *tmParamFile_create(const char *file_path)
+{
+  struct stat  st;
+  tmParamFile *file = NULL;
+  int          fd   = -1;
+
+  file = calloc(1, sizeof(tmParamFile));
+  check_mem(file);
+
+  file->path = file_path;
+
+  fd = open(file_path, O_RDONLY);
+  check( fd >= 0, "Failed to open %s.", file_path);
+  check( fstat(fd, &st) == 0, "Failed to access %s.", file_path);
+
+  file->length = (long) st.st_size;
+
+  if ( file->length > 0 )
+  {
+    void *data = mmap(NULL, (size_t) file->length, PROT_READ, 
+                      MAP_PRIVATE, fd, 0);
+    check( data != MAP_FAILED, "Failed to map %s.", file_path);
+
+    posix_madvise(data, (size_t) file->length, 
+                  POSIX_MADV_SEQUENTIAL);
+    file->data = (const char*) data;
+    file->mapped = TRUE;
+  }
+
+  close(fd);
+  fd = -1;
+
+  check( tmParamFile_tokenize(file) == TRUE, 
+      "Failed to read %s.", file_path);
+
+  return file;
+
+error:
+  if ( fd >= 0 )
+    close(fd);
+  tmParamFile_destroy(file);
+  return NULL;
+
+} /* tmParamFile_create() */
+
+/*************************************************************
+* Function: tmParamFile_createFromString()
+*------------------------------------------------------------
+* Reads the node and boundary definitions of the parameter
+* file content in data, which must persist until the file 
+* is destroyed
+* @return: NULL on errors
+*************************************************************/
+tmParamFile *tmParamFile_createFromString(const char *data,
+                                          long        length)
+{
+  tmParamFile *file = calloc(1, sizeof(tmParamFile));
+  check_mem(file);
+
+  file->path   = "<string>";
+  file->data   = data;
+  file->length = length;
+  file->mapped = FALSE;
+
+  check( tmParamFile_tokenize(file) == TRUE, 
+      "Failed to read parameter file content.");
+
+  return file;
+
+error:
+  tmParamFile_destroy(file);
+  return NULL;
+
+} /* tmParamFile_createFromString() */
+
+/*************************************************************
+* Function: tmParamFile_destroy()
+*------------------------------------------------------------
+* Unmaps the parameter file and frees all its data
+*************************************************************/
+void tmParamFile_destroy(tmParamFile *file)
+{
+  int i;
+
+  if ( file == NULL )
+    return;
+
+  if ( file->mapped == TRUE )
+    munmap((void*) file->data, (size_t) file->length);
+
+  for (i = 0; i < file->nIntBdrys; i++)
+  {
+    free(file->intBdrys[i].edges);
+    free(file->intBdrys[i].edgeMarker);
+    free(file->intBdrys[i].edgeRefine);
+  }
+
+  free(file->extBdry.edges);
+  free(file->extBdry.edgeMarker);
+  free(file->extBdry.edgeRefine);
+  free(file->intBdrys);
+  free(file->nodes);
+  free(file->params);
+  free(file);
+
+} /* tmParamFile_destroy() */
+
+/*************************************************************
+* Function: tmParamFile_findParam()
+*------------------------------------------------------------
+* Searches for the last parameter line, which contains the 
+* specifier <fltr> and stores the text behind it in 
+* [*str, *end)
+* @return: the number of lines with the specifier
+*************************************************************/
+static int tmParamFile_findParam(tmParamFile *file,
+                                 const char  *fltr,
+                                 const char **str,
+                                 const char **end)
+{
+  int nfound = 0;
+  int i;
+
+  for (i = file->nParams-1; i >= 0; i--)
+  {
+    const tmParamLine *line = &file->params[i];
+    const char *fnd = tmParam_findStr(line->str, line->len, fltr);
+
+    if ( fnd == NULL )
+      continue;
+
+    if ( nfound == 0 )
+    {
+      *str = fnd;
+      *end = line->str + line->len;
+    }
+
+    nfound++;
+  }
+
+  return nfound;
+
+} /* tmParamFile_findParam() */
+
+/*************************************************************
+* Function: tmParamFile_extractParam()
+*------------------------------------------------------------
+* Same as tmParam_extractParam() for a mapped file
+*************************************************************/
+int tmParamFile_extractParam(tmParamFile *file,
+                             const char *fltr, int type,
+                             void *value)
+{
+  const char *str = NULL;
+  const char *end = NULL;
+  char        buf[128];
+  long        n;
+
+  int nfound = tmParamFile_findParam(file, fltr, &str, &end);
+
+  if ( nfound == 0 )
+    return 0;
+
+  if ( type == 2 )
+  {
+    *(bstring*)value = blk2bstr(str, (int) (end - str));
+    check_mem( *(bstring*)value );
+    return nfound;
+  }
+
+  n = MIN( (long) (end - str), (long) sizeof(buf) - 1 );
+  memcpy(buf, str, (size_t) n);
+  buf[n] = '\0';
+
+  if (type == 0)
+    *(int*)value = atoi(buf);
+  else if (type == 1)
+    *(double*)value = atof(buf);
+  else
+    sentinel("Wrong type definition.");
+
+  return nfound;
+
+error:
+  return -1;
+
+} /* tmParamFile_extractParam() */
+
+/*************************************************************
+* Function: tmParamFile_extractArray()
+*------------------------------------------------------------
+* Same as tmParam_extractArray() for a mapped file, where
+* only integers (type = 0) and doubles (type = 1) are 
+* supported. The number of values is stored in <n>.
+*************************************************************/
+int tmParamFile_extractArray(tmParamFile *file,
+                             const char *fltr, int type,
+                             void *value, int *n)
+{
+  const char *str = NULL;
+  const char *end = NULL;
+  const char *cur;
+  void       *array = NULL;
+  int         n_val = 1;
+  int         i;
+
+  int nfound = tmParamFile_findParam(file, fltr, &str, &end);
+
+  if ( nfound == 0 )
+    return 0;
+
+  check( type == 0 || type == 1, "Wrong type definition.");
+
+  for (cur = str; cur < end; cur++)
+    if ( *cur == ',' )
+      n_val++;
+
+  array = calloc(n_val, (type == 0) ? sizeof(int) : sizeof(double));
+  check_mem(array);
+
+  for (i = 0; i < n_val; i++)
+  {
+    tmBool ok = (type == 0) ? 
+                tmParam_parseInt(&str, end, &((int*)array)[i]) :
+                tmParam_parseDouble(&str, end, &((double*)array)[i]);
+
+    check( ok == TRUE && 
+           tmParam_parseSep(&str, end, 
+                            (i < n_val-1) ? ',' : '\0') == TRUE,
+        "Wrong definition of parameter <%s>", fltr);
+  }
+
+  if (type == 0)
+    *(int**)value = (int*) array;
+  else
+    *(double**)value = (double*) array;
+
+  *n = n_val;
+
+  return nfound;
+
+error:
+  free(array);
+  return -1;
+
+} /* tmParamFile_extractArray() */
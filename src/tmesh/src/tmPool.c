@@ -0,0 +1,281 @@
+/*
+ * This source file is part of the tmesh library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tmPool.h"
+
+/**********************************************************
+* Function: tmPool_nextChunk()
+*----------------------------------------------------------
+* Fetch the next chunk of loop indices of the current job
+*----------------------------------------------------------
+* @param pool: tmPool structure
+* @param i_beg, i_end: the fetched index range
+* @return: FALSE if no indices are left
+**********************************************************/
+static tmBool tmPool_nextChunk(tmPool *pool, 
+                               size_t *i_beg, size_t *i_end)
+{
+  tmBool found = FALSE;
+
+  pthread_mutex_lock(&pool->lock);
+
+  if ( pool->next < pool->n )
+  {
+    *i_beg      = pool->next;
+    *i_end      = MIN(pool->next + pool->chunk, pool->n);
+    pool->next  = *i_end;
+    found       = TRUE;
+  }
+
+  pthread_mutex_unlock(&pool->lock);
+
+  return found;
+
+} /* tmPool_nextChunk() */
+
+/**********************************************************
+* Function: tmPool_runChunks()
+*----------------------------------------------------------
+* Process chunks of the current job, until all indices 
+* have been fetched
+*----------------------------------------------------------
+* @param pool: tmPool structure
+* @param thread_id: id of the calling thread
+**********************************************************/
+static void tmPool_runChunks(tmPool *pool, int thread_id)
+{
+  size_t i_beg, i_end;
+
+  while ( tmPool_nextChunk(pool, &i_beg, &i_end) == TRUE )
+    pool->fun(pool->data, i_beg, i_end, thread_id);
+
+} /* tmPool_runChunks() */
+
+/**********************************************************
+* Worker thread arguments
+**********************************************************/
+typedef struct tmPoolWorker {
+  tmPool *pool;
+  int     thread_id;
+} tmPoolWorker;
+
+/**********************************************************
+* Function: tmPool_worker()
+*----------------------------------------------------------
+* Main loop of a worker thread: Wait for a new job, 
+* process its chunks and report back
+*----------------------------------------------------------
+* @param arg: tmPoolWorker structure
+**********************************************************/
+static void *tmPool_worker(void *arg)
+{
+  tmPoolWorker *worker = (tmPoolWorker*) arg;
+  tmPool       *pool   = worker->pool;
+  int           id     = worker->thread_id;
+
+  unsigned long job_done = 0;
+
+  free(worker);
+
+  while (TRUE)
+  {
+    pthread_mutex_lock(&pool->lock);
+
+    while ( pool->shutdown == FALSE && pool->job_id == job_done )
+      pthread_cond_wait(&pool->work_cond, &pool->lock);
+
+    if ( pool->shutdown == TRUE )
+    {
+      pthread_mutex_unlock(&pool->lock);
+      break;
+    }
+
+    job_done = pool->job_id;
+    pthread_mutex_unlock(&pool->lock);
+
+    tmPool_runChunks(pool, id);
+
+    pthread_mutex_lock(&pool->lock);
+    pool->n_busy -= 1;
+    if ( pool->n_busy == 0 )
+      pthread_cond_signal(&pool->done_cond);
+    pthread_mutex_unlock(&pool->lock);
+  }
+
+  return NULL;
+
+} /* tmPool_worker() */
+
+/**********************************************************
+* Function: tmPool_create()
+*----------------------------------------------------------
+* Create a new tmPool structure with n_threads-1 worker
+* threads and return a pointer to it.
+* The calling thread takes part in every parallel loop.
+* On errors, the started worker threads are joined again.
+*----------------------------------------------------------
+* @param n_threads: total number of threads
+* @return: Pointer to a new tmPool structure
+**********************************************************/
+tmPool *tmPool_create(int n_threads)
+{
+  tmPool *pool = NULL;
+  int i;
+
+  check( n_threads > 0, "Invalid number of threads: %d", 
+      n_threads);
+
+  pool = (tmPool*) calloc( 1, sizeof(tmPool) );
+  check_mem(pool);
+
+  /*-------------------------------------------------------
+  | n_threads counts the started threads, such that 
+  | tmPool_destroy() joins exactly these
+  -------------------------------------------------------*/
+  pool->n_threads = 1;
+  pool->job_id    = 0;
+  pool->n_busy    = 0;
+  pool->shutdown  = FALSE;
+
+  pthread_mutex_init(&pool->lock, NULL);
+  pthread_cond_init(&pool->work_cond, NULL);
+  pthread_cond_init(&pool->done_cond, NULL);
+
+  pool->threads = (pthread_t*) calloc(n_threads, sizeof(pthread_t));
+  check_mem(pool->threads);
+
+  /*-------------------------------------------------------
+  | Thread 0 is the calling thread 
+  -------------------------------------------------------*/
+  for (i = 1; i < n_threads; i++)
+  {
+    tmPoolWorker *worker = malloc( sizeof(tmPoolWorker) );
+    check_mem(worker);
+
+    worker->pool      = pool;
+    worker->thread_id = i;
+
+    if ( pthread_create(&pool->threads[i], NULL, 
+                        tmPool_worker, worker) != 0 )
+    {
+      free(worker);
+      log_warn("Could only create %d of %d threads", 
+          i, n_threads);
+      break;
+    }
+
+    pool->n_threads = i + 1;
+  }
+
+  return pool;
+error:
+  tmPool_destroy(pool);
+  return NULL;
+
+} /* tmPool_create() */
+
+/**********************************************************
+* Function: tmPool_destroy()
+*----------------------------------------------------------
+* Joins all worker threads and frees the tmPool memory
+*----------------------------------------------------------
+* @param *pool: pointer to a tmPool to destroy
+**********************************************************/
+void tmPool_destroy(tmPool *pool)
+{
+  int i;
+
+  if ( pool == NULL )
+    return;
+
+  pthread_mutex_lock(&pool->lock);
+  pool->shutdown = TRUE;
+  pthread_cond_broadcast(&pool->work_cond);
+  pthread_mutex_unlock(&pool->lock);
+
+  for (i = 1; i < pool->n_threads; i++)
+    pthread_join(pool->threads[i], NULL);
+
+  pthread_mutex_destroy(&pool->lock);
+  pthread_cond_destroy(&pool->work_cond);
+  pthread_cond_destroy(&pool->done_cond);
+
+  free(pool->threads);
+  free(pool);
+
+} /* tmPool_destroy() */
+
+/**********************************************************
+* Function: tmPool_parallelFor()
+*----------------------------------------------------------
+* Processes the loop indices [0, n) in parallel.
+* Threads fetch chunks of indices dynamically, hence 
+* the loop body must not depend on the order in which 
+* chunks are processed. The function returns, when all 
+* indices have been processed.
+* If pool is NULL, the loop is processed serially.
+*----------------------------------------------------------
+* @param *pool: pointer to a tmPool (may be NULL)
+* @param n: number of loop indices
+* @param chunk: number of indices fetched at once
+* @param fun: loop body
+* @param data: data passed to the loop body
+**********************************************************/
+void tmPool_parallelFor(tmPool   *pool,
+                        size_t    n,
+                        size_t    chunk,
+                        tmPoolFun fun,
+                        void     *data)
+{
+  if ( n == 0 )
+    return;
+
+  if ( chunk < 1 )
+    chunk = 1;
+
+  /*-------------------------------------------------------
+  | Small loops are not worth waking up the workers
+  -------------------------------------------------------*/
+  if ( pool == NULL || pool->n_threads < 2 || n <= chunk )
+  {
+    fun(data, 0, n, 0);
+    return;
+  }
+
+  /*-------------------------------------------------------
+  | Publish job and wake up workers
+  -------------------------------------------------------*/
+  pthread_mutex_lock(&pool->lock);
+
+  pool->fun    = fun;
+  pool->data   = data;
+  pool->n      = n;
+  pool->chunk  = chunk;
+  pool->next   = 0;
+  pool->n_busy = pool->n_threads - 1;
+  pool->job_id += 1;
+
+  pthread_cond_broadcast(&pool->work_cond);
+  pthread_mutex_unlock(&pool->lock);
+
+  /*-------------------------------------------------------
+  | Calling thread takes part in the job
+  -------------------------------------------------------*/
+  tmPool_runChunks(pool, 0);
+
+  /*-------------------------------------------------------
+  | Wait for all workers to finish
+  -------------------------------------------------------*/
+  pthread_mutex_lock(&pool->lock);
+
+  while ( pool->n_busy > 0 )
+    pthread_cond_wait(&pool->done_cond, &pool->lock);
+
+  pthread_mutex_unlock(&pool->lock);
+
+} /* tmPool_parallelFor() */
@@ -562,6 +562,206 @@ tmBool tmQtree_addObj(tmQtree *qtree, void *obj)
 
 } /* tmQtree_addObj() */
 
+/**********************************************************
+* Function: tmQtree_getObjXY()
+*----------------------------------------------------------
+* Returns the coordinates of an object of the qtree
+*----------------------------------------------------------
+* @param qtree: tmQtree structure
+* @param obj:   object of the qtree
+**********************************************************/
+static tmDouble *tmQtree_getObjXY(tmQtree *qtree, void *obj)
+{
+  if ( qtree->obj_type == TM_NODE)
+    return ((tmNode*)obj)->xy;
+  else if ( qtree->obj_type == TM_EDGE)
+    return ((tmEdge*)obj)->xy;
+  else if ( qtree->obj_type == TM_TRI)
+    return ((tmTri*)obj)->xy;
+
+  log_err("Wrong type provied for tmQtree_getObjXY()");
+  return NULL;
+
+} /* tmQtree_getObjXY() */
+
+/**********************************************************
+* Function: tmQtree_getQuadrant()
+*----------------------------------------------------------
+* Returns the child of a qtree, which receives an object
+* from tmQtree_addObj(): 0: NE, 1: NW, 2: SW, 3: SE
+*----------------------------------------------------------
+* @param qtree: tmQtree structure
+* @param xy:    object coordinates
+**********************************************************/
+static int tmQtree_getQuadrant(tmQtree *qtree, tmDouble *xy)
+{
+  if ( xy[0] >= qtree->xy[0] && xy[1] >= qtree->xy[1] )
+    return 0;
+  if ( xy[0] <= qtree->xy[0] && xy[1] >= qtree->xy[1] )
+    return 1;
+  if ( xy[0] <= qtree->xy[0] )
+    return 2;
+
+  return 3;
+
+} /* tmQtree_getQuadrant() */
+
+/**********************************************************
+* Function: tmQtree_bulkAdd()
+*----------------------------------------------------------
+* Adds n objects, which are located within the bbox of
+* the qtree. The objects are partitioned in place into 
+* the quadrants of the qtree, which is only splitted, 
+* if the objects do not fit into it as a whole.
+*----------------------------------------------------------
+* @param qtree: tmQtree structure
+* @param objs:  array of objects to add
+* @param n:     number of objects
+**********************************************************/
+static void tmQtree_bulkAdd(tmQtree *qtree, void **objs, int n)
+{
+  tmQtree *children[4];
+  int      n_quad[4] = { 0, 0, 0, 0 };
+  int      beg[4], nxt[4];
+  int      i, k;
+
+  if ( n == 0 )
+    return;
+
+  /*-------------------------------------------------------
+  | Add all objects to this leaf
+  -------------------------------------------------------*/
+  if ( qtree->is_splitted == FALSE 
+    && qtree->n_obj + n <= qtree->max_obj )
+  {
+    tmQtree *p = qtree->parent;
+
+    for (i = 0; i < n; i++)
+    {
+      tmList_push(qtree->obj, objs[i]);
+
+      if ( qtree->obj_type == TM_NODE)
+      {
+        ((tmNode*)objs[i])->qtree_pos = tmList_last_node(qtree->obj);
+        ((tmNode*)objs[i])->qtree     = qtree;
+      }
+      else if ( qtree->obj_type == TM_EDGE)
+      {
+        ((tmEdge*)objs[i])->qtree_pos = tmList_last_node(qtree->obj);
+        ((tmEdge*)objs[i])->qtree     = qtree;
+      }
+      else
+      {
+        ((tmTri*)objs[i])->qtree_pos = tmList_last_node(qtree->obj);
+        ((tmTri*)objs[i])->qtree     = qtree;
+      }
+    }
+
+    qtree->n_obj     += n;
+    qtree->n_obj_tot += n;
+
+    while (p != NULL)
+    {
+      p->n_obj_tot += n;
+      p = p->parent;
+    }
+
+    return;
+  }
+
+  if ( qtree->is_splitted == FALSE )
+    tmQtree_split(qtree);
+
+  /*-------------------------------------------------------
+  | Partition the objects in place into the quadrants
+  -------------------------------------------------------*/
+  for (i = 0; i < n; i++)
+    n_quad[ tmQtree_getQuadrant(qtree, 
+                tmQtree_getObjXY(qtree, objs[i])) ] += 1;
+
+  beg[0] = 0;
+  for (k = 1; k < 4; k++)
+    beg[k] = beg[k-1] + n_quad[k-1];
+
+  for (k = 0; k < 4; k++)
+    nxt[k] = beg[k];
+
+  for (k = 0; k < 4; k++)
+  {
+    while ( nxt[k] < beg[k] + n_quad[k] )
+    {
+      void *obj = objs[nxt[k]];
+      int   q   = tmQtree_getQuadrant(qtree, 
+                      tmQtree_getObjXY(qtree, obj));
+
+      if ( q == k )
+      {
+        nxt[k] += 1;
+        continue;
+      }
+
+      objs[nxt[k]] = objs[nxt[q]];
+      objs[nxt[q]] = obj;
+      nxt[q] += 1;
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Add the partitions to the children
+  -------------------------------------------------------*/
+  children[0] = qtree->child_NE;
+  children[1] = qtree->child_NW;
+  children[2] = qtree->child_SW;
+  children[3] = qtree->child_SE;
+
+  for (k = 0; k < 4; k++)
+    tmQtree_bulkAdd(children[k], &objs[beg[k]], n_quad[k]);
+
+} /* tmQtree_bulkAdd() */
+
+/**********************************************************
+* Function: tmQtree_addObjs()
+*----------------------------------------------------------
+* Adds an array of objects to the qtree at once. 
+* In contrast to tmQtree_addObj(), every object is only
+* moved down the qtree once and leaves are only splitted 
+* once, which makes it suited for the bulk-loading 
+* of an entire mesh.
+* The order of the array is changed.
+*----------------------------------------------------------
+* @param qtree: tmQtree structure
+* @param objs:  array of objects to add
+* @param n:     number of objects
+* @return: FALSE, if objects were located outside of the 
+*          qtree's bbox -> these are not added
+**********************************************************/
+tmBool tmQtree_addObjs(tmQtree *qtree, void **objs, int n)
+{
+  int i;
+  int n_in = 0;
+
+  /*-------------------------------------------------------
+  | Move objects within the qtree's bbox to the front
+  -------------------------------------------------------*/
+  for (i = 0; i < n; i++)
+  {
+    tmDouble *xy = tmQtree_getObjXY(qtree, objs[i]);
+
+    if ( IN_ON_BBOX(xy, qtree->xy_min, qtree->xy_max) )
+    {
+      void *obj   = objs[n_in];
+      objs[n_in]  = objs[i];
+      objs[i]     = obj;
+      n_in       += 1;
+    }
+  }
+
+  tmQtree_bulkAdd(qtree, objs, n_in);
+
+  return (n_in == n);
+
+} /* tmQtree_addObjs() */
+
 
 /**********************************************************
 * Function: tmQtree_remObj()
@@ -697,6 +897,121 @@ tmBool tmQtree_remObj(tmQtree *qtree, void *obj)
 
 } /* tmQtree_remObj() */
 
+/**********************************************************
+* Function: tmQtree_detachObj()
+*----------------------------------------------------------
+* Detach an object from its qtree leaf, if its coordinates
+* have left the bounding box of this leaf. 
+* The leaf is not merged with its siblings, since these 
+* may still contain objects with outdated locations.
+*----------------------------------------------------------
+* @param qtree: root tmQtree structure
+* @param obj:   object to detach from the qtree
+* @return: TRUE if the object has been detached
+**********************************************************/
+tmBool tmQtree_detachObj(tmQtree *qtree, void *obj)
+{
+  tmDouble    *xy;
+  tmQtree    **leaf;
+  tmListNode **pos;
+
+  if ( qtree->obj_type == TM_NODE)
+  {
+    xy   =  ((tmNode*)obj)->xy;
+    leaf = &((tmNode*)obj)->qtree;
+    pos  = &((tmNode*)obj)->qtree_pos;
+  }
+  else if ( qtree->obj_type == TM_EDGE)
+  {
+    xy   =  ((tmEdge*)obj)->xy;
+    leaf = &((tmEdge*)obj)->qtree;
+    pos  = &((tmEdge*)obj)->qtree_pos;
+  }
+  else if ( qtree->obj_type == TM_TRI)
+  {
+    xy   =  ((tmTri*)obj)->xy;
+    leaf = &((tmTri*)obj)->qtree;
+    pos  = &((tmTri*)obj)->qtree_pos;
+  }
+  else
+  {
+    log_err("Wrong type provied for tmQtree_detachObj()");
+    return FALSE;
+  }
+
+  /*-------------------------------------------------------
+  | Object is already detached or did not leave the 
+  | bounding box of its leaf
+  -------------------------------------------------------*/
+  if ( *leaf == NULL || *pos == NULL )
+    return FALSE;
+
+  if ( IN_ON_BBOX(xy, (*leaf)->xy_min, (*leaf)->xy_max) )
+    return FALSE;
+
+  /*-------------------------------------------------------
+  | Detach object from its leaf 
+  -------------------------------------------------------*/
+  tmList_remove((*leaf)->obj, *pos);
+  (*leaf)->n_obj     -= 1;
+  (*leaf)->n_obj_tot -= 1;
+
+  tmQtree *p = (*leaf)->parent;
+  while (p != NULL)
+  {
+    p->n_obj_tot -= 1;
+    p = p->parent;
+  }
+
+  *leaf = NULL;
+  *pos  = NULL;
+
+  return TRUE;
+
+} /* tmQtree_detachObj() */
+
+/**********************************************************
+* Function: tmQtree_updateObj()
+*----------------------------------------------------------
+* Relocate an object within the qtree after its 
+* coordinates have changed. 
+* Nothing is done, if the object is still located in the
+* bounding box of its current qtree leaf. Otherwise it 
+* is detached from its leaf and inserted again, starting
+* from the given root qtree.
+* Inserting may split leaves, hence all other objects of 
+* the qtree must be located within their leaves. If 
+* several objects have been moved, all of them must be
+* detached with tmQtree_detachObj() first.
+*----------------------------------------------------------
+* @param qtree: root tmQtree structure
+* @param obj:   object to relocate in the qtree
+**********************************************************/
+tmBool tmQtree_updateObj(tmQtree *qtree, void *obj)
+{
+  tmQtree *leaf;
+
+  tmQtree_detachObj(qtree, obj);
+
+  if ( qtree->obj_type == TM_NODE)
+    leaf = ((tmNode*)obj)->qtree;
+  else if ( qtree->obj_type == TM_EDGE)
+    leaf = ((tmEdge*)obj)->qtree;
+  else if ( qtree->obj_type == TM_TRI)
+    leaf = ((tmTri*)obj)->qtree;
+  else
+  {
+    log_err("Wrong type provied for tmQtree_updateObj()");
+    return FALSE;
+  }
+
+  if ( leaf != NULL )
+    return TRUE;
+
+  return tmQtree_addObj(qtree, obj);
+
+} /* tmQtree_updateObj() */
+
 /**********************************************************
 * Function: tmQtree_getObjNo()
 *----------------------------------------------------------
@@ -892,7 +1207,10 @@ tmList *tmQtree_getObjBbox(tmQtree *qtree,
 * Function: tmQtree_getObjCirc()
 *----------------------------------------------------------
 * Return a list of objects that are contained within
-* a specified circle 
+* a specified circle.
+* The qtree and its objects are not modified, such that
+* concurrent queries are safe, as long as no objects are
+* added or removed at the same time.
 *----------------------------------------------------------
 * @param qtree: tmQtree structure to initialize
 * @param xy: circle centroid
@@ -973,19 +1291,7 @@ tmList *tmQtree_getObjCirc(tmQtree *qtree,
       const tmBool in_circ = dist2 <= r2 ? TRUE : FALSE;
 
       if (in_circ == TRUE)
-      {
         tmList_push(obj_found, cur->value);
-
-        /* Buffer distance of object to centroid */
-        if ( qtree->obj_type == TM_NODE)
-          ((tmNode*)cur->value)->dblBuf = dist2;
-        else if ( qtree->obj_type == TM_EDGE)
-          ((tmEdge*)cur->value)->dblBuf = dist2;
-        else if ( qtree->obj_type == TM_TRI)
-          ((tmTri*)cur->value)->dblBuf = dist2;
-        else
-          log_err("Wrong type provied for tmQtree_getObjCirc()");
-      }
     }
   }
 
@@ -0,0 +1,629 @@
+/*
+ * This source file is part of the tmesh library.  
+ * This code was written by Florian Setzwein in 2020, 
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#include <stdlib.h>
+
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tmList.h"
+#include "tmesh/tmMesh.h"
+#include "tmesh/tmRenumber.h"
+#include "tmesh/tmEdge.h"
+#include "tmesh/tmNode.h"
+#include "tmesh/tmTri.h"
+
+/**********************************************************
+* tmRenumberItem: Sort key of a node or triangle for the
+*                 mesh renumbering
+**********************************************************/
+typedef struct tmRenumberItem {
+  unsigned long  key[2];
+  int            pos;    /* Position in the mesh list     */
+  void          *obj;
+} tmRenumberItem;
+
+/**********************************************************
+* Function: tmRenumberItem_compare()
+*----------------------------------------------------------
+* Compares two items by their keys. Items with equal keys
+* keep their order in the mesh list.
+**********************************************************/
+static int tmRenumberItem_compare(const void *a, const void *b)
+{
+  const tmRenumberItem *ia = (const tmRenumberItem*) a;
+  const tmRenumberItem *ib = (const tmRenumberItem*) b;
+  int i;
+
+  for (i = 0; i < 2; i++)
+    if ( ia->key[i] != ib->key[i] )
+      return ( ia->key[i] < ib->key[i] ) ? -1 : 1;
+
+  return ia->pos - ib->pos;
+
+} /* tmRenumberItem_compare() */
+
+/**********************************************************
+* Function: tmMesh_hilbertKey()
+*----------------------------------------------------------
+* Returns the position of a coordinate along a Hilbert 
+* curve with 2^TM_HILBERT_BITS cells per axis, which 
+* covers the mesh bounding box
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param xy: coordinate
+**********************************************************/
+static unsigned long tmMesh_hilbertKey(tmMesh *mesh, tmDouble xy[2])
+{
+  const unsigned long n = 1UL << TM_HILBERT_BITS;
+  unsigned long c[2], s, rx, ry, t;
+  unsigned long d = 0;
+  int i;
+
+  for (i = 0; i < 2; i++)
+  {
+    tmDouble dx = mesh->xy_max[i] - mesh->xy_min[i];
+    tmDouble r  = ( dx > 0.0 ) ? (xy[i] - mesh->xy_min[i]) / dx : 0.0;
+
+    r    = MAX(0.0, MIN(1.0, r));
+    c[i] = (unsigned long) ( r * (tmDouble) (n-1) );
+  }
+
+  for (s = n/2; s > 0; s /= 2)
+  {
+    rx = ( (c[0] & s) > 0 );
+    ry = ( (c[1] & s) > 0 );
+    d += s * s * ( (3 * rx) ^ ry );
+
+    /*-----------------------------------------------------
+    | Rotate the quadrant
+    -----------------------------------------------------*/
+    if ( ry == 0 )
+    {
+      if ( rx == 1 )
+      {
+        c[0] = n-1 - c[0];
+        c[1] = n-1 - c[1];
+      }
+      t    = c[0];
+      c[0] = c[1];
+      c[1] = t;
+    }
+  }
+
+  return d;
+
+} /* tmMesh_hilbertKey() */
+
+/**********************************************************
+* Function: tmMesh_orderHilbert()
+*----------------------------------------------------------
+* Sorts the mesh nodes along a Hilbert curve
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param **nodes: returns all mesh nodes in their new 
+*                 order
+* @return: FALSE, if the memory can not be allocated
+**********************************************************/
+static tmBool tmMesh_orderHilbert(tmMesh *mesh, tmNode **nodes)
+{
+  tmListNode     *cur;
+  tmRenumberItem *items;
+  int i = 0;
+
+  items = (tmRenumberItem*) calloc(mesh->no_nodes+1, 
+                                   sizeof(tmRenumberItem));
+  check_mem(items);
+
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmNode *node = (tmNode*) cur->value;
+
+    items[i].key[0] = tmMesh_hilbertKey(mesh, node->xy);
+    items[i].pos    = i;
+    items[i].obj    = node;
+    i += 1;
+  }
+
+  qsort(items, mesh->no_nodes, sizeof(tmRenumberItem), 
+        tmRenumberItem_compare);
+
+  for (i = 0; i < mesh->no_nodes; i++)
+    nodes[i] = (tmNode*) items[i].obj;
+
+  free(items);
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmMesh_orderHilbert() */
+
+/**********************************************************
+* Function: tmMesh_compareInt()
+*----------------------------------------------------------
+* Compares two integers for qsort()
+**********************************************************/
+static int tmMesh_compareInt(const void *a, const void *b)
+{
+  return *(const int*) a - *(const int*) b;
+}
+
+/**********************************************************
+* Function: tmMesh_calcAdjacency()
+*----------------------------------------------------------
+* Computes the node adjacency of the mesh triangles in
+* compressed row format. Rows and columns refer to the 
+* node indices.
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param **adj_beg: returns the row offsets (no_nodes+1)
+* @param **adj: returns the adjacent nodes of all rows
+* @return: FALSE, if the memory can not be allocated
+**********************************************************/
+static tmBool tmMesh_calcAdjacency(tmMesh *mesh, 
+                                   int   **adj_beg,
+                                   int   **adj)
+{
+  tmListNode *cur;
+  int *beg, *pos, *cols;
+  int i, j, k, n_beg;
+
+  beg  = (int*) calloc(mesh->no_nodes+1, sizeof(int));
+  pos  = (int*) calloc(mesh->no_nodes+1, sizeof(int));
+  cols = (int*) calloc(6*mesh->no_tris+1, sizeof(int));
+  check_mem(beg);
+  check_mem(pos);
+  check_mem(cols);
+
+  /*-------------------------------------------------------
+  | Every triangle connects each of its nodes to the 
+  | two others - shared edges are removed afterwards
+  -------------------------------------------------------*/
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *tri = (tmTri*) cur->value;
+    beg[tri->n1->index+1] += 2;
+    beg[tri->n2->index+1] += 2;
+    beg[tri->n3->index+1] += 2;
+  }
+
+  for (i = 0; i < mesh->no_nodes; i++)
+  {
+    beg[i+1] += beg[i];
+    pos[i]    = beg[i];
+  }
+
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *tri = (tmTri*) cur->value;
+    int    n[3];
+
+    n[0] = tri->n1->index;
+    n[1] = tri->n2->index;
+    n[2] = tri->n3->index;
+
+    for (i = 0; i < 3; i++)
+    {
+      cols[pos[n[i]]++] = n[(i+1)%3];
+      cols[pos[n[i]]++] = n[(i+2)%3];
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Sort the rows and remove duplicate entries
+  -------------------------------------------------------*/
+  k = 0;
+  n_beg = 0;
+
+  for (i = 0; i < mesh->no_nodes; i++)
+  {
+    int i_end = beg[i+1];
+
+    qsort(&cols[n_beg], i_end-n_beg, sizeof(int), 
+          tmMesh_compareInt);
+
+    beg[i] = k;
+
+    for (j = n_beg; j < i_end; j++)
+      if ( j == n_beg || cols[j] != cols[j-1] )
+        cols[k++] = cols[j];
+
+    n_beg = i_end;
+  }
+  beg[mesh->no_nodes] = k;
+
+  free(pos);
+
+  *adj_beg = beg;
+  *adj     = cols;
+
+  return TRUE;
+
+error:
+  free(beg);
+  free(pos);
+  free(cols);
+  return FALSE;
+
+} /* tmMesh_calcAdjacency() */
+
+/**********************************************************
+* Function: tmMesh_levelStructure()
+*----------------------------------------------------------
+* Traverses the connected nodes of a start node in 
+* breadth-first order and stores their level
+*----------------------------------------------------------
+* @param beg, adj: node adjacency
+* @param start: start node
+* @param level: returns the level of all traversed nodes,
+*               all other entries must be -1
+* @param queue: returns the traversed nodes
+* @param n_queue: returns the number of traversed nodes
+* @return: the number of levels
+**********************************************************/
+static int tmMesh_levelStructure(int *beg, int *adj, int start,
+                                 int *level, int *queue,
+                                 int *n_queue)
+{
+  int head = 0;
+  int n    = 0;
+  int j;
+
+  level[start] = 0;
+  queue[n++]   = start;
+
+  while ( head < n )
+  {
+    int v = queue[head++];
+
+    for (j = beg[v]; j < beg[v+1]; j++)
+    {
+      if ( level[adj[j]] < 0 )
+      {
+        level[adj[j]] = level[v] + 1;
+        queue[n++]    = adj[j];
+      }
+    }
+  }
+
+  *n_queue = n;
+
+  return level[queue[n-1]] + 1;
+
+} /* tmMesh_levelStructure() */
+
+/**********************************************************
+* Function: tmMesh_peripheralNode()
+*----------------------------------------------------------
+* Returns a pseudo-peripheral node of the connected 
+* nodes of a start node (George and Liu)
+*----------------------------------------------------------
+* @param beg, adj: node adjacency
+* @param start: start node
+* @param level, queue: work arrays, all entries of level
+*                      must be -1
+**********************************************************/
+static int tmMesh_peripheralNode(int *beg, int *adj, int start,
+                                 int *level, int *queue)
+{
+  int n_levels, n_queue, i;
+
+  n_levels = tmMesh_levelStructure(beg, adj, start, 
+                                   level, queue, &n_queue);
+
+  while ( TRUE )
+  {
+    /*-----------------------------------------------------
+    | Choose the node with the lowest degree from the 
+    | last level
+    -----------------------------------------------------*/
+    int cand = queue[n_queue-1];
+    int n_cand_levels;
+
+    for (i = n_queue-1; i >= 0 && level[queue[i]] == n_levels-1; i--)
+      if ( beg[queue[i]+1]-beg[queue[i]] <= beg[cand+1]-beg[cand] )
+        cand = queue[i];
+
+    for (i = 0; i < n_queue; i++)
+      level[queue[i]] = -1;
+
+    n_cand_levels = tmMesh_levelStructure(beg, adj, cand, 
+                                          level, queue, &n_queue);
+
+    if ( n_cand_levels <= n_levels )
+      break;
+
+    start    = cand;
+    n_levels = n_cand_levels;
+  }
+
+  for (i = 0; i < n_queue; i++)
+    level[queue[i]] = -1;
+
+  return start;
+
+} /* tmMesh_peripheralNode() */
+
+/**********************************************************
+* Function: tmMesh_orderRCM()
+*----------------------------------------------------------
+* Sorts the mesh nodes with the reverse Cuthill-McKee
+* algorithm 
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param **nodes: returns all mesh nodes in their new 
+*                 order
+* @return: FALSE, if the memory can not be allocated
+**********************************************************/
+static tmBool tmMesh_orderRCM(tmMesh *mesh, tmNode **nodes)
+{
+  tmListNode *cur;
+  tmNode    **list  = NULL;
+  int        *beg   = NULL;
+  int        *adj   = NULL;
+  int        *level = NULL;
+  int        *queue = NULL;
+  int        *order = NULL;
+  tmBool     *done  = NULL;
+  int n = mesh->no_nodes;
+  int n_order = 0;
+  int i, j, k;
+
+  list  = (tmNode**) calloc(n+1, sizeof(tmNode*));
+  level = (int*)     calloc(n+1, sizeof(int));
+  queue = (int*)     calloc(n+1, sizeof(int));
+  order = (int*)     calloc(n+1, sizeof(int));
+  done  = (tmBool*)  calloc(n+1, sizeof(tmBool));
+  check_mem(list);
+  check_mem(level);
+  check_mem(queue);
+  check_mem(order);
+  check_mem(done);
+
+  i = 0;
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+  {
+    list[i] = (tmNode*) cur->value;
+    list[i]->index = i;
+    level[i] = -1;
+    i += 1;
+  }
+
+  check( tmMesh_calcAdjacency(mesh, &beg, &adj) == TRUE,
+      "Failed to compute the node adjacency.");
+
+  /*-------------------------------------------------------
+  | Cuthill-McKee ordering of every connected component,
+  | starting from a pseudo-peripheral node
+  -------------------------------------------------------*/
+  for (i = 0; i < n; i++)
+  {
+    int head;
+
+    if ( done[i] == TRUE )
+      continue;
+
+    head = n_order;
+    order[n_order] = tmMesh_peripheralNode(beg, adj, i, 
+                                           level, queue);
+    done[order[n_order++]] = TRUE;
+
+    while ( head < n_order )
+    {
+      int v     = order[head++];
+      int first = n_order;
+
+      for (j = beg[v]; j < beg[v+1]; j++)
+      {
+        if ( done[adj[j]] == FALSE )
+        {
+          done[adj[j]] = TRUE;
+          order[n_order++] = adj[j];
+        }
+      }
+
+      /*---------------------------------------------------
+      | Sort the new nodes by increasing degree
+      ---------------------------------------------------*/
+      for (j = first+1; j < n_order; j++)
+      {
+        int u   = order[j];
+        int deg = beg[u+1] - beg[u];
+
+        for (k = j; k > first; k--)
+        {
+          int w = order[k-1];
+          if ( beg[w+1]-beg[w] <= deg )
+            break;
+          order[k] = w;
+        }
+        order[k] = u;
+      }
+    }
+  }
+
+  for (i = 0; i < n; i++)
+    nodes[i] = list[order[n-1-i]];
+
+  free(list);
+  free(beg);
+  free(adj);
+  free(level);
+  free(queue);
+  free(order);
+  free(done);
+  return TRUE;
+
+error:
+  free(list);
+  free(beg);
+  free(adj);
+  free(level);
+  free(queue);
+  free(order);
+  free(done);
+  return FALSE;
+
+} /* tmMesh_orderRCM() */
+
+/**********************************************************
+* Function: tmMesh_renumber()
+*----------------------------------------------------------
+* Sorts the mesh nodes and triangles for the cache 
+* locality of solvers, which operate on the mesh output
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param method: TM_RENUMBER_HILBERT or TM_RENUMBER_RCM
+* @return: FALSE, if the memory can not be allocated
+**********************************************************/
+tmBool tmMesh_renumber(tmMesh *mesh, int method)
+{
+  tmListNode     *cur;
+  tmNode        **nodes = NULL;
+  tmTri         **tris  = NULL;
+  tmRenumberItem *items = NULL;
+  tmBool          ok;
+  int i;
+
+  if ( method == TM_RENUMBER_NONE )
+    return TRUE;
+
+  check( method == TM_RENUMBER_HILBERT || method == TM_RENUMBER_RCM,
+      "Invalid mesh renumbering method %d.", method);
+
+  nodes = (tmNode**) calloc(mesh->no_nodes+1, sizeof(tmNode*));
+  tris  = (tmTri**)  calloc(mesh->no_tris+1,  sizeof(tmTri*));
+  items = (tmRenumberItem*) calloc(mesh->no_tris+1, 
+                                   sizeof(tmRenumberItem));
+  check_mem(nodes);
+  check_mem(tris);
+  check_mem(items);
+
+  /*-------------------------------------------------------
+  | Sort the nodes 
+  -------------------------------------------------------*/
+  if ( method == TM_RENUMBER_HILBERT )
+    ok = tmMesh_orderHilbert(mesh, nodes);
+  else
+    ok = tmMesh_orderRCM(mesh, nodes);
+
+  check( ok == TRUE, "Failed to renumber the mesh nodes.");
+
+  tmMesh_orderNodes(mesh, nodes);
+
+  /*-------------------------------------------------------
+  | Sort the triangles along the Hilbert curve or by 
+  | their lowest node index
+  -------------------------------------------------------*/
+  i = 0;
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *tri = (tmTri*) cur->value;
+    int i1 = tri->n1->index;
+    int i2 = tri->n2->index;
+    int i3 = tri->n3->index;
+
+    if ( method == TM_RENUMBER_HILBERT )
+      items[i].key[0] = tmMesh_hilbertKey(mesh, tri->xy);
+    else
+    {
+      items[i].key[0] = (unsigned long) MIN(i1, MIN(i2, i3));
+      items[i].key[1] = (unsigned long) i1 + i2 + i3;
+    }
+
+    items[i].pos = i;
+    items[i].obj = tri;
+    i += 1;
+  }
+
+  qsort(items, mesh->no_tris, sizeof(tmRenumberItem), 
+        tmRenumberItem_compare);
+
+  for (i = 0; i < mesh->no_tris; i++)
+    tris[i] = (tmTri*) items[i].obj;
+
+  tmMesh_orderTris(mesh, tris);
+
+  free(nodes);
+  free(tris);
+  free(items);
+  return TRUE;
+
+error:
+  free(nodes);
+  free(tris);
+  free(items);
+  return FALSE;
+
+} /* tmMesh_renumber() */
+
+/**********************************************************
+* Function: tmMesh_calcBandwidth()
+*----------------------------------------------------------
+* Sets the node indices according to their order in the
+* mesh list and computes the bandwidth and profile of the
+* node adjacency matrix
+*----------------------------------------------------------
+* @param *mesh: pointer to a tmMesh 
+* @param *bandwidth: maximum index distance of two 
+*                    connected nodes
+* @param *profile: sum of the index distances of all 
+*                  nodes to their lowest connected node
+* @return: FALSE, if the memory can not be allocated
+**********************************************************/
+tmBool tmMesh_calcBandwidth(tmMesh *mesh, 
+                            long   *bandwidth, 
+                            long   *profile)
+{
+  tmListNode *cur;
+  int *first;
+  int i;
+
+  *bandwidth = 0;
+  *profile   = 0;
+
+  first = (int*) calloc(mesh->no_nodes+1, sizeof(int));
+  check_mem(first);
+
+  i = 0;
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+  {
+    ((tmNode*)cur->value)->index = i;
+    first[i] = i;
+    i += 1;
+  }
+
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *tri = (tmTri*) cur->value;
+    int    n[3];
+    int    j;
+
+    n[0] = tri->n1->index;
+    n[1] = tri->n2->index;
+    n[2] = tri->n3->index;
+
+    for (j = 0; j < 3; j++)
+    {
+      int a = n[j];
+      int b = n[(j+1)%3];
+
+      *bandwidth = MAX(*bandwidth, (long) ABS(a-b));
+      first[a]   = MIN(first[a], b);
+      first[b]   = MIN(first[b], a);
+    }
+  }
+
+  for (i = 0; i < mesh->no_nodes; i++)
+    *profile += (long) (i - first[i]);
+
+  free(first);
+  return TRUE;
+
+error:
+  return FALSE;
+
+} /* tmMesh_calcBandwidth() */
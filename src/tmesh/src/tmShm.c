@@ -0,0 +1,270 @@
+/*
+ * This source file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tmList.h"
+#include "tmesh/tmNode.h"
+#include "tmesh/tmEdge.h"
+#include "tmesh/tmTri.h"
+#include "tmesh/tmMesh.h"
+#include "tmesh/tmShm.h"
+#include "tmesh/tmAtomic.h"
+
+/**********************************************************
+* Function: tmShm_export()
+*----------------------------------------------------------
+* Writes the mesh to the shared memory segment name,
+* which replaces an existing segment of the same name.
+* The nodes and triangles are indexed in the order of
+* the mesh lists and written directly into the mapped
+* segment without any intermediate copy.
+*----------------------------------------------------------
+* @param mesh: pointer to mesh structure
+* @param name: segment name, e.g. "/tmesh"
+* @return: FALSE, if the segment could not be written
+**********************************************************/
+tmBool tmShm_export(tmMesh *mesh, const char *name)
+{
+  tmListNode    *cur;
+  tmShmHeader   *hdr;
+  unsigned char *data    = MAP_FAILED;
+  uint64_t       n_nodes = mesh->no_nodes;
+  uint64_t       n_tris  = mesh->no_tris;
+  uint64_t       off[3], size;
+  double       (*nodes)[2];
+  int32_t      (*tris)[3];
+  int32_t      (*nbrs)[3];
+  tmIndex        index;
+  int            fd = -1;
+  int            j;
+
+  check( n_nodes < INT32_MAX && n_tris < INT32_MAX,
+      "Mesh is too large for the shared memory output.");
+
+  /*-------------------------------------------------------
+  | Array offsets -> each array is aligned to 8 bytes
+  -------------------------------------------------------*/
+  off[0] = ((sizeof(tmShmHeader) + 7) / 8) * 8;
+  off[1] = off[0] + 16 * n_nodes;
+  off[2] = off[1] + ((12 * n_tris + 7) / 8) * 8;
+  size   = off[2] + ((12 * n_tris + 7) / 8) * 8;
+
+  /*-------------------------------------------------------
+  | A new segment replaces the old one, such that
+  | readers of the old mesh keep a valid mapping
+  -------------------------------------------------------*/
+  shm_unlink(name);
+
+  fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+  check( fd >= 0, "Failed to create shared memory %s", name);
+  check( ftruncate(fd, (off_t) size) == 0,
+      "Failed to resize shared memory %s", name);
+
+  data = (unsigned char*) mmap(NULL, (size_t) size,
+                               PROT_READ | PROT_WRITE,
+                               MAP_SHARED, fd, 0);
+  check( data != MAP_FAILED, "Failed to map shared memory %s", name);
+
+  close(fd);
+  fd = -1;
+
+  hdr   = (tmShmHeader*) data;
+  nodes = (double  (*)[2]) (data + off[0]);
+  tris  = (int32_t (*)[3]) (data + off[1]);
+  nbrs  = (int32_t (*)[3]) (data + off[2]);
+
+  /*-------------------------------------------------------
+  | Compact the node and triangle indices in the order
+  | of the mesh lists and write the nodes and triangles
+  -------------------------------------------------------*/
+  index = 0;
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmNode *n = (tmNode*) cur->value;
+
+    n->index        = index;
+    nodes[index][0] = n->xy[0];
+    nodes[index][1] = n->xy[1];
+    index += 1;
+  }
+
+  index = 0;
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *t = (tmTri*) cur->value;
+
+    t->index       = index;
+    tris[index][0] = (int32_t) t->n1->index;
+    tris[index][1] = (int32_t) t->n2->index;
+    tris[index][2] = (int32_t) t->n3->index;
+    index += 1;
+  }
+
+  /*-------------------------------------------------------
+  | Missing neighbors are replaced by the negative
+  | boundary marker of the edge
+  -------------------------------------------------------*/
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri  *t       = (tmTri*) cur->value;
+    tmTri  *nbr[3]  = { t->t1, t->t2, t->t3 };
+    tmEdge *edge[3] = { t->e1, t->e2, t->e3 };
+
+    for (j = 0; j < 3; j++)
+      nbrs[t->index][j] = ( nbr[j] != NULL && nbr[j] != t )
+                        ? (int32_t) nbr[j]->index
+                        : (int32_t) -(edge[j]->bdry_marker);
+  }
+
+  /*-------------------------------------------------------
+  | Header, whose magic marks the mesh as complete
+  -------------------------------------------------------*/
+  hdr->version     = TM_SHM_VERSION;
+  hdr->header_size = (uint32_t) sizeof(tmShmHeader);
+  hdr->size        = size;
+  hdr->n_nodes     = n_nodes;
+  hdr->n_tris      = n_tris;
+  hdr->off_nodes   = off[0];
+  hdr->off_tris    = off[1];
+  hdr->off_nbrs    = off[2];
+
+  tmAtomic_fenceRelease();
+  memcpy(hdr->magic, TM_SHM_MAGIC, 8);
+
+  munmap(data, (size_t) size);
+
+  return TRUE;
+
+error:
+  if ( fd >= 0 )
+    close(fd);
+  if ( data != MAP_FAILED )
+    munmap(data, (size_t) size);
+  shm_unlink(name);
+  return FALSE;
+
+} /* tmShm_export() */
+
+/**********************************************************
+* Function: tmShm_map()
+*----------------------------------------------------------
+* Maps the mesh of a shared memory segment read-only
+*----------------------------------------------------------
+* @param name: segment name
+* @param mesh: returns the mapped mesh
+* @return: FALSE, if the segment does not contain a
+*          complete mesh
+**********************************************************/
+tmBool tmShm_map(const char *name, tmShmMesh *mesh)
+{
+  struct stat        st;
+  const tmShmHeader *hdr;
+  unsigned char     *data = MAP_FAILED;
+  char               magic[8];
+  int                fd   = -1;
+
+  memset(mesh, 0, sizeof(tmShmMesh));
+
+  fd = shm_open(name, O_RDONLY, 0);
+  check( fd >= 0, "Failed to open shared memory %s", name);
+  check( fstat(fd, &st) == 0 &&
+         (size_t) st.st_size >= sizeof(tmShmHeader),
+      "Invalid shared memory mesh %s", name);
+
+  data = (unsigned char*) mmap(NULL, (size_t) st.st_size,
+                               PROT_READ, MAP_SHARED, fd, 0);
+  check( data != MAP_FAILED, "Failed to map shared memory %s", name);
+
+  close(fd);
+  fd = -1;
+
+  hdr = (const tmShmHeader*) data;
+
+  memcpy(magic, hdr->magic, 8);
+  tmAtomic_fenceAcquire();
+
+  check( memcmp(magic, TM_SHM_MAGIC, 8) == 0,
+      "Shared memory %s contains no complete mesh", name);
+
+  /*-------------------------------------------------------
+  | The offsets are bounded by the segment size before the
+  | array sizes are compared to their differences, such
+  | that corrupted headers can not overflow
+  -------------------------------------------------------*/
+  check( hdr->version == TM_SHM_VERSION
+      && hdr->header_size == sizeof(tmShmHeader)
+      && hdr->size <= (uint64_t) st.st_size
+      && hdr->n_nodes < INT32_MAX && hdr->n_tris < INT32_MAX
+      && hdr->off_nodes % 8 == 0 && hdr->off_tris % 8 == 0
+      && hdr->off_nbrs % 8 == 0
+      && hdr->off_nodes >= sizeof(tmShmHeader)
+      && hdr->off_nodes <= hdr->off_tris
+      && hdr->off_tris  <= hdr->off_nbrs
+      && hdr->off_nbrs  <= hdr->size
+      && 16 * hdr->n_nodes <= hdr->off_tris - hdr->off_nodes
+      && 12 * hdr->n_tris  <= hdr->off_nbrs - hdr->off_tris
+      && 12 * hdr->n_tris  <= hdr->size     - hdr->off_nbrs,
+      "Invalid shared memory mesh %s", name);
+
+  mesh->data    = data;
+  mesh->size    = (size_t) st.st_size;
+  mesh->n_nodes = (int) hdr->n_nodes;
+  mesh->n_tris  = (int) hdr->n_tris;
+  mesh->nodes   = (const double  (*)[2]) (data + hdr->off_nodes);
+  mesh->tris    = (const int32_t (*)[3]) (data + hdr->off_tris);
+  mesh->nbrs    = (const int32_t (*)[3]) (data + hdr->off_nbrs);
+
+  return TRUE;
+
+error:
+  if ( fd >= 0 )
+    close(fd);
+  if ( data != MAP_FAILED )
+    munmap(data, (size_t) st.st_size);
+  memset(mesh, 0, sizeof(tmShmMesh));
+  return FALSE;
+
+} /* tmShm_map() */
+
+/**********************************************************
+* Function: tmShm_unmap()
+*----------------------------------------------------------
+* Unmaps a mesh of tmShm_map()
+*----------------------------------------------------------
+* @param mesh: pointer to a mapped mesh
+**********************************************************/
+void tmShm_unmap(tmShmMesh *mesh)
+{
+  if ( mesh->data != NULL )
+    munmap(mesh->data, mesh->size);
+
+  memset(mesh, 0, sizeof(tmShmMesh));
+
+} /* tmShm_unmap() */
+
+/**********************************************************
+* Function: tmShm_unlink()
+*----------------------------------------------------------
+* Removes a shared memory segment. Existing mappings
+* remain valid.
+*----------------------------------------------------------
+* @param name: segment name
+* @return: FALSE, if the segment does not exist
+**********************************************************/
+tmBool tmShm_unlink(const char *name)
+{
+  return ( shm_unlink(name) == 0 ) ? TRUE : FALSE;
+
+} /* tmShm_unlink() */
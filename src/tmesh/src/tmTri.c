@@ -249,9 +249,9 @@ static void tmTri_calcTriQuality(tmTri *tri)
   tmDouble e2 = tri->edgeLen[1];
   tmDouble e3 = tri->edgeLen[2];
 
-  tmDouble d1 = tri->mesh->sizeFun(tri->mesh, tri->n1->xy);
-  tmDouble d2 = tri->mesh->sizeFun(tri->mesh, tri->n2->xy);
-  tmDouble d3 = tri->mesh->sizeFun(tri->mesh, tri->n3->xy);
+  tmDouble d1 = tmNode_getSize(tri->n1);
+  tmDouble d2 = tmNode_getSize(tri->n2);
+  tmDouble d3 = tmNode_getSize(tri->n3);
 
   tmDouble delta_1 = 0.5 * (d1+d2);
   tmDouble delta_2 = 0.5 * (d2+d3);
@@ -315,6 +315,7 @@ tmTri *tmTri_create(tmMesh *mesh,
   -------------------------------------------------------*/
   tri->mesh      = mesh;
   tri->index     = mesh->no_tris;
+  tri->stream_index = -1;
   tri->qtree_pos = NULL;
 
   /*-------------------------------------------------------
@@ -394,13 +395,7 @@ tmTri *tmTri_create(tmMesh *mesh,
   /*-------------------------------------------------------
   | 
   -------------------------------------------------------*/
-  tmTri_calcCentroid(tri);
-  tmTri_calcArea(tri);
-  tmTri_calcCircumcenter(tri);
-  tmTri_calcEdgeLen(tri);
-  tmTri_calcShapeFac(tri);
-  tmTri_calcAngles(tri);
-  tmTri_calcTriQuality(tri);
+  tmTri_calcProperties(tri);
 
   /*-------------------------------------------------------
   | Add tri to qtree
@@ -446,6 +441,111 @@ void tmTri_destroy(tmTri *tri)
 
 } /* tmTri_destroy() */
 
+/**********************************************************
+* Function: tmTri_calcProperties()
+*----------------------------------------------------------
+* (Re-)computes all geometric properties of a triangle
+* from the coordinates of its nodes
+*----------------------------------------------------------
+* @param *tri: pointer to a tmTri 
+**********************************************************/
+void tmTri_calcProperties(tmTri *tri)
+{
+  tmTri_calcCentroid(tri);
+  tmTri_calcArea(tri);
+  tmTri_calcCircumcenter(tri);
+  tmTri_calcEdgeLen(tri);
+  tmTri_calcShapeFac(tri);
+  tmTri_calcAngles(tri);
+  tmTri_calcTriQuality(tri);
+
+} /* tmTri_calcProperties() */
+
+/**********************************************************
+* Function: tmTri_setNodes()
+*----------------------------------------------------------
+* Redefines the nodes of an existing triangle in place.
+* Only the triangle-lists of nodes that are removed from 
+* or added to the triangle are modified. 
+* Afterwards all triangle properties are recomputed.
+* The mesh area and the triangle's location in the mesh 
+* qtree are not updated -> this is left to the caller 
+* (see tmQtree_updateObj()), such that triangles with 
+* disjoint nodes can be redefined concurrently.
+*----------------------------------------------------------
+* @param *tri: pointer to a tmTri 
+* @param n1,n2,n3: new nodes of the triangle (ccw)
+**********************************************************/
+void tmTri_setNodes(tmTri *tri, 
+                    tmNode *n1, tmNode *n2, tmNode *n3)
+{
+  int i, j;
+
+  tmNode     *old_n[3]   = { tri->n1, tri->n2, tri->n3 };
+  tmListNode *old_pos[3] = { tri->n1_pos, tri->n2_pos, 
+                             tri->n3_pos };
+  tmBool      reused[3]  = { FALSE, FALSE, FALSE };
+
+  tmNode     *new_n[3]   = { n1, n2, n3 };
+  tmListNode *new_pos[3] = { NULL, NULL, NULL };
+
+  /*-------------------------------------------------------
+  | Keep list positions of nodes that remain in the 
+  | triangle
+  -------------------------------------------------------*/
+  for (i = 0; i < 3; i++)
+  {
+    for (j = 0; j < 3; j++)
+    {
+      if ( reused[j] == FALSE && new_n[i] == old_n[j] )
+      {
+        new_pos[i] = old_pos[j];
+        reused[j]  = TRUE;
+        break;
+      }
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Remove triangle from nodes, that are not used anymore
+  -------------------------------------------------------*/
+  for (j = 0; j < 3; j++)
+  {
+    if ( reused[j] == FALSE )
+    {
+      tmList_remove(old_n[j]->tris, old_pos[j]);
+      old_n[j]->n_tris -= 1;
+    }
+  }
+
+  /*-------------------------------------------------------
+  | Add triangle to its new nodes
+  -------------------------------------------------------*/
+  for (i = 0; i < 3; i++)
+  {
+    if ( new_pos[i] == NULL )
+    {
+      tmList_push(new_n[i]->tris, tri);
+      new_pos[i] = tmList_last_node(new_n[i]->tris);
+      new_n[i]->n_tris += 1;
+    }
+  }
+
+  tri->n1 = n1;
+  tri->n2 = n2;
+  tri->n3 = n3;
+
+  tri->n1_pos = new_pos[0];
+  tri->n2_pos = new_pos[1];
+  tri->n3_pos = new_pos[2];
+
+  /*-------------------------------------------------------
+  | Update triangle properties 
+  -------------------------------------------------------*/
+  tmTri_calcProperties(tri);
+
+} /* tmTri_setNodes() */
+
 /**********************************************************
 * Function: tmTri_findNbrTriFromEdge()
 *----------------------------------------------------------
@@ -458,6 +558,7 @@ void tmTri_destroy(tmTri *tri)
 * @param tri:   triangle for which a neighbor will be found
 *               if one has been found, it will be included
 *               to its neighbors
+* @return: the neighbor or NULL, if none has been found
 **********************************************************/
 tmTri *tmTri_findTriNeighbor(tmNode *n1, 
                              tmNode *n2,
@@ -474,6 +575,9 @@ tmTri *tmTri_findTriNeighbor(tmNode *n1,
   {
     t_nb = (tmTri*)cur->value;
 
+    if (t_nb == tri)
+      continue;
+
     if (n2 == t_nb->n1)
     {
       if (n1 == t_nb->n2)
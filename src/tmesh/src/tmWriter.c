@@ -0,0 +1,599 @@
+/*
+ * This source file is part of the tmesh library.
+ * This code was written by Florian Setzwein in 2020,
+ * and is covered under the MIT License
+ * Refer to the accompanying documentation for details
+ * on usage and license.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "tmesh/tmTypedefs.h"
+#include "tmesh/tmWriter.h"
+#include "tmesh/tmPool.h"
+
+/**********************************************************
+* Function: tmWriter_init()
+*----------------------------------------------------------
+* Initializes a writer for the file descriptor fd
+*----------------------------------------------------------
+* @param w: writer to initialize
+* @param fd: file descriptor or -1 for memory
+* @param size: initial buffer size
+* @return: FALSE, if the buffer can not be allocated
+**********************************************************/
+static tmBool tmWriter_init(tmWriter *w, int fd, size_t size)
+{
+  w->fd       = fd;
+  w->close_fd = FALSE;
+  w->n        = 0;
+  w->size     = size;
+  w->ok       = TRUE;
+  w->buf      = NULL;
+
+  if (size > 0)
+  {
+    w->buf = (char*) malloc(size);
+    check_mem(w->buf);
+  }
+
+  return TRUE;
+
+error:
+  w->size = 0;
+  w->ok   = FALSE;
+  return FALSE;
+
+} /* tmWriter_init() */
+
+/**********************************************************
+* Function: tmWriter_create()
+*----------------------------------------------------------
+* Create a new tmWriter structure, which writes to the
+* file descriptor fd. The descriptor is not closed,
+* when the writer is destroyed.
+* For fd < 0, all data is kept in the writer's buffer.
+*----------------------------------------------------------
+* @param fd: file descriptor
+* @return: Pointer to a new tmWriter structure
+**********************************************************/
+tmWriter *tmWriter_create(int fd)
+{
+  tmWriter *w = (tmWriter*) calloc(1, sizeof(tmWriter));
+  check_mem(w);
+
+  if (fd < 0)
+    fd = -1;
+
+  check( tmWriter_init(w, fd, TM_WRITER_BUF_SIZE) == TRUE,
+      "Failed to allocate writer buffer.");
+
+  return w;
+
+error:
+  free(w);
+  return NULL;
+
+} /* tmWriter_create() */
+
+/**********************************************************
+* Function: tmWriter_createStdout()
+*----------------------------------------------------------
+* Create a new tmWriter structure, which writes to the
+* standard output. Pending output of the stdout stream 
+* is written before.
+*----------------------------------------------------------
+* @return: Pointer to a new tmWriter structure
+**********************************************************/
+tmWriter *tmWriter_createStdout(void)
+{
+  fflush(stdout);
+
+  return tmWriter_create(STDOUT_FILENO);
+
+} /* tmWriter_createStdout() */
+
+/**********************************************************
+* Function: tmWriter_open()
+*----------------------------------------------------------
+* Create a new tmWriter structure, which writes to the
+* file at path. An existing file is overwritten.
+*----------------------------------------------------------
+* @param path: file path
+* @return: Pointer to a new tmWriter structure or NULL,
+*          if the file can not be opened
+**********************************************************/
+tmWriter *tmWriter_open(const char *path)
+{
+  tmWriter *w  = NULL;
+  int       fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+  check( fd >= 0, "Failed to open file %s", path);
+
+  w = tmWriter_create(fd);
+  check( w != NULL, "Failed to create writer for %s", path);
+
+  w->close_fd = TRUE;
+
+  return w;
+
+error:
+  if (fd >= 0)
+    close(fd);
+  return NULL;
+
+} /* tmWriter_open() */
+
+/**********************************************************
+* Function: tmWriter_destroy()
+*----------------------------------------------------------
+* Writes all buffered data, closes the file descriptor
+* of tmWriter_open() and frees the writer's memory
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter to destroy
+* @return: FALSE, if any write has failed
+**********************************************************/
+tmBool tmWriter_destroy(tmWriter *w)
+{
+  tmBool ok;
+
+  if (w == NULL)
+    return FALSE;
+
+  ok = tmWriter_flush(w);
+
+  if ( w->close_fd == TRUE && close(w->fd) != 0 )
+    ok = FALSE;
+
+  free(w->buf);
+  free(w);
+
+  return ok;
+
+} /* tmWriter_destroy() */
+
+/**********************************************************
+* Function: tmWriter_writeFd()
+*----------------------------------------------------------
+* Writes n bytes to the file descriptor of the writer
+**********************************************************/
+static void tmWriter_writeFd(tmWriter *w, const char *data, size_t n)
+{
+  while (n > 0)
+  {
+    ssize_t k = write(w->fd, data, n);
+
+    if (k < 0)
+    {
+      if (errno == EINTR)
+        continue;
+
+      w->ok = FALSE;
+      return;
+    }
+
+    data += k;
+    n    -= (size_t) k;
+  }
+
+} /* tmWriter_writeFd() */
+
+/**********************************************************
+* Function: tmWriter_flush()
+*----------------------------------------------------------
+* Writes all buffered data to the file descriptor
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @return: FALSE, if any write has failed
+**********************************************************/
+tmBool tmWriter_flush(tmWriter *w)
+{
+  if (w->fd < 0)
+    return w->ok;
+
+  tmWriter_writeFd(w, w->buf, w->n);
+  w->n = 0;
+
+  return w->ok;
+
+} /* tmWriter_flush() */
+
+/**********************************************************
+* Function: tmWriter_reserve()
+*----------------------------------------------------------
+* Ensures, that n more bytes fit into the buffer.
+* The buffer of a memory writer grows as required.
+*----------------------------------------------------------
+* @return: FALSE, if the buffer can not be enlarged
+**********************************************************/
+static tmBool tmWriter_reserve(tmWriter *w, size_t n)
+{
+  size_t size;
+  char  *buf;
+
+  if (w->n + n <= w->size)
+    return TRUE;
+
+  if (w->fd >= 0)
+  {
+    tmWriter_flush(w);
+
+    if (n <= w->size)
+      return TRUE;
+  }
+
+  size = MAX(2 * w->size, w->n + n);
+  buf  = (char*) realloc(w->buf, size);
+
+  if (buf == NULL)
+  {
+    w->ok = FALSE;
+    return FALSE;
+  }
+
+  w->buf  = buf;
+  w->size = size;
+
+  return TRUE;
+
+} /* tmWriter_reserve() */
+
+/**********************************************************
+* Function: tmWriter_putBytes()
+*----------------------------------------------------------
+* Appends n bytes
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param data, n: bytes to append
+**********************************************************/
+void tmWriter_putBytes(tmWriter *w, const void *data, size_t n)
+{
+  if (n == 0)
+    return;
+
+  /*-------------------------------------------------------
+  | Large blocks are written without copying
+  -------------------------------------------------------*/
+  if (w->fd >= 0 && n >= w->size)
+  {
+    tmWriter_flush(w);
+    tmWriter_writeFd(w, (const char*) data, n);
+    return;
+  }
+
+  if ( tmWriter_reserve(w, n) == FALSE )
+    return;
+
+  memcpy(w->buf + w->n, data, n);
+  w->n += n;
+
+} /* tmWriter_putBytes() */
+
+/**********************************************************
+* Function: tmWriter_putStr()
+*----------------------------------------------------------
+* Appends a string
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param s: null-terminated string
+**********************************************************/
+void tmWriter_putStr(tmWriter *w, const char *s)
+{
+  tmWriter_putBytes(w, s, strlen(s));
+
+} /* tmWriter_putStr() */
+
+/**********************************************************
+* Function: tmWriter_putChar()
+*----------------------------------------------------------
+* Appends a single character
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param c: character
+**********************************************************/
+void tmWriter_putChar(tmWriter *w, char c)
+{
+  if ( tmWriter_reserve(w, 1) == FALSE )
+    return;
+
+  w->buf[w->n++] = c;
+
+} /* tmWriter_putChar() */
+
+/**********************************************************
+* Function: tmWriter_putDigits()
+*----------------------------------------------------------
+* Appends a number, whose characters are given in
+* reversed order, right-aligned to the field width
+**********************************************************/
+static void tmWriter_putDigits(tmWriter   *w,
+                               const char *rev,
+                               int         len,
+                               int         width)
+{
+  int n_pad = MAX(width - len, 0);
+  int i;
+
+  if ( tmWriter_reserve(w, n_pad + len) == FALSE )
+    return;
+
+  for (i = 0; i < n_pad; i++)
+    w->buf[w->n++] = ' ';
+
+  for (i = len-1; i >= 0; i--)
+    w->buf[w->n++] = rev[i];
+
+} /* tmWriter_putDigits() */
+
+/**********************************************************
+* Function: tmWriter_putInt()
+*----------------------------------------------------------
+* Appends an integer, right-aligned to a field of the
+* given width (as printf("%*ld"))
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param v: value
+* @param width: minimum field width
+**********************************************************/
+void tmWriter_putInt(tmWriter *w, long v, int width)
+{
+  char          rev[24];
+  int           len = 0;
+  unsigned long u   = (v < 0) ? -(unsigned long) v
+                              :  (unsigned long) v;
+
+  do {
+    rev[len++] = (char) ('0' + u % 10);
+    u /= 10;
+  } while (u > 0);
+
+  if (v < 0)
+    rev[len++] = '-';
+
+  tmWriter_putDigits(w, rev, len, width);
+
+} /* tmWriter_putInt() */
+
+/**********************************************************
+* Function: tmWriter_putFormat()
+*----------------------------------------------------------
+* Appends a single value with snprintf()
+**********************************************************/
+static void tmWriter_putFormat(tmWriter   *w,
+                               const char *fmt,
+                               int         width,
+                               int         prec,
+                               double      v)
+{
+  int len = snprintf(NULL, 0, fmt, width, prec, v);
+
+  if ( len < 0 || tmWriter_reserve(w, len + 1) == FALSE )
+    return;
+
+  snprintf(w->buf + w->n, len + 1, fmt, width, prec, v);
+  w->n += len;
+
+} /* tmWriter_putFormat() */
+
+/**********************************************************
+* Function: tmWriter_putFixed()
+*----------------------------------------------------------
+* Appends a floating point value with prec decimals,
+* right-aligned to a field of the given width.
+* The result is the same as printf("%*.*f").
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param v: value
+* @param width: minimum field width
+* @param prec: number of decimals
+**********************************************************/
+void tmWriter_putFixed(tmWriter *w, double v, int width, int prec)
+{
+  static const double scale[] = { 1.0E0, 1.0E1, 1.0E2, 1.0E3,
+                                  1.0E4, 1.0E5, 1.0E6, 1.0E7,
+                                  1.0E8, 1.0E9 };
+  char               rev[48];
+  int                len = 0;
+  int                i;
+  double             s, r;
+  unsigned long long u;
+
+  /*-------------------------------------------------------
+  | The scaled value is rounded to an integer.
+  | Values close to a rounding tie, large values and
+  | negative zeros are passed to snprintf(), such that
+  | the result is always the same.
+  -------------------------------------------------------*/
+  if ( prec < 0 || prec > 9 || !isfinite(v) )
+  {
+    tmWriter_putFormat(w, "%*.*f", width, prec, v);
+    return;
+  }
+
+  s = v * scale[prec];
+  r = nearbyint(s);
+
+  if ( !(fabs(s) < TM_WRITER_FIXED_MAX) ||
+       fabs(fabs(s - floor(s)) - 0.5) < TM_WRITER_FIXED_TIE ||
+       (r == 0.0 && signbit(v)) )
+  {
+    tmWriter_putFormat(w, "%*.*f", width, prec, v);
+    return;
+  }
+
+  u = (unsigned long long) fabs(r);
+
+  for (i = 0; i < prec; i++)
+  {
+    rev[len++] = (char) ('0' + u % 10);
+    u /= 10;
+  }
+
+  if (prec > 0)
+    rev[len++] = '.';
+
+  do {
+    rev[len++] = (char) ('0' + u % 10);
+    u /= 10;
+  } while (u > 0);
+
+  if (r < 0.0)
+    rev[len++] = '-';
+
+  tmWriter_putDigits(w, rev, len, width);
+
+} /* tmWriter_putFixed() */
+
+/**********************************************************
+* Function: tmWriter_putDouble()
+*----------------------------------------------------------
+* Appends the shortest representation of a floating
+* point value, which is read back to the same value
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param v: value
+**********************************************************/
+void tmWriter_putDouble(tmWriter *w, double v)
+{
+  char str[32];
+  int  prec;
+
+  /*-------------------------------------------------------
+  | 15 digits are sufficient for most values, which
+  | have a short decimal representation
+  -------------------------------------------------------*/
+  for (prec = 15; prec < 17; prec++)
+  {
+    snprintf(str, sizeof(str), "%.*g", prec, v);
+
+    if ( strtod(str, NULL) == v || !isfinite(v) )
+      break;
+  }
+
+  if (prec == 17)
+    snprintf(str, sizeof(str), "%.17g", v);
+
+  tmWriter_putStr(w, str);
+
+} /* tmWriter_putDouble() */
+
+/**********************************************************
+* tmWriterRows: Table, whose rows are formatted in
+*               parallel
+**********************************************************/
+typedef struct tmWriterRows {
+  tmWriterFun fun;
+  void       *data;
+  tmWriter   *bufs;       /* Memory writer for each chunk */
+  size_t      n_rows;
+  size_t      chunk_beg;  /* First chunk of the current set*/
+} tmWriterRows;
+
+/**********************************************************
+* Function: tmWriter_formatChunks()
+*----------------------------------------------------------
+* Parallel loop body, which formats the chunks
+* [i_beg, i_end) of the current set of chunks
+*----------------------------------------------------------
+* @param data: tmWriterRows structure
+**********************************************************/
+static void tmWriter_formatChunks(void  *data,
+                                  size_t i_beg,
+                                  size_t i_end,
+                                  int    thread_id)
+{
+  tmWriterRows *rows = (tmWriterRows*) data;
+  size_t i;
+
+  (void) thread_id;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    size_t r_beg = (rows->chunk_beg + i) * TM_WRITER_CHUNK_ROWS;
+    size_t r_end = MIN(r_beg + TM_WRITER_CHUNK_ROWS, rows->n_rows);
+
+    rows->fun(rows->data, &rows->bufs[i], r_beg, r_end);
+  }
+
+} /* tmWriter_formatChunks() */
+
+/**********************************************************
+* Function: tmWriter_writeRows()
+*----------------------------------------------------------
+* Writes the rows [0, n_rows) of a table with the
+* function fun. Chunks of rows are formatted on the
+* threads of the pool and written in their order.
+* If pool is NULL, all rows are written directly.
+*----------------------------------------------------------
+* @param w: pointer to a tmWriter
+* @param pool: pointer to a tmPool (may be NULL)
+* @param n_rows: number of rows
+* @param fun: function to write a range of rows
+* @param data: data passed to fun
+**********************************************************/
+void tmWriter_writeRows(tmWriter   *w,
+                        tmPool     *pool,
+                        size_t      n_rows,
+                        tmWriterFun fun,
+                        void       *data)
+{
+  tmWriterRows rows;
+  size_t       n_chunks, n_bufs, i, k;
+
+  if ( pool == NULL || n_rows <= TM_WRITER_CHUNK_ROWS )
+  {
+    fun(data, w, 0, n_rows);
+    return;
+  }
+
+  n_chunks = (n_rows + TM_WRITER_CHUNK_ROWS - 1)
+           / TM_WRITER_CHUNK_ROWS;
+  n_bufs   = MIN(n_chunks, (size_t) pool->n_threads
+                           * TM_WRITER_CHUNKS_PER_THREAD);
+
+  rows.fun    = fun;
+  rows.data   = data;
+  rows.n_rows = n_rows;
+  rows.bufs   = (tmWriter*) calloc(n_bufs, sizeof(tmWriter));
+  check_mem(rows.bufs);
+
+  for (k = 0; k < n_bufs; k++)
+    tmWriter_init(&rows.bufs[k], -1, 0);
+
+  /*-------------------------------------------------------
+  | Format sets of chunks in parallel and append them
+  | in order -> the memory is bounded by the set size
+  -------------------------------------------------------*/
+  for (i = 0; i < n_chunks; i += n_bufs)
+  {
+    size_t n = MIN(n_bufs, n_chunks - i);
+
+    rows.chunk_beg = i;
+
+    tmPool_parallelFor(pool, n, 1, tmWriter_formatChunks, &rows);
+
+    for (k = 0; k < n; k++)
+    {
+      if (rows.bufs[k].ok == FALSE)
+        w->ok = FALSE;
+
+      tmWriter_putBytes(w, rows.bufs[k].buf, rows.bufs[k].n);
+      rows.bufs[k].n = 0;
+    }
+  }
+
+  for (k = 0; k < n_bufs; k++)
+    free(rows.bufs[k].buf);
+  free(rows.bufs);
+
+  return;
+
+error:
+  w->ok = FALSE;
+  return;
+
+} /* tmWriter_writeRows() */
@@ -232,3 +232,172 @@ char *test_tmParam_comments()
 
   return NULL;
 } 
+
+/*************************************************************
+* Read a memory mapped parameter file in a single pass
+*************************************************************/
+char *test_tmParamFile()
+{
+  const char *path = "tmesh_test_param.para";
+  const char *nums[] = { "1.0", "-0.5", "3.14159265358979", 
+    "1e-7", "-2.5E+3", "0.000123456789012345678", 
+    "123456789012345678901234", "1e23", ".5", "7.", "+4.25e-30",
+    "0.1", "2.2250738585072014e-308" };
+  tmParamFile *file;
+  FILE        *fp;
+  tmDouble     v, *bbox;
+  int          i, n, iv;
+  bstring      str_param;
+
+  /*----------------------------------------------------------
+  | The fast float parser must agree with strtod()
+  ----------------------------------------------------------*/
+  for (i = 0; i < (int) (sizeof(nums) / sizeof(nums[0])); i++)
+  {
+    const char *pos = nums[i];
+    const char *end = nums[i] + strlen(nums[i]);
+
+    mu_assert( tmParam_parseDouble(&pos, end, &v) == TRUE 
+            && pos == end && v == strtod(nums[i], NULL),
+        "<tmParam_parseDouble> failed.");
+  }
+
+  const char *bad = "-.e5";
+  mu_assert( tmParam_parseDouble(&bad, bad+4, &v) == FALSE,
+      "<tmParam_parseDouble> failed.");
+
+  const char *exp_str = "2e+";
+  mu_assert( tmParam_parseDouble(&exp_str, exp_str+3, &v) == TRUE
+          && v == 2.0 && *exp_str == 'e',
+      "<tmParam_parseDouble> failed.");
+
+  /*----------------------------------------------------------
+  | Numbers, which exceed the buffer for strtod()
+  ----------------------------------------------------------*/
+  char long_num[201];
+  const char *long_pos = long_num;
+  memset(long_num, '3', 200);
+  long_num[0]   = '0';
+  long_num[1]   = '.';
+  long_num[200] = '\0';
+  mu_assert( tmParam_parseDouble(&long_pos, long_num+200, &v) == TRUE
+          && long_pos == long_num+200 
+          && v == strtod(long_num, NULL),
+      "<tmParam_parseDouble> failed.");
+
+  const char *big = "2147483648";
+  mu_assert( tmParam_parseInt(&big, big+10, &iv) == FALSE,
+      "<tmParam_parseInt> failed.");
+
+  /*----------------------------------------------------------
+  | Write and read a parameter file
+  ----------------------------------------------------------*/
+  fp = fopen(path, "w");
+  mu_assert( fp != NULL, "Failed to write parameter file.");
+  fprintf(fp, 
+    "# Header comment\n"
+    "Global element size: 0.5 # comment\n"
+    "Number of quadtree elements: 50\n"
+    "Mesh bounding box: -10.0, -10.0, 20.0,20.0\n"
+    "Output file: mesh.txt\n"
+    "Define nodes:\n"
+    "0.0, 0.0\n"
+    "  1.0e1 ,0.0\n"
+    "10.0,  10.0 # top\n"
+    "\n"
+    "0.0, 10.0\n"
+    "2.0, 2.0\n"
+    "2.0, 4.0\n"
+    "4.0, 2.0\n"
+    "End nodes\n"
+    "Define exterior boundary: 3\n"
+    "0, 1, 0, 1.4\n"
+    "1, 2, 0, 1.4\n"
+    "2, 3, 1, 1.4\n"
+    "3, 0, 0, 1.4\n"
+    "End exterior boundary\n"
+    "Define interior boundary: 1\n"
+    "4, 5, 2, 1.6\n"
+    "5, 6, 2, 1.6\n"
+    "6, 4, 2, 1.6\n"
+    "End interior boundary\n"
+    "Define interior boundary: 4\n"
+    "End interior boundary");
+  fclose(fp);
+
+  file = tmParamFile_create(path);
+  mu_assert( file != NULL, "<tmParamFile_create> failed.");
+
+  mu_assert( file->nNodes == 7 
+          && file->nodes[1][0] == 10.0 && file->nodes[1][1] == 0.0
+          && file->nodes[2][1] == 10.0 && file->nodes[6][0] == 4.0,
+      "<tmParamFile_create> failed to read nodes.");
+
+  mu_assert( file->hasExtBdry == TRUE 
+          && file->extBdry.marker == 3 
+          && file->extBdry.nEdges == 4
+          && file->extBdry.edges[2][0] == 2 
+          && file->extBdry.edges[2][1] == 3
+          && file->extBdry.edgeMarker[2] == 1
+          && file->extBdry.edgeRefine[3] == 1.4,
+      "<tmParamFile_create> failed to read exterior boundary.");
+
+  mu_assert( file->nIntBdrys == 2 
+          && file->intBdrys[0].marker == 1
+          && file->intBdrys[0].nEdges == 3
+          && file->intBdrys[0].edges[2][1] == 4
+          && file->intBdrys[0].edgeRefine[0] == 1.6
+          && file->intBdrys[1].marker == 4
+          && file->intBdrys[1].nEdges == 0,
+      "<tmParamFile_create> failed to read interior boundaries.");
+
+  /*----------------------------------------------------------
+  | Extract parameters
+  ----------------------------------------------------------*/
+  mu_assert( tmParamFile_extractParam(file, 
+        "Global element size:", 1, &v) == 1 && v == 0.5,
+      "<tmParamFile_extractParam> failed.");
+  mu_assert( tmParamFile_extractParam(file, 
+        "Number of quadtree elements:", 0, &iv) == 1 && iv == 50,
+      "<tmParamFile_extractParam> failed.");
+  mu_assert( tmParamFile_extractParam(file, 
+        "Number of threads:", 0, &iv) == 0,
+      "<tmParamFile_extractParam> failed.");
+
+  mu_assert( tmParamFile_extractParam(file, 
+        "Output file:", 2, &str_param) == 1,
+      "<tmParamFile_extractParam> failed.");
+  mu_assert( strcmp(" mesh.txt", (char*) str_param->data) == 0,
+      "<tmParamFile_extractParam> failed.");
+  bdestroy(str_param);
+
+  mu_assert( tmParamFile_extractArray(file, 
+        "Mesh bounding box:", 1, &bbox, &n) == 1 && n == 4
+        && bbox[0] == -10.0 && bbox[3] == 20.0,
+      "<tmParamFile_extractArray> failed.");
+  free(bbox);
+
+  tmParamFile_destroy(file);
+
+  /*----------------------------------------------------------
+  | Wrong definitions
+  ----------------------------------------------------------*/
+  fp = fopen(path, "w");
+  fprintf(fp, "Define nodes:\n0.0, 0.0\n1.0; 0.0\nEnd nodes\n");
+  fclose(fp);
+  mu_assert( tmParamFile_create(path) == NULL,
+      "<tmParamFile_create> accepted wrong node definition.");
+
+  fp = fopen(path, "w");
+  fprintf(fp, "Define exterior boundary: 1\n0, 1, 0, 1.0\n");
+  fclose(fp);
+  mu_assert( tmParamFile_create(path) == NULL,
+      "<tmParamFile_create> accepted missing boundary end.");
+
+  remove(path);
+
+  mu_assert( tmParamFile_create(path) == NULL,
+      "<tmParamFile_create> opened missing file.");
+
+  return NULL;
+}
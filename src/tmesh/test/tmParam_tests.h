@@ -5,4 +5,6 @@ char *test_tmParam_readfile();
 
 char *test_tmParam_comments();
 
+char *test_tmParamFile();
+
 #endif
@@ -1,6 +1,7 @@
 #include "tmesh/tmNode.h"
 #include "tmesh/tmEdge.h"
 #include "tmesh/tmMesh.h"
+#include "tmesh/tmMeshIO.h"
 #include "tmesh/tmBdry.h"
 
 #include "tmesh/dbg.h"
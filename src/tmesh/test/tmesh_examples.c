@@ -3,6 +3,7 @@
 #include "tmesh/tmTri.h"
 #include "tmesh/tmBdry.h"
 #include "tmesh/tmMesh.h"
+#include "tmesh/tmMeshIO.h"
 #include "tmesh/tmQtree.h"
 #include "tmesh/tmFront.h"
 #include "tmesh/tmList.h"
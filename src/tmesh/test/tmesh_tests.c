@@ -3,9 +3,19 @@
 #include "tmesh/tmTri.h"
 #include "tmesh/tmBdry.h"
 #include "tmesh/tmMesh.h"
+#include "tmesh/tmMeshIO.h"
+#include "tmesh/tmRenumber.h"
+#include "tmesh/tmMeshLoad.h"
 #include "tmesh/tmQtree.h"
 #include "tmesh/tmFront.h"
 #include "tmesh/tmList.h"
+#include "tmesh/tmPool.h"
+#include "tmesh/tmWriter.h"
+#include "tmesh/tmCache.h"
+#include "tmesh/tmExpr.h"
+#include "tmesh/tmClient.h"
+#include "tmesh/tmShm.h"
+#include "tmesh/tinyexpr.h"
 
 #include "tmesh/minunit.h"
 #include "tmesh/dbg.h"
@@ -14,9 +24,18 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/un.h>
 
 
 tmDouble GLOBSIZE = 2.4;
@@ -84,6 +103,10 @@ static inline tmDouble size_fun_7( tmDouble xy[2] )
 
   return rho;
 }
+static inline tmDouble size_fun_8( tmDouble xy[2] )
+{
+  return 0.5 + 0.1 * xy[0];
+}
 
 
 /*************************************************************
@@ -1763,3 +1786,2339 @@ char *test_tmBdry_sizeFunction()
   return NULL;
 
 } /* test_automaticSizeFunction() */
+
+/************************************************************
+* Creates the boundaries for the delaunay edge flip tests: 
+* A square with a regular polygon as interior boundary,
+* which leads to cocircular node configurations 
+************************************************************/
+static tmMesh *create_flip_test_bdry()
+{
+  tmDouble xy_min[2] = { -1.0, -1.0 };
+  tmDouble xy_max[2] = { 11.0, 11.0 };
+  tmMesh *mesh = tmMesh_create(xy_min, xy_max, 20, 
+                               1.0, size_fun_2);
+  tmDouble sizeFac = 1.0;
+  int i;
+
+  /*--------------------------------------------------------
+  | exterior boundary
+  --------------------------------------------------------*/
+  tmDouble xy_ext[4][2] = { {  0.0,  0.0 }, { 10.0,  0.0 },
+                            { 10.0, 10.0 }, {  0.0, 10.0 } };
+  tmNode  *n_ext[4];
+
+  for (i = 0; i < 4; i++)
+    n_ext[i] = tmNode_create(mesh, xy_ext[i]);
+
+  tmBdry *bdry_ext = tmMesh_addBdry(mesh, FALSE, 0);
+  for (i = 0; i < 4; i++)
+    tmBdry_edgeCreate(bdry_ext, n_ext[i], n_ext[(i+1)%4], 
+                      0, sizeFac);
+
+  /*--------------------------------------------------------
+  | interior boundary: regular polygon, which leads to 
+  | cocircular node configurations in the mesh
+  --------------------------------------------------------*/
+  const int n_int = 16;
+  tmNode   *n_circ[16];
+
+  for (i = 0; i < n_int; i++)
+  {
+    tmDouble phi = -2.0 * PI_D * (tmDouble) i / (tmDouble) n_int;
+    tmDouble xy[2] = { 5.0 + 2.0 * cos(phi), 
+                       5.0 + 2.0 * sin(phi) };
+    n_circ[i] = tmNode_create(mesh, xy);
+  }
+
+  tmBdry *bdry_int = tmMesh_addBdry(mesh, TRUE, 1);
+  for (i = 0; i < n_int; i++)
+    tmBdry_edgeCreate(bdry_int, n_circ[i], n_circ[(i+1)%n_int], 
+                      1, sizeFac);
+
+  return mesh;
+}
+
+/************************************************************
+* Creates the mesh for the delaunay edge flip tests
+************************************************************/
+static tmMesh *create_flip_test_mesh()
+{
+  tmMesh *mesh = create_flip_test_bdry();
+
+  tmMesh_ADFMeshing(mesh);
+
+  return mesh;
+}
+
+/************************************************************
+* Unit test function for the in-place delaunay edge flips
+************************************************************/
+char *test_tmMesh_delaunayFlip()
+{
+  tmMesh *mesh = create_flip_test_mesh();
+  int i;
+
+  /*--------------------------------------------------------
+  | Flip edges
+  --------------------------------------------------------*/
+  int      no_tris  = mesh->no_tris;
+  int      no_edges = mesh->no_edges;
+  tmDouble area     = mesh->areaTris;
+
+  tmMesh_delaunayFlip(mesh);
+
+  mu_assert( mesh->no_tris == no_tris,
+      "Delaunay flip changed the number of triangles.");
+  mu_assert( mesh->no_edges == no_edges,
+      "Delaunay flip changed the number of edges.");
+  mu_assert( mesh->delaunay_stack->count == 0,
+      "Delaunay stack is not empty after edge flips.");
+  mu_assert( ABS(mesh->areaTris - area) < 1.0E-8 * area,
+      "Delaunay flip changed the triangulated area.");
+
+  /*--------------------------------------------------------
+  | Check edge properties
+  --------------------------------------------------------*/
+  tmListNode *cur;
+
+  for (cur = mesh->edges_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmEdge *e = (tmEdge*) cur->value;
+
+    mu_assert( e->is_local_delaunay == TRUE,
+        "Mesh edge is not locally delaunay.");
+    mu_assert( e->t1 != NULL || e->t2 != NULL,
+        "Mesh edge without adjacent triangles.");
+
+    if (e->t1 != NULL)
+      mu_assert( (e->t1->e1 == e || e->t1->e2 == e || 
+                  e->t1->e3 == e),
+          "Edge-triangle connectivity is broken.");
+    if (e->t2 != NULL)
+      mu_assert( (e->t2->e1 == e || e->t2->e2 == e || 
+                  e->t2->e3 == e),
+          "Edge-triangle connectivity is broken.");
+  }
+
+  /*--------------------------------------------------------
+  | Check triangle properties
+  --------------------------------------------------------*/
+  for (cur = mesh->tris_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmTri  *t    = (tmTri*) cur->value;
+    tmTri  *t_nbr[3] = { t->t1, t->t2, t->t3 };
+    tmEdge *e_nbr[3] = { t->e1, t->e2, t->e3 };
+
+    mu_assert( t->area > 0.0,
+        "Triangle with non-positive area.");
+
+    for (i = 0; i < 3; i++)
+    {
+      tmEdge *e = e_nbr[i];
+      tmTri  *t_exp = (e->t1 == t) ? e->t2 : e->t1;
+
+      if (t_exp == NULL)
+        t_exp = t;
+
+      mu_assert( t_nbr[i] == t_exp,
+          "Triangle neighbors are inconsistent.");
+    }
+  }
+
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmMesh_delaunayFlip() */
+
+/************************************************************
+* Unit test function for the parallel delaunay edge flips
+************************************************************/
+char *test_tmMesh_delaunayFlipParallel()
+{
+  tmMesh *mesh_ser = create_flip_test_mesh();
+  tmMesh *mesh_par = create_flip_test_mesh();
+
+  tmMesh_delaunayFlip(mesh_ser);
+
+  tmMesh_setThreads(mesh_par, 4);
+  mu_assert( mesh_par->n_threads == 4,
+      "Failed to set number of threads.");
+  tmMesh_delaunayFlip(mesh_par);
+
+  mu_assert( mesh_par->delaunay_stack->count == 0,
+      "Delaunay stack is not empty after parallel edge flips.");
+  mu_assert( mesh_ser->no_tris == mesh_par->no_tris,
+      "Parallel delaunay flip changed the number of triangles.");
+
+  /*--------------------------------------------------------
+  | Triangles are redefined in place, hence both meshes 
+  | must have identical triangles on their stacks
+  --------------------------------------------------------*/
+  tmListNode *cur_ser = mesh_ser->tris_stack->first;
+  tmListNode *cur_par = mesh_par->tris_stack->first;
+
+  for ( ; cur_ser != NULL && cur_par != NULL; 
+        cur_ser = cur_ser->next, cur_par = cur_par->next)
+  {
+    tmTri *t_ser = (tmTri*) cur_ser->value;
+    tmTri *t_par = (tmTri*) cur_par->value;
+
+    mu_assert( t_ser->n1->index == t_par->n1->index &&
+               t_ser->n2->index == t_par->n2->index &&
+               t_ser->n3->index == t_par->n3->index,
+        "Parallel delaunay flip differs from serial flip.");
+  }
+
+  tmMesh_destroy(mesh_ser);
+  tmMesh_destroy(mesh_par);
+
+  return NULL;
+
+} /* test_tmMesh_delaunayFlipParallel() */
+
+/************************************************************
+* Unit test function for the mesh smoothing
+************************************************************/
+char *test_tmMesh_smooth()
+{
+  tmMesh *mesh = create_flip_test_mesh();
+  tmListNode *cur;
+
+  tmMesh_delaunayFlip(mesh);
+
+  /*--------------------------------------------------------
+  | Store boundary node coordinates and mesh quality
+  --------------------------------------------------------*/
+  tmDouble area     = mesh->areaTris;
+  tmDouble minAngle = PI_D;
+  tmDouble bdry_xy  = 0.0;
+
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+    minAngle = MIN(minAngle, ((tmTri*)cur->value)->minAngle);
+
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmNode *n = (tmNode*) cur->value;
+    if (n->on_bdry == TRUE)
+      bdry_xy += n->xy[0] + n->xy[1];
+  }
+
+  /*--------------------------------------------------------
+  | Smooth mesh 
+  --------------------------------------------------------*/
+  tmMesh_setThreads(mesh, 2);
+  tmMesh_smooth(mesh, 5);
+  tmMesh_delaunayFlip(mesh);
+
+  tmDouble minAngle_new = PI_D;
+  tmDouble bdry_xy_new  = 0.0;
+
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *t = (tmTri*) cur->value;
+    mu_assert( t->area > 0.0,
+        "Smoothing created triangle with non-positive area.");
+    minAngle_new = MIN(minAngle_new, t->minAngle);
+  }
+
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmNode *n = (tmNode*) cur->value;
+    if (n->on_bdry == TRUE)
+      bdry_xy_new += n->xy[0] + n->xy[1];
+  }
+
+  mu_assert( bdry_xy_new == bdry_xy,
+      "Smoothing moved boundary nodes.");
+  mu_assert( ABS(mesh->areaTris - area) < 1.0E-8 * area,
+      "Smoothing changed the triangulated area.");
+  mu_assert( minAngle_new >= minAngle,
+      "Smoothing decreased the minimum triangle angle.");
+
+  /*--------------------------------------------------------
+  | All objects must still be contained in the qtrees
+  --------------------------------------------------------*/
+  mu_assert( mesh->nodes_qtree->n_obj_tot == mesh->nodes_stack->count,
+      "Smoothing lost nodes in the qtree.");
+  mu_assert( mesh->edges_qtree->n_obj_tot == mesh->edges_stack->count,
+      "Smoothing lost edges in the qtree.");
+  mu_assert( mesh->tris_qtree->n_obj_tot == mesh->tris_stack->count,
+      "Smoothing lost triangles in the qtree.");
+
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmMesh_smooth() */
+
+/************************************************************
+* Unit test function for the parallel meshing of 
+* subdomains
+************************************************************/
+char *test_tmMesh_ADFMeshingParallel()
+{
+  tmMesh *mesh = create_flip_test_bdry();
+  tmListNode *cur;
+  int i;
+
+  tmMesh_setThreads(mesh, 2);
+  tmMesh_ADFMeshingParallel(mesh, 4);
+
+  mu_assert( mesh->front->no_edges == 0,
+      "Advancing front is not empty after parallel meshing.");
+  mu_assert( ABS(mesh->areaTris - mesh->areaBdry) 
+             < 1.0E-8 * mesh->areaBdry,
+      "Parallel meshing did not cover the domain.");
+
+  /*--------------------------------------------------------
+  | Subdomain interfaces must be merged to interior edges
+  --------------------------------------------------------*/
+  for (cur = mesh->edges_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmEdge *e = (tmEdge*) cur->value;
+
+    mu_assert( e->bdry_marker != TM_DOMAIN_MARKER,
+        "Subdomain interface edge remains in the mesh.");
+    mu_assert( e->t1 != NULL,
+        "Mesh edge without adjacent triangle.");
+    mu_assert( e->bdry_marker >= 0 || e->t2 != NULL,
+        "Interior mesh edge with a single triangle.");
+    mu_assert( (e->t1->e1 == e || e->t1->e2 == e || 
+                e->t1->e3 == e),
+        "Edge-triangle connectivity is broken.");
+    if (e->t2 != NULL)
+      mu_assert( (e->t2->e1 == e || e->t2->e2 == e || 
+                  e->t2->e3 == e),
+          "Edge-triangle connectivity is broken.");
+  }
+
+  for (cur = mesh->tris_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmTri  *t        = (tmTri*) cur->value;
+    tmEdge *e_nbr[3] = { t->e1, t->e2, t->e3 };
+
+    mu_assert( t->area > 0.0,
+        "Triangle with non-positive area.");
+
+    for (i = 0; i < 3; i++)
+      mu_assert( e_nbr[i] != NULL,
+          "Triangle without edge.");
+  }
+
+  /*--------------------------------------------------------
+  | Euler characteristic of a domain with one hole
+  --------------------------------------------------------*/
+  mu_assert( mesh->no_nodes - mesh->no_edges + mesh->no_tris == 0,
+      "Merged mesh violates the Euler characteristic.");
+
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmMesh_ADFMeshingParallel() */
+
+/************************************************************
+* Unit test function for the speculative advancing front
+* meshing on several threads
+************************************************************/
+char *test_tmMesh_ADFMeshingSpeculative()
+{
+  tmMesh *mesh = create_flip_test_bdry();
+  tmListNode *cur;
+
+  tmMesh_setThreads(mesh, 2);
+  tmMesh_ADFMeshingSpeculative(mesh);
+
+  mu_assert( mesh->front->no_edges == 0,
+      "Advancing front is not empty after speculative meshing.");
+  mu_assert( ABS(mesh->areaTris - mesh->areaBdry) 
+             < 1.0E-8 * mesh->areaBdry,
+      "Speculative meshing did not cover the domain.");
+
+  for (cur = mesh->tris_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmTri *t = (tmTri*) cur->value;
+
+    mu_assert( t->area > 0.0,
+        "Triangle with non-positive area.");
+    mu_assert( t->e1 != NULL && t->e2 != NULL && t->e3 != NULL,
+        "Triangle without edge.");
+  }
+
+  /*--------------------------------------------------------
+  | Euler characteristic of a domain with one hole
+  --------------------------------------------------------*/
+  mu_assert( mesh->no_nodes - mesh->no_edges + mesh->no_tris == 0,
+      "Speculative meshing violates the Euler characteristic.");
+
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmMesh_ADFMeshingSpeculative() */
+
+/************************************************************
+* Unit test function for the parallel check of neighbor 
+* nodes during the front advancement
+************************************************************/
+char *test_tmFront_advanceParallel()
+{
+  tmMesh *mesh_ser = create_flip_test_bdry();
+  tmMesh *mesh_par = create_flip_test_bdry();
+  tmListNode *cur_ser, *cur_par;
+
+  tmMesh_setThreads(mesh_par, 2);
+  tmMesh_setAdvanceCands(mesh_par, 3, 0);
+
+  tmMesh_ADFMeshing(mesh_ser);
+  tmMesh_ADFMeshing(mesh_par);
+
+  mu_assert( mesh_par->front->no_edges == 0,
+      "Advancing front is not empty after meshing.");
+
+  /*--------------------------------------------------------
+  | The parallel check must select the same nodes
+  --------------------------------------------------------*/
+  mu_assert( mesh_ser->no_tris == mesh_par->no_tris,
+      "Parallel node check changed the number of triangles.");
+  mu_assert( mesh_ser->no_nodes == mesh_par->no_nodes,
+      "Parallel node check changed the number of nodes.");
+
+  cur_ser = mesh_ser->tris_stack->first;
+  cur_par = mesh_par->tris_stack->first;
+
+  for ( ; cur_ser != NULL && cur_par != NULL; 
+        cur_ser = cur_ser->next, cur_par = cur_par->next)
+  {
+    tmTri *t_ser = (tmTri*) cur_ser->value;
+    tmTri *t_par = (tmTri*) cur_par->value;
+
+    mu_assert( t_ser->n1->index == t_par->n1->index &&
+               t_ser->n2->index == t_par->n2->index &&
+               t_ser->n3->index == t_par->n3->index,
+        "Parallel node check changed the triangles.");
+  }
+
+  tmMesh_destroy(mesh_ser);
+  tmMesh_destroy(mesh_par);
+
+  return NULL;
+
+} /* test_tmFront_advanceParallel() */
+
+/************************************************************
+* Unit test function for the binary mesh output
+************************************************************/
+char *test_tmMesh_writeBinary()
+{
+  tmMesh *mesh = create_flip_test_bdry();
+  const char *path = "tmesh_test_mesh.bin";
+  unsigned char hdr[TM_BIN_HEADER_SIZE];
+  uint64_t vals[10];
+  uint64_t n_hdr[3], off_hdr[7];
+  int32_t  tri[3];
+  double   xy[2];
+  long     size;
+  FILE    *fp;
+  tmListNode *cur;
+  uint64_t n_sides = 0;
+  int      i, j;
+
+  tmMesh_ADFMeshing(mesh);
+
+  mu_assert( tmMesh_writeBinary(mesh, path) == TRUE,
+      "Failed to write binary mesh file.");
+
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *t = (tmTri*) cur->value;
+    tmTri *nbrs[3] = { t->t1, t->t2, t->t3 };
+
+    for (j = 0; j < 3; j++)
+      if ( nbrs[j] == NULL || nbrs[j] == t )
+        n_sides += 1;
+  }
+
+  fp = fopen(path, "rb");
+  mu_assert( fp != NULL, "Binary mesh file does not exist.");
+  mu_assert( fread(hdr, 1, TM_BIN_HEADER_SIZE, fp) == 
+             TM_BIN_HEADER_SIZE, "Failed to read header.");
+
+  /*--------------------------------------------------------
+  | Decode the little-endian header values
+  --------------------------------------------------------*/
+  for (i = 0; i < 10; i++)
+  {
+    vals[i] = 0;
+    for (j = 0; j < 8; j++)
+      vals[i] |= ((uint64_t) hdr[16 + 8*i + j]) << (8*j);
+  }
+
+  mu_assert( memcmp(hdr, TM_BIN_MAGIC, 8) == 0,
+      "Wrong binary mesh file identifier.");
+  mu_assert( hdr[8] == TM_BIN_VERSION && hdr[12] == TM_BIN_HEADER_SIZE,
+      "Wrong binary mesh file version.");
+  mu_assert( vals[0] == (uint64_t) mesh->no_nodes 
+          && vals[1] == (uint64_t) mesh->no_tris,
+      "Wrong number of nodes or triangles.");
+  mu_assert( vals[2] == n_sides,
+      "Boundary edges differ from the triangle sides.");
+
+  fseek(fp, 0, SEEK_END);
+  size = ftell(fp);
+  mu_assert( (uint64_t) size == vals[9], "Wrong binary mesh file size.");
+
+  /*--------------------------------------------------------
+  | An offset, whose sum with the array size wraps around,
+  | must be rejected
+  --------------------------------------------------------*/
+  mu_assert( tmMesh_checkBinHeader(hdr, size, n_hdr, off_hdr) == TRUE,
+      "Valid binary mesh header is rejected.");
+
+  for (j = 0; j < 8; j++)
+    hdr[48 + j] = (j == 0) ? 0xF8 : 0xFF;
+
+  mu_assert( tmMesh_checkBinHeader(hdr, size, n_hdr, off_hdr) == FALSE,
+      "Binary mesh header with a wrapping offset is accepted.");
+
+  /*--------------------------------------------------------
+  | Check the last triangle and its nodes
+  | (assumes a little-endian host)
+  --------------------------------------------------------*/
+  tmTri *t = (tmTri*) mesh->tris_stack->last->value;
+
+  fseek(fp, vals[4] + 12 * (mesh->no_tris - 1), SEEK_SET);
+  mu_assert( fread(tri, sizeof(int32_t), 3, fp) == 3,
+      "Failed to read triangle.");
+  mu_assert( tri[0] == t->n1->index && tri[1] == t->n2->index &&
+             tri[2] == t->n3->index, "Wrong triangle nodes.");
+
+  fseek(fp, vals[3] + 16 * t->n3->index, SEEK_SET);
+  mu_assert( fread(xy, sizeof(double), 2, fp) == 2,
+      "Failed to read node.");
+  mu_assert( xy[0] == t->n3->xy[0] && xy[1] == t->n3->xy[1],
+      "Wrong node coordinates.");
+
+  fclose(fp);
+  remove(path);
+
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmMesh_writeBinary() */
+
+/************************************************************
+* Unit test function for the VTU mesh output
+************************************************************/
+char *test_tmMesh_writeVTU()
+{
+  tmMesh *mesh = create_flip_test_bdry();
+  const char *path = "tmesh_test_mesh.vtu";
+  const char *tail = "\n  </AppendedData>\n</VTKFile>\n";
+  tmListNode *cur;
+  char     *buf, *data;
+  uint64_t  n_bytes;
+  double    xy[3];
+  long      size, n_cells = 0;
+  FILE     *fp;
+  int       i, j;
+
+  tmMesh_ADFMeshing(mesh);
+
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *t = (tmTri*) cur->value;
+    tmTri *nbrs[3] = { t->t1, t->t2, t->t3 };
+
+    for (j = 0; j < 3; j++)
+      if ( nbrs[j] == NULL || nbrs[j] == t )
+        n_cells += 1;
+  }
+
+  n_cells += mesh->no_tris;
+
+  mu_assert( tmMesh_writeVTU(mesh, path) == TRUE,
+      "Failed to write VTU mesh file.");
+
+  fp = fopen(path, "rb");
+  mu_assert( fp != NULL, "VTU mesh file does not exist.");
+
+  fseek(fp, 0, SEEK_END);
+  size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  buf = calloc(size+1, sizeof(char));
+  mu_assert( fread(buf, 1, size, fp) == (size_t) size,
+      "Failed to read VTU mesh file.");
+  fclose(fp);
+  remove(path);
+
+  mu_assert( strstr(buf, "type=\"UnstructuredGrid\"") != NULL,
+      "Wrong VTU file type.");
+  mu_assert( memcmp(buf + size - strlen(tail), tail, strlen(tail)) == 0,
+      "VTU file is not terminated.");
+
+  data = strstr(buf, "NumberOfCells=\"");
+  mu_assert( data != NULL && strtol(data + 15, NULL, 10) == n_cells,
+      "Wrong number of VTU cells.");
+
+  /*--------------------------------------------------------
+  | The appended data starts with the node coordinates
+  | (assumes a little-endian host)
+  --------------------------------------------------------*/
+  data = strstr(buf, "<AppendedData encoding=\"raw\">");
+  mu_assert( data != NULL, "Missing VTU appended data.");
+  data = strchr(data, '_') + 1;
+
+  memcpy(&n_bytes, data, sizeof(n_bytes));
+  mu_assert( n_bytes == 24 * (uint64_t) mesh->no_nodes,
+      "Wrong size of VTU point array.");
+
+  i = 0;
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmNode *n = (tmNode*) cur->value;
+
+    memcpy(xy, data + 8 + 24 * i, sizeof(xy));
+    mu_assert( xy[0] == n->xy[0] && xy[1] == n->xy[1] && xy[2] == 0.0,
+        "Wrong VTU node coordinates.");
+    i += 1;
+  }
+
+  free(buf);
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmMesh_writeVTU() */
+
+/************************************************************
+* Returns the first occurence of str in the binary buffer
+* buf of size n or NULL
+************************************************************/
+static char *find_bytes(char *buf, long n, const char *str)
+{
+  long len = (long) strlen(str);
+  long i;
+
+  for (i = 0; i + len <= n; i++)
+    if ( memcmp(buf + i, str, len) == 0 )
+      return buf + i;
+
+  return NULL;
+}
+
+/************************************************************
+* Unit test function for the Gmsh MSH mesh output
+************************************************************/
+char *test_tmMesh_writeMSH()
+{
+  tmMesh *mesh = create_flip_test_bdry();
+  const char *path = "tmesh_test_mesh.msh";
+  const char *head = "$MeshFormat\n4.1 1 8\n";
+  const char *tail = "\n$EndElements\n";
+  char     *buf, *data;
+  uint64_t  vals[4];
+  uint64_t  n_sides = 0;
+  int32_t   one;
+  long      size;
+  FILE     *fp;
+  tmListNode *cur;
+  int       j;
+
+  tmMesh_ADFMeshing(mesh);
+
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *t = (tmTri*) cur->value;
+    tmTri *nbrs[3] = { t->t1, t->t2, t->t3 };
+
+    for (j = 0; j < 3; j++)
+      if ( nbrs[j] == NULL || nbrs[j] == t )
+        n_sides += 1;
+  }
+
+  mu_assert( tmMesh_writeMSH(mesh, path) == TRUE,
+      "Failed to write MSH mesh file.");
+
+  fp = fopen(path, "rb");
+  mu_assert( fp != NULL, "MSH mesh file does not exist.");
+
+  fseek(fp, 0, SEEK_END);
+  size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+
+  buf = calloc(size+1, sizeof(char));
+  mu_assert( fread(buf, 1, size, fp) == (size_t) size,
+      "Failed to read MSH mesh file.");
+  fclose(fp);
+  remove(path);
+
+  /*--------------------------------------------------------
+  | Check the binary header and the element counts
+  | (assumes a little-endian host)
+  --------------------------------------------------------*/
+  mu_assert( memcmp(buf, head, strlen(head)) == 0,
+      "Wrong MSH file format.");
+  memcpy(&one, buf + strlen(head), sizeof(one));
+  mu_assert( one == 1, "Wrong MSH endianness check.");
+  mu_assert( memcmp(buf + size - strlen(tail), tail, strlen(tail)) == 0,
+      "MSH file is not terminated.");
+  mu_assert( find_bytes(buf, size, "1 1 \"marker_1\"") != NULL
+          && find_bytes(buf, size, "1 2 \"marker_0\"") != NULL,
+      "Missing MSH physical group of the boundary marker.");
+  mu_assert( find_bytes(buf, size, "1 3 \"boundary_0\"") != NULL
+          && find_bytes(buf, size, "1 4 \"boundary_1\"") != NULL,
+      "Missing MSH physical group of the boundary.");
+
+  data = find_bytes(buf, size, "$Nodes\n");
+  mu_assert( data != NULL, "Missing MSH nodes.");
+  memcpy(vals, data + strlen("$Nodes\n"), sizeof(vals));
+  mu_assert( vals[0] == 1 && vals[1] == (uint64_t) mesh->no_nodes &&
+             vals[2] == 1 && vals[3] == (uint64_t) mesh->no_nodes,
+      "Wrong MSH node block.");
+
+  data = find_bytes(data, size - (data - buf), "$Elements\n");
+  mu_assert( data != NULL, "Missing MSH elements.");
+  memcpy(vals, data + strlen("$Elements\n"), sizeof(vals));
+  mu_assert( vals[1] == (uint64_t) mesh->no_tris + n_sides,
+      "Wrong number of MSH elements.");
+
+  free(buf);
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmMesh_writeMSH() */
+
+/************************************************************
+* Row function for test_tmWriter(): writes the row index
+************************************************************/
+static void write_test_rows(void     *data,
+                            tmWriter *w,
+                            size_t    i_beg,
+                            size_t    i_end)
+{
+  size_t i;
+
+  (void) data;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmWriter_putInt(w, (long) i, 0);
+    tmWriter_putChar(w, '\n');
+  }
+}
+
+/************************************************************
+* Unit test function for the buffered writer
+************************************************************/
+char *test_tmWriter()
+{
+  double values[] = { 0.0, -0.0, 1.5, -2.25, 0.000005, 
+                      -0.000004, 0.125, 2.675, 1.0E-7, 
+                      123456.789012, -98765.4321, 1.0E20 };
+  int    n_values = sizeof(values) / sizeof(values[0]);
+  char   ref[128];
+  size_t pos = 0;
+  int    i;
+
+  tmWriter *w    = tmWriter_create(-1);
+  tmPool   *pool = tmPool_create(2);
+
+  mu_assert( w != NULL, "Failed to create writer.");
+
+  /*--------------------------------------------------------
+  | Formatted values must be the same as with printf()
+  --------------------------------------------------------*/
+  for (i = 0; i < n_values; i++)
+  {
+    w->n = 0;
+    tmWriter_putFixed(w, values[i], 9, 5);
+    tmWriter_putChar(w, '\0');
+    sprintf(ref, "%9.5f", values[i]);
+    mu_assert( strcmp(w->buf, ref) == 0, 
+        "Fixed-point value differs from printf().");
+
+    w->n = 0;
+    tmWriter_putInt(w, (long) values[i], 9);
+    tmWriter_putChar(w, '\0');
+    sprintf(ref, "%9ld", (long) values[i]);
+    mu_assert( strcmp(w->buf, ref) == 0, 
+        "Integer value differs from printf().");
+
+    w->n = 0;
+    tmWriter_putDouble(w, values[i]);
+    tmWriter_putChar(w, '\0');
+    mu_assert( strtod(w->buf, NULL) == values[i], 
+        "Floating point value is not reproduced.");
+  }
+
+  /*--------------------------------------------------------
+  | Rows, which are formatted in parallel, must be 
+  | written in order
+  --------------------------------------------------------*/
+  w->n = 0;
+  tmWriter_writeRows(w, pool, 10 * TM_WRITER_CHUNK_ROWS + 7, 
+                     write_test_rows, NULL);
+
+  for (i = 0; i < 10 * TM_WRITER_CHUNK_ROWS + 7; i++)
+  {
+    int len = sprintf(ref, "%d\n", i);
+    mu_assert( pos + len <= w->n && 
+               memcmp(w->buf + pos, ref, len) == 0,
+        "Rows are written in the wrong order.");
+    pos += len;
+  }
+  mu_assert( pos == w->n, "Wrong number of written bytes.");
+
+  tmWriter_destroy(w);
+  tmPool_destroy(pool);
+
+  return NULL;
+
+} /* test_tmWriter() */
+
+/************************************************************
+* Sink for test_tmMesh_sink(): Stores the received nodes 
+* and triangles
+************************************************************/
+typedef struct test_sink {
+  tmMesh   *mesh;
+  tmDouble (*xy)[2];
+  tmIndex  (*tris)[3];
+  int        n_nodes;
+  int        n_tris;
+  int        n_max;
+  int        mesh_tris_first;  /* Mesh triangles at first */
+  tmBool     ok;               /* output                  */
+} test_sink;
+
+static void test_sink_node(void *ctx, tmIndex index, tmDouble xy[2])
+{
+  test_sink *sink = (test_sink*) ctx;
+
+  if ( index != sink->n_nodes || index >= sink->n_max )
+  {
+    sink->ok = FALSE;
+    return;
+  }
+
+  sink->xy[index][0] = xy[0];
+  sink->xy[index][1] = xy[1];
+  sink->n_nodes += 1;
+}
+
+static void test_sink_tri(void *ctx, tmIndex index, 
+                          tmIndex n1, tmIndex n2, tmIndex n3)
+{
+  test_sink *sink = (test_sink*) ctx;
+
+  if ( sink->n_tris == 0 )
+    sink->mesh_tris_first = sink->mesh->no_tris;
+
+  /*--------------------------------------------------------
+  | Triangles must only refer to nodes, which have 
+  | already been received
+  --------------------------------------------------------*/
+  if ( index != sink->n_tris || index >= sink->n_max ||
+       n1 >= sink->n_nodes || n2 >= sink->n_nodes || 
+       n3 >= sink->n_nodes )
+  {
+    sink->ok = FALSE;
+    return;
+  }
+
+  sink->tris[index][0] = n1;
+  sink->tris[index][1] = n2;
+  sink->tris[index][2] = n3;
+  sink->n_tris += 1;
+}
+
+/************************************************************
+* Unit test function for the output of nodes and triangles
+* during the meshing
+************************************************************/
+char *test_tmMesh_sink()
+{
+  tmMesh    *mesh = create_flip_test_bdry();
+  test_sink  sink;
+  tmListNode *cur;
+  int i, j;
+
+  sink.mesh            = mesh;
+  sink.n_max           = 100000;
+  sink.xy              = calloc(sink.n_max, sizeof(*sink.xy));
+  sink.tris            = calloc(sink.n_max, sizeof(*sink.tris));
+  sink.n_nodes         = 0;
+  sink.n_tris          = 0;
+  sink.mesh_tris_first = 0;
+  sink.ok              = TRUE;
+
+  tmMesh_setSink(mesh, test_sink_node, test_sink_tri, &sink);
+  tmMesh_ADFMeshing(mesh);
+
+  mu_assert( sink.ok == TRUE, "Mesh sink received invalid data.");
+  mu_assert( sink.n_nodes == mesh->no_nodes,
+      "Mesh sink did not receive all nodes.");
+  mu_assert( sink.n_tris == mesh->no_tris,
+      "Mesh sink did not receive all triangles.");
+  mu_assert( sink.mesh_tris_first < mesh->no_tris,
+      "Mesh sink did not receive triangles during the meshing.");
+
+  /*--------------------------------------------------------
+  | The mesh must be sorted in the order of the output
+  --------------------------------------------------------*/
+  i = 0;
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmNode *n = (tmNode*) cur->value;
+    mu_assert( n->xy[0] == sink.xy[i][0] && n->xy[1] == sink.xy[i][1],
+        "Mesh nodes are not sorted in the order of the output.");
+    i += 1;
+  }
+
+  i = 0;
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *t = (tmTri*) cur->value;
+    mu_assert( t->n1->stream_index == sink.tris[i][0] &&
+               t->n2->stream_index == sink.tris[i][1] &&
+               t->n3->stream_index == sink.tris[i][2],
+        "Mesh triangles are not sorted in the order of the output.");
+    i += 1;
+  }
+
+  /*--------------------------------------------------------
+  | Triangle neighbors must be symmetric after sorting
+  --------------------------------------------------------*/
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *t      = (tmTri*) cur->value;
+    tmTri *nbr[3] = { t->t1, t->t2, t->t3 };
+
+    for (j = 0; j < 3; j++)
+      mu_assert( nbr[j] != NULL && ( nbr[j] == t 
+                 || nbr[j]->t1 == t || nbr[j]->t2 == t 
+                 || nbr[j]->t3 == t ),
+          "Streamed triangle neighbors are inconsistent.");
+  }
+
+  free(sink.xy);
+  free(sink.tris);
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmMesh_sink() */
+
+/************************************************************
+* Unit test function for the mesh renumbering
+************************************************************/ 
+char *test_tmMesh_renumber()
+{
+  int methods[2] = { TM_RENUMBER_HILBERT, TM_RENUMBER_RCM };
+  int m;
+
+  for (m = 0; m < 2; m++)
+  {
+    tmMesh     *mesh = create_flip_test_bdry();
+    tmListNode *cur;
+    tmDouble    area;
+    long        bw_0, pr_0, bw_1, pr_1;
+    int         n_nodes, n_tris, i;
+
+    tmMesh_ADFMeshing(mesh);
+
+    n_nodes = mesh->no_nodes;
+    n_tris  = mesh->no_tris;
+    area    = mesh->areaTris;
+
+    mu_assert( tmMesh_calcBandwidth(mesh, &bw_0, &pr_0) == TRUE,
+        "Failed to compute the mesh bandwidth.");
+    mu_assert( tmMesh_renumber(mesh, methods[m]) == TRUE,
+        "Failed to renumber the mesh.");
+    mu_assert( tmMesh_calcBandwidth(mesh, &bw_1, &pr_1) == TRUE,
+        "Failed to compute the mesh bandwidth.");
+
+    if ( methods[m] == TM_RENUMBER_RCM )
+      mu_assert( bw_1 <= bw_0 && pr_1 <= pr_0,
+          "RCM renumbering increased the mesh bandwidth.");
+
+    mu_assert( mesh->no_nodes == n_nodes && mesh->no_tris == n_tris,
+        "Mesh renumbering changed the number of entities.");
+
+    /*------------------------------------------------------
+    | Indices must follow the list order and triangle 
+    | neighbors must still share their edges
+    ------------------------------------------------------*/
+    i = 0;
+    for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+    {
+      tmNode *n = (tmNode*) cur->value;
+      mu_assert( n->index == i && n->stack_pos == cur,
+          "Renumbered node index does not match the list order.");
+      i += 1;
+    }
+    mu_assert( i == n_nodes, "Renumbering lost mesh nodes.");
+
+    tmMesh_setTriNeighbors(mesh);
+    tmMesh_calcArea(mesh);
+
+    i = 0;
+    for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+    {
+      tmTri *t = (tmTri*) cur->value;
+      mu_assert( t->index == i && t->stack_pos == cur,
+          "Renumbered triangle index does not match the list order.");
+      mu_assert( t->t1 == NULL || t->t1->t1 == t || 
+                 t->t1->t2 == t || t->t1->t3 == t,
+          "Renumbered triangle neighbors are inconsistent.");
+      i += 1;
+    }
+    mu_assert( i == n_tris, "Renumbering lost mesh triangles.");
+    mu_assert( EQ(area, mesh->areaTris),
+        "Renumbering changed the mesh area.");
+
+    tmMesh_destroy(mesh);
+  }
+
+  return NULL;
+
+} /* test_tmMesh_renumber() */
+
+/************************************************************
+* Unit test function for the mesh cache
+************************************************************/ 
+char *test_tmCache()
+{
+  const char *dir  = "tmesh_test_cache";
+  const char *out  = "tmesh_test_cache.out";
+  const char *data = "cached mesh data\n";
+  char        key_1[17], key_2[17];
+  char        buf[64], path[64];
+  tmCache    *cache, *other;
+  FILE       *fp;
+  size_t      n;
+
+  cache = tmCache_create(dir, 0);
+  mu_assert( cache != NULL, "Failed to create mesh cache.");
+
+  tmCache_updateKey(cache, "mesh_1", 6);
+  tmCache_key(cache, key_1);
+  mu_assert( tmCache_fetch(cache, out) == FALSE,
+      "Mesh cache returned a missing entry.");
+
+  /*--------------------------------------------------------
+  | Store and return an entry
+  --------------------------------------------------------*/
+  fp = fopen(tmCache_tmpPath(cache), "w");
+  mu_assert( fp != NULL, "Failed to open new cache entry.");
+  fputs(data, fp);
+  fclose(fp);
+
+  mu_assert( tmCache_store(cache) == TRUE,
+      "Failed to store mesh cache entry.");
+  mu_assert( tmCache_fetch(cache, out) == TRUE,
+      "Failed to fetch mesh cache entry.");
+
+  fp = fopen(out, "r");
+  mu_assert( fp != NULL, "Missing mesh cache output.");
+  n = fread(buf, 1, sizeof(buf)-1, fp);
+  buf[n] = '\0';
+  fclose(fp);
+  remove(out);
+
+  mu_assert( strcmp(buf, data) == 0, "Wrong mesh cache output.");
+
+  /*--------------------------------------------------------
+  | An entry of another input is not returned for a 
+  | colliding key
+  --------------------------------------------------------*/
+  other = tmCache_create(dir, 0);
+  mu_assert( other != NULL, "Failed to create mesh cache.");
+  tmCache_updateKey(other, "mesh_3", 6);
+  tmCache_key(other, key_2);
+
+  sprintf(buf, "%s/%s.tmc", dir, key_1);
+  sprintf(path, "%s/%s.tmc", dir, key_2);
+  mu_assert( rename(buf, path) == 0, "Missing mesh cache entry.");
+  mu_assert( tmCache_fetch(other, out) == FALSE,
+      "Mesh cache returned the entry of another input.");
+  mu_assert( rename(path, buf) == 0, "Missing mesh cache entry.");
+
+  tmCache_destroy(other);
+
+  /*--------------------------------------------------------
+  | A new key replaces the old entry for a size limit of 0
+  --------------------------------------------------------*/
+  tmCache_updateKey(cache, "_2", 2);
+  tmCache_key(cache, key_2);
+  mu_assert( strcmp(key_1, key_2) != 0, "Mesh cache keys are equal.");
+
+  fp = fopen(tmCache_tmpPath(cache), "w");
+  mu_assert( fp != NULL, "Failed to open new cache entry.");
+  fputs(data, fp);
+  fclose(fp);
+
+  mu_assert( tmCache_store(cache) == TRUE,
+      "Failed to store mesh cache entry.");
+
+  sprintf(buf, "%s/%s.tmc", dir, key_1);
+  mu_assert( fopen(buf, "r") == NULL,
+      "Least recently used cache entry was not removed.");
+
+  sprintf(buf, "%s/%s.tmc", dir, key_2);
+  mu_assert( remove(buf) == 0, "Missing new cache entry.");
+
+  tmCache_destroy(cache);
+  remove(dir);
+
+  return NULL;
+
+} /* test_tmCache() */
+
+/************************************************************
+* Checks a mesh, that has been loaded by tmMesh_load(), 
+* against the mesh, from which the file has been written
+************************************************************/
+static char *check_loaded_mesh(tmMesh *mesh, tmMesh *ref)
+{
+  tmListNode *cur;
+
+  mu_assert( mesh != NULL, "Failed to load mesh.");
+  mu_assert( mesh->no_nodes == ref->no_nodes 
+          && mesh->no_tris  == ref->no_tris
+          && mesh->no_edges == ref->no_edges
+          && mesh->no_bdrys == ref->no_bdrys,
+      "Wrong number of loaded mesh objects.");
+  mu_assert( ABS(mesh->areaTris - ref->areaTris) < 1.0E-3,
+      "Wrong area of loaded mesh.");
+
+  mu_assert( mesh->nodes_qtree->n_obj_tot == mesh->no_nodes
+          && mesh->edges_qtree->n_obj_tot == mesh->no_edges
+          && mesh->tris_qtree->n_obj_tot  == mesh->no_tris,
+      "Loaded mesh objects are missing in the qtrees.");
+
+  for (cur = mesh->bdry_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmBdry *bdry = (tmBdry*) cur->value;
+
+    mu_assert( bdry->is_interior == (bdry->index == 1),
+        "Wrong type of loaded boundary.");
+    mu_assert( bdry->edges_qtree->n_obj_tot == bdry->no_edges,
+        "Loaded boundary edges are missing in the qtree.");
+  }
+
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *t = (tmTri*) cur->value;
+
+    mu_assert( t->e1 != NULL && t->e2 != NULL && t->e3 != NULL,
+        "Loaded triangle without edges.");
+    mu_assert( (t->t1 == t || t->t1->t1 == t || t->t1->t2 == t 
+                           || t->t1->t3 == t) &&
+               (t->t2 == t || t->t2->t1 == t || t->t2->t2 == t 
+                           || t->t2->t3 == t) &&
+               (t->t3 == t || t->t3->t1 == t || t->t3->t2 == t 
+                           || t->t3->t3 == t),
+        "Loaded triangle neighbors are not symmetric.");
+  }
+
+  for (cur = mesh->edges_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmEdge *e = (tmEdge*) cur->value;
+
+    mu_assert( e->t1 != NULL, "Loaded mesh edge without triangle.");
+    mu_assert( e->t2 != NULL || e->bdry_marker == 0 
+                             || e->bdry_marker == 1,
+        "Wrong marker of loaded boundary edge.");
+  }
+
+  return NULL;
+}
+
+/************************************************************
+* Unit test function for the loading of a mesh
+************************************************************/
+char *test_tmMesh_load()
+{
+  tmMesh     *ref  = create_flip_test_mesh();
+  const char *path = "tmesh_test_load.dat";
+  char       *msg;
+  tmMesh     *mesh;
+  tmWriter   *w;
+  tmListNode *cur;
+  tmDouble    xy[2] = { 7.5, 8.5 };
+  int         no_nodes, i;
+
+  /*--------------------------------------------------------
+  | Binary file
+  --------------------------------------------------------*/
+  mu_assert( tmMesh_writeBinary(ref, path) == TRUE,
+      "Failed to write binary mesh file.");
+
+  mesh = tmMesh_load(path, 20, 1.0, size_fun_2);
+  msg  = check_loaded_mesh(mesh, ref);
+  if ( msg != NULL )
+    return msg;
+
+  /*--------------------------------------------------------
+  | The loaded mesh can be refined
+  --------------------------------------------------------*/
+  no_nodes = mesh->no_nodes;
+
+  tmMesh_delaunayFlip(mesh);
+  mu_assert( mesh->delaunay_stack->count == 0,
+      "Delaunay stack is not empty after edge flips.");
+
+  tmMesh_refineLocally(mesh, xy);
+  mu_assert( mesh->no_nodes == no_nodes + 1 
+          && mesh->nodes_qtree->n_obj_tot == no_nodes + 1
+          && mesh->no_tris  == ref->no_tris  + 2
+          && mesh->no_edges == ref->no_edges + 3,
+      "Failed to refine loaded mesh.");
+  mu_assert( mesh->delaunay_stack->count == 0,
+      "Refined mesh is not delaunay.");
+
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri *t = (tmTri*) cur->value;
+
+    mu_assert( (t->t1 == t || t->t1->t1 == t || t->t1->t2 == t 
+                           || t->t1->t3 == t) &&
+               (t->t2 == t || t->t2->t1 == t || t->t2->t2 == t 
+                           || t->t2->t3 == t) &&
+               (t->t3 == t || t->t3->t1 == t || t->t3->t2 == t 
+                           || t->t3->t3 == t),
+        "Refined triangle neighbors are not symmetric.");
+  }
+  mu_assert( ABS(mesh->areaTris - ref->areaTris) < 1.0E-8,
+      "Refinement changed the area of the loaded mesh.");
+
+  tmMesh_destroy(mesh);
+
+  /*--------------------------------------------------------
+  | Text files with and without boundary sections
+  --------------------------------------------------------*/
+  for (i = 0; i < 2; i++)
+  {
+    w = tmWriter_open(path);
+    mu_assert( w != NULL, "Failed to open text mesh file.");
+
+    if ( i == 0 )
+      tmMesh_writeMesh(ref, w);
+    else
+      tmMesh_writeMeshIncomflow(ref, w);
+
+    mu_assert( tmWriter_destroy(w) == TRUE,
+        "Failed to write text mesh file.");
+
+    mesh = tmMesh_load(path, 20, 1.0, size_fun_2);
+    msg  = check_loaded_mesh(mesh, ref);
+    if ( msg != NULL )
+      return msg;
+
+    tmMesh_destroy(mesh);
+  }
+
+  remove(path);
+
+  mu_assert( tmMesh_load(path, 20, 1.0, size_fun_2) == NULL,
+      "Loaded a missing mesh file.");
+
+  tmMesh_destroy(ref);
+
+  return NULL;
+
+} /* test_tmMesh_load() */
+
+/*************************************************************
+* Compares two expression values bitwise
+*************************************************************/
+static tmBool expr_equal(tmDouble a, tmDouble b)
+{
+  return (isnan(a) && isnan(b)) || memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+/*************************************************************
+* Unit test function for the compiled size function 
+* expressions
+*************************************************************/
+char *test_tmExpr()
+{
+  const char *exprs[] = { 
+    "0.5-0.43*exp(-0.03*((1.-x)*(2.-x)+(9.-y)*(9.-y)))",
+    "x", "-y", "2*pi", "x^2+y^-1.5", "-(x-y)/(x*y)", 
+    "atan2(y, x) + sqrt(abs(x))*ln(1+y*y)", "x % 0.7 - -y",
+    "sin x + cos(y)^2 * tanh(x*y)", "(x, y+1), 3*x", 
+    "1+x+2+x+3+x+4+x+5+x+6+x+7+x+8+x+9+x", NULL };
+
+  tmDouble x, y;
+  te_variable vars[] = { {"x", &x, TE_VARIABLE, NULL}, 
+                         {"y", &y, TE_VARIABLE, NULL} };
+  tmDouble xy[100][2], out[100];
+  int i, j, err;
+
+  for (i = 0; i < 100; i++)
+  {
+    xy[i][0] = -5.0 + 0.113 * i;
+    xy[i][1] =  3.0 - 0.071 * i;
+  }
+
+  for (j = 0; exprs[j] != NULL; j++)
+  {
+    te_expr *ref  = te_compile(exprs[j], vars, 2, &err);
+    tmExpr  *expr = tmExpr_compile(exprs[j], &err);
+
+    mu_assert( ref != NULL && expr != NULL && err == 0,
+        "Failed to compile expression.");
+    mu_assert( expr->n_regs <= 2 + expr->n_consts + 4,
+        "Expression uses too many registers.");
+
+    mu_assert( tmExpr_evalBatch(expr, 100, 
+                 (const tmDouble (*)[2]) xy, out) == TRUE,
+        "Failed to evaluate expression batch.");
+
+    for (i = 0; i < 100; i++)
+    {
+      x = xy[i][0];
+      y = xy[i][1];
+
+      mu_assert( expr_equal(tmExpr_eval(expr, xy[i]), te_eval(ref)),
+          "Compiled expression differs from te_eval().");
+      mu_assert( expr_equal(out[i], te_eval(ref)),
+          "Batch expression differs from te_eval().");
+    }
+
+    te_free(ref);
+    tmExpr_destroy(expr);
+  }
+
+  /*----------------------------------------------------------
+  | Constant subexpressions are folded
+  ----------------------------------------------------------*/
+  tmExpr *expr = tmExpr_compile("x * (2^3 + cos(0))", &err);
+  mu_assert( expr != NULL && expr->n_code == 1 && 
+             expr->n_consts == 1 && expr->consts[0] == 9.0,
+      "Failed to fold constant expression.");
+  tmExpr_destroy(expr);
+
+  /*----------------------------------------------------------
+  | Invalid expressions
+  ----------------------------------------------------------*/
+  mu_assert( tmExpr_compile("x + z", &err) == NULL && err > 0,
+      "Compiled invalid expression.");
+  mu_assert( tmExpr_compile("ncr(x,", &err) == NULL && err > 0,
+      "Compiled invalid expression.");
+
+  return NULL;
+
+} /* test_tmExpr() */
+
+/*************************************************************
+* Performance of the compiled size function expression of
+* share/files/size_function.para compared to te_eval()
+*************************************************************/
+char *test_tmExpr_performance()
+{
+  const char *str = 
+    "0.5-0.43*exp(-0.03*((1.-x)*(2.-x)+(9.-y)*(9.-y)))";
+  const int n = 1000000;
+
+  tmDouble x, y;
+  te_variable vars[] = { {"x", &x, TE_VARIABLE, NULL}, 
+                         {"y", &y, TE_VARIABLE, NULL} };
+  tmDouble (*xy)[2] = calloc(n, sizeof(*xy));
+  tmDouble  *out    = calloc(n, sizeof(tmDouble));
+  tmDouble   sum_0 = 0.0, sum_1 = 0.0, sum_2 = 0.0;
+  int i, err;
+
+  te_expr *ref  = te_compile(str, vars, 2, &err);
+  tmExpr  *expr = tmExpr_compile(str, &err);
+
+  for (i = 0; i < n; i++)
+  {
+    xy[i][0] = -10.0 + 30.0 * (tmDouble) (i % 1000) / 1000.0;
+    xy[i][1] = -10.0 + 30.0 * (tmDouble) (i / 1000) / 1000.0;
+  }
+
+  clock_t tic_0 = clock();
+
+  for (i = 0; i < n; i++)
+  {
+    x = xy[i][0];
+    y = xy[i][1];
+    sum_0 += te_eval(ref);
+  }
+
+  clock_t tic_1 = clock();
+
+  for (i = 0; i < n; i++)
+    sum_1 += tmExpr_eval(expr, xy[i]);
+
+  clock_t tic_2 = clock();
+
+  tmExpr_evalBatch(expr, n, (const tmDouble (*)[2]) xy, out);
+  for (i = 0; i < n; i++)
+    sum_2 += out[i];
+
+  clock_t tic_3 = clock();
+
+  printf("\n");
+  printf(" > Size function evaluations     : %d\n", n);
+  printf(" > te_eval()                     : %e sec\n", (double) (tic_1 - tic_0) / CLOCKS_PER_SEC );
+  printf(" > tmExpr_eval()                 : %e sec\n", (double) (tic_2 - tic_1) / CLOCKS_PER_SEC );
+  printf(" > tmExpr_evalBatch()            : %e sec\n", (double) (tic_3 - tic_2) / CLOCKS_PER_SEC );
+
+  mu_assert( sum_0 == sum_1 && sum_0 == sum_2,
+      "Compiled expression differs from te_eval().");
+
+  te_free(ref);
+  tmExpr_destroy(expr);
+  free(xy);
+  free(out);
+
+  return NULL;
+
+} /* test_tmExpr_performance() */
+
+/*************************************************************
+* Batch version of size_fun_5()
+*************************************************************/
+static void size_fun_5_batch(void *ctx, int n, 
+                             tmDouble (*xy)[2], tmDouble *out)
+{
+  int i;
+  (void) ctx;
+  for (i = 0; i < n; i++)
+    out[i] = size_fun_5(xy[i]);
+}
+
+/*************************************************************
+* Creates a mesh with boundaries for the size function 
+* batch test
+*************************************************************/
+static tmMesh *create_size_fun_test_mesh(tmBool batch)
+{
+  tmDouble xy_min[2] = { -1.0, -1.0 };
+  tmDouble xy_max[2] = { 17.0, 13.0 };
+  tmMesh *mesh = tmMesh_create(xy_min, xy_max, 20, 
+                               GLOBSIZE, size_fun_5);
+  int i;
+
+  if (batch == TRUE)
+    tmMesh_setSizeFunBatch(mesh, size_fun_5_batch);
+
+  tmDouble xy_ext[5][2] = { {  0.0,  0.0 }, { 16.0,  0.0 },
+                            { 16.0, 12.0 }, {  4.0, 12.0 }, 
+                            {  0.0,  7.0 } };
+  tmNode  *n_ext[5];
+
+  for (i = 0; i < 5; i++)
+    n_ext[i] = tmNode_create(mesh, xy_ext[i]);
+
+  tmBdry *bdry_ext = tmMesh_addBdry(mesh, FALSE, 0);
+  for (i = 0; i < 5; i++)
+    tmBdry_edgeCreate(bdry_ext, n_ext[i], n_ext[(i+1)%5], 
+                      0, 1.5);
+
+  tmDouble xy_int[3][2] = { { 10.0, 3.0 }, { 11.0, 7.0 },
+                            { 13.0, 4.0 } };
+  tmNode  *n_int[3];
+
+  for (i = 0; i < 3; i++)
+    n_int[i] = tmNode_create(mesh, xy_int[i]);
+
+  tmBdry *bdry_int = tmMesh_addBdry(mesh, TRUE, 1);
+  for (i = 0; i < 3; i++)
+    tmBdry_edgeCreate(bdry_int, n_int[i], n_int[(i+1)%3], 
+                      1, 1.2);
+
+  return mesh;
+}
+
+/*************************************************************
+* Unit test function for the batch evaluation of the 
+* size function
+*************************************************************/
+char *test_tmMesh_sizeFunBatch()
+{
+  tmMesh *mesh  = create_size_fun_test_mesh(FALSE);
+  tmMesh *batch = create_size_fun_test_mesh(TRUE);
+  tmDouble xy[200][2], out_1[200], out_2[200];
+  tmListNode *cur_1, *cur_2;
+  int i;
+
+  for (i = 0; i < 200; i++)
+  {
+    xy[i][0] = -0.5 + 0.0851 * i;
+    xy[i][1] = 12.5 - 0.0637 * i;
+  }
+
+  /*----------------------------------------------------------
+  | The batch evaluation equals the one of every point
+  ----------------------------------------------------------*/
+  tmMesh_sizeFunBatch(mesh,  200, xy, out_1);
+  tmMesh_sizeFunBatch(batch, 200, xy, out_2);
+
+  for (i = 0; i < 200; i++)
+  {
+    tmDouble rho = tmMesh_sizeFun(mesh, xy[i]);
+    mu_assert( memcmp(&rho, &out_1[i], sizeof(rho)) == 0,
+        "Size function batch differs from tmMesh_sizeFun().");
+    mu_assert( memcmp(&rho, &out_2[i], sizeof(rho)) == 0,
+        "User size function batch differs from tmMesh_sizeFun().");
+  }
+
+  /*----------------------------------------------------------
+  | Both meshes are the same
+  ----------------------------------------------------------*/
+  tmMesh_ADFMeshing(mesh);
+  tmMesh_ADFMeshing(batch);
+
+  mu_assert( mesh->no_nodes == batch->no_nodes &&
+             mesh->no_tris  == batch->no_tris,
+      "Mesh with size function batch differs.");
+
+  for (cur_1 = mesh->nodes_stack->first, 
+       cur_2 = batch->nodes_stack->first; 
+       cur_1 != NULL && cur_2 != NULL; 
+       cur_1 = cur_1->next, cur_2 = cur_2->next)
+  {
+    tmNode *n1 = (tmNode*) cur_1->value;
+    tmNode *n2 = (tmNode*) cur_2->value;
+    mu_assert( n1->xy[0] == n2->xy[0] && n1->xy[1] == n2->xy[1],
+        "Mesh with size function batch differs.");
+  }
+
+  tmMesh_destroy(mesh);
+  tmMesh_destroy(batch);
+
+  return NULL;
+
+} /* test_tmMesh_sizeFunBatch() */
+
+/*************************************************************
+* Unit test function for the subdivision of edges with the
+* integral of the size function
+*************************************************************/
+char *test_tmMesh_subdivision()
+{
+  tmDouble xy_min[2] = { -1.0, -1.0 };
+  tmDouble xy_max[2] = { 11.0, 11.0 };
+  tmMesh *mesh = tmMesh_create(xy_min, xy_max, 20, 0.5, NULL);
+  tmDouble (*xy)[2] = NULL;
+  tmEdge *edges[4];
+  tmListNode *cur;
+  int     off[5];
+  int     i, j;
+
+  tmMesh_setSubdivision(mesh, TM_SUBDIVIDE_INTEGRAL);
+
+  tmDouble xy_ext[4][2] = { {  0.0,  0.0 }, { 10.0,  0.0 },
+                            { 10.0, 10.0 }, {  0.0, 10.0 } };
+  tmNode  *n_ext[4];
+
+  for (i = 0; i < 4; i++)
+    n_ext[i] = tmNode_create(mesh, xy_ext[i]);
+
+  tmBdry *bdry = tmMesh_addBdry(mesh, FALSE, 0);
+  for (i = 0; i < 4; i++)
+    edges[i] = tmBdry_edgeCreate(bdry, n_ext[i], n_ext[(i+1)%4], 
+                                 0, 0.0);
+
+  tmBdry_initSizeFun(bdry);
+
+  /*----------------------------------------------------------
+  | The constant element size 2 * 0.5 results in nodes 
+  | at every unit length
+  ----------------------------------------------------------*/
+  mu_assert( tmEdge_subdivide(mesh, edges, 4, 1.0, off, &xy) == TRUE,
+      "Failed to subdivide edges.");
+  mu_assert( off[4] == 36, "Wrong number of subdivision nodes.");
+
+  for (i = 0; i < 4; i++)
+    for (j = off[i]; j < off[i+1]; j++)
+    {
+      tmDouble s = (tmDouble) (j - off[i] + 1);
+      tmDouble x = xy_ext[i][0] + 0.1 * s * (xy_ext[(i+1)%4][0] - xy_ext[i][0]);
+      tmDouble y = xy_ext[i][1] + 0.1 * s * (xy_ext[(i+1)%4][1] - xy_ext[i][1]);
+      mu_assert( fabs(xy[j][0] - x) < 1.0E-10 && 
+                 fabs(xy[j][1] - y) < 1.0E-10,
+          "Wrong position of subdivision node.");
+    }
+
+  free(xy);
+
+  tmBdry_refine(bdry);
+
+  mu_assert( bdry->no_edges == 40 && mesh->no_nodes == 40,
+      "Failed to subdivide boundary.");
+  mu_assert( mesh->nodes_qtree->n_obj_tot == 40 &&
+             bdry->edges_qtree->n_obj_tot == 40,
+      "Subdivided boundary is not in the qtrees.");
+
+  tmMesh_destroy(mesh);
+
+  /*----------------------------------------------------------
+  | Mesh with a subdivided advancing front
+  ----------------------------------------------------------*/
+  mesh = create_size_fun_test_mesh(TRUE);
+  tmMesh_setSubdivision(mesh, TM_SUBDIVIDE_INTEGRAL);
+
+  tmMesh_ADFMeshing(mesh);
+
+  mu_assert( mesh->no_tris > 0 && 
+      fabs(mesh->areaTris - mesh->areaBdry) < 1.0E-5 * mesh->areaBdry,
+      "Failed to mesh with subdivided advancing front.");
+  mu_assert( mesh->nodes_qtree->n_obj_tot == mesh->no_nodes,
+      "Subdivided advancing front is not in the qtrees.");
+
+  tmMesh_destroy(mesh);
+
+  /*----------------------------------------------------------
+  | Geometry of share/files/example.para, whose refined 
+  | corners require edges, that are shorter than the 
+  | subdivision of the unrefined boundary
+  ----------------------------------------------------------*/
+  tmDouble xy_min_ex[2] = { -10.0, -10.0 };
+  tmDouble xy_max_ex[2] = {  20.0,  20.0 };
+  tmDouble xy_ex[11][2] = { {  1.0,  1.0 }, { 10.0,  0.0 },
+                            { 10.0, 10.0 }, {  0.0, 10.0 },
+                            {  2.0,  2.0 }, {  2.0,  4.0 },
+                            {  4.0,  4.0 }, {  4.0,  2.0 },
+                            {  6.0,  5.0 }, {  7.0,  7.0 },
+                            {  9.0,  4.0 } };
+  tmNode *n_ex[11];
+
+  mesh = tmMesh_create(xy_min_ex, xy_max_ex, 50, 0.5, NULL);
+  tmMesh_setSubdivision(mesh, TM_SUBDIVIDE_INTEGRAL);
+
+  for (i = 0; i < 11; i++)
+    n_ex[i] = tmNode_create(mesh, xy_ex[i]);
+
+  bdry = tmMesh_addBdry(mesh, FALSE, 1);
+  for (i = 0; i < 4; i++)
+    tmBdry_edgeCreate(bdry, n_ex[i], n_ex[(i+1)%4], 1, 1.4);
+
+  bdry = tmMesh_addBdry(mesh, TRUE, 1);
+  for (i = 0; i < 4; i++)
+    tmBdry_edgeCreate(bdry, n_ex[4+i], n_ex[4+(i+1)%4], 2, 1.6);
+
+  bdry = tmMesh_addBdry(mesh, TRUE, 2);
+  for (i = 0; i < 3; i++)
+    tmBdry_edgeCreate(bdry, n_ex[8+i], n_ex[8+(i+1)%3], 3, 1.5);
+
+  tmMesh_ADFMeshing(mesh);
+
+  mu_assert( mesh->front->no_edges == 0 &&
+      fabs(mesh->areaTris - 82.5) < 1.0E-8 * 82.5,
+      "Failed to mesh example with subdivided boundaries.");
+
+  for (cur = mesh->edges_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmEdge *e = (tmEdge*) cur->value;
+    mu_assert( e->t1 != NULL && 
+               (e->t2 != NULL || e->bdry_marker >= 0),
+        "Subdivided example mesh is not closed.");
+  }
+
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmMesh_subdivision() */
+
+/*************************************************************
+* Checks, that all sizes, which are cached on the mesh 
+* nodes and edges, equal the size function
+*************************************************************/
+static char *check_cached_sizes(tmMesh *mesh, int *n_cached)
+{
+  tmListNode *cur;
+
+  *n_cached = 0;
+
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmNode  *node = (tmNode*) cur->value;
+    tmDouble rho  = tmMesh_sizeFun(mesh, node->xy);
+
+    if (node->size == 0.0)
+      continue;
+
+    mu_assert( memcmp(&rho, &node->size, sizeof(rho)) == 0,
+        "Cached node size differs from the size function.");
+    *n_cached += 1;
+  }
+
+  for (cur = mesh->edges_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmEdge  *edge = (tmEdge*) cur->value;
+    tmDouble rho  = tmMesh_sizeFun(mesh, edge->xy);
+
+    if (edge->size == 0.0)
+      continue;
+
+    mu_assert( memcmp(&rho, &edge->size, sizeof(rho)) == 0,
+        "Cached edge size differs from the size function.");
+  }
+
+  return NULL;
+}
+
+/*************************************************************
+* Unit test function for the size function values, which
+* are cached on nodes and edges
+*************************************************************/
+char *test_tmNode_getSize()
+{
+  tmDouble xy_min[2] = { -1.0, -1.0 };
+  tmDouble xy_max[2] = { 17.0, 13.0 };
+  tmMesh *mesh = tmMesh_create(xy_min, xy_max, 20, 
+                               GLOBSIZE, size_fun_5);
+  tmDouble xy[2] = { 5.0, 5.0 };
+  char *msg;
+  int   n_cached;
+
+  /*----------------------------------------------------------
+  | A node evaluates the size function only once
+  ----------------------------------------------------------*/
+  tmNode *node = tmNode_create(mesh, xy);
+  tmDouble rho = tmNode_getSize(node);
+
+  mu_assert( rho == tmMesh_sizeFun(mesh, xy) && 
+             mesh->n_size_saved == 0,
+      "Wrong size function value of node.");
+  mu_assert( tmNode_getSize(node) == rho && mesh->n_size_saved == 1,
+      "Size function value is not cached on node.");
+
+  tmMesh_destroy(mesh);
+
+  /*----------------------------------------------------------
+  | Cached sizes remain valid during the meshing and are
+  | invalidated for smoothed nodes
+  ----------------------------------------------------------*/
+  mesh = create_size_fun_test_mesh(FALSE);
+  tmMesh_setThreads(mesh, 4);
+  tmMesh_ADFMeshing(mesh);
+
+  mu_assert( mesh->n_size_saved > mesh->no_nodes,
+      "No size function evaluations are saved.");
+
+  msg = check_cached_sizes(mesh, &n_cached);
+  if (msg != NULL) return msg;
+  mu_assert( n_cached == mesh->no_nodes, 
+      "Size function values are not cached on all nodes.");
+
+  tmMesh_smooth(mesh, 5);
+
+  msg = check_cached_sizes(mesh, &n_cached);
+  if (msg != NULL) return msg;
+
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmNode_getSize() */
+
+/*************************************************************
+* Size function job for the test of independent meshes
+*************************************************************/
+typedef struct {
+  const char *expr_str;
+  tmExpr     *expr;
+  int         n_tris;
+  tmDouble    area;
+} tmTestSizeFunJob;
+
+static tmDouble size_fun_ctx(void *ctx, tmDouble xy[2])
+{
+  return tmExpr_eval((const tmExpr*) ctx, xy);
+}
+
+static void mesh_size_fun_job(void *data, size_t i_beg, 
+                              size_t i_end, int thread_id)
+{
+  tmTestSizeFunJob *jobs = (tmTestSizeFunJob*) data;
+  tmDouble xy_min[2] = { -1.0, -1.0 };
+  tmDouble xy_max[2] = { 11.0, 11.0 };
+  tmDouble xy_ext[4][2] = { {  0.0,  0.0 }, { 10.0,  0.0 },
+                            { 10.0, 10.0 }, {  0.0, 10.0 } };
+  size_t i;
+  int    j;
+
+  (void) thread_id;
+
+  for (i = i_beg; i < i_end; i++)
+  {
+    tmMesh *mesh = tmMesh_create(xy_min, xy_max, 20, 1.0, NULL);
+    tmNode *n_ext[4];
+
+    tmMesh_setSizeFunCtx(mesh, size_fun_ctx, jobs[i].expr);
+
+    for (j = 0; j < 4; j++)
+      n_ext[j] = tmNode_create(mesh, xy_ext[j]);
+
+    tmBdry *bdry = tmMesh_addBdry(mesh, FALSE, 0);
+    for (j = 0; j < 4; j++)
+      tmBdry_edgeCreate(bdry, n_ext[j], n_ext[(j+1)%4], 0, 1.0);
+
+    tmMesh_ADFMeshing(mesh);
+
+    jobs[i].n_tris = mesh->no_tris;
+    jobs[i].area   = mesh->areaTris;
+
+    tmMesh_destroy(mesh);
+  }
+}
+
+/*************************************************************
+* Unit test function for independent meshes with different
+* size functions, which are created concurrently
+*************************************************************/
+char *test_tmMesh_sizeFunCtx()
+{
+  tmTestSizeFunJob jobs[4] = { 
+    { "0.8", NULL, 0, 0.0 },
+    { "0.3+0.05*x", NULL, 0, 0.0 },
+    { "0.5-0.3*exp(-0.1*((x-5)^2+(y-5)^2))", NULL, 0, 0.0 },
+    { "0.8", NULL, 0, 0.0 } };
+  tmTestSizeFunJob ref[4];
+  int i, err;
+
+  for (i = 0; i < 4; i++)
+  {
+    jobs[i].expr = tmExpr_compile(jobs[i].expr_str, &err);
+    mu_assert( jobs[i].expr != NULL, "Failed to compile expression.");
+  }
+
+  memcpy(ref, jobs, sizeof(jobs));
+  mesh_size_fun_job(ref, 0, 4, 0);
+
+  tmPool *pool = tmPool_create(4);
+  tmPool_parallelFor(pool, 4, 1, mesh_size_fun_job, jobs);
+  tmPool_destroy(pool);
+
+  for (i = 0; i < 4; i++)
+  {
+    mu_assert( jobs[i].n_tris > 0 && jobs[i].n_tris == ref[i].n_tris
+            && fabs(jobs[i].area - 100.0) < 1.0E-8,
+        "Concurrent meshes differ from serial meshes.");
+    tmExpr_destroy(jobs[i].expr);
+  }
+
+  mu_assert( jobs[0].n_tris == jobs[3].n_tris &&
+             jobs[0].n_tris != jobs[1].n_tris,
+      "Meshes do not depend on their size function context.");
+
+  return NULL;
+
+} /* test_tmMesh_sizeFunCtx() */
+
+/************************************************************
+* Server of test_tmClient_mesh(), which answers requests 
+* with the content "mesh" with the binary data of a mesh
+************************************************************/
+typedef struct tmTestServer {
+  int     fd;
+  tmMesh *mesh;
+  int     n_requests;
+} tmTestServer;
+
+static void *test_server(void *arg)
+{
+  tmTestServer *srv = (tmTestServer*) arg;
+  tmWriter     *w   = tmWriter_create(-1);
+  void         *data;
+  uint64_t      len;
+  uint32_t      type;
+  int           fd  = accept(srv->fd, NULL, NULL);
+
+  while ( fd >= 0 && w != NULL &&
+          tmClient_recvMsg(fd, TM_MSG_REQUEST, 
+                           &type, &data, &len) == TRUE )
+  {
+    w->n = 0;
+
+    if ( type == TM_REQUEST_PARA && strcmp(data, "mesh") == 0 
+         && tmMesh_writeBinaryTo(srv->mesh, w) == TRUE )
+      tmClient_sendMsg(fd, TM_MSG_RESPONSE, TM_RESPONSE_OK, 
+                       w->buf, w->n);
+    else
+      tmClient_sendMsg(fd, TM_MSG_RESPONSE, TM_RESPONSE_ERROR, 
+                       "error", 6);
+
+    srv->n_requests += 1;
+    free(data);
+  }
+
+  if ( fd >= 0 )
+    close(fd);
+  tmWriter_destroy(w);
+
+  return NULL;
+}
+
+/************************************************************
+* Unit test function for the client of the TMesh daemon
+************************************************************/
+char *test_tmClient_mesh()
+{
+  const char        *path = "tmesh_test.sock";
+  tmMesh            *mesh = create_flip_test_bdry();
+  tmTestServer       srv  = { -1, mesh, 0 };
+  tmClient          *client;
+  tmClientMesh       cm;
+  struct sockaddr_un addr;
+  pthread_t          thread;
+  tmListNode        *cur;
+  int                i;
+
+  tmMesh_ADFMeshing(mesh);
+
+  /*--------------------------------------------------------
+  | Start the server
+  --------------------------------------------------------*/
+  memset(&addr, 0, sizeof(addr));
+  addr.sun_family = AF_UNIX;
+  strcpy(addr.sun_path, path);
+  unlink(path);
+
+  srv.fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  mu_assert( srv.fd >= 0 && 
+             bind(srv.fd, (struct sockaddr*) &addr, sizeof(addr)) == 0 
+             && listen(srv.fd, 1) == 0,
+      "Failed to create the server socket.");
+  mu_assert( pthread_create(&thread, NULL, test_server, &srv) == 0,
+      "Failed to start the server.");
+
+  mu_assert( tmClient_connect("tmesh_test_missing.sock") == NULL,
+      "Connected to a missing socket.");
+
+  client = tmClient_connect(path);
+  mu_assert( client != NULL, "Failed to connect to the server.");
+
+  /*--------------------------------------------------------
+  | The received arrays equal the mesh
+  | (assumes a little-endian host)
+  --------------------------------------------------------*/
+  for (i = 0; i < 2; i++)
+  {
+    mu_assert( tmClient_mesh(client, "mesh", 4, &cm) == TRUE,
+        "Failed to receive the mesh.");
+    mu_assert( cm.n_nodes == mesh->no_nodes && 
+               cm.n_tris  == mesh->no_tris,
+        "Wrong number of nodes or triangles.");
+
+    tmTri *t = (tmTri*) mesh->tris_stack->last->value;
+    mu_assert( cm.tris[cm.n_tris-1][0] == t->n1->index &&
+               cm.tris[cm.n_tris-1][1] == t->n2->index &&
+               cm.tris[cm.n_tris-1][2] == t->n3->index,
+        "Wrong triangle nodes.");
+
+    for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+    {
+      tmNode *n = (tmNode*) cur->value;
+      mu_assert( cm.nodes[n->index][0] == n->xy[0] &&
+                 cm.nodes[n->index][1] == n->xy[1],
+          "Wrong node coordinates.");
+    }
+
+    tmClientMesh_free(&cm);
+  }
+
+  /*--------------------------------------------------------
+  | Errors are reported, but the connection remains usable
+  --------------------------------------------------------*/
+  mu_assert( tmClient_mesh(client, "none", 4, &cm) == FALSE,
+      "Received a mesh for an invalid request.");
+  mu_assert( cm.data == NULL, "Invalid request returned data.");
+  mu_assert( tmClient_mesh(client, "mesh", 4, &cm) == TRUE,
+      "Connection failed after an invalid request.");
+  tmClientMesh_free(&cm);
+
+  tmClient_destroy(client);
+  pthread_join(thread, NULL);
+
+  mu_assert( srv.n_requests == 4, "Wrong number of requests.");
+
+  close(srv.fd);
+  unlink(path);
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmClient_mesh() */
+
+/************************************************************
+* Unit test function for the shared memory mesh output
+************************************************************/ 
+char *test_tmShm_export()
+{
+  tmMesh     *mesh = create_flip_test_bdry();
+  const char *name = "/tmesh_test_shm";
+  tmShmMesh   shm, bad_shm;
+  tmListNode *cur;
+  int         i, j, fd;
+  uint64_t    off;
+  uint64_t    bad      = UINT64_MAX - 7;
+  off_t       off_nbrs = (off_t) offsetof(tmShmHeader, off_nbrs);
+
+  tmMesh_ADFMeshing(mesh);
+
+  mu_assert( tmShm_export(mesh, name) == TRUE,
+      "Failed to export the mesh to shared memory.");
+  mu_assert( tmShm_map(name, &shm) == TRUE,
+      "Failed to map the shared memory mesh.");
+  mu_assert( shm.n_nodes == mesh->no_nodes && 
+             shm.n_tris  == mesh->no_tris,
+      "Wrong number of shared memory nodes or triangles.");
+
+  /*--------------------------------------------------------
+  | The arrays must follow the order of the mesh lists 
+  --------------------------------------------------------*/
+  i = 0;
+  for (cur = mesh->nodes_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmNode *n = (tmNode*) cur->value;
+    mu_assert( n->index == i && shm.nodes[i][0] == n->xy[0] &&
+               shm.nodes[i][1] == n->xy[1],
+        "Wrong shared memory node.");
+    i += 1;
+  }
+
+  i = 0;
+  for (cur = mesh->tris_stack->first; cur != NULL; cur = cur->next)
+  {
+    tmTri  *t       = (tmTri*) cur->value;
+    tmTri  *nbr[3]  = { t->t1, t->t2, t->t3 };
+    tmEdge *edge[3] = { t->e1, t->e2, t->e3 };
+
+    mu_assert( shm.tris[i][0] == t->n1->index &&
+               shm.tris[i][1] == t->n2->index &&
+               shm.tris[i][2] == t->n3->index,
+        "Wrong shared memory triangle.");
+
+    for (j = 0; j < 3; j++)
+    {
+      if ( nbr[j] != NULL && nbr[j] != t )
+      {
+        mu_assert( shm.nbrs[i][j] == nbr[j]->index,
+            "Wrong shared memory triangle neighbor.");
+      }
+      else
+      {
+        mu_assert( shm.nbrs[i][j] == -(edge[j]->bdry_marker),
+            "Wrong shared memory boundary marker.");
+      }
+    }
+    i += 1;
+  }
+
+  /*--------------------------------------------------------
+  | An offset, whose sum with the array size wraps around,
+  | must be rejected
+  --------------------------------------------------------*/
+  fd = shm_open(name, O_RDWR, 0);
+  mu_assert( fd >= 0 && lseek(fd, off_nbrs, SEEK_SET) == off_nbrs
+             && read(fd, &off, 8) == 8
+             && lseek(fd, off_nbrs, SEEK_SET) == off_nbrs
+             && write(fd, &bad, 8) == 8,
+      "Failed to modify the shared memory mesh.");
+  mu_assert( tmShm_map(name, &bad_shm) == FALSE,
+      "Mapped a shared memory mesh with a wrapping offset.");
+  mu_assert( lseek(fd, off_nbrs, SEEK_SET) == off_nbrs
+             && write(fd, &off, 8) == 8,
+      "Failed to restore the shared memory mesh.");
+  close(fd);
+
+  /*--------------------------------------------------------
+  | A mapping stays valid after the segment is removed
+  --------------------------------------------------------*/
+  mu_assert( tmShm_unlink(name) == TRUE,
+      "Failed to remove the shared memory mesh.");
+  mu_assert( shm.nodes[0][0] == 
+             ((tmNode*)mesh->nodes_stack->first->value)->xy[0],
+      "Shared memory mapping is invalid after removal.");
+  tmShm_unmap(&shm);
+
+  mu_assert( tmShm_map(name, &shm) == FALSE && shm.data == NULL,
+      "Mapped a missing shared memory mesh.");
+
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmShm_export() */
+
+/************************************************************
+* Unit test function for the meshing of symmetric domains
+* with mirror and rotational symmetries
+************************************************************/
+char *test_tmMesh_ADFMeshingSymmetric()
+{
+  tmDouble    center[2] = { 5.0, 5.0 };
+  tmListNode *cur;
+  int i, k;
+
+  for (k = 0; k < 2; k++)
+  {
+    tmMesh  *mesh = create_flip_test_bdry();
+    tmDouble rot[2][2];
+
+    tmMesh_setThreads(mesh, 2);
+
+    /*------------------------------------------------------
+    | Mirror symmetry to y = 5 / rotational symmetry 
+    | about the center by 90 degrees
+    ------------------------------------------------------*/
+    if (k == 0)
+    {
+      tmMesh_ADFMeshingSymmetric(mesh, TM_SYMMETRY_MIRROR, 
+                                 center, 0.0, 0);
+      rot[0][0] = 1.0;  rot[0][1] =  0.0;
+      rot[1][0] = 0.0;  rot[1][1] = -1.0;
+    }
+    else
+    {
+      tmMesh_ADFMeshingSymmetric(mesh, TM_SYMMETRY_ROTATION, 
+                                 center, 0.1, 4);
+      rot[0][0] = 0.0;  rot[0][1] = -1.0;
+      rot[1][0] = 1.0;  rot[1][1] =  0.0;
+    }
+
+    mu_assert( ABS(mesh->areaTris - mesh->areaBdry) 
+               < 1.0E-8 * mesh->areaBdry,
+        "Symmetric meshing did not cover the domain.");
+
+    /*------------------------------------------------------
+    | Sector sides must be merged to interior edges
+    ------------------------------------------------------*/
+    for (cur = mesh->edges_stack->first; 
+         cur != NULL; cur = cur->next)
+    {
+      tmEdge *e = (tmEdge*) cur->value;
+
+      mu_assert( e->bdry_marker != TM_DOMAIN_MARKER,
+          "Sector side edge remains in the mesh.");
+      mu_assert( e->t1 != NULL,
+          "Mesh edge without adjacent triangle.");
+      mu_assert( e->bdry_marker >= 0 || e->t2 != NULL,
+          "Interior mesh edge with a single triangle.");
+      mu_assert( e->bdry_marker < 0 || e->t2 == NULL,
+          "Boundary mesh edge with two triangles.");
+    }
+
+    for (cur = mesh->tris_stack->first; 
+         cur != NULL; cur = cur->next)
+    {
+      tmTri *t        = (tmTri*) cur->value;
+      tmTri *t_nbr[3] = { t->t1, t->t2, t->t3 };
+
+      mu_assert( t->area > 0.0,
+          "Triangle with non-positive area.");
+
+      for (i = 0; i < 3; i++)
+      {
+        if (t_nbr[i] != NULL)
+        {
+          mu_assert( t_nbr[i]->t1 == t || t_nbr[i]->t2 == t ||
+                     t_nbr[i]->t3 == t,
+              "Triangle neighbors are not symmetric.");
+        }
+      }
+    }
+
+    mu_assert( mesh->no_nodes - mesh->no_edges + mesh->no_tris == 0,
+        "Symmetric mesh violates the Euler characteristic.");
+
+    /*------------------------------------------------------
+    | Every node must have a node at its image location
+    ------------------------------------------------------*/
+    for (cur = mesh->nodes_stack->first; 
+         cur != NULL; cur = cur->next)
+    {
+      tmNode  *n     = (tmNode*) cur->value;
+      tmDouble dx    = n->xy[0] - center[0];
+      tmDouble dy    = n->xy[1] - center[1];
+      tmDouble xy[2] = { center[0] + rot[0][0]*dx + rot[0][1]*dy,
+                         center[1] + rot[1][0]*dx + rot[1][1]*dy };
+
+      tmList *found = tmQtree_getObjCirc(mesh->nodes_qtree, 
+                                         xy, 1.0E-8);
+      mu_assert( found != NULL && found->count == 1,
+          "Mesh is not symmetric.");
+      tmList_destroy(found);
+    }
+
+    tmMesh_destroy(mesh);
+  }
+
+  return NULL;
+
+} /* test_tmMesh_ADFMeshingSymmetric() */
+
+/************************************************************
+* Unit test function for the meshing of a periodic cell
+* with a hole, which is replicated on a 3 x 2 lattice
+************************************************************/
+char *test_tmMesh_ADFMeshingPeriodic()
+{
+  tmDouble xy_min[2] = { -1.0, -1.0 };
+  tmDouble xy_max[2] = { 31.0, 21.0 };
+  tmMesh  *mesh = tmMesh_create(xy_min, xy_max, 20, 
+                                1.0, size_fun_2);
+  tmListNode *cur;
+  int i;
+
+  /*--------------------------------------------------------
+  | Cell with different markers on every side and an 
+  | off-center hole, such that opposite sides get 
+  | different node distributions, if meshed on their own
+  --------------------------------------------------------*/
+  tmDouble xy_ext[4][2] = { {  0.0,  0.0 }, { 10.0,  0.0 },
+                            { 10.0, 10.0 }, {  0.0, 10.0 } };
+  tmNode  *n_ext[4];
+  tmNode  *n_circ[16];
+
+  for (i = 0; i < 4; i++)
+    n_ext[i] = tmNode_create(mesh, xy_ext[i]);
+
+  tmBdry *bdry_ext = tmMesh_addBdry(mesh, FALSE, 0);
+  for (i = 0; i < 4; i++)
+    tmBdry_edgeCreate(bdry_ext, n_ext[i], n_ext[(i+1)%4], 
+                      2+i, 1.0);
+
+  for (i = 0; i < 16; i++)
+  {
+    tmDouble phi = -2.0 * PI_D * (tmDouble) i / 16.0;
+    tmDouble xy[2] = { 3.5 + 2.0 * cos(phi), 
+                       4.0 + 2.0 * sin(phi) };
+    n_circ[i] = tmNode_create(mesh, xy);
+  }
+
+  tmBdry *bdry_int = tmMesh_addBdry(mesh, TRUE, 1);
+  for (i = 0; i < 16; i++)
+    tmBdry_edgeCreate(bdry_int, n_circ[i], n_circ[(i+1)%16], 
+                      1, 1.0);
+
+  tmMesh_ADFMeshingPeriodic(mesh, 3, 2);
+
+  tmDouble area_cell = 100.0 - 32.0 * sin(PI_D / 8.0);
+
+  mu_assert( ABS(mesh->areaBdry - 6.0 * area_cell) 
+             < 1.0E-8 * mesh->areaBdry,
+      "Periodic mesh boundaries do not cover the lattice.");
+  mu_assert( ABS(mesh->areaTris - mesh->areaBdry) 
+             < 1.0E-8 * mesh->areaBdry,
+      "Periodic meshing did not cover the domain.");
+  mu_assert( mesh->no_bdrys == 7,
+      "Periodic mesh has wrong number of boundaries.");
+
+  /*------------------------------------------------------
+  | Common cell sides must be merged to interior edges
+  ------------------------------------------------------*/
+  for (cur = mesh->edges_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmEdge  *e = (tmEdge*) cur->value;
+    tmDouble x = 0.5 * (e->n1->xy[0] + e->n2->xy[0]);
+    tmDouble y = 0.5 * (e->n1->xy[1] + e->n2->xy[1]);
+
+    mu_assert( e->t1 != NULL,
+        "Mesh edge without adjacent triangle.");
+    mu_assert( (e->bdry_marker >= 0) == (e->t2 == NULL),
+        "Mesh edge with wrong number of triangles.");
+
+    if (e->bdry_marker > 1)
+    {
+      mu_assert( ABS(x) < 1.0E-8 || ABS(x - 30.0) < 1.0E-8 ||
+                 ABS(y) < 1.0E-8 || ABS(y - 20.0) < 1.0E-8,
+          "Cell side edge remains in the interior of the mesh.");
+    }
+  }
+
+  for (cur = mesh->tris_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmTri *t        = (tmTri*) cur->value;
+    tmTri *t_nbr[3] = { t->t1, t->t2, t->t3 };
+
+    mu_assert( t->area > 0.0,
+        "Triangle with non-positive area.");
+
+    for (i = 0; i < 3; i++)
+    {
+      if (t_nbr[i] != NULL)
+      {
+        mu_assert( t_nbr[i]->t1 == t || t_nbr[i]->t2 == t ||
+                   t_nbr[i]->t3 == t,
+            "Triangle neighbors are not symmetric.");
+      }
+    }
+  }
+
+  mu_assert( mesh->no_nodes - mesh->no_edges + mesh->no_tris == -5,
+      "Periodic mesh violates the Euler characteristic.");
+
+  /*------------------------------------------------------
+  | Every node must have a node at its translated 
+  | locations within the lattice
+  ------------------------------------------------------*/
+  for (cur = mesh->nodes_stack->first; 
+       cur != NULL; cur = cur->next)
+  {
+    tmNode *n = (tmNode*) cur->value;
+
+    for (i = 0; i < 2; i++)
+    {
+      tmDouble xy[2] = { n->xy[0] + 10.0 * (tmDouble) (1-i), 
+                         n->xy[1] + 10.0 * (tmDouble) i };
+
+      if (xy[0] > 30.0 + 1.0E-8 || xy[1] > 20.0 + 1.0E-8)
+        continue;
+
+      tmList *found = tmQtree_getObjCirc(mesh->nodes_qtree, 
+                                         xy, 1.0E-8);
+      mu_assert( found != NULL && found->count == 1,
+          "Mesh is not periodic.");
+      tmList_destroy(found);
+    }
+  }
+
+  tmMesh_destroy(mesh);
+
+  /*------------------------------------------------------
+  | The size function must only be evaluated within the
+  | lattice, here it is negative left of the cell
+  ------------------------------------------------------*/
+  mesh = tmMesh_create(xy_min, xy_max, 20, 1.0, size_fun_8);
+
+  for (i = 0; i < 4; i++)
+    n_ext[i] = tmNode_create(mesh, xy_ext[i]);
+
+  bdry_ext = tmMesh_addBdry(mesh, FALSE, 0);
+  for (i = 0; i < 4; i++)
+    tmBdry_edgeCreate(bdry_ext, n_ext[i], n_ext[(i+1)%4], 
+                      2+i, 1.0);
+
+  tmMesh_ADFMeshingPeriodic(mesh, 3, 2);
+
+  mu_assert( ABS(mesh->areaTris - 600.0) < 1.0E-8 * 600.0,
+      "Periodic meshing failed for a non-periodic size function.");
+
+  tmMesh_destroy(mesh);
+
+  return NULL;
+
+} /* test_tmMesh_ADFMeshingPeriodic() */
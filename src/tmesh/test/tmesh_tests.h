@@ -65,4 +65,127 @@ char *test_tmFront_tMesh();
 ************************************************************/ 
 char *test_tmBdry_sizeFunction();
 
+/************************************************************
+* Unit test function for the in-place delaunay edge flips
+************************************************************/ 
+char *test_tmMesh_delaunayFlip();
+char *test_tmMesh_delaunayFlipParallel();
+
+/************************************************************
+* Unit test function for the mesh smoothing
+************************************************************/ 
+char *test_tmMesh_smooth();
+
+/************************************************************
+* Unit test function for the parallel meshing of 
+* subdomains
+************************************************************/ 
+char *test_tmMesh_ADFMeshingParallel();
+
+/************************************************************
+* Unit test function for the speculative advancing front
+* meshing on several threads
+************************************************************/ 
+char *test_tmMesh_ADFMeshingSpeculative();
+
+/************************************************************
+* Unit test function for the parallel check of neighbor 
+* nodes during the front advancement
+************************************************************/ 
+char *test_tmFront_advanceParallel();
+
+/************************************************************
+* Unit test function for the binary mesh output
+************************************************************/ 
+char *test_tmMesh_writeBinary();
+
+/************************************************************
+* Unit test function for the VTU mesh output
+************************************************************/ 
+char *test_tmMesh_writeVTU();
+
+/************************************************************
+* Unit test function for the Gmsh MSH mesh output
+************************************************************/ 
+char *test_tmMesh_writeMSH();
+
+/************************************************************
+* Unit test function for the buffered writer
+************************************************************/ 
+char *test_tmWriter();
+
+/************************************************************
+* Unit test function for the output of nodes and triangles
+* during the meshing
+************************************************************/ 
+char *test_tmMesh_sink();
+
+/************************************************************
+* Unit test function for the mesh renumbering
+************************************************************/ 
+char *test_tmMesh_renumber();
+
+/************************************************************
+* Unit test function for the mesh cache
+************************************************************/ 
+char *test_tmCache();
+
+/************************************************************
+* Unit test function for the loading of a mesh
+************************************************************/ 
+char *test_tmMesh_load();
+
+/************************************************************
+* Unit test function for the compiled size function 
+* expressions and their performance
+************************************************************/ 
+char *test_tmExpr();
+char *test_tmExpr_performance();
+
+/************************************************************
+* Unit test function for the batch evaluation of the 
+* size function
+************************************************************/ 
+char *test_tmMesh_sizeFunBatch();
+
+/************************************************************
+* Unit test function for the subdivision of edges with the
+* integral of the size function
+************************************************************/ 
+char *test_tmMesh_subdivision();
+
+/************************************************************
+* Unit test function for the size function values, which
+* are cached on nodes and edges
+************************************************************/ 
+char *test_tmNode_getSize();
+
+/************************************************************
+* Unit test function for independent meshes with different
+* size functions, which are created concurrently
+************************************************************/ 
+char *test_tmMesh_sizeFunCtx();
+
+/************************************************************
+* Unit test function for the client of the TMesh daemon
+************************************************************/ 
+char *test_tmClient_mesh();
+
+/************************************************************
+* Unit test function for the shared memory mesh output
+************************************************************/ 
+char *test_tmShm_export();
+
+/************************************************************
+* Unit test function for the meshing of symmetric domains
+* with mirror and rotational symmetries
+************************************************************/ 
+char *test_tmMesh_ADFMeshingSymmetric();
+
+/************************************************************
+* Unit test function for the meshing of a periodic cell
+* with a hole, which is replicated on a 3 x 2 lattice
+************************************************************/ 
+char *test_tmMesh_ADFMeshingPeriodic();
+
 #endif
@@ -1,4 +1,5 @@
 #include <assert.h>
+#include <stdlib.h>
 #include "tmesh/minunit.h"
 #include "tmesh/dbg.h"
 #include "tmesh_tests.h"
@@ -32,6 +33,7 @@ char *all_tests()
   **********************************************************/
   //mu_run_test(test_tmParam_readfile);
   mu_run_test(test_tmParam_comments);
+  mu_run_test(test_tmParamFile);
 
   /**********************************************************
   * Unit tests for tmesh library
@@ -54,6 +56,34 @@ char *all_tests()
   //mu_run_test(test_tmQuad_transformation);
     
   //mu_run_test(test_tmBdry_sizeFunction);
+  mu_run_test(test_tmMesh_delaunayFlip);
+  mu_run_test(test_tmMesh_delaunayFlipParallel);
+  mu_run_test(test_tmMesh_smooth);
+  mu_run_test(test_tmMesh_ADFMeshingParallel);
+  mu_run_test(test_tmMesh_ADFMeshingSpeculative);
+  mu_run_test(test_tmFront_advanceParallel);
+  mu_run_test(test_tmMesh_writeBinary);
+  mu_run_test(test_tmMesh_writeVTU);
+  mu_run_test(test_tmMesh_writeMSH);
+  mu_run_test(test_tmWriter);
+  mu_run_test(test_tmMesh_sink);
+  mu_run_test(test_tmMesh_renumber);
+  mu_run_test(test_tmCache);
+  mu_run_test(test_tmMesh_load);
+  mu_run_test(test_tmExpr);
+  /*--------------------------------------------------------
+  | Timings are only run on demand, since they take a while
+  --------------------------------------------------------*/
+  if ( getenv("TMESH_PERF_TESTS") != NULL )
+    mu_run_test(test_tmExpr_performance);
+  mu_run_test(test_tmMesh_sizeFunBatch);
+  mu_run_test(test_tmMesh_subdivision);
+  mu_run_test(test_tmNode_getSize);
+  mu_run_test(test_tmMesh_sizeFunCtx);
+  mu_run_test(test_tmClient_mesh);
+  mu_run_test(test_tmShm_export);
+  mu_run_test(test_tmMesh_ADFMeshingSymmetric);
+  mu_run_test(test_tmMesh_ADFMeshingPeriodic);
   
   //mu_run_test(test_mesh_cylinder);
   